@@ -0,0 +1,301 @@
+#include "AccountRisk.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+namespace OrderMatchingEngine {
+
+namespace {
+
+long long currentTimestamp() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+void copyField(char* field, size_t size, const std::string& value) {
+    size_t length = std::min(value.size(), size - 1);
+    std::memcpy(field, value.data(), length);
+    std::memset(field + length, 0, size - length);
+}
+
+std::string readField(const char* field, size_t size) {
+    size_t length = 0;
+    while (length < size && field[length] != '\0') {
+        ++length;
+    }
+    return std::string(field, length);
+}
+
+} // namespace
+
+const char* toString(RiskCheckResult result) {
+    switch (result) {
+        case RiskCheckResult::ACCEPTED:           return "ACCEPTED";
+        case RiskCheckResult::ACCOUNT_INACTIVE:   return "ACCOUNT_INACTIVE";
+        case RiskCheckResult::UNKNOWN_ACCOUNT:    return "UNKNOWN_ACCOUNT";
+        case RiskCheckResult::TRADING_HALTED:     return "TRADING_HALTED";
+        case RiskCheckResult::ORDER_TOO_LARGE:    return "ORDER_TOO_LARGE";
+        case RiskCheckResult::POSITION_LIMIT:     return "POSITION_LIMIT";
+        case RiskCheckResult::EXPOSURE_LIMIT:     return "EXPOSURE_LIMIT";
+        case RiskCheckResult::DAILY_VOLUME_LIMIT: return "DAILY_VOLUME_LIMIT";
+        case RiskCheckResult::DAILY_LOSS_LIMIT:   return "DAILY_LOSS_LIMIT";
+        case RiskCheckResult::DAILY_ORDER_LIMIT:  return "DAILY_ORDER_LIMIT";
+        case RiskCheckResult::ORDER_RATE_LIMIT:   return "ORDER_RATE_LIMIT";
+        case RiskCheckResult::INSUFFICIENT_FUNDS: return "INSUFFICIENT_FUNDS";
+    }
+    return "UNKNOWN";
+}
+
+// TokenBucket implementation
+void TokenBucket::configure(double tokensPerSecond, int burst) {
+    if (tokensPerSecond <= 0.0) {
+        emissionInterval.store(0, std::memory_order_relaxed);
+        return;
+    }
+    long long interval = std::max(1LL, std::llround(1000000.0 / tokensPerSecond));
+    burstTolerance.store(interval * (std::max(burst, 1) - 1), std::memory_order_relaxed);
+    emissionInterval.store(interval, std::memory_order_relaxed);
+}
+
+// AccountRiskState implementation
+AccountRiskState::AccountRiskState(CashAmount initialCash, size_t positionCapacity)
+    : availableCash(initialCash), reservedCash(0), dayLoss(0), ordersToday(0),
+      active(true), maxOrderValue(0), maxPositionValue(0), dailyLossLimit(0), maxOrdersPerDay(0),
+      maxOrdersPerSecond(0), overflowUsed(false) {
+    size_t capacity = roundUpToPowerOfTwo(positionCapacity > 0 ? positionCapacity : 1);
+    positions.reset(new PositionSlot[capacity]);
+    positionMask = capacity - 1;
+    for (size_t i = 0; i < capacity; ++i) {
+        positions[i].key.store(0, std::memory_order_relaxed);
+        positions[i].quantity.store(0, std::memory_order_relaxed);
+    }
+}
+
+void AccountRiskState::setLimits(const AccountLimits& limits) {
+    maxOrderValue.store(limits.maxOrderValue, std::memory_order_relaxed);
+    maxPositionValue.store(limits.maxPositionValue, std::memory_order_relaxed);
+    dailyLossLimit.store(limits.dailyLossLimit, std::memory_order_relaxed);
+    maxOrdersPerDay.store(limits.maxOrdersPerDay, std::memory_order_relaxed);
+    maxOrdersPerSecond.store(limits.maxOrdersPerSecond, std::memory_order_relaxed);
+    orderRate.configure(limits.maxOrdersPerSecond, limits.maxOrdersPerSecond);
+}
+
+AccountLimits AccountRiskState::getLimits() const {
+    AccountLimits limits;
+    limits.maxOrderValue = maxOrderValue.load(std::memory_order_relaxed);
+    limits.maxPositionValue = maxPositionValue.load(std::memory_order_relaxed);
+    limits.dailyLossLimit = dailyLossLimit.load(std::memory_order_relaxed);
+    limits.maxOrdersPerDay = maxOrdersPerDay.load(std::memory_order_relaxed);
+    limits.maxOrdersPerSecond = maxOrdersPerSecond.load(std::memory_order_relaxed);
+    return limits;
+}
+
+RiskCheckResult AccountRiskState::checkAndReserve(const PreTradeOrder& order, long long nowMicros) {
+    if (!active.load(std::memory_order_acquire)) {
+        return RiskCheckResult::ACCOUNT_INACTIVE;
+    }
+
+    // Read-only checks first, so most rejections touch no shared counter
+    CashAmount value = order.getValue();
+    CashAmount orderLimit = maxOrderValue.load(std::memory_order_relaxed);
+    if (orderLimit > 0 && value > orderLimit) {
+        return RiskCheckResult::ORDER_TOO_LARGE;
+    }
+    CashAmount positionLimit = maxPositionValue.load(std::memory_order_relaxed);
+    if (positionLimit > 0) {
+        std::int64_t projected = getPosition(order.symbolIndex) +
+                                 (order.side == OrderSide::BUY ? order.quantity : -order.quantity);
+        if (std::llabs(projected) * order.unitPrice > positionLimit) {
+            return RiskCheckResult::POSITION_LIMIT;
+        }
+    }
+    CashAmount lossLimit = dailyLossLimit.load(std::memory_order_relaxed);
+    if (lossLimit > 0 && dayLoss.load(std::memory_order_relaxed) >= lossLimit) {
+        return RiskCheckResult::DAILY_LOSS_LIMIT;
+    }
+
+    int dayLimit = maxOrdersPerDay.load(std::memory_order_relaxed);
+    if (ordersToday.fetch_add(1, std::memory_order_relaxed) >= dayLimit && dayLimit > 0) {
+        ordersToday.fetch_sub(1, std::memory_order_relaxed);
+        return RiskCheckResult::DAILY_ORDER_LIMIT;
+    }
+    if (!orderRate.tryAcquire(nowMicros)) {
+        ordersToday.fetch_sub(1, std::memory_order_relaxed);
+        return RiskCheckResult::ORDER_RATE_LIMIT;
+    }
+
+    if (order.side == OrderSide::BUY) {
+        CashAmount cash = availableCash.load(std::memory_order_relaxed);
+        do {
+            if (cash < value) {
+                ordersToday.fetch_sub(1, std::memory_order_relaxed);
+                return RiskCheckResult::INSUFFICIENT_FUNDS;
+            }
+        } while (!availableCash.compare_exchange_weak(cash, cash - value, std::memory_order_acq_rel,
+                                                      std::memory_order_relaxed));
+        reservedCash.fetch_add(value, std::memory_order_relaxed);
+    }
+    return RiskCheckResult::ACCEPTED;
+}
+
+void AccountRiskState::releaseReservation(CashAmount amount) {
+    reservedCash.fetch_sub(amount, std::memory_order_relaxed);
+    availableCash.fetch_add(amount, std::memory_order_acq_rel);
+}
+
+bool AccountRiskState::withdraw(CashAmount amount) {
+    CashAmount cash = availableCash.load(std::memory_order_relaxed);
+    do {
+        if (cash < amount) {
+            return false;
+        }
+    } while (!availableCash.compare_exchange_weak(cash, cash - amount, std::memory_order_acq_rel,
+                                                  std::memory_order_relaxed));
+    return true;
+}
+
+void AccountRiskState::applyFill(std::uint16_t symbolIndex, OrderSide side, int quantity,
+                                 CashAmount unitPrice, CashAmount reservedPart) {
+    std::int64_t delta = side == OrderSide::BUY ? quantity : -quantity;
+    PositionSlot* slot = findSlot(symbolIndex, true);
+    if (slot) {
+        slot->quantity.fetch_add(delta, std::memory_order_acq_rel);
+    } else {
+        std::lock_guard<std::mutex> lock(overflowMutex);
+        overflowPositions[symbolIndex] += delta;
+        overflowUsed.store(true, std::memory_order_release);
+    }
+
+    CashAmount value = unitPrice * quantity;
+    if (side == OrderSide::BUY) {
+        // A fill below the reserved price hands the difference back
+        reservedCash.fetch_sub(reservedPart, std::memory_order_relaxed);
+        availableCash.fetch_add(reservedPart - value, std::memory_order_acq_rel);
+    } else {
+        availableCash.fetch_add(value, std::memory_order_acq_rel);
+    }
+}
+
+void AccountRiskState::resetDay() {
+    dayLoss.store(0, std::memory_order_relaxed);
+    ordersToday.store(0, std::memory_order_relaxed);
+}
+
+AccountRiskState::PositionSlot* AccountRiskState::findSlot(std::uint16_t symbolIndex, bool create) const {
+    std::uint32_t key = static_cast<std::uint32_t>(symbolIndex) + 1;
+    size_t start = (static_cast<size_t>(symbolIndex) * 2654435761u) & positionMask;
+    for (size_t probe = 0; probe <= positionMask; ++probe) {
+        PositionSlot& slot = positions[(start + probe) & positionMask];
+        std::uint32_t current = slot.key.load(std::memory_order_acquire);
+        if (current == key) {
+            return &slot;
+        }
+        if (current == 0) {
+            // Slots are never freed, so the first empty one ends the probe
+            if (!create) {
+                return nullptr;
+            }
+            if (slot.key.compare_exchange_strong(current, key, std::memory_order_acq_rel) || current == key) {
+                return &slot;
+            }
+        }
+    }
+    return nullptr;
+}
+
+std::int64_t AccountRiskState::getPosition(std::uint16_t symbolIndex) const {
+    PositionSlot* slot = findSlot(symbolIndex, false);
+    if (slot) {
+        return slot->quantity.load(std::memory_order_acquire);
+    }
+    if (!overflowUsed.load(std::memory_order_acquire)) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(overflowMutex);
+    auto it = overflowPositions.find(symbolIndex);
+    return it != overflowPositions.end() ? it->second : 0;
+}
+
+std::vector<std::pair<std::uint16_t, std::int64_t>> AccountRiskState::getPositions() const {
+    std::vector<std::pair<std::uint16_t, std::int64_t>> result;
+    for (size_t i = 0; i <= positionMask; ++i) {
+        std::uint32_t key = positions[i].key.load(std::memory_order_acquire);
+        std::int64_t quantity = positions[i].quantity.load(std::memory_order_acquire);
+        if (key != 0 && quantity != 0) {
+            result.emplace_back(static_cast<std::uint16_t>(key - 1), quantity);
+        }
+    }
+    std::lock_guard<std::mutex> lock(overflowMutex);
+    for (const auto& entry : overflowPositions) {
+        if (entry.second != 0) {
+            result.emplace_back(entry.first, entry.second);
+        }
+    }
+    return result;
+}
+
+// AuditRecord implementation
+AuditRecord::AuditRecord() : timestamp(0) {
+    std::memset(userId, 0, sizeof(userId));
+    std::memset(action, 0, sizeof(action));
+    std::memset(details, 0, sizeof(details));
+}
+
+AuditRecord::AuditRecord(const std::string& userId, const std::string& action, const std::string& details,
+                         long long timestamp)
+    : timestamp(timestamp) {
+    copyField(this->userId, sizeof(this->userId), userId);
+    copyField(this->action, sizeof(this->action), action);
+    copyField(this->details, sizeof(this->details), details);
+}
+
+std::string AuditRecord::getUserId() const { return readField(userId, sizeof(userId)); }
+std::string AuditRecord::getAction() const { return readField(action, sizeof(action)); }
+std::string AuditRecord::getDetails() const { return readField(details, sizeof(details)); }
+
+// AuditTrail implementation
+AuditTrail::AuditTrail(size_t ringCapacity, size_t maxArchived)
+    : pending(ringCapacity), maxArchived(maxArchived) {
+}
+
+void AuditTrail::append(const std::string& userId, const std::string& action, const std::string& details) {
+    AuditRecord record(userId, action, details, currentTimestamp());
+    while (!pending.tryPush(record)) {
+        // Nobody has read the trail for a while: archive the backlog and retry
+        std::lock_guard<std::mutex> lock(archiveMutex);
+        collect();
+    }
+}
+
+void AuditTrail::collect() const {
+    AuditRecord record;
+    while (pending.tryPop(record)) {
+        archive.push_back(record);
+        if (archive.size() > maxArchived) {
+            archive.pop_front();
+        }
+    }
+}
+
+std::vector<AuditRecord> AuditTrail::getRecords(const std::string& userId) const {
+    std::lock_guard<std::mutex> lock(archiveMutex);
+    collect();
+
+    // Records hold the user ID truncated to its field, so match on the same prefix
+    std::vector<AuditRecord> result;
+    for (const auto& record : archive) {
+        if (userId.compare(0, sizeof(record.userId) - 1, record.userId) == 0) {
+            result.push_back(record);
+        }
+    }
+    return result;
+}
+
+size_t AuditTrail::size() const {
+    std::lock_guard<std::mutex> lock(archiveMutex);
+    collect();
+    return archive.size();
+}
+
+} // namespace OrderMatchingEngine
\ No newline at end of file
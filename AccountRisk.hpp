@@ -0,0 +1,270 @@
+#ifndef ACCOUNT_RISK_HPP
+#define ACCOUNT_RISK_HPP
+
+#include "Order.hpp"
+#include "RingBuffer.hpp"
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace OrderMatchingEngine {
+
+/**
+ * @brief Cash amount in fixed point, CASH_SCALE units per currency unit
+ * Reserving and releasing the same amount cancels exactly, which repeated
+ * double arithmetic on a shared balance does not guarantee.
+ */
+using CashAmount = std::int64_t;
+constexpr CashAmount CASH_SCALE = 10000;
+
+inline CashAmount toCashAmount(double value) {
+    return static_cast<CashAmount>(std::llround(value * static_cast<double>(CASH_SCALE)));
+}
+
+inline double fromCashAmount(CashAmount amount) {
+    return static_cast<double>(amount) / static_cast<double>(CASH_SCALE);
+}
+
+/**
+ * @brief Outcome of a pre-trade check
+ */
+enum class RiskCheckResult : std::uint8_t {
+    ACCEPTED,
+    ACCOUNT_INACTIVE,
+    UNKNOWN_ACCOUNT,
+    TRADING_HALTED,
+    ORDER_TOO_LARGE,
+    POSITION_LIMIT,
+    EXPOSURE_LIMIT,
+    DAILY_VOLUME_LIMIT,
+    DAILY_LOSS_LIMIT,
+    DAILY_ORDER_LIMIT,
+    ORDER_RATE_LIMIT,
+    INSUFFICIENT_FUNDS
+};
+
+const char* toString(RiskCheckResult result);
+
+/**
+ * @brief Lock-free token bucket, kept as a theoretical arrival time (GCRA)
+ *
+ * Tokens refill continuously at the configured rate up to the burst size.
+ * One CAS on a single word per acquired token, however many threads share
+ * the bucket.
+ */
+class TokenBucket {
+private:
+    std::atomic<long long> theoreticalArrival;  // Microseconds; time the bucket is full again
+    std::atomic<long long> emissionInterval;    // Microseconds per token, 0 when unlimited
+    std::atomic<long long> burstTolerance;      // emissionInterval * (burst - 1)
+
+public:
+    TokenBucket() : theoreticalArrival(0), emissionInterval(0), burstTolerance(0) {}
+
+    /**
+     * @brief Set the refill rate and burst size; a rate of 0 disables the limit
+     */
+    void configure(double tokensPerSecond, int burst);
+
+    /**
+     * @brief Take one token if available
+     */
+    bool tryAcquire(long long nowMicros) {
+        long long interval = emissionInterval.load(std::memory_order_relaxed);
+        if (interval == 0) {
+            return true;
+        }
+        long long tolerance = burstTolerance.load(std::memory_order_relaxed);
+        long long arrival = theoreticalArrival.load(std::memory_order_relaxed);
+        while (true) {
+            long long base = arrival > nowMicros ? arrival : nowMicros;
+            if (base - nowMicros > tolerance) {
+                return false;
+            }
+            if (theoreticalArrival.compare_exchange_weak(arrival, base + interval, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+    }
+
+    bool isLimited() const { return emissionInterval.load(std::memory_order_relaxed) != 0; }
+};
+
+/**
+ * @brief Per-account limits; 0 disables a limit
+ */
+struct AccountLimits {
+    CashAmount maxOrderValue;
+    CashAmount maxPositionValue;    // Per symbol, at the order's price
+    CashAmount dailyLossLimit;
+    int maxOrdersPerDay;
+    int maxOrdersPerSecond;         // Token bucket rate; the burst is one second's worth
+
+    AccountLimits()
+        : maxOrderValue(0), maxPositionValue(0), dailyLossLimit(0), maxOrdersPerDay(0),
+          maxOrdersPerSecond(0) {}
+};
+
+/**
+ * @brief What a pre-trade check needs to know about an order
+ */
+struct PreTradeOrder {
+    std::uint16_t symbolIndex;
+    OrderSide side;
+    int quantity;
+    CashAmount unitPrice;           // Limit price, or a reference price for market orders
+
+    CashAmount getValue() const { return unitPrice * quantity; }
+};
+
+/**
+ * @brief Hot pre-trade state of one account, checked and updated without locks
+ *
+ * Every counter is an atomic on its own cache line, so the matching and
+ * gateway threads of different shards can reserve cash and move positions of
+ * the same account concurrently. checkAndReserve() is the whole pre-trade
+ * path: limit checks, order counters and the cash reservation (buys only),
+ * with a rejected order leaving no trace but its rate token.
+ *
+ * Positions live in a fixed open-addressing table keyed by symbol index;
+ * symbols beyond its capacity spill into a mutex-protected map.
+ */
+class AccountRiskState {
+private:
+    struct PositionSlot {
+        std::atomic<std::uint32_t> key;     // Symbol index + 1, 0 while free
+        std::atomic<std::int64_t> quantity;
+    };
+
+    alignas(CACHE_LINE_SIZE) std::atomic<CashAmount> availableCash;
+    std::atomic<CashAmount> reservedCash;
+    alignas(CACHE_LINE_SIZE) std::atomic<CashAmount> dayLoss;
+    std::atomic<int> ordersToday;
+    TokenBucket orderRate;
+    alignas(CACHE_LINE_SIZE) std::atomic<bool> active;
+    std::atomic<CashAmount> maxOrderValue;
+    std::atomic<CashAmount> maxPositionValue;
+    std::atomic<CashAmount> dailyLossLimit;
+    std::atomic<int> maxOrdersPerDay;
+    std::atomic<int> maxOrdersPerSecond;
+
+    std::unique_ptr<PositionSlot[]> positions;
+    size_t positionMask;
+    std::atomic<bool> overflowUsed;
+    mutable std::mutex overflowMutex;
+    std::unordered_map<std::uint16_t, std::int64_t> overflowPositions;
+
+    PositionSlot* findSlot(std::uint16_t symbolIndex, bool create) const;
+
+public:
+    /**
+     * @brief Constructor
+     * @param positionCapacity Symbols tracked lock-free, rounded up to a power of two
+     */
+    explicit AccountRiskState(CashAmount initialCash = 0, size_t positionCapacity = 64);
+
+    AccountRiskState(const AccountRiskState&) = delete;
+    AccountRiskState& operator=(const AccountRiskState&) = delete;
+
+    void setLimits(const AccountLimits& limits);
+    AccountLimits getLimits() const;
+    void setActive(bool enabled) { active.store(enabled, std::memory_order_release); }
+    bool isActive() const { return active.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Run every pre-trade check and, for a buy, reserve its value
+     * @param nowMicros Current time, for the order-rate window
+     */
+    RiskCheckResult checkAndReserve(const PreTradeOrder& order, long long nowMicros);
+
+    /**
+     * @brief Return an unused reservation, e.g. when a buy is cancelled
+     */
+    void releaseReservation(CashAmount amount);
+
+    /**
+     * @brief Apply a fill: move the position and settle cash
+     * For a buy, reservedPart of the cost comes out of the order's reservation
+     * and the rest out of available cash; a sell credits its proceeds.
+     */
+    void applyFill(std::uint16_t symbolIndex, OrderSide side, int quantity, CashAmount unitPrice,
+                   CashAmount reservedPart);
+
+    void deposit(CashAmount amount) { availableCash.fetch_add(amount, std::memory_order_acq_rel); }
+    bool withdraw(CashAmount amount);
+    void recordLoss(CashAmount loss) { dayLoss.fetch_add(loss, std::memory_order_relaxed); }
+    void resetDay();
+
+    CashAmount getAvailableCash() const { return availableCash.load(std::memory_order_acquire); }
+    CashAmount getReservedCash() const { return reservedCash.load(std::memory_order_acquire); }
+    CashAmount getDayLoss() const { return dayLoss.load(std::memory_order_relaxed); }
+    int getOrdersToday() const { return ordersToday.load(std::memory_order_relaxed); }
+    std::int64_t getPosition(std::uint16_t symbolIndex) const;
+
+    /**
+     * @brief Every non-zero position, by symbol index
+     */
+    std::vector<std::pair<std::uint16_t, std::int64_t>> getPositions() const;
+};
+
+/**
+ * @brief Fixed-size audit entry; text fields are truncated, never allocated
+ */
+struct AuditRecord {
+    long long timestamp;            // Microseconds since epoch
+    char userId[24];
+    char action[24];
+    char details[72];
+
+    AuditRecord();
+    AuditRecord(const std::string& userId, const std::string& action, const std::string& details,
+                long long timestamp);
+
+    std::string getUserId() const;
+    std::string getAction() const;
+    std::string getDetails() const;
+};
+
+/**
+ * @brief Asynchronous audit trail: lock-free appends, archived in bulk
+ *
+ * append() copies a fixed record into an MPSC ring. Readers, and a producer
+ * that finds the ring full, move the pending records into the archive under
+ * a mutex the hot path never takes otherwise.
+ */
+class AuditTrail {
+private:
+    mutable MpscRing<AuditRecord> pending;      // Consumed under archiveMutex only
+    mutable std::mutex archiveMutex;
+    mutable std::deque<AuditRecord> archive;
+    size_t maxArchived;
+
+    void collect() const;   // Caller holds archiveMutex
+
+public:
+    /**
+     * @brief Constructor
+     * @param ringCapacity Records buffered between collections
+     * @param maxArchived Oldest records are dropped beyond this many
+     */
+    explicit AuditTrail(size_t ringCapacity = 16384, size_t maxArchived = 1000000);
+
+    void append(const std::string& userId, const std::string& action, const std::string& details = "");
+
+    /**
+     * @brief Archived records of one user, oldest first
+     */
+    std::vector<AuditRecord> getRecords(const std::string& userId) const;
+
+    size_t size() const;
+};
+
+} // namespace OrderMatchingEngine
+
+#endif // ACCOUNT_RISK_HPP
\ No newline at end of file
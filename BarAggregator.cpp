@@ -0,0 +1,211 @@
+#include "BarAggregator.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace OrderMatchingEngine {
+
+namespace {
+
+long long floorDiv(long long value, long long step) {
+    long long quotient = value / step;
+    return (value % step != 0 && value < 0) ? quotient - 1 : quotient;
+}
+
+size_t ringSlot(long long barNumber, size_t ringSize) {
+    long long slot = barNumber % static_cast<long long>(ringSize);
+    return static_cast<size_t>(slot < 0 ? slot + static_cast<long long>(ringSize) : slot);
+}
+
+} // namespace
+
+// Bar implementation
+Bar::Bar()
+    : startTimestamp(0), openPrice(0), highPrice(0), lowPrice(0), closePrice(0), volume(0),
+      notional(0.0), tradeCount(0) {
+}
+
+// TradeTotals implementation
+TradeTotals::TradeTotals()
+    : tradeCount(0), volume(0), notional(0.0), firstTimestamp(0), lastTimestamp(0) {
+}
+
+void TradeTotals::add(const Trade& trade) {
+    if (tradeCount == 0 || trade.timestamp < firstTimestamp) {
+        firstTimestamp = trade.timestamp;
+    }
+    if (tradeCount == 0 || trade.timestamp > lastTimestamp) {
+        lastTimestamp = trade.timestamp;
+    }
+    tradeCount++;
+    volume += trade.quantity;
+    notional += static_cast<double>(trade.price) * trade.quantity;
+}
+
+// BarAggregator implementation
+BarAggregator::BarAggregator(const AggregatorConfig& config) : config(config) {
+    if (config.secondBarsRetained == 0 || config.minuteBarsRetained == 0 || config.dayBarsRetained == 0) {
+        throw std::invalid_argument("Bar retention must be at least one bar per interval");
+    }
+}
+
+long long BarAggregator::intervalMicros(BarInterval interval) {
+    switch (interval) {
+        case BarInterval::SECOND: return 1000000LL;
+        case BarInterval::MINUTE: return 60LL * 1000000LL;
+        case BarInterval::DAY:    return 86400LL * 1000000LL;
+    }
+    throw std::invalid_argument("Unknown bar interval");
+}
+
+BarAggregator::SymbolAggregates& BarAggregator::aggregatesFor(const std::string& symbol) {
+    {
+        std::shared_lock<std::shared_mutex> lock(symbolsMutex);
+        auto it = symbols.find(symbol);
+        if (it != symbols.end()) {
+            return *it->second;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(symbolsMutex);
+    auto& slot = symbols[symbol];
+    if (!slot) {
+        slot = std::make_unique<SymbolAggregates>();
+        slot->bars[static_cast<size_t>(BarInterval::SECOND)].resize(config.secondBarsRetained);
+        slot->bars[static_cast<size_t>(BarInterval::MINUTE)].resize(config.minuteBarsRetained);
+        slot->bars[static_cast<size_t>(BarInterval::DAY)].resize(config.dayBarsRetained);
+    }
+    return *slot;
+}
+
+const BarAggregator::SymbolAggregates* BarAggregator::findAggregates(const std::string& symbol) const {
+    std::shared_lock<std::shared_mutex> lock(symbolsMutex);
+    auto it = symbols.find(symbol);
+    return it != symbols.end() ? it->second.get() : nullptr;   // Entries are never erased while in use
+}
+
+void BarAggregator::addToBar(std::vector<Bar>& ring, long long intervalLength, const Trade& trade) {
+    long long barNumber = floorDiv(trade.timestamp, intervalLength);
+    long long barStart = barNumber * intervalLength;
+    Bar& bar = ring[ringSlot(barNumber, ring.size())];
+
+    if (bar.isEmpty() || bar.startTimestamp < barStart) {
+        // Slot held an expired bar: start a new one
+        bar = Bar();
+        bar.startTimestamp = barStart;
+        bar.openPrice = bar.highPrice = bar.lowPrice = trade.price;
+    } else if (bar.startTimestamp > barStart) {
+        return; // Trade is older than the retained bars
+    }
+
+    bar.highPrice = std::max(bar.highPrice, trade.price);
+    bar.lowPrice = std::min(bar.lowPrice, trade.price);
+    bar.closePrice = trade.price;
+    bar.volume += trade.quantity;
+    bar.notional += static_cast<double>(trade.price) * trade.quantity;
+    bar.tradeCount++;
+}
+
+void BarAggregator::onTrade(const Trade& trade) {
+    SymbolAggregates& aggregates = aggregatesFor(trade.symbol);
+    {
+        std::lock_guard<std::mutex> lock(aggregates.mutex);
+        aggregates.totals.add(trade);
+        for (size_t i = 0; i < INTERVAL_COUNT; ++i) {
+            addToBar(aggregates.bars[i], intervalMicros(static_cast<BarInterval>(i)), trade);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(engineTotalsMutex);
+    engineTotals.add(trade);
+}
+
+void BarAggregator::onTrades(const std::vector<Trade>& trades) {
+    for (const auto& trade : trades) {
+        onTrade(trade);
+    }
+}
+
+bool BarAggregator::getLatestBar(const std::string& symbol, BarInterval interval, Bar& bar) const {
+    const SymbolAggregates* aggregates = findAggregates(symbol);
+    if (!aggregates) {
+        return false;
+    }
+    long long length = intervalMicros(interval);
+    std::lock_guard<std::mutex> lock(aggregates->mutex);
+    if (aggregates->totals.tradeCount == 0) {
+        return false;
+    }
+    const std::vector<Bar>& ring = aggregates->bars[static_cast<size_t>(interval)];
+    long long barNumber = floorDiv(aggregates->totals.lastTimestamp, length);
+    const Bar& latest = ring[ringSlot(barNumber, ring.size())];
+    if (latest.isEmpty() || latest.startTimestamp != barNumber * length) {
+        return false;
+    }
+    bar = latest;
+    return true;
+}
+
+std::vector<Bar> BarAggregator::getBars(const std::string& symbol, BarInterval interval,
+                                         long long start, long long end) const {
+    std::vector<Bar> result;
+    const SymbolAggregates* aggregates = findAggregates(symbol);
+    if (!aggregates || end <= start) {
+        return result;
+    }
+
+    long long length = intervalMicros(interval);
+    std::lock_guard<std::mutex> lock(aggregates->mutex);
+    const std::vector<Bar>& ring = aggregates->bars[static_cast<size_t>(interval)];
+    long long ringSize = static_cast<long long>(ring.size());
+
+    // Only the last ringSize bars up to the latest trade can still be in the ring
+    long long lastBar = std::min(floorDiv(end - 1, length), floorDiv(aggregates->totals.lastTimestamp, length));
+    long long firstBar = std::max(floorDiv(start + length - 1, length), lastBar - ringSize + 1);
+    for (long long barNumber = firstBar; barNumber <= lastBar; ++barNumber) {
+        const Bar& bar = ring[ringSlot(barNumber, ring.size())];
+        if (!bar.isEmpty() && bar.startTimestamp == barNumber * length) {
+            result.push_back(bar);
+        }
+    }
+    return result;
+}
+
+TradeTotals BarAggregator::getSymbolTotals(const std::string& symbol) const {
+    const SymbolAggregates* aggregates = findAggregates(symbol);
+    if (!aggregates) {
+        return TradeTotals();
+    }
+    std::lock_guard<std::mutex> lock(aggregates->mutex);
+    return aggregates->totals;
+}
+
+std::unordered_map<std::string, TradeTotals> BarAggregator::getAllSymbolTotals() const {
+    std::unordered_map<std::string, TradeTotals> totals;
+    std::shared_lock<std::shared_mutex> lock(symbolsMutex);
+    totals.reserve(symbols.size());
+    for (const auto& entry : symbols) {
+        std::lock_guard<std::mutex> symbolLock(entry.second->mutex);
+        totals.emplace(entry.first, entry.second->totals);
+    }
+    return totals;
+}
+
+TradeTotals BarAggregator::getEngineTotals() const {
+    std::lock_guard<std::mutex> lock(engineTotalsMutex);
+    return engineTotals;
+}
+
+void BarAggregator::reset() {
+    std::unique_lock<std::shared_mutex> lock(symbolsMutex);
+    for (auto& entry : symbols) {
+        std::lock_guard<std::mutex> symbolLock(entry.second->mutex);
+        entry.second->totals = TradeTotals();
+        for (auto& ring : entry.second->bars) {
+            std::fill(ring.begin(), ring.end(), Bar());
+        }
+    }
+    std::lock_guard<std::mutex> totalsLock(engineTotalsMutex);
+    engineTotals = TradeTotals();
+}
+
+} // namespace OrderMatchingEngine
\ No newline at end of file
@@ -0,0 +1,142 @@
+#ifndef BAR_AGGREGATOR_HPP
+#define BAR_AGGREGATOR_HPP
+
+#include "OrderBook.hpp"
+#include <array>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace OrderMatchingEngine {
+
+/**
+ * @brief Bar lengths maintained by BarAggregator
+ */
+enum class BarInterval {
+    SECOND = 0,
+    MINUTE = 1,
+    DAY = 2
+};
+
+/**
+ * @brief OHLC bar with volume, notional and trade count; prices in ticks
+ */
+struct Bar {
+    long long startTimestamp;   // Microseconds since epoch (UTC boundaries)
+    Price openPrice;
+    Price highPrice;
+    Price lowPrice;
+    Price closePrice;
+    long long volume;
+    double notional;            // Sum of price * quantity, in ticks
+    long long tradeCount;
+
+    Bar();
+
+    double vwap() const { return volume > 0 ? notional / volume : 0.0; }
+    bool isEmpty() const { return tradeCount == 0; }
+};
+
+/**
+ * @brief Running totals since start-up, for one symbol or for the whole engine
+ */
+struct TradeTotals {
+    long long tradeCount;
+    long long volume;
+    double notional;
+    long long firstTimestamp;
+    long long lastTimestamp;
+
+    TradeTotals();
+
+    void add(const Trade& trade);
+    double averageTradeSize() const { return tradeCount > 0 ? static_cast<double>(volume) / tradeCount : 0.0; }
+};
+
+/**
+ * @brief Per-symbol 1s/1m/1d bars and totals, updated as each trade is logged
+ *
+ * Each trade touches one bar per interval and the symbol's totals, so queries
+ * cost O(1) for totals and the current bar and O(bars) for a history range,
+ * regardless of how many trades have been logged. Bars live in fixed rings
+ * per symbol; anything older than the retention of its interval is gone,
+ * and the trade store answers those queries instead.
+ */
+class BarAggregator {
+public:
+    struct AggregatorConfig {
+        size_t secondBarsRetained;
+        size_t minuteBarsRetained;
+        size_t dayBarsRetained;
+
+        AggregatorConfig() : secondBarsRetained(3600), minuteBarsRetained(1440), dayBarsRetained(366) {}
+    };
+
+    static constexpr size_t INTERVAL_COUNT = 3;
+
+    static long long intervalMicros(BarInterval interval);
+
+private:
+    struct SymbolAggregates {
+        mutable std::mutex mutex;
+        TradeTotals totals;
+        std::array<std::vector<Bar>, INTERVAL_COUNT> bars;     // Rings indexed by bar number
+    };
+
+    AggregatorConfig config;
+    std::unordered_map<std::string, std::unique_ptr<SymbolAggregates>> symbols;
+    mutable std::shared_mutex symbolsMutex;                 // Exclusive only to add a symbol
+
+    TradeTotals engineTotals;
+    mutable std::mutex engineTotalsMutex;
+
+    SymbolAggregates& aggregatesFor(const std::string& symbol);
+    const SymbolAggregates* findAggregates(const std::string& symbol) const;
+    static void addToBar(std::vector<Bar>& ring, long long intervalLength, const Trade& trade);
+
+public:
+    explicit BarAggregator(const AggregatorConfig& config = AggregatorConfig());
+
+    /**
+     * @brief Fold a trade into its symbol's bars and totals
+     */
+    void onTrade(const Trade& trade);
+    void onTrades(const std::vector<Trade>& trades);
+
+    /**
+     * @brief Bar containing the symbol's latest trade
+     * @return False if the symbol has no bar of that interval yet
+     */
+    bool getLatestBar(const std::string& symbol, BarInterval interval, Bar& bar) const;
+
+    /**
+     * @brief Non-empty bars starting in [start, end), oldest first
+     * Limited to the bars still retained for the interval.
+     */
+    std::vector<Bar> getBars(const std::string& symbol, BarInterval interval,
+                             long long start, long long end) const;
+
+    /**
+     * @brief Totals for one symbol (all zero if it never traded)
+     */
+    TradeTotals getSymbolTotals(const std::string& symbol) const;
+
+    /**
+     * @brief Totals for every symbol that has traded
+     */
+    std::unordered_map<std::string, TradeTotals> getAllSymbolTotals() const;
+
+    TradeTotals getEngineTotals() const;
+
+    /**
+     * @brief Drop every bar and total
+     */
+    void reset();
+};
+
+} // namespace OrderMatchingEngine
+
+#endif // BAR_AGGREGATOR_HPP
\ No newline at end of file
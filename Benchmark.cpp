@@ -0,0 +1,590 @@
+#include "OrderBook.hpp"
+#include "MatchingShard.hpp"
+#include "MarketDepth.hpp"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <functional>
+
+using namespace OrderMatchingEngine;
+
+/**
+ * @brief Reproducible micro-benchmarks for the OrderBook and MatchingShard APIs
+ *
+ * Every scenario is driven by a fixed-seed generator, runs a warmup phase that
+ * is not recorded, and reports throughput together with a latency distribution
+ * of the individual book operations. Order objects and random choices are made
+ * outside the timed region, so only the engine call itself is measured.
+ *
+ * Build:  g++ -std=c++17 -O2 -pthread Benchmark.cpp OrderBook.cpp Order.cpp OrderPool.cpp TimerWheel.cpp
+ *              MatchingShard.cpp SnapshotWriter.cpp EventLog.cpp MarketDataFeed.cpp MarketDepth.cpp LatencyMonitor.cpp -o benchmark
+ * Usage:  ./benchmark [--scenario NAME|all] [--ops N] [--warmup N] [--seed S]
+ *                     [--producers N] [--ladder] [--format text|json|csv]
+ */
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const Price MID_PRICE = 1000000;       // 100.0000 at the default scale
+const Price PRICE_BAND = 50000;        // Orders are generated within +/- 5.0000 of mid
+const Price TICK = 100;                // 0.0100
+
+volatile long long resultSink;          // Keeps query results from being optimized away
+
+struct BenchmarkOptions {
+    std::string scenario = "all";
+    size_t ops = 200000;
+    size_t warmup = 20000;
+    std::uint32_t seed = 42;
+    int producers = 4;
+    bool useLadder = false;
+    std::string format = "text";
+};
+
+struct BenchmarkResult {
+    std::string scenario;
+    size_t ops = 0;
+    size_t trades = 0;
+    double seconds = 0.0;
+    double opsPerSecond = 0.0;
+    double meanNs = 0.0;
+    long long p50Ns = 0;
+    long long p99Ns = 0;
+    long long p999Ns = 0;
+    long long maxNs = 0;
+};
+
+/**
+ * @brief Collects per-operation latencies once the warmup phase is over
+ */
+class LatencyRecorder {
+private:
+    std::vector<long long> samples;
+    size_t warmup;
+    size_t seen;
+    long long totalNs;
+
+public:
+    LatencyRecorder(size_t ops, size_t warmup) : warmup(warmup), seen(0), totalNs(0) {
+        samples.reserve(ops);
+    }
+
+    void record(Clock::time_point start, Clock::time_point end) {
+        if (seen++ < warmup) {
+            return;
+        }
+        long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        samples.push_back(ns);
+        totalNs += ns;
+    }
+
+    void merge(const LatencyRecorder& other) {
+        samples.insert(samples.end(), other.samples.begin(), other.samples.end());
+        totalNs += other.totalNs;
+    }
+
+    BenchmarkResult summarize(const std::string& scenario, size_t trades) {
+        BenchmarkResult result;
+        result.scenario = scenario;
+        result.ops = samples.size();
+        result.trades = trades;
+        result.seconds = totalNs / 1e9;
+        if (samples.empty()) {
+            return result;
+        }
+
+        std::sort(samples.begin(), samples.end());
+        auto percentile = [this](double q) {
+            size_t rank = static_cast<size_t>(q * samples.size());
+            return samples[std::min(rank, samples.size() - 1)];
+        };
+        result.opsPerSecond = result.seconds > 0 ? result.ops / result.seconds : 0.0;
+        result.meanNs = static_cast<double>(totalNs) / samples.size();
+        result.p50Ns = percentile(0.50);
+        result.p99Ns = percentile(0.99);
+        result.p999Ns = percentile(0.999);
+        result.maxNs = samples.back();
+        return result;
+    }
+};
+
+SymbolConfig makeConfig(const BenchmarkOptions& options, std::uint16_t symbolIndex = 0) {
+    SymbolConfig config;
+    if (options.useLadder) {
+        config = SymbolConfig(PriceLadderConfig(TICK, MID_PRICE - 4 * PRICE_BAND, MID_PRICE + 4 * PRICE_BAND));
+    }
+    config.symbolIndex = symbolIndex;
+    return config;
+}
+
+/**
+ * @brief Deterministic order flow shared by the scenarios
+ */
+class OrderGenerator {
+private:
+    std::mt19937 rng;
+    std::string symbol;
+
+public:
+    OrderGenerator(std::uint32_t seed, const std::string& symbol) : rng(seed), symbol(symbol) {}
+
+    Price randomTick(Price low, Price high) {
+        std::uniform_int_distribution<Price> dist(low / TICK, high / TICK);
+        return dist(rng) * TICK;
+    }
+
+    int randomQuantity() {
+        return std::uniform_int_distribution<int>(1, 100)(rng);
+    }
+
+    /**
+     * @brief Limit order that rests on its own side of mid without crossing
+     */
+    OrderPtr passive(OrderSide side, const std::string& onSymbol) {
+        Price price = side == OrderSide::BUY ? randomTick(MID_PRICE - PRICE_BAND, MID_PRICE - TICK)
+                                             : randomTick(MID_PRICE + TICK, MID_PRICE + PRICE_BAND);
+        return std::make_shared<Order>("", "BENCH_USER", onSymbol, OrderType::LIMIT, side,
+                                       price, randomQuantity());
+    }
+
+    OrderPtr passive(OrderSide side) { return passive(side, symbol); }
+
+    /**
+     * @brief Limit order priced through the opposite side so it sweeps several levels
+     */
+    OrderPtr aggressive(OrderSide side, const std::string& onSymbol) {
+        Price reach = randomTick(TICK, PRICE_BAND / 10);
+        Price price = side == OrderSide::BUY ? MID_PRICE + reach : MID_PRICE - reach;
+        return std::make_shared<Order>("", "BENCH_USER", onSymbol, OrderType::LIMIT, side,
+                                       price, randomQuantity() * 3);
+    }
+
+    OrderPtr aggressive(OrderSide side) { return aggressive(side, symbol); }
+
+    OrderSide randomSide() { return rng() & 1 ? OrderSide::BUY : OrderSide::SELL; }
+
+    size_t pick(size_t size) { return std::uniform_int_distribution<size_t>(0, size - 1)(rng); }
+};
+
+/**
+ * @brief Remove a random live order ID in O(1), keeping the pool in generator order
+ */
+OrderId takeRandom(std::vector<OrderId>& live, OrderGenerator& generator) {
+    size_t slot = generator.pick(live.size());
+    OrderId orderId = live[slot];
+    live[slot] = live.back();
+    live.pop_back();
+    return orderId;
+}
+
+void prefill(OrderBook& book, OrderGenerator& generator, size_t count, std::vector<OrderId>* live) {
+    for (size_t i = 0; i < count; ++i) {
+        auto order = generator.passive(i % 2 ? OrderSide::BUY : OrderSide::SELL, book.getSymbol());
+        book.addOrder(order);
+        if (live) {
+            live->push_back(order->getOrderId());
+        }
+    }
+}
+
+// Scenario: only non-crossing adds, measuring level creation and FIFO append
+BenchmarkResult runAddOnly(const BenchmarkOptions& options) {
+    OrderBook book("BENCH", makeConfig(options));
+    OrderGenerator generator(options.seed, "BENCH");
+    LatencyRecorder recorder(options.ops, options.warmup);
+
+    for (size_t i = 0; i < options.warmup + options.ops; ++i) {
+        auto order = generator.passive(generator.randomSide());
+        auto start = Clock::now();
+        book.addOrder(order);
+        recorder.record(start, Clock::now());
+    }
+    return recorder.summarize("add_only", 0);
+}
+
+// Scenario: aggressive orders sweeping a replenished book
+BenchmarkResult runAggressive(const BenchmarkOptions& options) {
+    OrderBook book("BENCH", makeConfig(options));
+    OrderGenerator generator(options.seed, "BENCH");
+    LatencyRecorder recorder(options.ops, options.warmup);
+    prefill(book, generator, 20000, nullptr);
+
+    size_t trades = 0;
+    std::vector<Fill> fills;
+    for (size_t i = 0; i < options.warmup + options.ops; ++i) {
+        OrderSide side = generator.randomSide();
+        auto order = generator.aggressive(side);
+        fills.clear();
+        auto start = Clock::now();
+        book.addOrder(order, fills);
+        recorder.record(start, Clock::now());
+        trades += fills.size();
+
+        // Replenish what was taken (untimed) so the book keeps its shape
+        for (int refill = 0; refill < 4; ++refill) {
+            book.addOrder(generator.passive(side == OrderSide::BUY ? OrderSide::SELL : OrderSide::BUY));
+        }
+    }
+    return recorder.summarize("aggressive", trades);
+}
+
+// Scenario: market-maker flow, four cancels for every add
+BenchmarkResult runCancelHeavy(const BenchmarkOptions& options) {
+    OrderBook book("BENCH", makeConfig(options));
+    OrderGenerator generator(options.seed, "BENCH");
+    LatencyRecorder recorder(options.ops, options.warmup);
+    std::vector<OrderId> live;
+    prefill(book, generator, 50000, &live);
+
+    for (size_t i = 0; i < options.warmup + options.ops; ++i) {
+        bool doCancel = !live.empty() && generator.pick(5) != 0;
+        if (doCancel) {
+            OrderId orderId = takeRandom(live, generator);
+            auto start = Clock::now();
+            book.cancelOrder(orderId);
+            recorder.record(start, Clock::now());
+        } else {
+            auto order = generator.passive(generator.randomSide());
+            auto start = Clock::now();
+            book.addOrder(order);
+            recorder.record(start, Clock::now());
+            live.push_back(order->getOrderId());
+        }
+        // Keep the resting population stable
+        while (live.size() < 40000) {
+            auto order = generator.passive(generator.randomSide());
+            book.addOrder(order);
+            live.push_back(order->getOrderId());
+        }
+    }
+    return recorder.summarize("cancel_heavy", 0);
+}
+
+// Scenario: market and limit orders each sweeping SWEEP_LEVELS levels of a rebuilt book
+BenchmarkResult runSweep(const BenchmarkOptions& options) {
+    const int SWEEP_LEVELS = 64;
+    const int LEVEL_QUANTITY = 10;
+    OrderBook book("BENCH", makeConfig(options));
+    size_t sweeps = (options.warmup + options.ops) / SWEEP_LEVELS;
+    LatencyRecorder recorder(sweeps, options.warmup / SWEEP_LEVELS);
+
+    auto rebuild = [&](OrderSide side) {
+        for (int level = 1; level <= SWEEP_LEVELS; ++level) {
+            Price price = side == OrderSide::SELL ? MID_PRICE + level * TICK : MID_PRICE - level * TICK;
+            book.addOrder(std::make_shared<Order>("", "BENCH_USER", "BENCH", OrderType::LIMIT, side,
+                                                  price, LEVEL_QUANTITY));
+        }
+    };
+    rebuild(OrderSide::BUY);
+    rebuild(OrderSide::SELL);
+
+    size_t trades = 0;
+    std::vector<Fill> fills;
+    for (size_t i = 0; i < sweeps; ++i) {
+        OrderSide side = i % 2 ? OrderSide::BUY : OrderSide::SELL;
+        bool market = (i / 2) % 2 == 0;
+        Price reach = SWEEP_LEVELS * TICK;
+        auto order = std::make_shared<Order>("", "BENCH_USER", "BENCH",
+                                             market ? OrderType::MARKET : OrderType::LIMIT, side,
+                                             market ? 0 : (side == OrderSide::BUY ? MID_PRICE + reach : MID_PRICE - reach),
+                                             SWEEP_LEVELS * LEVEL_QUANTITY);
+        fills.clear();
+        auto start = Clock::now();
+        book.addOrder(order, fills);
+        recorder.record(start, Clock::now());
+        trades += fills.size();
+
+        // Put the swept side back (untimed)
+        rebuild(side == OrderSide::BUY ? OrderSide::SELL : OrderSide::BUY);
+    }
+    return recorder.summarize("sweep", trades);
+}
+
+// Scenario: mixed add/cancel/cross flow against a book with many levels and orders
+BenchmarkResult runDeepBook(const BenchmarkOptions& options) {
+    OrderBook book("BENCH", makeConfig(options));
+    OrderGenerator generator(options.seed, "BENCH");
+    LatencyRecorder recorder(options.ops, options.warmup);
+    std::vector<OrderId> live;
+    prefill(book, generator, 200000, &live);
+
+    size_t trades = 0;
+    std::vector<Fill> fills;
+    for (size_t i = 0; i < options.warmup + options.ops; ++i) {
+        size_t action = generator.pick(10);
+        if (action < 4 && !live.empty()) {
+            OrderId orderId = takeRandom(live, generator);
+            auto start = Clock::now();
+            book.cancelOrder(orderId);
+            recorder.record(start, Clock::now());
+        } else if (action < 5) {
+            auto order = generator.aggressive(generator.randomSide());
+            fills.clear();
+            auto start = Clock::now();
+            book.addOrder(order, fills);
+            recorder.record(start, Clock::now());
+            trades += fills.size();
+        } else {
+            auto order = generator.passive(generator.randomSide());
+            auto start = Clock::now();
+            book.addOrder(order);
+            recorder.record(start, Clock::now());
+            live.push_back(order->getOrderId());
+        }
+    }
+    return recorder.summarize("deep_book", trades);
+}
+
+// Scenario: flow spread over many independent books, stressing cache footprint
+BenchmarkResult runManySymbols(const BenchmarkOptions& options) {
+    const int SYMBOL_COUNT = 256;
+    std::vector<std::unique_ptr<OrderBook>> books;
+    std::vector<std::string> symbols;
+    for (int s = 0; s < SYMBOL_COUNT; ++s) {
+        symbols.push_back("SYM" + std::to_string(s));
+        books.push_back(std::make_unique<OrderBook>(symbols.back(),
+                                                    makeConfig(options, static_cast<std::uint16_t>(s))));
+    }
+
+    OrderGenerator generator(options.seed, symbols.front());
+    LatencyRecorder recorder(options.ops, options.warmup);
+    for (int s = 0; s < SYMBOL_COUNT; ++s) {
+        prefill(*books[s], generator, 200, nullptr);
+    }
+
+    size_t trades = 0;
+    std::vector<Fill> fills;
+    for (size_t i = 0; i < options.warmup + options.ops; ++i) {
+        size_t s = generator.pick(SYMBOL_COUNT);
+        OrderSide side = generator.randomSide();
+        auto order = generator.pick(4) == 0 ? generator.aggressive(side, symbols[s])
+                                            : generator.passive(side, symbols[s]);
+        fills.clear();
+        auto start = Clock::now();
+        books[s]->addOrder(order, fills);
+        recorder.record(start, Clock::now());
+        trades += fills.size();
+    }
+    return recorder.summarize("many_symbols", trades);
+}
+
+// Scenario: router-style depth requests, every book's top levels plus impact and at-or-better queries
+BenchmarkResult runDepthQueries(const BenchmarkOptions& options) {
+    const int SYMBOL_COUNT = 256;
+    const int LEVELS = MarketDataSnapshot::MAX_DEPTH;
+    std::vector<std::unique_ptr<OrderBook>> books;
+    std::vector<const OrderBook*> request;
+    OrderGenerator generator(options.seed, "DEPTH0");
+    for (int s = 0; s < SYMBOL_COUNT; ++s) {
+        books.push_back(std::make_unique<OrderBook>("DEPTH" + std::to_string(s),
+                                                    makeConfig(options, static_cast<std::uint16_t>(s))));
+        prefill(*books.back(), generator, 400, nullptr);
+        request.push_back(books.back().get());
+    }
+
+    // One operation is a whole request: collect all books, then query each of them
+    size_t requests = (options.warmup + options.ops) / SYMBOL_COUNT + 1;
+    LatencyRecorder recorder(requests, options.warmup / SYMBOL_COUNT);
+    DepthBatch batch;
+    long long checksum = 0;
+    for (size_t i = 0; i < requests; ++i) {
+        long long size = generator.randomQuantity() * 20;
+        auto start = Clock::now();
+        collectDepth(request, LEVELS, batch);
+        for (size_t b = 0; b < batch.size(); ++b) {
+            const DepthBatch::Range& range = batch.ranges[b];
+            PriceImpact impact = DepthKernels::estimateImpact(batch.askPrices(b), batch.askQuantities(b),
+                                                              range.askCount, size);
+            checksum += impact.notional;
+            checksum += DepthKernels::quantityAtOrBetter(batch.bidPrices(b), batch.bidQuantities(b),
+                                                         range.bidCount, MID_PRICE - PRICE_BAND / 10, true);
+        }
+        recorder.record(start, Clock::now());
+    }
+    resultSink = checksum;
+    return recorder.summarize(std::string("depth_") + DepthKernels::getImplementation(), 0);
+}
+
+// Scenario: several gateway threads feeding one matching shard through its ingress ring
+BenchmarkResult runMultiProducer(const BenchmarkOptions& options) {
+    const int SYMBOL_COUNT = 8;
+    MatchingShard shard(0, 1 << 16);
+    std::vector<std::string> symbols;
+    for (int s = 0; s < SYMBOL_COUNT; ++s) {
+        symbols.push_back("MP" + std::to_string(s));
+        shard.addSymbol(symbols.back(), makeConfig(options, static_cast<std::uint16_t>(s)));
+    }
+    std::atomic<size_t> trades(0);
+    shard.setFillHandler([&trades](const OrderBook&, const std::vector<Fill>& fills) {
+        trades.fetch_add(fills.size(), std::memory_order_relaxed);
+    });
+
+    int producers = std::max(1, options.producers);
+    size_t perProducer = (options.warmup + options.ops) / producers;
+
+    // Each producer pre-builds its whole flow from its own seed
+    std::vector<std::vector<OrderPtr>> flows(producers);
+    for (int p = 0; p < producers; ++p) {
+        OrderGenerator generator(options.seed + p, symbols.front());
+        flows[p].reserve(perProducer);
+        for (size_t i = 0; i < perProducer; ++i) {
+            const std::string& symbol = symbols[generator.pick(SYMBOL_COUNT)];
+            OrderSide side = generator.randomSide();
+            flows[p].push_back(generator.pick(4) == 0 ? generator.aggressive(side, symbol)
+                                                      : generator.passive(side, symbol));
+        }
+    }
+
+    // Push latency is what a gateway thread sees; throughput is end to end
+    std::vector<LatencyRecorder> recorders;
+    for (int p = 0; p < producers; ++p) {
+        recorders.emplace_back(perProducer, options.warmup / producers);
+    }
+
+    shard.start();
+    std::atomic<bool> go(false);
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p]() {
+            while (!go.load(std::memory_order_acquire)) {
+            }
+            for (auto& order : flows[p]) {
+                auto start = Clock::now();
+                while (!shard.submitOrder(order)) {
+                    std::this_thread::yield();
+                }
+                recorders[p].record(start, Clock::now());
+            }
+        });
+    }
+
+    auto wallStart = Clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    size_t expected = perProducer * producers;
+    while (static_cast<size_t>(shard.getCommandsProcessed()) < expected) {
+        std::this_thread::yield();
+    }
+    double wallSeconds = std::chrono::duration<double>(Clock::now() - wallStart).count();
+    shard.stop();
+
+    // Merge the per-producer samples into one distribution
+    LatencyRecorder merged(expected, 0);
+    for (const auto& recorder : recorders) {
+        merged.merge(recorder);
+    }
+    BenchmarkResult result = merged.summarize("multi_producer", trades.load());
+    result.seconds = wallSeconds;
+    result.opsPerSecond = wallSeconds > 0 ? expected / wallSeconds : 0.0;
+    return result;
+}
+
+void printResults(const std::vector<BenchmarkResult>& results, const BenchmarkOptions& options) {
+    if (options.format == "json") {
+        std::cout << "{\"seed\":" << options.seed << ",\"ops\":" << options.ops
+                  << ",\"warmup\":" << options.warmup << ",\"ladder\":" << (options.useLadder ? "true" : "false")
+                  << ",\"results\":[";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const BenchmarkResult& r = results[i];
+            std::cout << (i ? "," : "") << "{\"scenario\":\"" << r.scenario << "\""
+                      << ",\"ops\":" << r.ops << ",\"trades\":" << r.trades
+                      << std::fixed << std::setprecision(1)
+                      << ",\"ops_per_sec\":" << r.opsPerSecond << ",\"mean_ns\":" << r.meanNs
+                      << ",\"p50_ns\":" << r.p50Ns << ",\"p99_ns\":" << r.p99Ns
+                      << ",\"p999_ns\":" << r.p999Ns << ",\"max_ns\":" << r.maxNs << "}";
+        }
+        std::cout << "]}\n";
+    } else if (options.format == "csv") {
+        std::cout << "scenario,ops,trades,ops_per_sec,mean_ns,p50_ns,p99_ns,p999_ns,max_ns\n";
+        for (const auto& r : results) {
+            std::cout << r.scenario << "," << r.ops << "," << r.trades << ","
+                      << std::fixed << std::setprecision(1) << r.opsPerSecond << "," << r.meanNs << ","
+                      << r.p50Ns << "," << r.p99Ns << "," << r.p999Ns << "," << r.maxNs << "\n";
+        }
+    } else {
+        std::cout << "seed=" << options.seed << " ops=" << options.ops << " warmup=" << options.warmup
+                  << " levels=" << (options.useLadder ? "ladder" : "tree") << "\n";
+        std::cout << std::left << std::setw(16) << "scenario" << std::right
+                  << std::setw(12) << "ops/s" << std::setw(10) << "mean"
+                  << std::setw(10) << "p50" << std::setw(10) << "p99"
+                  << std::setw(10) << "p99.9" << std::setw(12) << "max (ns)" << "\n";
+        for (const auto& r : results) {
+            std::cout << std::left << std::setw(16) << r.scenario << std::right
+                      << std::fixed << std::setprecision(0)
+                      << std::setw(12) << r.opsPerSecond << std::setw(10) << r.meanNs
+                      << std::setw(10) << r.p50Ns << std::setw(10) << r.p99Ns
+                      << std::setw(10) << r.p999Ns << std::setw(12) << r.maxNs << "\n";
+        }
+    }
+}
+
+bool parseOptions(int argc, char* argv[], BenchmarkOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--scenario" && hasValue) {
+            options.scenario = argv[++i];
+        } else if (arg == "--ops" && hasValue) {
+            options.ops = std::stoul(argv[++i]);
+        } else if (arg == "--warmup" && hasValue) {
+            options.warmup = std::stoul(argv[++i]);
+        } else if (arg == "--seed" && hasValue) {
+            options.seed = static_cast<std::uint32_t>(std::stoul(argv[++i]));
+        } else if (arg == "--producers" && hasValue) {
+            options.producers = std::stoi(argv[++i]);
+        } else if (arg == "--ladder") {
+            options.useLadder = true;
+        } else if (arg == "--format" && hasValue) {
+            options.format = argv[++i];
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    BenchmarkOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "Usage: " << argv[0] << " [--scenario NAME|all] [--ops N] [--warmup N] [--seed S]\n"
+                  << "       [--producers N] [--ladder] [--format text|json|csv]\n"
+                  << "Scenarios: add_only aggressive cancel_heavy deep_book sweep many_symbols multi_producer\n"
+                  << "           depth_queries\n";
+        return 1;
+    }
+
+    const std::vector<std::pair<std::string, std::function<BenchmarkResult(const BenchmarkOptions&)>>> scenarios = {
+        {"add_only", runAddOnly},
+        {"aggressive", runAggressive},
+        {"cancel_heavy", runCancelHeavy},
+        {"deep_book", runDeepBook},
+        {"sweep", runSweep},
+        {"many_symbols", runManySymbols},
+        {"multi_producer", runMultiProducer},
+        {"depth_queries", runDepthQueries},
+    };
+
+    std::vector<BenchmarkResult> results;
+    for (const auto& scenario : scenarios) {
+        if (options.scenario == "all" || options.scenario == scenario.first) {
+            results.push_back(scenario.second(options));
+        }
+    }
+    if (results.empty()) {
+        std::cerr << "Unknown scenario: " << options.scenario << "\n";
+        return 1;
+    }
+
+    printResults(results, options);
+    return 0;
+}
\ No newline at end of file
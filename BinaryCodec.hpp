@@ -0,0 +1,89 @@
+#ifndef BINARY_CODEC_HPP
+#define BINARY_CODEC_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace OrderMatchingEngine {
+
+/**
+ * @brief Appends trivially copyable values and length-prefixed strings to a byte buffer
+ * Values are stored in host byte order; files are read back on the same platform.
+ */
+class ByteWriter {
+private:
+    std::string& buffer;
+
+public:
+    explicit ByteWriter(std::string& buffer) : buffer(buffer) {}
+
+    template<typename T>
+    void put(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "ByteWriter::put needs a POD value");
+        buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void putString(const std::string& value) {
+        put(static_cast<std::uint32_t>(value.size()));
+        buffer.append(value);
+    }
+
+    size_t size() const { return buffer.size(); }
+};
+
+/**
+ * @brief Reads values written by ByteWriter, throwing on truncated input
+ */
+class ByteReader {
+private:
+    const char* cursor;
+    const char* end;
+
+    void require(size_t bytes) const {
+        if (static_cast<size_t>(end - cursor) < bytes) {
+            throw std::runtime_error("Unexpected end of binary data");
+        }
+    }
+
+public:
+    ByteReader(const char* data, size_t size) : cursor(data), end(data + size) {}
+
+    template<typename T>
+    T get() {
+        static_assert(std::is_trivially_copyable<T>::value, "ByteReader::get needs a POD value");
+        require(sizeof(T));
+        T value;
+        std::memcpy(&value, cursor, sizeof(T));
+        cursor += sizeof(T);
+        return value;
+    }
+
+    std::string getString() {
+        std::uint32_t length = get<std::uint32_t>();
+        require(length);
+        std::string value(cursor, length);
+        cursor += length;
+        return value;
+    }
+
+    size_t remaining() const { return static_cast<size_t>(end - cursor); }
+};
+
+/**
+ * @brief 32-bit FNV-1a checksum, used to detect torn or corrupt records
+ */
+inline std::uint32_t checksum32(const char* data, size_t size) {
+    std::uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+} // namespace OrderMatchingEngine
+
+#endif // BINARY_CODEC_HPP
\ No newline at end of file
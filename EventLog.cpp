@@ -0,0 +1,377 @@
+#include "EventLog.hpp"
+#include "BinaryCodec.hpp"
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace OrderMatchingEngine {
+
+namespace {
+
+const char WAL_MAGIC[8] = {'O', 'M', 'E', 'W', 'A', 'L', '0', '3'};
+const size_t RECORD_PREFIX_SIZE = 2 * sizeof(std::uint32_t);    // Body length and checksum
+
+bool writeFully(int fd, const char* data, size_t bytes) {
+    while (bytes > 0) {
+        ssize_t written = ::write(fd, data, bytes);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        bytes -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+} // namespace
+
+// SequencedEvent implementation
+SequencedEvent::SequencedEvent()
+    : sequence(0), previousSequence(0), type(EventType::SUBMIT), timestamp(0), orderId(0), price(0),
+      triggerPrice(0), expireTime(0), quantity(0), symbolIndex(0), side(OrderSide::BUY),
+      orderType(OrderType::LIMIT), timeInForce(TimeInForce::GTC) {
+}
+
+SequencedEvent SequencedEvent::submit(const Order& order) {
+    SequencedEvent event;
+    event.type = EventType::SUBMIT;
+    event.timestamp = order.getTimestamp();
+    event.orderId = order.getOrderId();
+    event.price = order.getPrice();
+    event.triggerPrice = order.getTriggerPrice();
+    event.expireTime = order.getExpireTime();
+    event.quantity = order.getRemainingQuantity();
+    event.symbolIndex = getSymbolIndex(order.getOrderId());
+    event.side = order.getSide();
+    event.orderType = order.getType();
+    event.timeInForce = order.getTimeInForce();
+    event.symbol = order.getSymbol();
+    event.userId = order.getUserId();
+    event.clientOrderId = order.getClientOrderId();
+    return event;
+}
+
+SequencedEvent SequencedEvent::submit(const OrderEntry& entry, const std::string& symbol) {
+    SequencedEvent event;
+    event.type = EventType::SUBMIT;
+    event.timestamp = entry.timestamp;
+    event.orderId = entry.orderId;
+    event.price = entry.price;
+    event.triggerPrice = entry.triggerPrice;
+    event.expireTime = entry.expireTime;
+    event.quantity = entry.quantity;
+    event.symbolIndex = getSymbolIndex(entry.orderId);
+    event.side = entry.side;
+    event.orderType = entry.type;
+    event.timeInForce = entry.timeInForce;
+    event.symbol = symbol;
+    event.userId = entry.getUserId();
+    return event;
+}
+
+SequencedEvent SequencedEvent::cancel(OrderId orderId, long long receiveTime) {
+    SequencedEvent event;
+    event.type = EventType::CANCEL;
+    event.timestamp = receiveTime;
+    event.orderId = orderId;
+    event.symbolIndex = getSymbolIndex(orderId);
+    return event;
+}
+
+SequencedEvent SequencedEvent::modify(OrderId orderId, Price newPrice, int newQuantity, long long receiveTime) {
+    SequencedEvent event;
+    event.type = EventType::MODIFY;
+    event.timestamp = receiveTime;
+    event.orderId = orderId;
+    event.price = newPrice;
+    event.quantity = newQuantity;
+    event.symbolIndex = getSymbolIndex(orderId);
+    return event;
+}
+
+OrderPtr SequencedEvent::toOrder() const {
+    auto order = std::make_shared<Order>(clientOrderId, userId, symbol, orderType, side,
+                                         price, quantity, triggerPrice);
+    order->setOrderId(orderId);
+    order->setTimestamp(timestamp);
+    order->setTimeInForce(timeInForce, expireTime);
+    return order;
+}
+
+// WriteAheadLog implementation
+WriteAheadLog::WriteAheadLog(std::atomic<std::uint64_t>* sequenceSource, bool syncOnCommit)
+    : fileDescriptor(-1), committedBytes(0), failed(false), pendingEvents(0), syncOnCommit(syncOnCommit),
+      ownSequence(0),
+      sequenceSource(sequenceSource ? sequenceSource : &ownSequence),
+      lastAppendedSequence(0), lastCommittedSequence(0), commits(0), eventsCommitted(0) {
+}
+
+WriteAheadLog::~WriteAheadLog() {
+    close();
+}
+
+bool WriteAheadLog::open(const std::string& logPath, std::uint64_t resumeAfter) {
+    close();
+    path = logPath;
+    fileDescriptor = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fileDescriptor < 0) {
+        return false;
+    }
+    off_t size = ::lseek(fileDescriptor, 0, SEEK_END);
+    if (size < 0 || (size == 0 && !writeFully(fileDescriptor, WAL_MAGIC, sizeof(WAL_MAGIC)))) {
+        close();
+        return false;
+    }
+    committedBytes = size == 0 ? static_cast<off_t>(sizeof(WAL_MAGIC)) : size;
+    failed = false;
+
+    // Never hand out a sequence number that recovery has already seen
+    std::uint64_t current = sequenceSource->load();
+    while (current < resumeAfter && !sequenceSource->compare_exchange_weak(current, resumeAfter)) {
+    }
+    lastCommittedSequence = lastAppendedSequence = resumeAfter;
+    return true;
+}
+
+void WriteAheadLog::close() {
+    if (fileDescriptor >= 0) {
+        commit();
+        ::close(fileDescriptor);
+        fileDescriptor = -1;
+    }
+}
+
+std::uint64_t WriteAheadLog::append(SequencedEvent& event) {
+    event.sequence = sequenceSource->fetch_add(1, std::memory_order_relaxed) + 1;
+    event.previousSequence = lastAppendedSequence;
+    encode(event);
+    return event.sequence;
+}
+
+void WriteAheadLog::appendReplicated(const SequencedEvent& event) {
+    std::uint64_t current = sequenceSource->load(std::memory_order_relaxed);
+    while (current < event.sequence && !sequenceSource->compare_exchange_weak(current, event.sequence)) {
+    }
+    encode(event);
+}
+
+void WriteAheadLog::encode(const SequencedEvent& event) {
+    // Reserve the length/checksum prefix, encode the body, then fill the prefix in
+    size_t recordStart = pendingBatch.size();
+    pendingBatch.append(RECORD_PREFIX_SIZE, '\0');
+    ByteWriter writer(pendingBatch);
+    writer.put(event.sequence);
+    writer.put(event.previousSequence);
+    writer.put(event.type);
+    writer.put(event.timestamp);
+    writer.put(event.orderId);
+    writer.put(event.price);
+    writer.put(event.triggerPrice);
+    writer.put(event.expireTime);
+    writer.put(event.quantity);
+    writer.put(event.symbolIndex);
+    writer.put(event.side);
+    writer.put(event.orderType);
+    writer.put(event.timeInForce);
+    writer.putString(event.symbol);
+    writer.putString(event.userId);
+    writer.putString(event.clientOrderId);
+
+    const char* body = pendingBatch.data() + recordStart + RECORD_PREFIX_SIZE;
+    std::uint32_t bodySize = static_cast<std::uint32_t>(pendingBatch.size() - recordStart - RECORD_PREFIX_SIZE);
+    std::uint32_t checksum = checksum32(body, bodySize);
+    std::memcpy(&pendingBatch[recordStart], &bodySize, sizeof(bodySize));
+    std::memcpy(&pendingBatch[recordStart + sizeof(bodySize)], &checksum, sizeof(checksum));
+
+    pendingEvents++;
+    lastAppendedSequence = event.sequence;
+}
+
+bool WriteAheadLog::commit() {
+    if (pendingEvents == 0) {
+        return true;
+    }
+    if (failed || fileDescriptor < 0) {
+        return false;
+    }
+    if (!writeFully(fileDescriptor, pendingBatch.data(), pendingBatch.size())) {
+        // Cut off whatever part of the batch did land, or the retry would follow torn
+        // bytes and recovery would stop reading there
+        if (::ftruncate(fileDescriptor, committedBytes) != 0) {
+            failed = true;
+        }
+        return false;
+    }
+    if (syncOnCommit && ::fdatasync(fileDescriptor) != 0) {
+        // The kernel may already have dropped the dirty pages and cleared the error,
+        // so a second fdatasync could succeed without the batch being on disk
+        failed = true;
+        return false;
+    }
+
+    committedBytes += static_cast<off_t>(pendingBatch.size());
+    commits++;
+    eventsCommitted += static_cast<long long>(pendingEvents);
+    lastCommittedSequence = lastAppendedSequence;
+    if (commitListener) {
+        commitListener(pendingBatch.data(), pendingBatch.size(), lastCommittedSequence);
+    }
+    pendingBatch.clear();
+    pendingEvents = 0;
+    return true;
+}
+
+bool WriteAheadLog::truncate() {
+    if (fileDescriptor < 0 || !commit()) {
+        return false;
+    }
+    if (::ftruncate(fileDescriptor, 0) != 0 ||
+        !writeFully(fileDescriptor, WAL_MAGIC, sizeof(WAL_MAGIC))) {
+        failed = true;  // No longer known to hold the magic
+        return false;
+    }
+    committedBytes = static_cast<off_t>(sizeof(WAL_MAGIC));
+    if (syncOnCommit && ::fdatasync(fileDescriptor) != 0) {
+        failed = true;
+        return false;
+    }
+    return true;
+}
+
+bool WriteAheadLog::rotate() {
+    if (fileDescriptor < 0 || !commit()) {
+        return false;
+    }
+    std::string previous = previousSegmentPath(path);
+    if (::access(previous.c_str(), F_OK) == 0 || std::rename(path.c_str(), previous.c_str()) != 0) {
+        return false;
+    }
+
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd < 0 || !writeFully(fd, WAL_MAGIC, sizeof(WAL_MAGIC)) ||
+        (syncOnCommit && ::fdatasync(fd) != 0)) {
+        // Keep appending to the one file there is
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        std::rename(previous.c_str(), path.c_str());
+        return false;
+    }
+    ::close(fileDescriptor);
+    fileDescriptor = fd;
+    committedBytes = static_cast<off_t>(sizeof(WAL_MAGIC));
+    return true;
+}
+
+bool WriteAheadLog::releasePreviousSegment() const {
+    return std::remove(previousSegmentPath(path).c_str()) == 0;
+}
+
+// EventLogReader implementation
+EventLogReader::EventLogReader() : offset(0) {
+}
+
+bool EventLogReader::open(const std::string& path) {
+    if (!SnapshotStore::readFile(path, contents)) {
+        return false;
+    }
+    offset = 0;
+    if (contents.size() >= sizeof(WAL_MAGIC) &&
+        std::memcmp(contents.data(), WAL_MAGIC, sizeof(WAL_MAGIC)) == 0) {
+        offset = sizeof(WAL_MAGIC);
+    } else {
+        contents.clear(); // Not a log: treat as empty
+    }
+    return true;
+}
+
+void EventLogReader::feed(const char* data, size_t size) {
+    if (offset > 0) {
+        contents.erase(0, offset);
+        offset = 0;
+    }
+    contents.append(data, size);
+}
+
+bool EventLogReader::next(SequencedEvent& event) {
+    if (contents.size() - offset < RECORD_PREFIX_SIZE) {
+        return false;
+    }
+    std::uint32_t bodySize;
+    std::uint32_t checksum;
+    std::memcpy(&bodySize, contents.data() + offset, sizeof(bodySize));
+    std::memcpy(&checksum, contents.data() + offset + sizeof(bodySize), sizeof(checksum));
+
+    const char* body = contents.data() + offset + RECORD_PREFIX_SIZE;
+    if (contents.size() - offset - RECORD_PREFIX_SIZE < bodySize ||
+        checksum32(body, bodySize) != checksum) {
+        return false; // Torn write at the tail
+    }
+
+    ByteReader reader(body, bodySize);
+    event.sequence = reader.get<std::uint64_t>();
+    event.previousSequence = reader.get<std::uint64_t>();
+    event.type = reader.get<EventType>();
+    event.timestamp = reader.get<long long>();
+    event.orderId = reader.get<OrderId>();
+    event.price = reader.get<Price>();
+    event.triggerPrice = reader.get<Price>();
+    event.expireTime = reader.get<long long>();
+    event.quantity = reader.get<int>();
+    event.symbolIndex = reader.get<std::uint16_t>();
+    event.side = reader.get<OrderSide>();
+    event.orderType = reader.get<OrderType>();
+    event.timeInForce = reader.get<TimeInForce>();
+    event.symbol = reader.getString();
+    event.userId = reader.getString();
+    event.clientOrderId = reader.getString();
+
+    offset += RECORD_PREFIX_SIZE + bodySize;
+    return true;
+}
+
+// SnapshotStore implementation
+bool SnapshotStore::writeFile(const std::string& path, const std::string& contents) {
+    std::string temporaryPath = path + ".tmp";
+    int fd = ::open(temporaryPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    bool written = writeFully(fd, contents.data(), contents.size()) && ::fsync(fd) == 0;
+    ::close(fd);
+    if (!written) {
+        std::remove(temporaryPath.c_str());
+        return false;
+    }
+    return std::rename(temporaryPath.c_str(), path.c_str()) == 0;
+}
+
+bool SnapshotStore::readFile(const std::string& path, std::string& contents) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    bool ok = ::fstat(fd, &info) == 0;
+    if (ok) {
+        contents.resize(static_cast<size_t>(info.st_size));
+        size_t offset = 0;
+        while (ok && offset < contents.size()) {
+            ssize_t bytes = ::read(fd, &contents[offset], contents.size() - offset);
+            if (bytes < 0 && errno == EINTR) {
+                continue;
+            }
+            ok = bytes > 0;
+            offset += ok ? static_cast<size_t>(bytes) : 0;
+        }
+    }
+    ::close(fd);
+    return ok;
+}
+
+} // namespace OrderMatchingEngine
\ No newline at end of file
@@ -0,0 +1,239 @@
+#ifndef EVENT_LOG_HPP
+#define EVENT_LOG_HPP
+
+#include "Order.hpp"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+namespace OrderMatchingEngine {
+
+/**
+ * @brief Kind of input event recorded in the write-ahead log
+ */
+enum class EventType : std::uint8_t {
+    SUBMIT = 1,
+    CANCEL,
+    MODIFY
+};
+
+/**
+ * @brief One accepted input event, in the order it was applied to the books
+ *
+ * Only inputs are logged; trades are a deterministic function of the inputs and
+ * are reproduced by replaying them against the snapshot they follow.
+ */
+struct SequencedEvent {
+    std::uint64_t sequence;         // Global position in the input stream
+    std::uint64_t previousSequence; // Sequence of the event before it in the same log (0 for the first)
+    EventType type;
+    long long timestamp;            // Order timestamp (SUBMIT) or receive time
+    OrderId orderId;                // Engine ID (0 for a SUBMIT the book numbers itself)
+    Price price;                    // Limit price, or new price for MODIFY
+    Price triggerPrice;
+    long long expireTime;           // SUBMIT only, GTD deadline
+    int quantity;                   // Quantity, or new quantity for MODIFY
+    std::uint16_t symbolIndex;
+    OrderSide side;
+    OrderType orderType;
+    TimeInForce timeInForce;        // SUBMIT only
+    std::string symbol;             // SUBMIT only
+    std::string userId;             // SUBMIT only
+    std::string clientOrderId;      // SUBMIT only, may be empty
+
+    SequencedEvent();
+
+    static SequencedEvent submit(const Order& order);
+    static SequencedEvent submit(const OrderEntry& entry, const std::string& symbol);
+    static SequencedEvent cancel(OrderId orderId, long long receiveTime);
+    static SequencedEvent modify(OrderId orderId, Price newPrice, int newQuantity, long long receiveTime);
+
+    /**
+     * @brief Rebuild the order of a SUBMIT event so it can be fed to OrderBook::addOrder
+     */
+    OrderPtr toOrder() const;
+};
+
+/**
+ * @brief Append-only, checksummed log of sequenced input events with group commit
+ *
+ * Events are encoded into an in-memory batch by append() and reach the disk
+ * on commit(): one write() and one fdatasync() for the whole batch, so the
+ * cost of durability is shared by every event in it. Callers apply events to
+ * the books only after the commit that covers them has returned.
+ *
+ * Not thread-safe: each matching thread writes its own log. Sequence numbers
+ * can still be global by sharing one counter between several logs.
+ */
+class WriteAheadLog {
+public:
+    /**
+     * @brief Receives every committed batch in the log's own record encoding
+     * Called by commit() on the writing thread once the batch is durable, so it must not block.
+     */
+    using CommitListener = std::function<void(const char* records, size_t size, std::uint64_t lastSequence)>;
+
+private:
+    int fileDescriptor;
+    std::string path;
+    off_t committedBytes;           // File size up to the end of the last commit
+    bool failed;                    // Sync lost or file left torn; nothing more can be committed
+    std::string pendingBatch;
+    size_t pendingEvents;
+    bool syncOnCommit;
+
+    std::atomic<std::uint64_t> ownSequence;
+    std::atomic<std::uint64_t>* sequenceSource;
+    std::uint64_t lastAppendedSequence;
+    std::uint64_t lastCommittedSequence;
+
+    long long commits;
+    long long eventsCommitted;
+    CommitListener commitListener;
+
+    void encode(const SequencedEvent& event);
+
+public:
+    /**
+     * @brief Constructor
+     * @param sequenceSource Counter shared with other logs for a global sequence
+     *                       (nullptr to number events locally)
+     * @param syncOnCommit fdatasync on every commit; turning it off leaves durability to the OS
+     */
+    explicit WriteAheadLog(std::atomic<std::uint64_t>* sequenceSource = nullptr,
+                           bool syncOnCommit = true);
+    ~WriteAheadLog();
+
+    WriteAheadLog(const WriteAheadLog&) = delete;
+    WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+
+    /**
+     * @brief Open (or create) the log for appending
+     * @param resumeAfter Highest sequence already used, from recovery; numbering continues after it
+     * @return False if the file could not be opened
+     */
+    bool open(const std::string& path, std::uint64_t resumeAfter = 0);
+    void close();
+
+    /**
+     * @brief Assign the next sequence number and add the event to the pending batch
+     * Also links the event to the one appended before it, so a reader can tell a
+     * hole in this log from numbers taken by logs sharing the sequence source.
+     * @return The assigned sequence number
+     */
+    std::uint64_t append(SequencedEvent& event);
+
+    /**
+     * @brief Add an event that already carries its sequence number and link, e.g. a standby's copy of its primary's log
+     * The sequence source is raised to it, so numbering continues after it once this log takes over.
+     */
+    void appendReplicated(const SequencedEvent& event);
+
+    /**
+     * @brief Ship every commit to a listener, e.g. a replication publisher (before the first append only)
+     */
+    void setCommitListener(CommitListener listener) { commitListener = std::move(listener); }
+
+    /**
+     * @brief Make every pending event durable
+     * A failed write is cut back to the previous commit and the batch kept for a
+     * retry. A failed fdatasync cannot be retried safely, so it fails the log for good.
+     * @return False if the batch is not durable; see hasFailed() for whether a retry can help
+     */
+    bool commit();
+
+    /**
+     * @brief Whether the log can no longer commit, after a failed sync or an unrepairable write
+     */
+    bool hasFailed() const { return failed; }
+
+    /**
+     * @brief Start a fresh log after a snapshot covers everything in the current one
+     */
+    bool truncate();
+
+    /**
+     * @brief Move the log to its previous-segment path and continue in a fresh file
+     * Lets snapshots be written in the background: events up to here stay in the
+     * previous segment until releasePreviousSegment() once the snapshots are durable.
+     * @return False, leaving a single file, if a previous segment still exists or
+     *         the new file could not be created
+     */
+    bool rotate();
+
+    /**
+     * @brief Delete the previous segment left by rotate() (any thread)
+     */
+    bool releasePreviousSegment() const;
+
+    /**
+     * @brief Where rotate() moves the log at path; recovery reads it before path
+     */
+    static std::string previousSegmentPath(const std::string& path) { return path + ".prev"; }
+
+    size_t getPendingEvents() const { return pendingEvents; }
+    std::uint64_t getLastCommittedSequence() const { return lastCommittedSequence; }
+    long long getCommitCount() const { return commits; }
+    long long getEventsCommitted() const { return eventsCommitted; }
+    const std::string& getPath() const { return path; }
+};
+
+/**
+ * @brief Sequential reader for write-ahead logs
+ * Stops at the first torn or corrupt record, which marks the end of the durable log.
+ * Can also decode a live stream of records: feed() appends bytes as they arrive and
+ * next() returns each record once it is complete.
+ */
+class EventLogReader {
+private:
+    std::string contents;
+    size_t offset;
+
+public:
+    EventLogReader();
+
+    /**
+     * @brief Load a log file
+     * @return False if the file does not exist
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Append raw record bytes (without the file header) to decode, dropping those already read
+     */
+    void feed(const char* data, size_t size);
+
+    /**
+     * @brief Bytes fed but not decoded yet: the start of an incomplete record
+     */
+    size_t getBufferedBytes() const { return contents.size() - offset; }
+
+    /**
+     * @brief Decode the next event
+     * @return False at the end of the durable log, or of the complete records fed so far
+     */
+    bool next(SequencedEvent& event);
+};
+
+/**
+ * @brief Durable whole-file storage for order book snapshots
+ */
+namespace SnapshotStore {
+    /**
+     * @brief Write a file via a temporary, fsync it and rename it into place
+     */
+    bool writeFile(const std::string& path, const std::string& contents);
+
+    /**
+     * @brief Read a whole file
+     * @return False if it does not exist or cannot be read
+     */
+    bool readFile(const std::string& path, std::string& contents);
+}
+
+} // namespace OrderMatchingEngine
+
+#endif // EVENT_LOG_HPP
\ No newline at end of file
@@ -0,0 +1,103 @@
+#include "TradeJournal.hpp"
+#include <iostream>
+#include <string>
+
+using namespace OrderMatchingEngine;
+
+/**
+ * @brief Offline renderer for binary trade journals
+ *
+ * Matching threads only write fixed-size records; turning them into text is
+ * done here, away from the trading path.
+ *
+ * Build:  g++ -std=c++17 -O2 -pthread JournalDump.cpp TradeJournal.cpp OrderBook.cpp Order.cpp OrderPool.cpp -o journal_dump
+ * Usage:  ./journal_dump <journal> [--format csv|json] [--ticks-per-unit N] [--trades-only]
+ */
+namespace {
+
+const char* recordTypeName(JournalRecordType type) {
+    switch (type) {
+        case JournalRecordType::TRADE: return "TRADE";
+        case JournalRecordType::ORDER_SUBMITTED: return "ORDER_SUBMITTED";
+        case JournalRecordType::ORDER_CANCELLED: return "ORDER_CANCELLED";
+        case JournalRecordType::ORDER_MODIFIED: return "ORDER_MODIFIED";
+        case JournalRecordType::ORDER_FILLED: return "ORDER_FILLED";
+        case JournalRecordType::ORDER_REJECTED: return "ORDER_REJECTED";
+    }
+    return "UNKNOWN";
+}
+
+const char* sideName(const JournalRecord& record) {
+    if (record.type == JournalRecordType::TRADE) {
+        return "";
+    }
+    return record.side == OrderSide::BUY ? "BUY" : "SELL";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0]
+                  << " <journal> [--format csv|json] [--ticks-per-unit N] [--trades-only]\n";
+        return 1;
+    }
+
+    std::string path = argv[1];
+    std::string format = "csv";
+    PriceScale scale;
+    bool tradesOnly = false;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--format" && i + 1 < argc) {
+            format = argv[++i];
+        } else if (arg == "--ticks-per-unit" && i + 1 < argc) {
+            scale = PriceScale(std::stoll(argv[++i]));
+        } else if (arg == "--trades-only") {
+            tradesOnly = true;
+        } else {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    JournalReader reader;
+    try {
+        reader.open(path);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    if (format == "csv") {
+        std::cout << "type,timestamp,id,symbol_index,buy_order_id,sell_order_id,side,price,aux_price,quantity,producer\n";
+    }
+
+    JournalRecord record;
+    while (reader.next(record)) {
+        if (tradesOnly && record.type != JournalRecordType::TRADE) {
+            continue;
+        }
+        if (format == "json") {
+            std::cout << "{\"type\":\"" << recordTypeName(record.type) << "\""
+                      << ",\"timestamp\":" << record.timestamp
+                      << ",\"id\":" << record.id
+                      << ",\"symbol_index\":" << record.symbolIndex
+                      << ",\"buy_order_id\":" << record.buyOrderId
+                      << ",\"sell_order_id\":" << record.sellOrderId
+                      << ",\"side\":\"" << sideName(record) << "\""
+                      << ",\"price\":" << scale.toDouble(record.price)
+                      << ",\"aux_price\":" << scale.toDouble(record.auxPrice)
+                      << ",\"quantity\":" << record.quantity
+                      << ",\"producer\":" << record.producer << "}\n";
+        } else {
+            std::cout << recordTypeName(record.type) << "," << record.timestamp << ","
+                      << record.id << "," << record.symbolIndex << ","
+                      << record.buyOrderId << "," << record.sellOrderId << ","
+                      << sideName(record) << "," << scale.toDouble(record.price) << ","
+                      << scale.toDouble(record.auxPrice) << "," << record.quantity << ","
+                      << record.producer << "\n";
+        }
+    }
+    return 0;
+}
\ No newline at end of file
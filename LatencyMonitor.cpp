@@ -0,0 +1,268 @@
+#include "LatencyMonitor.hpp"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+namespace OrderMatchingEngine {
+
+namespace {
+
+const double CALIBRATION_MILLIS = 10.0;
+const double SUMMARY_PERCENTILES[] = {50.0, 90.0, 99.0, 99.9, 99.99};
+
+std::atomic<std::uint64_t> nextMonitorId(1);
+
+double measureNanosPerCycle() {
+#if defined(__x86_64__) || defined(__i386__)
+    auto startTime = std::chrono::steady_clock::now();
+    std::uint64_t startCycles = CycleClock::now();
+    std::chrono::duration<double, std::nano> elapsed(0);
+    while (elapsed.count() < CALIBRATION_MILLIS * 1e6) {
+        elapsed = std::chrono::steady_clock::now() - startTime;
+    }
+    std::uint64_t cycles = CycleClock::now() - startCycles;
+    return cycles > 0 ? elapsed.count() / static_cast<double>(cycles) : 1.0;
+#else
+    return 1.0;     // now() already counts nanoseconds
+#endif
+}
+
+LatencySummary summarize(LatencyStage stage, const LatencyHistogram& histogram, double nanosPerCycle) {
+    auto toNanos = [nanosPerCycle](std::uint64_t cycles) { return static_cast<double>(cycles) * nanosPerCycle; };
+    LatencySummary summary;
+    summary.stage = stage;
+    summary.count = histogram.getCount();
+    summary.meanNanos = histogram.getMean() * nanosPerCycle;
+    summary.minNanos = toNanos(histogram.getMin());
+    summary.p50Nanos = toNanos(histogram.getValueAtPercentile(50.0));
+    summary.p90Nanos = toNanos(histogram.getValueAtPercentile(90.0));
+    summary.p99Nanos = toNanos(histogram.getValueAtPercentile(99.0));
+    summary.p999Nanos = toNanos(histogram.getValueAtPercentile(99.9));
+    summary.p9999Nanos = toNanos(histogram.getValueAtPercentile(99.99));
+    summary.maxNanos = toNanos(histogram.getMax());
+    return summary;
+}
+
+} // namespace
+
+double CycleClock::getNanosPerCycle() {
+    static const double nanosPerCycle = measureNanosPerCycle();
+    return nanosPerCycle;
+}
+
+const char* toString(LatencyStage stage) {
+    switch (stage) {
+        case LatencyStage::QUEUE_WAIT: return "queue_wait";
+        case LatencyStage::VALIDATION: return "validation";
+        case LatencyStage::MATCH: return "match";
+        case LatencyStage::JOURNAL: return "journal";
+        case LatencyStage::MARKET_DATA: return "market_data";
+        case LatencyStage::END_TO_END: return "end_to_end";
+        default: return "unknown";
+    }
+}
+
+// LatencyHistogram implementation
+LatencyHistogram::LatencyHistogram()
+    : counts(BUCKET_COUNT, 0), totalCount(0), totalValue(0), minValue(~std::uint64_t(0)), maxValue(0) {
+}
+
+std::uint64_t LatencyHistogram::bucketHighestValue(size_t index) {
+    size_t shift = index < 2 * HALF_SUB_BUCKETS ? 0 : index / HALF_SUB_BUCKETS - 1;
+    std::uint64_t subBucket = index - shift * HALF_SUB_BUCKETS;
+    return ((subBucket + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(std::uint64_t value, std::uint64_t count) {
+    counts[bucketIndex(value)] += count;
+    totalCount += count;
+    totalValue += value * count;
+    minValue = std::min(minValue, value);
+    maxValue = std::max(maxValue, value);
+}
+
+void LatencyHistogram::addCounts(const std::uint64_t* bucketCounts, std::uint64_t sum, std::uint64_t min,
+                                 std::uint64_t max) {
+    std::uint64_t added = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        counts[i] += bucketCounts[i];
+        added += bucketCounts[i];
+    }
+    if (added == 0) {
+        return;
+    }
+    totalCount += added;
+    totalValue += sum;
+    minValue = std::min(minValue, min);
+    maxValue = std::max(maxValue, max);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    addCounts(other.counts.data(), other.totalValue, other.minValue, other.maxValue);
+}
+
+void LatencyHistogram::reset() {
+    std::fill(counts.begin(), counts.end(), 0);
+    totalCount = 0;
+    totalValue = 0;
+    minValue = ~std::uint64_t(0);
+    maxValue = 0;
+}
+
+std::uint64_t LatencyHistogram::getValueAtPercentile(double percentile) const {
+    if (totalCount == 0) {
+        return 0;
+    }
+    double clamped = std::min(100.0, std::max(0.0, percentile));
+    std::uint64_t target = std::max<std::uint64_t>(
+        1, static_cast<std::uint64_t>(std::ceil(clamped / 100.0 * static_cast<double>(totalCount))));
+
+    std::uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        seen += counts[i];
+        if (seen >= target) {
+            // Exact extremes beat bucket bounds at either end
+            return std::max(minValue, std::min(maxValue, bucketHighestValue(i)));
+        }
+    }
+    return maxValue;
+}
+
+// ThreadLatencyRecorder implementation
+ThreadLatencyRecorder::ThreadLatencyRecorder(const std::string& name, std::thread::id owner)
+    : name(name), owner(owner), stages(new StageCounters[LATENCY_STAGE_COUNT]()) {
+    reset();
+}
+
+void ThreadLatencyRecorder::addTo(LatencyStage stage, LatencyHistogram& histogram) const {
+    const StageCounters& counters = stages[static_cast<size_t>(stage)];
+    std::vector<std::uint64_t> snapshot(LatencyHistogram::BUCKET_COUNT);
+    for (size_t i = 0; i < snapshot.size(); ++i) {
+        snapshot[i] = counters.counts[i].load(std::memory_order_relaxed);
+    }
+    histogram.addCounts(snapshot.data(), counters.totalValue.load(std::memory_order_relaxed),
+                        counters.minValue.load(std::memory_order_relaxed),
+                        counters.maxValue.load(std::memory_order_relaxed));
+}
+
+void ThreadLatencyRecorder::reset() {
+    for (size_t stage = 0; stage < LATENCY_STAGE_COUNT; ++stage) {
+        StageCounters& counters = stages[stage];
+        for (auto& count : counters.counts) {
+            count.store(0, std::memory_order_relaxed);
+        }
+        counters.totalValue.store(0, std::memory_order_relaxed);
+        counters.minValue.store(~std::uint64_t(0), std::memory_order_relaxed);
+        counters.maxValue.store(0, std::memory_order_relaxed);
+    }
+}
+
+// LatencyMonitor implementation
+LatencyMonitor::LatencyMonitor() : instanceId(nextMonitorId.fetch_add(1, std::memory_order_relaxed)) {
+}
+
+ThreadLatencyRecorder* LatencyMonitor::registerThread(const std::string& name, std::thread::id owner) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    recorders.push_back(std::make_unique<ThreadLatencyRecorder>(name, owner));
+    return recorders.back().get();
+}
+
+ThreadLatencyRecorder& LatencyMonitor::forCurrentThread() {
+    struct CachedRecorder {
+        std::uint64_t monitorId;
+        ThreadLatencyRecorder* recorder;
+    };
+    thread_local CachedRecorder cached{0, nullptr};
+    if (cached.monitorId == instanceId) {
+        return *cached.recorder;
+    }
+
+    // A thread that alternates between monitors finds its recorder again instead of adding one
+    std::thread::id self = std::this_thread::get_id();
+    ThreadLatencyRecorder* recorder = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (const auto& candidate : recorders) {
+            if (candidate->getOwner() == self) {
+                recorder = candidate.get();
+                break;
+            }
+        }
+    }
+    if (!recorder) {
+        std::ostringstream name;
+        name << "thread-" << self;
+        recorder = registerThread(name.str(), self);
+    }
+    cached = CachedRecorder{instanceId, recorder};
+    return *recorder;
+}
+
+LatencyHistogram LatencyMonitor::collect(LatencyStage stage) const {
+    LatencyHistogram histogram;
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (const auto& recorder : recorders) {
+        recorder->addTo(stage, histogram);
+    }
+    return histogram;
+}
+
+std::vector<LatencySummary> LatencyMonitor::getSummaries() const {
+    double nanosPerCycle = CycleClock::getNanosPerCycle();
+    std::vector<LatencySummary> summaries;
+    for (size_t stage = 0; stage < LATENCY_STAGE_COUNT; ++stage) {
+        LatencyHistogram histogram = collect(static_cast<LatencyStage>(stage));
+        if (histogram.getCount() > 0) {
+            summaries.push_back(summarize(static_cast<LatencyStage>(stage), histogram, nanosPerCycle));
+        }
+    }
+    return summaries;
+}
+
+std::string LatencyMonitor::toPrometheusText(const std::string& prefix) const {
+    double nanosPerCycle = CycleClock::getNanosPerCycle();
+    std::string metric = prefix + "_stage_latency_nanoseconds";
+    std::ostringstream text;
+    text << "# HELP " << metric << " Latency of each stage of the order path\n";
+    text << "# TYPE " << metric << " summary\n";
+
+    std::vector<LatencyHistogram> histograms;
+    histograms.reserve(LATENCY_STAGE_COUNT);
+    for (size_t stage = 0; stage < LATENCY_STAGE_COUNT; ++stage) {
+        histograms.push_back(collect(static_cast<LatencyStage>(stage)));
+        const LatencyHistogram& histogram = histograms.back();
+        const char* name = toString(static_cast<LatencyStage>(stage));
+        for (double percentile : SUMMARY_PERCENTILES) {
+            text << metric << "{stage=\"" << name << "\",quantile=\"" << percentile / 100.0 << "\"} "
+                 << static_cast<std::uint64_t>(static_cast<double>(histogram.getValueAtPercentile(percentile)) *
+                                               nanosPerCycle) << "\n";
+        }
+        text << metric << "_sum{stage=\"" << name << "\"} "
+             << static_cast<std::uint64_t>(histogram.getMean() * static_cast<double>(histogram.getCount()) *
+                                           nanosPerCycle) << "\n";
+        text << metric << "_count{stage=\"" << name << "\"} " << histogram.getCount() << "\n";
+    }
+
+    std::string maxMetric = prefix + "_stage_latency_max_nanoseconds";
+    text << "# HELP " << maxMetric << " Largest latency of each stage since the last reset\n";
+    text << "# TYPE " << maxMetric << " gauge\n";
+    for (size_t stage = 0; stage < LATENCY_STAGE_COUNT; ++stage) {
+        text << maxMetric << "{stage=\"" << toString(static_cast<LatencyStage>(stage)) << "\"} "
+             << static_cast<std::uint64_t>(static_cast<double>(histograms[stage].getMax()) * nanosPerCycle) << "\n";
+    }
+    return text.str();
+}
+
+void LatencyMonitor::reset() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (const auto& recorder : recorders) {
+        recorder->reset();
+    }
+}
+
+size_t LatencyMonitor::getThreadCount() const {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    return recorders.size();
+}
+
+} // namespace OrderMatchingEngine
\ No newline at end of file
@@ -0,0 +1,284 @@
+#ifndef LATENCY_MONITOR_HPP
+#define LATENCY_MONITOR_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace OrderMatchingEngine {
+
+/**
+ * @brief Cheapest available timestamp, in cycles
+ *
+ * On x86 this is the time stamp counter (a few nanoseconds per read, no system
+ * call); elsewhere it falls back to steady_clock nanoseconds. Stamps taken on
+ * different cores are only comparable on CPUs with an invariant, synchronized
+ * TSC, which is every x86 server part of the last decade. Convert to time with
+ * getNanosPerCycle(), off the hot path.
+ */
+namespace CycleClock {
+
+inline std::uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+/**
+ * @brief Length of one cycle in nanoseconds, measured against steady_clock on first call
+ * The first call spins for a few milliseconds.
+ */
+double getNanosPerCycle();
+
+} // namespace CycleClock
+
+/**
+ * @brief Points of an order's path through the engine that are timed
+ */
+enum class LatencyStage : std::uint8_t {
+    QUEUE_WAIT,     // Ingress enqueue to dequeue by the matching thread
+    VALIDATION,     // Decoding and validating one request, risk checks included
+    MATCH,          // Applying one command to its book
+    JOURNAL,        // Appending and committing one command batch to the event log
+    MARKET_DATA,    // Publishing one command batch's trades and book deltas
+    END_TO_END,     // Ingress enqueue to the command applied, journal included
+    COUNT
+};
+
+constexpr size_t LATENCY_STAGE_COUNT = static_cast<size_t>(LatencyStage::COUNT);
+
+/**
+ * @brief Lower-case stage name, as used in metric labels
+ */
+const char* toString(LatencyStage stage);
+
+/**
+ * @brief Log-linear histogram of latencies in the style of HdrHistogram
+ *
+ * Every power of two is split into 64 buckets, so any recorded value is
+ * reported within 1/64 (1.6%) of itself from 128 up to 2^44. Recording is an
+ * index computation and an increment; memory is fixed at BUCKET_COUNT
+ * counters whatever the number of samples. Not thread-safe: this is the
+ * merged, read-side form of the per-thread recorders.
+ */
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BUCKET_BITS = 7;
+    static constexpr int MAX_VALUE_BITS = 44;
+    static constexpr size_t HALF_SUB_BUCKETS = size_t(1) << (SUB_BUCKET_BITS - 1);
+    static constexpr size_t BUCKET_COUNT = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 2) * HALF_SUB_BUCKETS;
+    static constexpr std::uint64_t MAX_VALUE = (std::uint64_t(1) << MAX_VALUE_BITS) - 1;
+
+    /**
+     * @brief Bucket of a value; values above MAX_VALUE land in the last bucket
+     */
+    static size_t bucketIndex(std::uint64_t value) {
+        value = value < MAX_VALUE ? value : MAX_VALUE;
+        int magnitude = 63 - __builtin_clzll(value | 1);
+        int shift = magnitude > SUB_BUCKET_BITS - 1 ? magnitude - (SUB_BUCKET_BITS - 1) : 0;
+        return static_cast<size_t>(shift) * HALF_SUB_BUCKETS + static_cast<size_t>(value >> shift);
+    }
+
+    /**
+     * @brief Largest value that falls into a bucket
+     */
+    static std::uint64_t bucketHighestValue(size_t index);
+
+private:
+    std::vector<std::uint64_t> counts;
+    std::uint64_t totalCount;
+    std::uint64_t totalValue;
+    std::uint64_t minValue;
+    std::uint64_t maxValue;
+
+public:
+    LatencyHistogram();
+
+    void record(std::uint64_t value, std::uint64_t count = 1);
+
+    /**
+     * @brief Add bucket counts gathered elsewhere (a recorder's, or another histogram's)
+     * min and max are taken as given, so exact extremes survive the merge.
+     */
+    void addCounts(const std::uint64_t* bucketCounts, std::uint64_t sum, std::uint64_t min, std::uint64_t max);
+    void merge(const LatencyHistogram& other);
+    void reset();
+
+    /**
+     * @brief Smallest value that at least percentile% of the samples do not exceed
+     * Reported as the top of its bucket, so tails are never understated. 0 when empty.
+     */
+    std::uint64_t getValueAtPercentile(double percentile) const;
+
+    std::uint64_t getCount() const { return totalCount; }
+    std::uint64_t getMin() const { return totalCount > 0 ? minValue : 0; }
+    std::uint64_t getMax() const { return maxValue; }
+    double getMean() const {
+        return totalCount > 0 ? static_cast<double>(totalValue) / static_cast<double>(totalCount) : 0.0;
+    }
+};
+
+/**
+ * @brief One thread's histograms, one per stage, in cycles
+ *
+ * Only the owning thread records, with relaxed single-writer increments (no
+ * locked instructions); any thread may read the counters at any time to merge
+ * them. A read racing a record may see the sample in its bucket but not yet in
+ * the sum, which is harmless at the precision of a scrape.
+ */
+class ThreadLatencyRecorder {
+private:
+    struct StageCounters {
+        std::atomic<std::uint64_t> counts[LatencyHistogram::BUCKET_COUNT];
+        std::atomic<std::uint64_t> totalValue;
+        std::atomic<std::uint64_t> minValue;
+        std::atomic<std::uint64_t> maxValue;
+    };
+
+    static void increment(std::atomic<std::uint64_t>& counter, std::uint64_t amount) {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    std::string name;
+    std::thread::id owner;
+    std::unique_ptr<StageCounters[]> stages;
+
+public:
+    ThreadLatencyRecorder(const std::string& name, std::thread::id owner);
+
+    /**
+     * @brief Record one sample of a stage, in cycles (owning thread only)
+     */
+    void record(LatencyStage stage, std::uint64_t cycles) {
+        StageCounters& counters = stages[static_cast<size_t>(stage)];
+        increment(counters.counts[LatencyHistogram::bucketIndex(cycles)], 1);
+        increment(counters.totalValue, cycles);
+        if (cycles < counters.minValue.load(std::memory_order_relaxed)) {
+            counters.minValue.store(cycles, std::memory_order_relaxed);
+        }
+        if (cycles > counters.maxValue.load(std::memory_order_relaxed)) {
+            counters.maxValue.store(cycles, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Record the time since startCycles and return the current stamp, to chain stages
+     */
+    std::uint64_t recordSince(LatencyStage stage, std::uint64_t startCycles) {
+        std::uint64_t now = CycleClock::now();
+        recordBetween(stage, startCycles, now);
+        return now;
+    }
+
+    /**
+     * @brief Record endCycles - startCycles; stamps from another core that read ahead count as 0
+     */
+    void recordBetween(LatencyStage stage, std::uint64_t startCycles, std::uint64_t endCycles) {
+        record(stage, endCycles > startCycles ? endCycles - startCycles : 0);
+    }
+
+    /**
+     * @brief Add this thread's samples of a stage to a histogram (any thread)
+     */
+    void addTo(LatencyStage stage, LatencyHistogram& histogram) const;
+
+    /**
+     * @brief Clear every stage; samples recorded concurrently may be lost
+     */
+    void reset();
+
+    const std::string& getName() const { return name; }
+    std::thread::id getOwner() const { return owner; }
+};
+
+/**
+ * @brief Latency percentiles of one stage across all threads, in nanoseconds
+ */
+struct LatencySummary {
+    LatencyStage stage;
+    std::uint64_t count;
+    double meanNanos;
+    double minNanos;
+    double p50Nanos;
+    double p90Nanos;
+    double p99Nanos;
+    double p999Nanos;
+    double p9999Nanos;
+    double maxNanos;
+};
+
+/**
+ * @brief Registry of per-thread latency recorders, merged on demand
+ *
+ * Each instrumented thread gets its own ThreadLatencyRecorder, so the hot
+ * paths never share a counter. Readers merge all recorders of a stage into a
+ * LatencyHistogram when they ask for it: scraping costs the reader a pass
+ * over the buckets and costs the recording threads nothing.
+ */
+class LatencyMonitor {
+private:
+    const std::uint64_t instanceId;     // Tells thread-local caches apart across monitors
+    mutable std::mutex registryMutex;
+    std::vector<std::unique_ptr<ThreadLatencyRecorder>> recorders;  // Never removed, so pointers stay valid
+
+public:
+    LatencyMonitor();
+    LatencyMonitor(const LatencyMonitor&) = delete;
+    LatencyMonitor& operator=(const LatencyMonitor&) = delete;
+
+    /**
+     * @brief Create the recorder one thread will write
+     * Call before the thread starts, or from it.
+     * @param owner Thread that will record, which forCurrentThread() finds it by
+     *              (defaults to the caller; a default-constructed id for none)
+     */
+    ThreadLatencyRecorder* registerThread(const std::string& name,
+                                          std::thread::id owner = std::this_thread::get_id());
+
+    /**
+     * @brief Recorder of the calling thread, registered on first use
+     * For threads the engine does not own; after the first call per thread it
+     * costs a thread-local lookup.
+     */
+    ThreadLatencyRecorder& forCurrentThread();
+
+    /**
+     * @brief Histogram of one stage merged over every thread, in cycles
+     */
+    LatencyHistogram collect(LatencyStage stage) const;
+
+    /**
+     * @brief Percentiles of every stage that has samples, in stage order
+     */
+    std::vector<LatencySummary> getSummaries() const;
+
+    /**
+     * @brief Every stage as a Prometheus summary, in the text exposition format
+     * @param prefix Metric name prefix
+     */
+    std::string toPrometheusText(const std::string& prefix = "order_engine") const;
+
+    /**
+     * @brief Clear every recorder; samples recorded concurrently may be lost
+     */
+    void reset();
+
+    size_t getThreadCount() const;
+};
+
+} // namespace OrderMatchingEngine
+
+#endif // LATENCY_MONITOR_HPP
\ No newline at end of file
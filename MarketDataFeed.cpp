@@ -0,0 +1,307 @@
+#include "MarketDataFeed.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace OrderMatchingEngine {
+
+namespace {
+
+long long currentTimestamp() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+const DepthLevel* findLevel(const DepthLevel* levels, int count, Price price) {
+    for (int i = 0; i < count; ++i) {
+        if (levels[i].price == price) {
+            return &levels[i];
+        }
+    }
+    return nullptr;
+}
+
+bool quoteChanged(const MarketDataSnapshot& before, const MarketDataSnapshot& after) {
+    auto topQuantity = [](const DepthLevel* levels, int count) { return count > 0 ? levels[0].quantity : 0; };
+    return before.bestBid != after.bestBid || before.bestAsk != after.bestAsk ||
+           topQuantity(before.bids, before.bidLevelCount) != topQuantity(after.bids, after.bidLevelCount) ||
+           topQuantity(before.asks, before.askLevelCount) != topQuantity(after.asks, after.askLevelCount);
+}
+
+void fillQuote(FeedMessage& message, const MarketDataSnapshot& book) {
+    message.price = book.bestBid;
+    message.quantity = book.bidLevelCount > 0 ? book.bids[0].quantity : 0;
+    message.auxPrice = book.bestAsk;
+    message.auxQuantity = book.askLevelCount > 0 ? book.asks[0].quantity : 0;
+}
+
+/**
+ * @brief Key under which a subscriber conflates a message, or 0 if it is always delivered
+ */
+std::uint64_t conflationKey(const FeedMessage& message) {
+    const std::uint64_t priceMask = (std::uint64_t(1) << 43) - 1;
+    switch (message.type) {
+        case FeedMessageType::LEVEL_UPDATE:
+            return (std::uint64_t(1) << 60) | (std::uint64_t(message.symbolIndex) << 44) |
+                   (std::uint64_t(message.side == OrderSide::SELL) << 43) |
+                   (static_cast<std::uint64_t>(message.price) & priceMask);
+        case FeedMessageType::QUOTE:
+            return (std::uint64_t(2) << 60) | (std::uint64_t(message.symbolIndex) << 44);
+        default:
+            return 0;
+    }
+}
+
+} // namespace
+
+// MarketDataFeed implementation
+MarketDataFeed::MarketDataFeed(size_t capacity)
+    : ring(capacity), messagesPublished(0), batchesPublished(0) {
+}
+
+void MarketDataFeed::addBook(const OrderBook& book) {
+    std::uint16_t symbolIndex = book.getSymbolIndex();
+    if (symbols.size() <= symbolIndex) {
+        symbols.resize(static_cast<size_t>(symbolIndex) + 1);
+    }
+    auto state = std::make_unique<SymbolState>();
+    state->symbolIndex = symbolIndex;
+    state->previous = book.getMarketData();
+    state->published.store(BookState{ring.getWrittenSequence(), state->previous});
+    state->touched = false;
+    symbols[symbolIndex] = std::move(state);
+}
+
+MarketDataFeed::SymbolState* MarketDataFeed::findState(std::uint16_t symbolIndex) const {
+    return symbolIndex < symbols.size() ? symbols[symbolIndex].get() : nullptr;
+}
+
+FeedMessage& MarketDataFeed::appendMessage(FeedMessageType type, std::uint16_t symbolIndex,
+                                           long long timestamp) {
+    pending.emplace_back();
+    FeedMessage& message = pending.back();
+    std::memset(&message, 0, sizeof(message));
+    message.sequence = ring.getWrittenSequence() + pending.size();
+    message.timestamp = timestamp;
+    message.symbolIndex = symbolIndex;
+    message.type = type;
+    return message;
+}
+
+template<typename Execution>
+void MarketDataFeed::appendTrades(const std::vector<Execution>& executions) {
+    // Trade and Fill carry the same fields; the print never needs the symbol string
+    for (const Execution& trade : executions) {
+        std::uint16_t symbolIndex = getSymbolIndex(trade.tradeId);
+        SymbolState* state = findState(symbolIndex);
+        if (!state) {
+            continue;
+        }
+        FeedMessage& message = appendMessage(FeedMessageType::TRADE, symbolIndex, trade.timestamp);
+        message.id = trade.tradeId;
+        message.price = trade.price;
+        message.quantity = trade.quantity;
+        state->touched = true;
+    }
+}
+
+void MarketDataFeed::publishTrades(const std::vector<Trade>& trades) {
+    appendTrades(trades);
+}
+
+void MarketDataFeed::publishTrades(const std::vector<Fill>& fills) {
+    appendTrades(fills);
+}
+
+void MarketDataFeed::diffSide(SymbolState& state, const DepthLevel* before, int beforeCount,
+                              const DepthLevel* after, int afterCount, OrderSide side, long long timestamp) {
+    // At most MAX_DEPTH levels a side, so a nested scan beats anything cleverer
+    for (int i = 0; i < beforeCount; ++i) {
+        if (!findLevel(after, afterCount, before[i].price)) {
+            FeedMessage& message = appendMessage(FeedMessageType::LEVEL_UPDATE, state.symbolIndex, timestamp);
+            message.side = side;
+            message.price = before[i].price;
+        }
+    }
+    for (int i = 0; i < afterCount; ++i) {
+        const DepthLevel* old = findLevel(before, beforeCount, after[i].price);
+        if (!old || old->quantity != after[i].quantity || old->orderCount != after[i].orderCount) {
+            FeedMessage& message = appendMessage(FeedMessageType::LEVEL_UPDATE, state.symbolIndex, timestamp);
+            message.side = side;
+            message.price = after[i].price;
+            message.quantity = after[i].quantity;
+            message.orderCount = after[i].orderCount;
+        }
+    }
+}
+
+void MarketDataFeed::publishBook(const OrderBook& book) {
+    SymbolState* state = findState(book.getSymbolIndex());
+    if (!state) {
+        return;
+    }
+    MarketDataSnapshot current = book.getMarketData();
+    if (current.version == state->previous.version) {
+        return;
+    }
+
+    long long timestamp = currentTimestamp();
+    const MarketDataSnapshot& previous = state->previous;
+    diffSide(*state, previous.bids, previous.bidLevelCount, current.bids, current.bidLevelCount,
+             OrderSide::BUY, timestamp);
+    diffSide(*state, previous.asks, previous.askLevelCount, current.asks, current.askLevelCount,
+             OrderSide::SELL, timestamp);
+    if (quoteChanged(previous, current)) {
+        fillQuote(appendMessage(FeedMessageType::QUOTE, state->symbolIndex, timestamp), current);
+    }
+
+    state->previous = current;
+    state->touched = true;
+}
+
+void MarketDataFeed::endBatch() {
+    if (pending.empty()) {
+        return;
+    }
+    pending.back().flags |= FEED_FLAG_END_OF_BATCH;
+    for (const auto& message : pending) {
+        ring.write(message);
+    }
+
+    // Snapshots must be current before the batch becomes visible, so a subscriber
+    // that joins at the new head never misses a delta its snapshot lacks
+    std::uint64_t lastSequence = ring.getWrittenSequence();
+    for (const auto& state : symbols) {
+        if (state && state->touched) {
+            state->published.store(BookState{lastSequence, state->previous});
+            state->touched = false;
+        }
+    }
+    ring.publish();
+
+    messagesPublished += static_cast<long long>(pending.size());
+    batchesPublished++;
+    pending.clear();
+}
+
+void MarketDataFeed::collectSnapshot(std::vector<FeedMessage>& messages) const {
+    for (const auto& state : symbols) {
+        if (!state) {
+            continue;
+        }
+        BookState bookState = state->published.load();
+        const MarketDataSnapshot& book = bookState.book;
+
+        FeedMessage message;
+        std::memset(&message, 0, sizeof(message));
+        message.sequence = bookState.sequence;
+        message.timestamp = currentTimestamp();
+        message.symbolIndex = state->symbolIndex;
+        message.flags = FEED_FLAG_SNAPSHOT;
+
+        message.type = FeedMessageType::BOOK_RESET;
+        messages.push_back(message);
+
+        message.type = FeedMessageType::LEVEL_UPDATE;
+        for (int side = 0; side < 2; ++side) {
+            const DepthLevel* levels = side == 0 ? book.bids : book.asks;
+            int count = side == 0 ? book.bidLevelCount : book.askLevelCount;
+            message.side = side == 0 ? OrderSide::BUY : OrderSide::SELL;
+            for (int i = 0; i < count; ++i) {
+                message.price = levels[i].price;
+                message.quantity = levels[i].quantity;
+                message.orderCount = levels[i].orderCount;
+                messages.push_back(message);
+            }
+        }
+
+        message.type = FeedMessageType::QUOTE;
+        message.side = OrderSide::BUY;
+        message.orderCount = 0;
+        fillQuote(message, book);
+        messages.push_back(message);
+    }
+    if (!messages.empty()) {
+        messages.back().flags |= FEED_FLAG_END_OF_BATCH;
+    }
+}
+
+// FeedSubscriber implementation
+FeedSubscriber::FeedSubscriber(const MarketDataFeed& feed, bool conflate)
+    : feed(feed), cursor(1), needsSnapshot(true), conflate(conflate), gaps(0), messagesReceived(0) {
+}
+
+void FeedSubscriber::fill(size_t maxMessages) {
+    buffer.clear();
+    bool resynchronized = false;
+
+    while (buffer.size() < maxMessages) {
+        if (needsSnapshot) {
+            // Read the head first: every delta up to it is already in the snapshots
+            std::uint64_t head = feed.getPublishedSequence();
+            size_t first = buffer.size();
+            feed.collectSnapshot(buffer);
+            for (size_t i = first; i < buffer.size(); ++i) {
+                if (buffer[i].type == FeedMessageType::BOOK_RESET) {
+                    if (snapshotSequence.size() <= buffer[i].symbolIndex) {
+                        snapshotSequence.resize(static_cast<size_t>(buffer[i].symbolIndex) + 1, 0);
+                    }
+                    snapshotSequence[buffer[i].symbolIndex] = buffer[i].sequence;
+                }
+            }
+            cursor = head + 1;
+            needsSnapshot = false;
+            resynchronized = true;
+        }
+
+        FeedMessage message;
+        auto result = feed.read(cursor, message);
+        if (result == BroadcastRing<FeedMessage>::ReadResult::NOT_READY) {
+            break;
+        }
+        if (result == BroadcastRing<FeedMessage>::ReadResult::OVERRUN) {
+            gaps++;
+            needsSnapshot = true;
+            continue;
+        }
+        cursor++;
+        if (message.symbolIndex < snapshotSequence.size() &&
+            message.sequence <= snapshotSequence[message.symbolIndex]) {
+            continue; // Already reflected in the snapshot this subscriber started from
+        }
+        buffer.push_back(message);
+    }
+
+    // A resync resets books mid-buffer; conflating across it would reorder resets and levels
+    if (conflate && !resynchronized) {
+        conflateBuffer();
+    }
+}
+
+void FeedSubscriber::conflateBuffer() {
+    if (buffer.size() < 2) {
+        return;
+    }
+    bool endOfBatch = (buffer.back().flags & FEED_FLAG_END_OF_BATCH) != 0;
+
+    // Walk backwards keeping the newest message per key, then restore arrival order
+    seenKeys.clear();
+    size_t kept = buffer.size();
+    for (size_t i = buffer.size(); i-- > 0;) {
+        std::uint64_t key = conflationKey(buffer[i]);
+        if (key != 0 && !seenKeys.insert(key).second) {
+            continue;
+        }
+        buffer[--kept] = buffer[i];
+    }
+    buffer.erase(buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(kept));
+
+    for (auto& message : buffer) {
+        message.flags &= static_cast<std::uint8_t>(~FEED_FLAG_END_OF_BATCH);
+    }
+    if (endOfBatch) {
+        buffer.back().flags |= FEED_FLAG_END_OF_BATCH;
+    }
+}
+
+} // namespace OrderMatchingEngine
\ No newline at end of file
@@ -0,0 +1,196 @@
+#ifndef MARKET_DATA_FEED_HPP
+#define MARKET_DATA_FEED_HPP
+
+#include "OrderBook.hpp"
+#include "RingBuffer.hpp"
+#include "SeqLock.hpp"
+#include <cstdint>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+namespace OrderMatchingEngine {
+
+/**
+ * @brief Kind of message carried by the market data feed
+ */
+enum class FeedMessageType : std::uint8_t {
+    LEVEL_UPDATE = 1,   // L2: new aggregate of one price level within the published depth
+    TRADE,              // Trade print
+    QUOTE,              // L1: best bid and ask changed
+    BOOK_RESET          // Drop the symbol's book; snapshot levels follow
+};
+
+const std::uint8_t FEED_FLAG_END_OF_BATCH = 0x01;  // Last message of a match cycle
+const std::uint8_t FEED_FLAG_SNAPSHOT = 0x02;      // Synthesized from a snapshot, not a live delta
+
+/**
+ * @brief Fixed-size binary feed message
+ *
+ * Field use by type:
+ * - LEVEL_UPDATE: side, price, quantity (0 removes the level), orderCount
+ * - TRADE: id = trade ID, price, quantity
+ * - QUOTE: price/quantity = best bid, auxPrice/auxQuantity = best ask (0 when empty)
+ * Prices are ticks of the symbol's PriceScale.
+ */
+struct FeedMessage {
+    std::uint64_t sequence;         // Feed sequence; snapshot messages carry the snapshot's
+    long long timestamp;            // Microseconds since epoch
+    std::uint64_t id;
+    Price price;
+    Price auxPrice;
+    std::int32_t quantity;
+    std::int32_t auxQuantity;
+    std::int32_t orderCount;
+    std::uint16_t symbolIndex;
+    FeedMessageType type;
+    OrderSide side;
+    std::uint8_t flags;
+    std::uint8_t reserved[7];
+};
+
+static_assert(sizeof(FeedMessage) == 64, "FeedMessage must stay one cache line");
+
+/**
+ * @brief Sequenced L1/L2 delta and trade feed, broadcast from one matching thread
+ *
+ * The matching thread calls publishTrades()/publishBook() for what a match
+ * cycle changed and endBatch() once per cycle. publishBook() diffs the book's
+ * published depth against the previous cycle, so one cycle emits one delta
+ * per changed level however many orders touched it. Messages go into a
+ * broadcast ring that subscribers read on their own threads: the matching
+ * thread never waits for a subscriber, and one that falls behind detects the
+ * gap and resynchronizes from the per-symbol snapshot instead.
+ *
+ * Depth deltas cover the MarketDataSnapshot::MAX_DEPTH best levels per side;
+ * a level pushed out of them is reported as removed.
+ */
+class MarketDataFeed {
+public:
+    /**
+     * @brief Book state a subscriber starts from, with the feed sequence it is current at
+     */
+    struct BookState {
+        std::uint64_t sequence;
+        MarketDataSnapshot book;
+    };
+
+private:
+    struct SymbolState {
+        std::uint16_t symbolIndex;
+        MarketDataSnapshot previous;    // Matching thread only: last depth diffed against
+        SeqLock<BookState> published;   // Read by subscribers joining or resynchronizing
+        bool touched;
+    };
+
+    BroadcastRing<FeedMessage> ring;
+    std::vector<std::unique_ptr<SymbolState>> symbols;  // Indexed by symbol index; fixed once publishing starts
+    std::vector<FeedMessage> pending;                   // Current batch
+    long long messagesPublished;
+    long long batchesPublished;
+
+    SymbolState* findState(std::uint16_t symbolIndex) const;
+    FeedMessage& appendMessage(FeedMessageType type, std::uint16_t symbolIndex, long long timestamp);
+    template<typename Execution>
+    void appendTrades(const std::vector<Execution>& executions);
+    void diffSide(SymbolState& state, const DepthLevel* before, int beforeCount,
+                  const DepthLevel* after, int afterCount, OrderSide side, long long timestamp);
+
+public:
+    /**
+     * @brief Constructor
+     * @param capacity Ring size in messages, rounded up to a power of two; bounds how far
+     *                 a subscriber may fall behind before it has to resynchronize
+     */
+    explicit MarketDataFeed(size_t capacity = 65536);
+
+    MarketDataFeed(const MarketDataFeed&) = delete;
+    MarketDataFeed& operator=(const MarketDataFeed&) = delete;
+
+    /**
+     * @brief Register a book, starting from its current state (before publishing starts)
+     */
+    void addBook(const OrderBook& book);
+
+    // Matching thread only
+    void publishTrades(const std::vector<Trade>& trades);
+    void publishTrades(const std::vector<Fill>& fills);
+
+    /**
+     * @brief Queue L1/L2 deltas between the book's depth at the previous batch and now
+     */
+    void publishBook(const OrderBook& book);
+
+    /**
+     * @brief Sequence and release the current batch to subscribers
+     */
+    void endBatch();
+
+    // Subscriber side (any thread)
+    BroadcastRing<FeedMessage>::ReadResult read(std::uint64_t sequence, FeedMessage& message) const {
+        return ring.read(sequence, message);
+    }
+    std::uint64_t getPublishedSequence() const { return ring.getPublishedSequence(); }
+
+    /**
+     * @brief Every registered symbol's latest book state, as snapshot messages
+     * Each book is a BOOK_RESET, its levels as LEVEL_UPDATEs and a QUOTE, all
+     * flagged FEED_FLAG_SNAPSHOT and carrying the state's sequence.
+     */
+    void collectSnapshot(std::vector<FeedMessage>& messages) const;
+
+    long long getMessagesPublished() const { return messagesPublished; }   // Matching thread only
+    long long getBatchesPublished() const { return batchesPublished; }
+};
+
+/**
+ * @brief One consumer's cursor into a MarketDataFeed, polled on the consumer's thread
+ *
+ * A new subscriber first receives a snapshot of every book, then the live
+ * deltas that follow it; deltas already covered by a symbol's snapshot are
+ * skipped. A gap in the sequence (the subscriber was overrun) triggers the
+ * same resynchronization. With conflation on, a poll delivers only the last
+ * update of each price level and the last quote of each symbol it read.
+ */
+class FeedSubscriber {
+private:
+    const MarketDataFeed& feed;
+    std::uint64_t cursor;                           // Next sequence to read
+    std::vector<std::uint64_t> snapshotSequence;    // Per symbol index: deltas up to here are in the snapshot
+    bool needsSnapshot;
+    bool conflate;
+    std::vector<FeedMessage> buffer;
+    std::unordered_set<std::uint64_t> seenKeys;     // Conflation keys already emitted in a poll
+
+    long long gaps;
+    long long messagesReceived;
+
+    void fill(size_t maxMessages);
+    void conflateBuffer();
+
+public:
+    explicit FeedSubscriber(const MarketDataFeed& feed, bool conflate = false);
+
+    /**
+     * @brief Deliver up to maxMessages pending messages to the handler
+     * @return Number of messages delivered
+     */
+    template<typename Handler>
+    size_t poll(Handler&& handler, size_t maxMessages = 1024) {
+        fill(maxMessages);
+        for (const FeedMessage& message : buffer) {
+            handler(message);
+        }
+        messagesReceived += static_cast<long long>(buffer.size());
+        return buffer.size();
+    }
+
+    bool isConflating() const { return conflate; }
+    long long getGapCount() const { return gaps; }
+    long long getMessagesReceived() const { return messagesReceived; }
+    std::uint64_t getNextSequence() const { return cursor; }
+};
+
+} // namespace OrderMatchingEngine
+
+#endif // MARKET_DATA_FEED_HPP
\ No newline at end of file
@@ -0,0 +1,261 @@
+#include "MarketDepth.hpp"
+#include <algorithm>
+#include <thread>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define DEPTH_KERNELS_AVX2 1
+#endif
+
+namespace OrderMatchingEngine {
+
+namespace {
+
+// Scalar kernels: the reference behaviour, and the fallback on every CPU
+void cumulativeQuantityScalar(const int* quantities, size_t count, long long* cumulative) {
+    long long total = 0;
+    for (size_t i = 0; i < count; ++i) {
+        total += quantities[i];
+        cumulative[i] = total;
+    }
+}
+
+long long quantityAtOrBetterScalar(const Price* prices, const int* quantities, size_t count,
+                                   Price limitPrice, bool bidSide) {
+    long long total = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (bidSide ? prices[i] < limitPrice : prices[i] > limitPrice) {
+            break;  // Levels are best first, so nothing further qualifies
+        }
+        total += quantities[i];
+    }
+    return total;
+}
+
+void takeLevels(const Price* prices, const int* quantities, size_t count, long long size,
+                PriceImpact& impact) {
+    for (size_t i = 0; i < count && impact.filledQuantity < size; ++i) {
+        long long take = std::min<long long>(quantities[i], size - impact.filledQuantity);
+        impact.filledQuantity += take;
+        impact.notional += prices[i] * take;
+        impact.worstPrice = prices[i];
+        impact.levelsConsumed++;
+    }
+}
+
+PriceImpact estimateImpactScalar(const Price* prices, const int* quantities, size_t count, long long size) {
+    PriceImpact impact{0, 0, 0, 0};
+    takeLevels(prices, quantities, count, size, impact);
+    return impact;
+}
+
+#ifdef DEPTH_KERNELS_AVX2
+
+// AVX2 kernels: four levels per step, quantities widened to 64 bits so sums cannot overflow
+
+__attribute__((target("avx2")))
+inline __m256i loadQuantities(const int* quantities) {
+    return _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(quantities)));
+}
+
+/**
+ * @brief In-register inclusive prefix sum of four 64-bit lanes
+ */
+__attribute__((target("avx2")))
+inline __m256i prefixSum(__m256i values) {
+    values = _mm256_add_epi64(values, _mm256_slli_si256(values, 8));   // Within each 128-bit half
+    __m256i lowHalfTotal = _mm256_permute4x64_epi64(values, _MM_SHUFFLE(1, 1, 1, 1));
+    return _mm256_add_epi64(values, _mm256_blend_epi32(_mm256_setzero_si256(), lowHalfTotal, 0xF0));
+}
+
+__attribute__((target("avx2")))
+inline long long horizontalSum(__m256i values) {
+    __m128i sum = _mm_add_epi64(_mm256_castsi256_si128(values), _mm256_extracti128_si256(values, 1));
+    return _mm_cvtsi128_si64(sum) + _mm_extract_epi64(sum, 1);
+}
+
+__attribute__((target("avx2")))
+void cumulativeQuantityAvx2(const int* quantities, size_t count, long long* cumulative) {
+    __m256i carry = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256i running = _mm256_add_epi64(prefixSum(loadQuantities(quantities + i)), carry);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(cumulative + i), running);
+        carry = _mm256_permute4x64_epi64(running, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+    long long total = i > 0 ? cumulative[i - 1] : 0;
+    for (; i < count; ++i) {
+        total += quantities[i];
+        cumulative[i] = total;
+    }
+}
+
+__attribute__((target("avx2")))
+long long quantityAtOrBetterAvx2(const Price* prices, const int* quantities, size_t count,
+                                 Price limitPrice, bool bidSide) {
+    const __m256i limit = _mm256_set1_epi64x(limitPrice);
+    __m256i total = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256i price = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(prices + i));
+        __m256i worse = bidSide ? _mm256_cmpgt_epi64(limit, price) : _mm256_cmpgt_epi64(price, limit);
+        total = _mm256_add_epi64(total, _mm256_andnot_si256(worse, loadQuantities(quantities + i)));
+        if (_mm256_movemask_epi8(worse) != 0) {
+            return horizontalSum(total);    // Crossed the limit inside this block
+        }
+    }
+    return horizontalSum(total) + quantityAtOrBetterScalar(prices + i, quantities + i, count - i,
+                                                           limitPrice, bidSide);
+}
+
+__attribute__((target("avx2")))
+PriceImpact estimateImpactAvx2(const Price* prices, const int* quantities, size_t count, long long size) {
+    PriceImpact impact{0, 0, 0, 0};
+    if (size <= 0) {
+        return impact;
+    }
+
+    // Whole blocks that leave the size unfilled are taken in one step
+    const __m256i fillTarget = _mm256_set1_epi64x(size);
+    __m256i carry = _mm256_setzero_si256();
+    __m256i notional = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256i quantity = loadQuantities(quantities + i);
+        __m256i running = _mm256_add_epi64(prefixSum(quantity), carry);
+        if (_mm256_movemask_epi8(_mm256_cmpgt_epi64(fillTarget, running)) != -1) {
+            break;  // The size is reached inside this block
+        }
+
+        // price * quantity with 32x32 multiplies: quantity fits in 32 bits, price may not
+        __m256i price = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(prices + i));
+        __m256i low = _mm256_mul_epu32(price, quantity);
+        __m256i high = _mm256_slli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(price, 32), quantity), 32);
+        notional = _mm256_add_epi64(notional, _mm256_add_epi64(low, high));
+        carry = _mm256_permute4x64_epi64(running, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+
+    if (i > 0) {
+        impact.filledQuantity = _mm256_extract_epi64(carry, 0);
+        impact.notional = horizontalSum(notional);
+        impact.worstPrice = prices[i - 1];
+        impact.levelsConsumed = static_cast<int>(i);
+    }
+    takeLevels(prices + i, quantities + i, count - i, size, impact);
+    return impact;
+}
+
+#endif // DEPTH_KERNELS_AVX2
+
+struct KernelTable {
+    void (*cumulativeQuantity)(const int*, size_t, long long*);
+    long long (*quantityAtOrBetter)(const Price*, const int*, size_t, Price, bool);
+    PriceImpact (*estimateImpact)(const Price*, const int*, size_t, long long);
+    const char* name;
+};
+
+KernelTable selectKernels() {
+#ifdef DEPTH_KERNELS_AVX2
+    if (__builtin_cpu_supports("avx2")) {
+        return {cumulativeQuantityAvx2, quantityAtOrBetterAvx2, estimateImpactAvx2, "avx2"};
+    }
+#endif
+    return {cumulativeQuantityScalar, quantityAtOrBetterScalar, estimateImpactScalar, "scalar"};
+}
+
+const KernelTable& kernels() {
+    static const KernelTable table = selectKernels();
+    return table;
+}
+
+void collectRange(const std::vector<const OrderBook*>& books, size_t begin, size_t end, DepthBatch& batch) {
+    for (size_t i = begin; i < end; ++i) {
+        DepthBatch::Range& range = batch.ranges[i];
+        range = DepthBatch::Range{0, 0, 0, 0};
+        const OrderBook* book = books[i];
+        if (!book || batch.levelsPerSide == 0) {
+            continue;
+        }
+        range.symbolIndex = book->getSymbolIndex();
+
+        // Nothing but a single-writer book's own thread may walk it, so it is read from the snapshot only
+        int levels = book->isSingleWriter() ? std::min(batch.levelsPerSide, MarketDataSnapshot::MAX_DEPTH)
+                                            : batch.levelsPerSide;
+
+        Price* prices = batch.prices.data();
+        int* quantities = batch.quantities.data();
+        size_t bid = batch.bidOffset(i);
+        size_t ask = batch.askOffset(i);
+        if (levels <= MarketDataSnapshot::MAX_DEPTH) {
+            // One snapshot for both sides, so they are consistent with each other
+            MarketDataSnapshot snapshot = book->getMarketData();
+            range.version = snapshot.version;
+            range.bidCount = std::min(levels, snapshot.bidLevelCount);
+            range.askCount = std::min(levels, snapshot.askLevelCount);
+            for (int level = 0; level < range.bidCount; ++level) {
+                prices[bid + level] = snapshot.bids[level].price;
+                quantities[bid + level] = snapshot.bids[level].quantity;
+            }
+            for (int level = 0; level < range.askCount; ++level) {
+                prices[ask + level] = snapshot.asks[level].price;
+                quantities[ask + level] = snapshot.asks[level].quantity;
+            }
+        } else {
+            range.bidCount = book->getDepth(true, levels, prices + bid, quantities + bid);
+            range.askCount = book->getDepth(false, levels, prices + ask, quantities + ask);
+        }
+    }
+}
+
+} // namespace
+
+// DepthKernels implementation
+void DepthKernels::cumulativeQuantity(const int* quantities, size_t count, long long* cumulative) {
+    kernels().cumulativeQuantity(quantities, count, cumulative);
+}
+
+long long DepthKernels::quantityAtOrBetter(const Price* prices, const int* quantities, size_t count,
+                                           Price limitPrice, bool bidSide) {
+    return kernels().quantityAtOrBetter(prices, quantities, count, limitPrice, bidSide);
+}
+
+PriceImpact DepthKernels::estimateImpact(const Price* prices, const int* quantities, size_t count,
+                                         long long size) {
+    return kernels().estimateImpact(prices, quantities, count, size);
+}
+
+const char* DepthKernels::getImplementation() {
+    return kernels().name;
+}
+
+void collectDepth(const std::vector<const OrderBook*>& books, int levelsPerSide, DepthBatch& batch,
+                  int workers) {
+    batch.levelsPerSide = std::max(0, levelsPerSide);
+    size_t slots = books.size() * 2 * static_cast<size_t>(batch.levelsPerSide);
+    if (batch.prices.size() < slots) {
+        batch.prices.resize(slots);
+        batch.quantities.resize(slots);
+    }
+    batch.ranges.resize(books.size());
+
+    size_t threadCount = std::min<size_t>(std::max(1, workers), books.size());
+    if (threadCount <= 1) {
+        collectRange(books, 0, books.size(), batch);
+        return;
+    }
+
+    // Books own disjoint, fixed slots of the batch, so the workers never coordinate
+    size_t chunk = (books.size() + threadCount - 1) / threadCount;
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount - 1);
+    for (size_t begin = chunk; begin < books.size(); begin += chunk) {
+        threads.emplace_back(collectRange, std::cref(books), begin, std::min(begin + chunk, books.size()),
+                             std::ref(batch));
+    }
+    collectRange(books, 0, std::min(chunk, books.size()), batch);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+} // namespace OrderMatchingEngine
\ No newline at end of file
@@ -0,0 +1,106 @@
+#ifndef MARKET_DEPTH_HPP
+#define MARKET_DEPTH_HPP
+
+#include "OrderBook.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace OrderMatchingEngine {
+
+/**
+ * @brief Cost of taking a given size from one side of the book
+ * Prices are in ticks; a side too thin for the size reports what it could fill.
+ */
+struct PriceImpact {
+    long long filledQuantity;   // Up to the requested size
+    long long notional;         // Sum of price * quantity over the filled part, in ticks
+    Price worstPrice;           // Price of the last level touched (0 if nothing filled)
+    int levelsConsumed;         // Levels touched, the last one possibly only in part
+
+    double getAveragePrice() const {
+        return filledQuantity > 0 ? static_cast<double>(notional) / static_cast<double>(filledQuantity) : 0.0;
+    }
+};
+
+/**
+ * @brief Depth kernels over one side in struct-of-arrays form, best price first
+ *
+ * Prices and quantities sit in separate contiguous arrays so the kernels load
+ * four levels per AVX2 instruction. The implementation is picked once at
+ * startup from the CPU's features; the scalar kernels give identical results
+ * and are used on CPUs without AVX2 and on other architectures.
+ */
+namespace DepthKernels {
+
+/**
+ * @brief Running total of quantity: cumulative[i] = quantities[0] + ... + quantities[i]
+ */
+void cumulativeQuantity(const int* quantities, size_t count, long long* cumulative);
+
+/**
+ * @brief Quantity resting at limitPrice or better
+ * @param bidSide True for bids (prices at or above the limit count), false for asks
+ */
+long long quantityAtOrBetter(const Price* prices, const int* quantities, size_t count,
+                             Price limitPrice, bool bidSide);
+
+/**
+ * @brief Walk the levels until size is filled, as a market order of that size would
+ */
+PriceImpact estimateImpact(const Price* prices, const int* quantities, size_t count, long long size);
+
+/**
+ * @brief Name of the kernels in use: "avx2" or "scalar"
+ */
+const char* getImplementation();
+
+} // namespace DepthKernels
+
+/**
+ * @brief Depth of many books in one flat struct-of-arrays buffer
+ *
+ * Every book gets a fixed stride of 2 * levelsPerSide slots, bids first, so
+ * books can be filled independently and in parallel without a sizing pass.
+ * A batch that is reused across requests stops allocating once it has grown
+ * to the largest one.
+ */
+struct DepthBatch {
+    struct Range {
+        std::uint16_t symbolIndex;
+        std::uint64_t version;  // Snapshot version the depth was read at (0 for a locked walk)
+        int bidCount;           // Levels used out of levelsPerSide (at most MAX_DEPTH for a single-writer book)
+        int askCount;
+    };
+
+    int levelsPerSide = 0;
+    std::vector<Price> prices;
+    std::vector<int> quantities;
+    std::vector<Range> ranges;  // One per requested book, in request order
+
+    size_t size() const { return ranges.size(); }
+    size_t bidOffset(size_t book) const { return book * 2 * static_cast<size_t>(levelsPerSide); }
+    size_t askOffset(size_t book) const { return bidOffset(book) + static_cast<size_t>(levelsPerSide); }
+
+    const Price* bidPrices(size_t book) const { return prices.data() + bidOffset(book); }
+    const int* bidQuantities(size_t book) const { return quantities.data() + bidOffset(book); }
+    const Price* askPrices(size_t book) const { return prices.data() + askOffset(book); }
+    const int* askQuantities(size_t book) const { return quantities.data() + askOffset(book); }
+};
+
+/**
+ * @brief Read the depth of several books into one batch
+ * Up to MarketDataSnapshot::MAX_DEPTH levels come from each book's published
+ * snapshot without locks; deeper requests walk each book under its lock.
+ * Single-writer books have no lock, so their ranges stop at MAX_DEPTH levels.
+ * @param books Books to read; a null entry yields an empty range
+ * @param workers Threads to split the books over. A snapshot read is a copy of a
+ *                few hundred bytes, so extra workers only pay off for deep
+ *                requests over many books.
+ */
+void collectDepth(const std::vector<const OrderBook*>& books, int levelsPerSide, DepthBatch& batch,
+                  int workers = 1);
+
+} // namespace OrderMatchingEngine
+
+#endif // MARKET_DEPTH_HPP
\ No newline at end of file
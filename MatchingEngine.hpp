@@ -2,8 +2,17 @@
 #define MATCHING_ENGINE_HPP
 
 #include "OrderBook.hpp"
+#include "MarketDepth.hpp"
 #include "UserManager.hpp"
+#include "RiskEngine.hpp"
 #include "TradeLogger.hpp"
+#include "MatchingShard.hpp"
+#include "OrderGateway.hpp"
+#include "LatencyMonitor.hpp"
+#include "MetricsEndpoint.hpp"
+#include "Partitioning.hpp"
+#include "Replication.hpp"
+#include "TaskScheduler.hpp"
 #include <unordered_map>
 #include <memory>
 #include <thread>
@@ -27,6 +36,13 @@ class MatchingEngine {
 public:
     // Core components
     std::unordered_map<std::string, std::unique_ptr<OrderBook>> orderBooks;
+    std::vector<OrderBook*> orderBooksByIndex;  // Symbol index (top bits of every OrderId) -> book
+
+    // Work-stealing pool for everything off the matching path: log maintenance,
+    // session cleanup, reports and analytics. Never runs on a matching core, and
+    // is declared before the components that submit to it so it outlives them.
+    std::unique_ptr<TaskScheduler> backgroundScheduler;
+
     std::unique_ptr<UserManager> userManager;
     std::unique_ptr<TradeLogger> tradeLogger;
 
@@ -39,23 +55,43 @@ public:
     // Order processing queue (lock-free for high performance)
     struct OrderRequest {
         OrderPtr order;
-        std::chrono::high_resolution_clock::time_point timestamp;
+        std::uint64_t enqueueCycles;    // CycleClock stamp, for the QUEUE_WAIT and END_TO_END stages
         int priority; // Higher values = higher priority
 
         OrderRequest(OrderPtr o, int p = 0) 
-            : order(o), timestamp(std::chrono::high_resolution_clock::now()), priority(p) {}
+            : order(o), enqueueCycles(CycleClock::now()), priority(p) {}
     };
 
     // Priority queue for order requests
     std::priority_queue<OrderRequest, std::vector<OrderRequest>, 
                        std::function<bool(const OrderRequest&, const OrderRequest&)>> orderQueue;
 
+    // Encodes and writes every shard's snapshots off the matching cores; declared
+    // before the shards so it outlives them
+    std::unique_ptr<SnapshotWriter> snapshotWriter;
+
+    // Sharded execution: every symbol is owned by exactly one pinned matching thread
+    std::vector<std::unique_ptr<MatchingShard>> shards;
+    std::unordered_map<std::string, MatchingShard*> symbolShards;
+
+    // Write-ahead logs, one per shard, numbered from one global input sequence
+    std::vector<std::unique_ptr<WriteAheadLog>> eventLogs;
+    std::atomic<std::uint64_t> eventSequence;
+
+    // Sequence behind engine-assigned order IDs
+    std::atomic<std::uint64_t> orderSequence;
+
     // Statistics and monitoring
     std::atomic<long long> totalOrdersProcessed;
     std::atomic<long long> totalTradesExecuted;
-    std::atomic<double> totalVolumeTraded;
+    std::atomic<long long> totalVolumeTraded;
     std::chrono::high_resolution_clock::time_point startTime;
 
+    // Per-stage latency histograms: every shard, the gateway and the worker
+    // threads record into their own recorder; scrapes merge them on demand
+    LatencyMonitor latencyMonitor;
+    std::unique_ptr<MetricsEndpoint> metricsEndpoint;
+
     // Configuration
     struct EngineConfig {
         int maxWorkerThreads;
@@ -67,12 +103,46 @@ public:
         int orderTimeoutSeconds;
         bool enableStopLossOrders;
         bool enableMultiThreading;
+        bool enableShardedMatching;     // Route orders to per-symbol shards instead of orderQueue
+        int numMatchingShards;
+        int firstMatchingCore;          // Shard i is pinned to core firstMatchingCore + i (-1 for no pinning)
+        int ingressRingSize;            // Commands buffered per shard before submissions are refused
+        bool enableEventLog;            // Write-ahead log every shard's input before matching
+        std::string eventLogDirectory;  // Per-shard logs and per-symbol snapshots
+        long long snapshotIntervalEvents; // Input events between book snapshots
+        bool backgroundSnapshots;       // Shards only capture their books; a writer thread encodes and fsyncs
+        int marketDataFeedCapacity;     // Messages a feed subscriber may lag before resynchronizing
+        bool enableOrderGateway;        // Binary order entry over TCP (sharded matching only)
+        int orderGatewayPort;
+        bool enableLatencyTracking;     // Per-stage histograms on shards, gateway and workers
+        bool enableMetricsEndpoint;     // Serve getMetricsText() over HTTP for scrapers
+        int metricsPort;
+        int partitionCount;             // Engine processes sharing the symbol set (1: unpartitioned)
+        int partitionId;                // This process's partition, or -1 for a gateway-only process
+        std::string partitionChannelPrefix; // Shared memory names of the partition channels
+        std::string sequencerName;      // Host-wide event sequence shared by every partition's logs
+        bool enableReplication;         // Stream every shard's committed log to a hot standby
+        int replicationPort;
+        bool startAsStandby;            // Follow primaryHost:replicationPort instead of matching
+        std::string primaryHost;
+        int backgroundThreads;          // Background pool workers (0: one per core left after the matching cores)
+        std::vector<int> backgroundCores; // Cores for the pool (empty: all); matching cores are always excluded
 
         EngineConfig() : maxWorkerThreads(4), maxQueueSize(10000), 
                         enableRiskManagement(true), enableMarketDataBroadcast(true),
                         maxOrderSize(1000000.0), maxPositionSize(5000000.0),
                         orderTimeoutSeconds(86400), enableStopLossOrders(true),
-                        enableMultiThreading(true) {}
+                        enableMultiThreading(true), enableShardedMatching(false),
+                        numMatchingShards(1), firstMatchingCore(-1), ingressRingSize(65536),
+                        enableEventLog(false), eventLogDirectory("./data"),
+                        snapshotIntervalEvents(1000000), backgroundSnapshots(true),
+                        marketDataFeedCapacity(65536),
+                        enableOrderGateway(false), orderGatewayPort(9001),
+                        enableLatencyTracking(true), enableMetricsEndpoint(false), metricsPort(9100),
+                        partitionCount(1), partitionId(0), partitionChannelPrefix("/order-engine"),
+                        sequencerName("/order-engine-sequence"), enableReplication(false),
+                        replicationPort(9200), startAsStandby(false), primaryHost("127.0.0.1"),
+                        backgroundThreads(0) {}
     } config;
 
     // Risk management
@@ -87,19 +157,44 @@ public:
                       maxOrderSize(1000000.0), maxOrdersPerSecond(1000) {}
     } riskLimits;
 
-    // Market data subscribers
-    std::vector<std::function<void(const Trade&)>> tradeCallbacks;
-    std::vector<std::function<void(const std::string&, double, double)>> marketDataCallbacks;
+    // Compiled form of riskLimits (symbol risk factors by symbol index, rate
+    // buckets and open/traded notional per account), rebuilt by updateRiskLimits
+    // and maintained from acks, fills and cancels; checkRiskLimits only compares
+    // against it
+    RiskEngine riskEngine;
+
+    // Market data output: one sequenced L1/L2/trade feed per shard (a single one
+    // published under engineMutex when matching is not sharded). Subscribers read
+    // them on their own threads, so a slow consumer never delays matching.
+    std::vector<std::unique_ptr<MarketDataFeed>> marketDataFeeds;
+
+    // Binary order entry: routes each symbol index to its shard's ingress ring
+    std::unique_ptr<OrderGateway> orderGateway;
+
+    // Partitioned deployment (partitionCount > 1): this process serves its own
+    // partition's symbols through partitionServer, and reaches the symbols of
+    // the other partitions through partitionRouter's shared memory channels
+    std::unique_ptr<PartitionMap> partitionMap;
+    std::unique_ptr<PartitionServer> partitionServer;
+    std::unique_ptr<PartitionRouter> partitionRouter;
+    Sequencer sequencer;
+
+    // Hot standby (sharded matching with the event log): a primary publishes its
+    // shards' commits; a standby applies them to identically built shards, whose
+    // fill handlers keep userManager and the risk engine in step, until promoted
+    std::unique_ptr<ReplicationPublisher> replicationPublisher;
+    std::unique_ptr<StandbyReplica> standbyReplica;
 
     // Internal methods
     void workerThreadFunction();
     void processOrderRequest(const OrderRequest& request);
     bool validateOrder(const OrderPtr& order);
-    bool checkRiskLimits(const OrderPtr& order);
-    void notifyTradeExecuted(const Trade& trade);
-    void notifyMarketDataUpdate(const std::string& symbol, double bid, double ask);
-    void cleanupExpiredOrders();
+    bool checkRiskLimits(const OrderPtr& order);     // Constant time, via riskEngine
+    std::unordered_map<OrderBook*, std::vector<OrderPtr>>
+    partitionBySymbol(const std::vector<OrderPtr>& orders);
+    void cleanupExpiredOrders();     // Collects from each book's timer wheel and cancels; no sweep
     OrderBook* getOrCreateOrderBook(const std::string& symbol);
+    MatchingShard* getShardForSymbol(const std::string& symbol) const;
 
 public:
     /**
@@ -116,10 +211,10 @@ public:
     // Core order operations
     /**
      * @brief Submit a new order to the matching engine
-     * @param order Order to be processed
-     * @return Order ID if successfully submitted, empty string if failed
+     * @param order Order to be processed; it is assigned its engine order ID
+     * @return Order ID if successfully submitted, 0 if failed
      */
-    std::string submitOrder(OrderPtr order);
+    OrderId submitOrder(OrderPtr order);
 
     /**
      * @brief Cancel an existing order
@@ -127,24 +222,33 @@ public:
      * @param userId User requesting cancellation (for authorization)
      * @return True if successfully cancelled, false otherwise
      */
-    bool cancelOrder(const std::string& orderId, const std::string& userId);
+    bool cancelOrder(OrderId orderId, const std::string& userId);
 
     /**
      * @brief Modify an existing order
      * @param orderId ID of order to modify
      * @param userId User requesting modification (for authorization)
-     * @param newPrice New price (0 to keep current)
+     * @param newPrice New price in ticks of the symbol's PriceScale (0 to keep current)
      * @param newQuantity New quantity (0 to keep current)
      * @return True if successfully modified, false otherwise
      */
-    bool modifyOrder(const std::string& orderId, const std::string& userId,
-                    double newPrice = 0.0, int newQuantity = 0);
+    bool modifyOrder(OrderId orderId, const std::string& userId,
+                    Price newPrice = 0, int newQuantity = 0);
+
+    // Query operations: with sharded matching, per-order queries are queued to the
+    // owning shard and answered by its thread (MatchingShard::queryOrder and friends),
+    // as its books have no lock to take
 
-    // Query operations
     /**
      * @brief Get order details
      */
-    OrderPtr getOrder(const std::string& orderId) const;
+    OrderPtr getOrder(OrderId orderId) const;
+
+    /**
+     * @brief Resolve a client order ID to the engine order ID
+     * @return The order ID, or 0 if no resting order on that symbol has the client ID
+     */
+    OrderId findOrderId(const std::string& symbol, const std::string& clientOrderId) const;
 
     /**
      * @brief Get all orders for a user
@@ -153,6 +257,8 @@ public:
 
     /**
      * @brief Get order book for a symbol
+     * A shard-owned book may only be read through its published snapshot, which
+     * caps depth at MarketDataSnapshot::MAX_DEPTH levels.
      */
     const OrderBook* getOrderBook(const std::string& symbol) const;
 
@@ -161,21 +267,26 @@ public:
      */
     struct MarketData {
         std::string symbol;
-        double bestBid;
+        double bestBid;             // Prices are decimals, converted with the symbol's PriceScale
         double bestAsk;
         double lastTradePrice;
         long long lastTradeTime;
-        double totalVolume;
+        long long totalVolume;
         long long totalTrades;
         double spread;
 
         std::string toString() const;
     };
 
+    /**
+     * Built from the book's published MarketDataSnapshot: takes neither the book
+     * lock nor engineMutex, so quote polling never contends with matching.
+     */
     MarketData getMarketData(const std::string& symbol) const;
 
     /**
-     * @brief Get market data for all symbols
+     * @brief Get market data for all symbols (one lock-free snapshot read per book)
+     * When partitioned, symbols of other partitions come from their published channel snapshots.
      */
     std::vector<MarketData> getAllMarketData() const;
 
@@ -195,15 +306,43 @@ public:
      */
     bool isRunning() const { return running.load(); }
 
+    /**
+     * @brief Whether this engine is following a primary instead of matching
+     */
+    bool isStandby() const { return standbyReplica && standbyReplica->isFollowing(); }
+
+    /**
+     * @brief Take over from the primary: apply what was received, then start the shards and gateway
+     * Nothing is replayed at this point, so the engine accepts orders within milliseconds.
+     * @return False if this engine is not a standby
+     * @throws std::runtime_error if the standby has diverged from the primary
+     */
+    bool promoteToPrimary();
+
+    /**
+     * @brief The standby's view of its primary, or nullptr when not a standby
+     */
+    const StandbyReplica* getStandbyReplica() const { return standbyReplica.get(); }
+
+    /**
+     * @brief Pool running log maintenance, session cleanup and reports, kept off the matching cores
+     * Also available for parallel analytics over engine state (parallelFor); nullptr before start().
+     */
+    TaskScheduler* getBackgroundScheduler() const { return backgroundScheduler.get(); }
+
     // Statistics and monitoring
     struct EngineStatistics {
         long long totalOrdersProcessed;
         long long totalTradesExecuted;
-        double totalVolumeTraded;
+        long long totalVolumeTraded;
         long long uptimeSeconds;
         int activeSymbols;
         int queueSize;
         double averageProcessingTimeMs;
+        double p50ProcessingTimeMicros;     // END_TO_END stage percentiles
+        double p99ProcessingTimeMicros;
+        double p999ProcessingTimeMicros;
+        double maxProcessingTimeMicros;
         double ordersPerSecond;
         double tradesPerSecond;
 
@@ -212,6 +351,17 @@ public:
 
     EngineStatistics getStatistics() const;
 
+    /**
+     * @brief Percentiles of every timed stage of the order path, merged over all threads
+     */
+    std::vector<LatencySummary> getLatencySummaries() const { return latencyMonitor.getSummaries(); }
+
+    /**
+     * @brief Engine counters and stage latency summaries in the Prometheus text format
+     * This is what the metrics endpoint serves.
+     */
+    std::string getMetricsText() const;
+
     /**
      * @brief Print comprehensive engine status
      */
@@ -225,23 +375,48 @@ public:
 
     /**
      * @brief Update risk limits
+     * Symbol risk factors are compiled into riskEngine's table by symbol index.
      */
     void updateRiskLimits(const RiskLimits& newLimits);
 
-    // Event subscription
+    // Market data subscription
     /**
-     * @brief Subscribe to trade events
+     * @brief Number of market data feeds; every symbol is published on exactly one of them
      */
-    void subscribeToTrades(std::function<void(const Trade&)> callback);
+    size_t getMarketDataFeedCount() const { return marketDataFeeds.size(); }
 
     /**
-     * @brief Subscribe to market data updates
+     * @brief Index of the feed that publishes a symbol
+     * @throws std::invalid_argument if the symbol is not supported
      */
-    void subscribeToMarketData(std::function<void(const std::string&, double, double)> callback);
+    size_t getMarketDataFeedIndex(const std::string& symbol) const;
+
+    /**
+     * @brief Join a feed: the subscriber starts from a snapshot of the feed's books,
+     *        then receives the trade prints and L1/L2 deltas that follow it
+     * Poll the subscriber from the consuming thread; it is not thread-safe itself.
+     * @param conflate Deliver only the latest update per price level and quote per poll
+     */
+    std::unique_ptr<FeedSubscriber> subscribeToMarketData(size_t feedIndex, bool conflate = false) const;
+
+    /**
+     * @brief The binary order entry gateway, or nullptr when it is disabled
+     */
+    const OrderGateway* getOrderGateway() const { return orderGateway.get(); }
+
+    /**
+     * @brief Router to the other partitions' processes, or nullptr when not partitioned
+     */
+    const PartitionRouter* getPartitionRouter() const { return partitionRouter.get(); }
+
+    /**
+     * @brief The metrics scrape endpoint, or nullptr when it is disabled
+     */
+    const MetricsEndpoint* getMetricsEndpoint() const { return metricsEndpoint.get(); }
 
     // Utility methods
     /**
-     * @brief Get all supported symbols
+     * @brief Get all supported symbols, across every partition of the deployment
      */
     std::vector<std::string> getSupportedSymbols() const;
 
@@ -250,6 +425,12 @@ public:
      */
     void addSymbol(const std::string& symbol);
 
+    /**
+     * @brief Add support for a symbol with its own price scale and level storage
+     * @param symbolConfig Price scale, and tick size/band when the book uses price ladders
+     */
+    void addSymbol(const std::string& symbol, const SymbolConfig& symbolConfig);
+
     /**
      * @brief Remove support for trading symbol
      */
@@ -262,14 +443,26 @@ public:
 
     /**
      * @brief Export order book state to file
+     * Every book is captured with OrderBook::captureSnapshot, on its shard's thread
+     * at one point of the input sequence when sharded; the binary images are then
+     * encoded and written by the snapshot writer, so matching never waits for the file.
      */
     bool exportOrderBookState(const std::string& filename) const;
 
     /**
      * @brief Import order book state from file
+     * Books are bulk-loaded from the images with OrderBook::restoreSnapshot, one
+     * level at a time, instead of re-entering every order.
      */
     bool importOrderBookState(const std::string& filename);
 
+    /**
+     * @brief Rebuild every shard from its latest snapshots and event-log tail
+     * Called by start() when enableEventLog is set, after symbols are added.
+     * @return Highest input sequence recovered
+     */
+    std::uint64_t recoverFromEventLog();
+
     // Advanced features
     /**
      * @brief Enable/disable circuit breaker for a symbol
@@ -279,14 +472,31 @@ public:
 
     /**
      * @brief Batch order submission for improved throughput
+     * The batch is validated and risk-checked in one pass, then partitioned by
+     * symbol so each book (or owning shard) takes the whole partition at once.
+     * @return Per-order outcomes in submission order, with each order's trades
+     *         contiguous in the shared trade list; failed checks are REJECTED
      */
-    std::vector<std::string> submitBatchOrders(const std::vector<OrderPtr>& orders);
+    BatchResult submitBatchOrders(const std::vector<OrderPtr>& orders);
 
     /**
      * @brief Get order book depth for multiple symbols
+     * Reads each book's published snapshot for up to MarketDataSnapshot::MAX_DEPTH levels.
      */
     std::unordered_map<std::string, std::vector<std::pair<double, int>>> 
     getMultiSymbolDepth(const std::vector<std::string>& symbols, int levels) const;
+
+    /**
+     * @brief Get order book depth for multiple symbols into one flat buffer, in tick prices
+     * Ranges follow the order of symbols (unknown ones are empty) and feed the
+     * DepthKernels queries directly; nothing is allocated once batch has grown.
+     * Shard-owned books are read from their published snapshots only, so with
+     * sharded matching every range holds at most MarketDataSnapshot::MAX_DEPTH
+     * levels per side; deeper depth of one book comes from MatchingShard::queryMarketDepth.
+     * @param workers Threads to split the books over (see collectDepth)
+     */
+    void getMultiSymbolDepth(const std::vector<std::string>& symbols, int levels, DepthBatch& batch,
+                             int workers = 1) const;
 };
 
 /**
@@ -318,30 +528,54 @@ public:
 
 /**
  * @brief Performance monitor for the matching engine
+ * Latencies go into per-thread histograms, so reporting percentiles costs the
+ * recording threads nothing beyond a cycle counter read and an increment.
  */
 class PerformanceMonitor {
 private:
     std::atomic<long long> orderCount;
     std::atomic<long long> tradeCount;
     std::chrono::high_resolution_clock::time_point startTime;
-    std::atomic<double> totalLatency;
+    LatencyMonitor latencyMonitor;
 
 public:
     PerformanceMonitor();
 
-    void recordOrderProcessed(double latencyMs);
+    /**
+     * @brief Count an order and record its END_TO_END latency on the calling thread
+     * @param startCycles CycleClock stamp taken when the order arrived
+     */
+    void recordOrderProcessed(std::uint64_t startCycles);
+
+    /**
+     * @brief Record one sample of any stage on the calling thread
+     */
+    void recordStage(LatencyStage stage, std::uint64_t startCycles);
     void recordTradeExecuted();
 
     struct PerformanceMetrics {
         double averageLatencyMs;
+        double p50LatencyMicros;
+        double p99LatencyMicros;
+        double p999LatencyMicros;
+        double maxLatencyMicros;
         long long ordersPerSecond;
         long long tradesPerSecond;
         long long totalOrders;
         long long totalTrades;
         long long uptimeSeconds;
+        std::vector<LatencySummary> stages;     // Every stage with samples
     };
 
     PerformanceMetrics getMetrics() const;
+
+    /**
+     * @brief Counters and stage latency summaries in the Prometheus text format
+     * Serve it with a MetricsEndpoint to make it scrapeable.
+     */
+    std::string getPrometheusText() const;
+
+    LatencyMonitor& getLatencyMonitor() { return latencyMonitor; }
     void reset();
 };
 
@@ -0,0 +1,877 @@
+#include "MatchingShard.hpp"
+#include <stdexcept>
+#include <algorithm>
+#include <chrono>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace OrderMatchingEngine {
+
+namespace {
+
+const size_t MAX_COMMAND_BATCH = 256;
+const long long EXPIRY_CHECK_INTERVAL_MICROS = 1000;
+
+long long currentTimestamp() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::high_resolution_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+MatchingShard::MatchingShard(int shardId, size_t ingressCapacity, int cpuCore)
+    : shardId(shardId), cpuCore(cpuCore), ingress(ingressCapacity), batch(MAX_COMMAND_BATCH),
+      running(false), failed(false), commandsProcessed(0), reportsDropped(0), nextExpiry(0), lastExpiryCheck(0),
+      marketDataFeed(nullptr), latencyMonitor(nullptr), latency(nullptr), marketDataCycles(0),
+      eventLog(nullptr), snapshotInterval(0), eventsSinceSnapshot(0), snapshotWriter(nullptr),
+      replayedSequence(0) {
+}
+
+MatchingShard::~MatchingShard() {
+    stop();
+    while (snapshotRound.isInFlight()) {
+        std::this_thread::yield(); // The writer still reads the round
+    }
+}
+
+OrderBook* MatchingShard::addSymbol(const std::string& symbol, const SymbolConfig& config) {
+    if (running.load()) {
+        throw std::invalid_argument("Symbols must be added before the shard is started");
+    }
+    if (books.count(symbol)) {
+        throw std::invalid_argument("Symbol is already owned by this shard");
+    }
+
+    SymbolConfig shardConfig = config;
+    shardConfig.singleWriter = true;
+    auto book = std::make_unique<OrderBook>(symbol, shardConfig);
+    OrderBook* bookPtr = book.get();
+    books.emplace(symbol, std::move(book));
+
+    if (booksByIndex.size() <= config.symbolIndex) {
+        booksByIndex.resize(config.symbolIndex + 1, nullptr);
+    }
+    booksByIndex[config.symbolIndex] = bookPtr;
+    return bookPtr;
+}
+
+bool MatchingShard::submitOrder(OrderPtr order) {
+    EngineCommand command;
+    command.type = EngineCommand::Type::SUBMIT;
+    command.order = std::move(order);
+    return pushCommand(command);
+}
+
+bool MatchingShard::submitOrders(std::vector<OrderPtr> orders) {
+    EngineCommand command;
+    command.type = EngineCommand::Type::SUBMIT_BATCH;
+    command.orders = std::move(orders);
+    return pushCommand(command);
+}
+
+bool MatchingShard::pushCommand(EngineCommand& command) {
+    if (failed.load(std::memory_order_relaxed) && command.type != EngineCommand::Type::QUERY) {
+        return false;
+    }
+    command.enqueueCycles = CycleClock::now();
+    return ingress.tryPush(std::move(command));
+}
+
+bool MatchingShard::cancelOrder(OrderId orderId) {
+    return cancelOrder(orderId, ReplyRoute());
+}
+
+std::future<OrderPtr> MatchingShard::queryOrder(OrderId orderId) {
+    return pushQuery<OrderPtr>([this, orderId]() {
+        OrderBook* book = findBook(orderId);
+        return book ? book->getOrder(orderId) : nullptr;
+    });
+}
+
+std::future<OrderId> MatchingShard::queryOrderId(const std::string& symbol, const std::string& clientOrderId) {
+    return pushQuery<OrderId>([this, symbol, clientOrderId]() {
+        OrderBook* book = getOrderBook(symbol);
+        return book ? book->findOrderId(clientOrderId) : 0;
+    });
+}
+
+std::future<std::vector<OrderPtr>> MatchingShard::queryUserOrders(const std::string& userId) {
+    return pushQuery<std::vector<OrderPtr>>([this, userId]() {
+        std::vector<OrderPtr> orders;
+        for (const auto& entry : books) {
+            std::vector<OrderPtr> bookOrders = entry.second->getUserOrders(userId);
+            orders.insert(orders.end(), bookOrders.begin(), bookOrders.end());
+        }
+        return orders;
+    });
+}
+
+std::future<std::vector<std::pair<Price, int>>>
+MatchingShard::queryMarketDepth(const std::string& symbol, int levels, bool buySide) {
+    return pushQuery<std::vector<std::pair<Price, int>>>([this, symbol, levels, buySide]() {
+        OrderBook* book = getOrderBook(symbol);
+        return book ? book->walkMarketDepth(levels, buySide) : std::vector<std::pair<Price, int>>();
+    });
+}
+
+bool MatchingShard::modifyOrder(OrderId orderId, Price newPrice, int newQuantity) {
+    return modifyOrder(orderId, newPrice, newQuantity, ReplyRoute());
+}
+
+bool MatchingShard::submitEntry(std::uint16_t symbolIndex, const OrderEntry& entry, const ReplyRoute& reply) {
+    EngineCommand command;
+    command.type = EngineCommand::Type::SUBMIT_ENTRY;
+    command.entry = entry;
+    command.symbolIndex = symbolIndex;
+    command.reply = reply;
+    return pushCommand(command);
+}
+
+bool MatchingShard::cancelOrder(OrderId orderId, const ReplyRoute& reply) {
+    EngineCommand command;
+    command.type = EngineCommand::Type::CANCEL;
+    command.orderId = orderId;
+    command.reply = reply;
+    command.timestamp = currentTimestamp();
+    return pushCommand(command);
+}
+
+bool MatchingShard::modifyOrder(OrderId orderId, Price newPrice, int newQuantity, const ReplyRoute& reply) {
+    EngineCommand command;
+    command.type = EngineCommand::Type::MODIFY;
+    command.orderId = orderId;
+    command.newPrice = newPrice;
+    command.newQuantity = newQuantity;
+    command.reply = reply;
+    command.timestamp = currentTimestamp();
+    return pushCommand(command);
+}
+
+void MatchingShard::start() {
+    std::unique_lock<std::shared_mutex> lifecycle(queryMutex);
+    if (running.exchange(true)) {
+        return;
+    }
+    if (marketDataFeed) {
+        for (const auto& entry : books) {
+            marketDataFeed->addBook(*entry.second);
+        }
+    }
+    if (latencyMonitor && !latency) {
+        // Registered before the thread exists, so run() never sees it change
+        latency = latencyMonitor->registerThread("shard-" + std::to_string(shardId), std::thread::id());
+    }
+    thread = std::thread(&MatchingShard::run, this);
+}
+
+void MatchingShard::stop() {
+    // Waits out queries already past their running check, and holds later ones until the
+    // thread has drained the ring, as they are then answered inline
+    std::unique_lock<std::shared_mutex> lifecycle(queryMutex);
+    if (!running.exchange(false)) {
+        return;
+    }
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+OrderBook* MatchingShard::getOrderBook(const std::string& symbol) const {
+    auto it = books.find(symbol);
+    return it != books.end() ? it->second.get() : nullptr;
+}
+
+void MatchingShard::pinToCore() {
+#ifdef __linux__
+    if (cpuCore < 0) {
+        return;
+    }
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(cpuCore, &cpuSet);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+#endif
+}
+
+OrderBook* MatchingShard::batchBook(const EngineCommand& command) const {
+    // The front order names the batch's symbol
+    if (command.orders.empty() || !command.orders.front()) {
+        return nullptr;
+    }
+    return getOrderBook(command.orders.front()->getSymbol());
+}
+
+OrderBook* MatchingShard::findBook(OrderId orderId) const {
+    return findBookByIndex(getSymbolIndex(orderId));
+}
+
+OrderBook* MatchingShard::findBookByIndex(std::uint16_t symbolIndex) const {
+    return symbolIndex < booksByIndex.size() ? booksByIndex[symbolIndex] : nullptr;
+}
+
+void MatchingShard::run() {
+    pinToCore();
+
+    int idleSpins = 0;
+    while (true) {
+        size_t count = failed.load(std::memory_order_relaxed) ? 0 : queueExpiries();
+        while (count < batch.size() && ingress.tryPop(batch[count])) {
+            ++count;
+        }
+
+        if (count > 0) {
+            if (latency) {
+                std::uint64_t dequeued = CycleClock::now();
+                for (size_t i = 0; i < count; ++i) {
+                    if (batch[i].enqueueCycles != 0) {
+                        latency->recordBetween(LatencyStage::QUEUE_WAIT, batch[i].enqueueCycles, dequeued);
+                    }
+                }
+            }
+            if (eventLog && !failed.load(std::memory_order_relaxed)) {
+                std::uint64_t start = latency ? CycleClock::now() : 0;
+                if (!logBatch(count)) {
+                    failed.store(true, std::memory_order_relaxed);
+                }
+                if (latency) {
+                    latency->recordSince(LatencyStage::JOURNAL, start);
+                }
+            }
+            if (failed.load(std::memory_order_relaxed)) {
+                // Matching is over: nothing more can be made durable, so only queries are served
+                for (size_t i = 0; i < count; ++i) {
+                    if (batch[i].type == EngineCommand::Type::QUERY) {
+                        batch[i].query();
+                        batch[i].query = nullptr;
+                    }
+                    batch[i].order.reset();
+                    batch[i].orders.clear();
+                }
+                idleSpins = 0;
+                continue;
+            }
+            marketDataCycles = 0;
+            size_t queries = 0;
+            for (size_t i = 0; i < count; ++i) {
+                if (batch[i].type == EngineCommand::Type::QUERY) {
+                    // Answered between commands, so the book is never seen half-updated
+                    batch[i].query();
+                    batch[i].query = nullptr;
+                    ++queries;
+                    continue;
+                }
+                process(batch[i]);
+                batch[i].order.reset();
+                batch[i].orders.clear();
+            }
+            if (marketDataFeed) {
+                std::uint64_t start = latency ? CycleClock::now() : 0;
+                publishMarketData();
+                if (latency) {
+                    latency->record(LatencyStage::MARKET_DATA, marketDataCycles + (CycleClock::now() - start));
+                }
+            }
+
+            eventsSinceSnapshot += static_cast<long long>(count - queries);
+            if (snapshotInterval > 0 && eventsSinceSnapshot >= snapshotInterval) {
+                takeSnapshots();
+            }
+            idleSpins = 0;
+            continue;
+        }
+        if (!running.load(std::memory_order_relaxed)) {
+            break; // Ring drained after stop()
+        }
+        // Spin briefly so a busy shard reacts within nanoseconds, then back off
+        if (++idleSpins > 1000) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+size_t MatchingShard::queueExpiries() {
+    long long now = currentTimestamp();
+    if (now - lastExpiryCheck >= EXPIRY_CHECK_INTERVAL_MICROS) {
+        lastExpiryCheck = now;
+        for (OrderBook* book : booksByIndex) {
+            if (book && book->getPendingExpiryCount() > 0) {
+                book->collectExpiredOrders(now, pendingExpiries);
+            }
+        }
+    }
+
+    // Expiries go ahead of new commands, so nothing trades against an order past its deadline
+    size_t count = 0;
+    while (count < batch.size() && nextExpiry < pendingExpiries.size()) {
+        EngineCommand& command = batch[count++];
+        command.type = EngineCommand::Type::CANCEL;
+        command.orderId = pendingExpiries[nextExpiry++];
+        command.reply = ReplyRoute();
+        command.timestamp = now;
+        command.enqueueCycles = 0;
+    }
+    if (nextExpiry == pendingExpiries.size()) {
+        pendingExpiries.clear();
+        nextExpiry = 0;
+    }
+    return count;
+}
+
+bool MatchingShard::logBatch(size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        EngineCommand& command = batch[i];
+        switch (command.type) {
+            case EngineCommand::Type::SUBMIT: {
+                if (command.order) {
+                    SequencedEvent event = SequencedEvent::submit(*command.order);
+                    eventLog->append(event);
+                }
+                break;
+            }
+            case EngineCommand::Type::SUBMIT_BATCH: {
+                // Replay submits each order to its own symbol's book, so only the orders
+                // apply() lets reach the batch's book are logged; the rest never get an ID
+                const OrderBook* book = batchBook(command);
+                if (!book) {
+                    break;
+                }
+                for (const auto& order : command.orders) {
+                    if (order && order->getSymbol() == book->getSymbol()) {
+                        SequencedEvent event = SequencedEvent::submit(*order);
+                        eventLog->append(event);
+                    }
+                }
+                break;
+            }
+            case EngineCommand::Type::SUBMIT_ENTRY: {
+                OrderBook* book = findBookByIndex(command.symbolIndex);
+                if (book) {
+                    SequencedEvent event = SequencedEvent::submit(command.entry, book->getSymbol());
+                    eventLog->append(event);
+                }
+                break;
+            }
+            case EngineCommand::Type::CANCEL: {
+                SequencedEvent event = SequencedEvent::cancel(command.orderId, command.timestamp);
+                eventLog->append(event);
+                break;
+            }
+            case EngineCommand::Type::MODIFY: {
+                SequencedEvent event = SequencedEvent::modify(command.orderId, command.newPrice,
+                                                              command.newQuantity, command.timestamp);
+                eventLog->append(event);
+                break;
+            }
+            case EngineCommand::Type::QUERY:
+                break;  // Changes nothing, so there is nothing to replay
+        }
+    }
+
+    // Nothing may reach a book before it is durable; a failing write stalls the shard
+    // until it goes through, a lost sync fails it for good
+    while (!eventLog->commit()) {
+        if (eventLog->hasFailed()) {
+            return false;
+        }
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+void MatchingShard::process(EngineCommand& command) {
+    fills.clear();
+    std::uint64_t start = latency ? CycleClock::now() : 0;
+    OrderBook* book = apply(command);
+    if (latency) {
+        std::uint64_t applied = latency->recordSince(LatencyStage::MATCH, start);
+        if (command.enqueueCycles != 0) {
+            latency->recordBetween(LatencyStage::END_TO_END, command.enqueueCycles, applied);
+        }
+    }
+
+    commandsProcessed.fetch_add(1, std::memory_order_relaxed);
+    if (marketDataFeed && book) {
+        std::uint64_t published = latency ? CycleClock::now() : 0;
+        marketDataFeed->publishTrades(fills);
+        if (latency) {
+            marketDataCycles += CycleClock::now() - published;
+        }
+        if (std::find(touchedBooks.begin(), touchedBooks.end(), book) == touchedBooks.end()) {
+            touchedBooks.push_back(book);
+        }
+    }
+    if (book) {
+        deliverFills(*book);
+    }
+}
+
+void MatchingShard::deliverFills(const OrderBook& book) {
+    if (fills.empty()) {
+        return;
+    }
+    if (fillHandler) {
+        fillHandler(book, fills);
+    }
+    if (tradeHandler) {
+        // The only place a symbol string is attached to an execution
+        tradeScratch.clear();
+        tradeScratch.reserve(fills.size());
+        for (const Fill& fill : fills) {
+            tradeScratch.emplace_back(fill, book.getSymbol());
+        }
+        tradeHandler(tradeScratch);
+    }
+}
+
+void MatchingShard::publishMarketData() {
+    // One delta per changed level for the whole batch, however many commands touched it
+    for (OrderBook* book : touchedBooks) {
+        marketDataFeed->publishBook(*book);
+    }
+    touchedBooks.clear();
+    marketDataFeed->endBatch();
+}
+
+OrderBook* MatchingShard::apply(EngineCommand& command) {
+    switch (command.type) {
+        case EngineCommand::Type::SUBMIT: {
+            if (!command.order) {
+                return nullptr;
+            }
+            OrderBook* book = getOrderBook(command.order->getSymbol());
+            if (!book) {
+                command.order->setStatus(OrderStatus::REJECTED);
+                return nullptr;
+            }
+            try {
+                book->addOrder(command.order, fills);
+            } catch (const std::invalid_argument&) {
+                command.order->setStatus(OrderStatus::REJECTED);
+            }
+            reportFills(0);
+            reportCancelledStops(*book);
+            return book;
+        }
+        case EngineCommand::Type::SUBMIT_BATCH: {
+            // One symbol per batch; stray orders are rejected by the book
+            if (command.orders.empty() || !command.orders.front()) {
+                return nullptr;
+            }
+            OrderBook* book = batchBook(command);
+            if (!book) {
+                for (const auto& order : command.orders) {
+                    if (order) {
+                        order->setStatus(OrderStatus::REJECTED);
+                    }
+                }
+                return nullptr;
+            }
+            batchResults.clear();
+            book->addOrders(command.orders, fills, batchResults);
+            reportFills(0);
+            reportCancelledStops(*book);
+            return book;
+        }
+        case EngineCommand::Type::SUBMIT_ENTRY:
+            return applyEntry(command);
+        case EngineCommand::Type::CANCEL:
+            return applyCancel(command);
+        case EngineCommand::Type::MODIFY:
+            return applyModify(command);
+        case EngineCommand::Type::QUERY:
+            command.query();
+            return nullptr;
+    }
+    return nullptr;
+}
+
+OrderBook* MatchingShard::applyEntry(EngineCommand& command) {
+    ExecutionReport report;
+    report.clientOrderId = command.reply.clientOrderId;
+
+    OrderBook* book = findBookByIndex(command.symbolIndex);
+    if (!book) {
+        report.type = ExecutionReport::Type::REJECTED;
+        report.reason = Protocol::RejectReason::UNKNOWN_SYMBOL;
+        sendReport(command.reply, report);
+        return nullptr;
+    }
+
+    size_t firstTrade = fills.size();
+    OrderResult result(0, OrderStatus::REJECTED, 0, 0);
+    try {
+        result = book->addOrder(command.entry, fills);
+    } catch (const std::invalid_argument&) {
+        report.type = ExecutionReport::Type::REJECTED;
+        report.reason = Protocol::RejectReason::INVALID_ORDER;
+        sendReport(command.reply, report);
+        return book;
+    }
+
+    report.type = ExecutionReport::Type::ACCEPTED;
+    report.orderId = result.orderId;
+    report.status = result.status;
+    report.leavesQuantity = result.remainingQuantity;
+    sendReport(command.reply, report);
+
+    // The route is in place before the order's own trades are reported, so they
+    // reach its session like any later fill
+    if (command.reply.ring) {
+        orderRoutes[result.orderId] = OrderRoute{command.reply, command.entry.price, command.entry.quantity};
+    }
+    reportFills(firstTrade);
+    reportCancelledStops(*book);
+    if (result.remainingQuantity == 0) {
+        // An IOC, FOK or market remainder was cancelled on arrival. Once fills have reported
+        // open quantity, the session is told here, so its last message is never such a FILL
+        auto route = orderRoutes.find(result.orderId);
+        if (route != orderRoutes.end()) {
+            if (result.status == OrderStatus::CANCELLED && route->second.leavesQuantity < command.entry.quantity) {
+                ExecutionReport cancel;
+                cancel.type = ExecutionReport::Type::CANCELLED;
+                cancel.clientOrderId = route->second.reply.clientOrderId;
+                cancel.orderId = result.orderId;
+                sendReport(route->second.reply, cancel);
+            }
+            orderRoutes.erase(route);
+        }
+    }
+    return book;
+}
+
+OrderBook* MatchingShard::applyCancel(EngineCommand& command) {
+    OrderBook* book = findBook(command.orderId);
+    auto route = orderRoutes.find(command.orderId);
+
+    if (command.reply.ring) {
+        // A session may only cancel orders it entered itself
+        bool owned = route != orderRoutes.end() && route->second.reply.ring == command.reply.ring &&
+                     route->second.reply.sessionId == command.reply.sessionId;
+        bool cancelled = owned && book && book->cancelOrder(command.orderId);
+        if (owned) {
+            orderRoutes.erase(route);   // Cancelled now, or already gone from the book
+        }
+
+        ExecutionReport report;
+        report.type = cancelled ? ExecutionReport::Type::CANCELLED : ExecutionReport::Type::CANCEL_REJECTED;
+        report.reason = cancelled ? Protocol::RejectReason::NONE : Protocol::RejectReason::UNKNOWN_ORDER;
+        report.clientOrderId = command.reply.clientOrderId;
+        report.orderId = command.orderId;
+        sendReport(command.reply, report);
+        return book;
+    }
+
+    if (book && book->cancelOrder(command.orderId) && route != orderRoutes.end()) {
+        // Cancelled from outside the gateway: tell the session that owns the order
+        ExecutionReport report;
+        report.type = ExecutionReport::Type::CANCELLED;
+        report.clientOrderId = route->second.reply.clientOrderId;
+        report.orderId = command.orderId;
+        sendReport(route->second.reply, report);
+        orderRoutes.erase(route);
+    }
+    return book;
+}
+
+OrderBook* MatchingShard::applyModify(EngineCommand& command) {
+    OrderBook* book = findBook(command.orderId);
+    auto route = orderRoutes.find(command.orderId);
+
+    ExecutionReport report;
+    report.type = ExecutionReport::Type::REPLACE_REJECTED;
+    report.clientOrderId = command.reply.clientOrderId;
+    report.orderId = command.orderId;
+
+    if (command.reply.ring) {
+        bool owned = route != orderRoutes.end() && route->second.reply.ring == command.reply.ring &&
+                     route->second.reply.sessionId == command.reply.sessionId;
+        if (!owned || !book || book->getOpenQuantity(command.orderId) == 0) {
+            if (owned) {
+                orderRoutes.erase(route);
+            }
+            report.reason = Protocol::RejectReason::UNKNOWN_ORDER;
+            sendReport(command.reply, report);
+            return book;
+        }
+    }
+    if (!book) {
+        return nullptr;
+    }
+
+    try {
+        book->modifyOrder(command.orderId, command.newPrice, command.newQuantity, fills, command.timestamp);
+    } catch (const std::invalid_argument&) {
+        // Off-tick or out-of-band price; the order is left unchanged
+        report.reason = Protocol::RejectReason::INVALID_ORDER;
+        sendReport(command.reply, report);
+        return book;
+    }
+
+    if (route != orderRoutes.end()) {
+        // Like a FIX replace, the order is known by the new client ID from here on
+        OrderRoute& open = route->second;
+        if (command.reply.ring) {
+            open.reply.clientOrderId = command.reply.clientOrderId;
+        }
+        if (command.newPrice > 0) {
+            open.price = command.newPrice;
+        }
+        if (command.newQuantity > 0) {
+            open.leavesQuantity = command.newQuantity;
+        }
+        report.type = ExecutionReport::Type::REPLACED;
+        report.clientOrderId = open.reply.clientOrderId;
+        report.price = open.price;
+        report.leavesQuantity = open.leavesQuantity;
+        sendReport(open.reply, report);
+    }
+    reportFills(0);
+    reportCancelledStops(*book);
+    return book;
+}
+
+void MatchingShard::reportFills(size_t first) {
+    if (orderRoutes.empty()) {
+        return;
+    }
+    for (size_t i = first; i < fills.size(); ++i) {
+        reportFill(fills[i].buyOrderId, fills[i]);
+        reportFill(fills[i].sellOrderId, fills[i]);
+    }
+}
+
+void MatchingShard::reportFill(OrderId orderId, const Fill& fill) {
+    auto it = orderRoutes.find(orderId);
+    if (it == orderRoutes.end()) {
+        return;
+    }
+    OrderRoute& route = it->second;
+    route.leavesQuantity = std::max(0, route.leavesQuantity - fill.quantity);
+
+    ExecutionReport report;
+    report.type = ExecutionReport::Type::FILL;
+    report.clientOrderId = route.reply.clientOrderId;
+    report.orderId = orderId;
+    report.tradeId = fill.tradeId;
+    report.price = fill.price;
+    report.quantity = fill.quantity;
+    report.leavesQuantity = route.leavesQuantity;
+    sendReport(route.reply, report);
+
+    if (route.leavesQuantity == 0) {
+        orderRoutes.erase(it);
+    }
+}
+
+void MatchingShard::reportCancelledStops(const OrderBook& book) {
+    if (orderRoutes.empty()) {
+        return;
+    }
+    // A triggered stop's remainder is cancelled in the book, so its session is told
+    // here; the last message it sees is never a FILL that leaves quantity open
+    for (const CancelledStop& stop : book.getCancelledStops()) {
+        auto it = orderRoutes.find(stop.orderId);
+        if (it == orderRoutes.end()) {
+            continue;
+        }
+        ExecutionReport report;
+        report.type = ExecutionReport::Type::CANCELLED;
+        report.clientOrderId = it->second.reply.clientOrderId;
+        report.orderId = stop.orderId;
+        sendReport(it->second.reply, report);
+        orderRoutes.erase(it);
+    }
+}
+
+void MatchingShard::sendReport(const ReplyRoute& reply, ExecutionReport& report) {
+    if (!reply.ring) {
+        return;
+    }
+    report.sessionId = reply.sessionId;
+    // The matching thread never waits for a gateway; one that stops draining loses reports
+    if (!reply.ring->tryPush(report)) {
+        reportsDropped++;
+    }
+}
+
+void MatchingShard::setSnapshotPolicy(const std::string& directory, long long intervalEvents) {
+    snapshotDirectory = directory;
+    snapshotInterval = intervalEvents;
+}
+
+std::string MatchingShard::snapshotPath(const std::string& symbol) const {
+    return snapshotDirectory + "/" + symbol + ".snapshot";
+}
+
+bool MatchingShard::takeSnapshots() {
+    if (snapshotDirectory.empty()) {
+        return false;
+    }
+    if (snapshotWriter) {
+        return queueSnapshots();
+    }
+
+    std::uint64_t sequence = eventLog ? eventLog->getLastCommittedSequence() : 0;
+    std::string image;
+    bool complete = true;
+    for (const auto& entry : books) {
+        entry.second->writeSnapshot(image, sequence);
+        complete = SnapshotStore::writeFile(snapshotPath(entry.first), image) && complete;
+    }
+    eventsSinceSnapshot = 0;
+
+    // The log may only shrink once every book has a snapshot covering it
+    if (complete && eventLog) {
+        complete = eventLog->truncate();
+    }
+    return complete;
+}
+
+bool MatchingShard::queueSnapshots() {
+    if (snapshotRound.isInFlight()) {
+        return false; // Retried after the next batch
+    }
+
+    // Later events go to a fresh segment; the writer drops this one once the round is durable.
+    // Without a rotation the log just keeps growing until a later round succeeds.
+    std::uint64_t sequence = eventLog ? eventLog->getLastCommittedSequence() : 0;
+    if (eventLog) {
+        eventLog->rotate();
+    }
+
+    snapshotRound.images.resize(books.size());
+    snapshotRound.sources.resize(books.size(), nullptr);
+    snapshotRound.paths.resize(books.size());
+    snapshotRound.log = eventLog;
+    size_t i = 0;
+    for (const auto& entry : books) {
+        if (snapshotRound.sources[i] != entry.second.get()) {
+            snapshotRound.images[i] = BookImage();
+            snapshotRound.sources[i] = entry.second.get();
+            snapshotRound.paths[i] = snapshotPath(entry.first);
+        }
+        entry.second->captureSnapshot(snapshotRound.images[i], sequence);
+        ++i;
+    }
+    eventsSinceSnapshot = 0;
+    return snapshotWriter->submit(snapshotRound);
+}
+
+std::uint64_t MatchingShard::recover(const std::string& logPath) {
+    if (running.load()) {
+        throw std::invalid_argument("Recovery must run before the shard is started");
+    }
+
+    // Latest snapshot per book, remembering how far into the log each one reaches
+    std::unordered_map<const OrderBook*, std::uint64_t> snapshotSequence;
+    std::uint64_t highestSequence = 0;
+    std::string image;
+    for (const auto& entry : books) {
+        std::uint64_t sequence = 0;
+        if (!snapshotDirectory.empty() && SnapshotStore::readFile(snapshotPath(entry.first), image)) {
+            sequence = entry.second->restoreSnapshot(image);
+        }
+        snapshotSequence[entry.second.get()] = sequence;
+        highestSequence = std::max(highestSequence, sequence);
+    }
+
+    // Replay the tail; the shard thread is not running, so apply() runs here directly
+    for (const std::string& path : {WriteAheadLog::previousSegmentPath(logPath), logPath}) {
+        EventLogReader reader;
+        if (!reader.open(path)) {
+            continue;
+        }
+        SequencedEvent event;
+        while (reader.next(event)) {
+            highestSequence = std::max(highestSequence, event.sequence);
+
+            EngineCommand command;
+            OrderBook* book = commandFor(event, command);
+            if (!book || event.sequence <= snapshotSequence[book]) {
+                continue;
+            }
+
+            fills.clear();
+            apply(command);
+        }
+    }
+    replayedSequence = highestSequence;
+    return highestSequence;
+}
+
+size_t MatchingShard::replicate(const std::vector<SequencedEvent>& events) {
+    if (running.load()) {
+        throw std::invalid_argument("Replication must stop before the shard is started");
+    }
+
+    // A shard's log is in sequence order, so only a prefix can overlap what is already applied
+    size_t first = 0;
+    while (first < events.size() && events[first].sequence <= replayedSequence) {
+        ++first;
+    }
+    if (first == events.size()) {
+        return 0;
+    }
+    // Sequences are shared by every log, so a shard's own events are linked rather than
+    // numbered one apart; a broken link is a lost event and nothing after it can be applied
+    for (size_t i = first; i < events.size(); ++i) {
+        std::uint64_t expected = i == first ? replayedSequence : events[i - 1].sequence;
+        if (events[i].previousSequence != expected) {
+            throw std::runtime_error("Replicated events skip event(s) after sequence " + std::to_string(expected));
+        }
+    }
+    if (eventLog) {
+        for (size_t i = first; i < events.size(); ++i) {
+            eventLog->appendReplicated(events[i]);
+        }
+        while (!eventLog->commit()) {
+            if (eventLog->hasFailed()) {
+                throw std::runtime_error("Event log failed; replicated events were not applied");
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    for (size_t i = first; i < events.size(); ++i) {
+        EngineCommand command;
+        OrderBook* book = commandFor(events[i], command);
+        if (book) {
+            fills.clear();
+            apply(command);
+            commandsProcessed.fetch_add(1, std::memory_order_relaxed);
+            deliverFills(*book);
+        }
+        replayedSequence = events[i].sequence;
+    }
+
+    size_t applied = events.size() - first;
+    eventsSinceSnapshot += static_cast<long long>(applied);
+    if (snapshotInterval > 0 && eventsSinceSnapshot >= snapshotInterval) {
+        takeSnapshots();
+    }
+    return applied;
+}
+
+OrderBook* MatchingShard::commandFor(const SequencedEvent& event, EngineCommand& command) const {
+    if (event.type == EventType::SUBMIT) {
+        command.type = EngineCommand::Type::SUBMIT;
+        try {
+            command.order = event.toOrder();
+        } catch (const std::invalid_argument&) {
+            return nullptr; // Was rejected when it first arrived, too
+        }
+        return getOrderBook(event.symbol);
+    }
+
+    command.type = event.type == EventType::CANCEL ? EngineCommand::Type::CANCEL : EngineCommand::Type::MODIFY;
+    command.orderId = event.orderId;
+    command.newPrice = event.price;
+    command.newQuantity = event.quantity;
+    command.timestamp = event.timestamp;
+    return findBook(event.orderId);
+}
+
+} // namespace OrderMatchingEngine
\ No newline at end of file
@@ -0,0 +1,394 @@
+#ifndef MATCHING_SHARD_HPP
+#define MATCHING_SHARD_HPP
+
+#include "OrderBook.hpp"
+#include "RingBuffer.hpp"
+#include "EventLog.hpp"
+#include "MarketDataFeed.hpp"
+#include "OrderEntryProtocol.hpp"
+#include "LatencyMonitor.hpp"
+#include "SnapshotWriter.hpp"
+#include <unordered_map>
+#include <functional>
+#include <future>
+#include <memory>
+#include <shared_mutex>
+#include <thread>
+#include <atomic>
+#include <vector>
+
+namespace OrderMatchingEngine {
+
+/**
+ * @brief Outcome of an order entry command, sent back to the gateway session that owns the order
+ */
+struct ExecutionReport {
+    enum class Type : std::uint8_t {
+        ACCEPTED,
+        REJECTED,
+        FILL,
+        CANCELLED,
+        CANCEL_REJECTED,
+        REPLACED,
+        REPLACE_REJECTED
+    };
+
+    Type type;
+    Protocol::RejectReason reason;  // Rejections only
+    OrderStatus status;             // ACCEPTED only: status after matching on arrival
+    std::uint32_t sessionId;
+    std::uint64_t clientOrderId;    // Of the request being answered; FILL: of the order
+    OrderId orderId;
+    TradeId tradeId;                // FILL only
+    Price price;                    // FILL: trade price; REPLACED: price after the change
+    int quantity;                   // FILL only
+    int leavesQuantity;
+
+    ExecutionReport()
+        : type(Type::ACCEPTED), reason(Protocol::RejectReason::NONE), status(OrderStatus::PENDING),
+          sessionId(0), clientOrderId(0), orderId(0), tradeId(0), price(0), quantity(0), leavesQuantity(0) {}
+};
+
+using ReportRing = MpscRing<ExecutionReport>;
+
+/**
+ * @brief Where the reports for a command go
+ */
+struct ReplyRoute {
+    ReportRing* ring;               // nullptr: nobody is waiting for reports
+    std::uint32_t sessionId;
+    std::uint64_t clientOrderId;
+
+    ReplyRoute() : ring(nullptr), sessionId(0), clientOrderId(0) {}
+    ReplyRoute(ReportRing* ring, std::uint32_t sessionId, std::uint64_t clientOrderId)
+        : ring(ring), sessionId(sessionId), clientOrderId(clientOrderId) {}
+};
+
+/**
+ * @brief Request handed from a gateway thread to the shard that owns the symbol
+ */
+struct EngineCommand {
+    enum class Type : std::uint8_t {
+        SUBMIT,
+        SUBMIT_BATCH,
+        SUBMIT_ENTRY,
+        CANCEL,
+        MODIFY,
+        QUERY
+    };
+
+    Type type;
+    OrderPtr order;         // SUBMIT only
+    std::vector<OrderPtr> orders;   // SUBMIT_BATCH only, all for one symbol
+    OrderEntry entry;       // SUBMIT_ENTRY only
+    std::uint16_t symbolIndex;      // SUBMIT_ENTRY only
+    OrderId orderId;        // CANCEL and MODIFY
+    Price newPrice;         // MODIFY only (0 to keep current)
+    int newQuantity;        // MODIFY only (0 to keep current)
+    ReplyRoute reply;       // SUBMIT_ENTRY, and CANCEL/MODIFY sent by a gateway
+    long long timestamp;    // CANCEL and MODIFY: receive time, logged and stamped on a modify's fills
+    std::uint64_t enqueueCycles;    // CycleClock stamp taken at ingress (0 for the shard's own expiries)
+    std::function<void()> query;    // QUERY only: read-only work on the shard's books, never logged
+
+    EngineCommand()
+        : type(Type::SUBMIT), entry(), symbolIndex(0), orderId(0), newPrice(0), newQuantity(0), timestamp(0),
+          enqueueCycles(0) {}
+};
+
+/**
+ * @brief Matching thread that exclusively owns the order books of a group of symbols
+ *
+ * Gateway threads never touch a book directly: they push commands into the
+ * shard's lock-free ingress ring and the shard thread applies them in arrival
+ * order. Because every book has exactly one writer, books are created in
+ * single-writer mode and run without their mutex. Adding shards therefore
+ * adds matching capacity instead of contention on a shared queue.
+ *
+ * Orders whose DAY or GTD deadline has passed are cancelled by the shard
+ * thread itself: once per millisecond it advances each book's timer wheel and
+ * puts a cancel ahead of the next commands, so expiries are logged and
+ * reported like any other cancel.
+ *
+ * Matching never consults the wall clock: fills carry the time of the input
+ * that caused them, and expiries enter the log as cancels. The books are
+ * therefore a pure function of the logged inputs, which is what lets
+ * recover() and a standby's replicate() rebuild them exactly.
+ */
+class MatchingShard {
+public:
+    using TradeHandler = std::function<void(const std::vector<Trade>&)>;
+    using FillHandler = std::function<void(const OrderBook&, const std::vector<Fill>&)>;
+
+private:
+    /**
+     * @brief Open order entered through a gateway, so fills can be reported to its session
+     */
+    struct OrderRoute {
+        ReplyRoute reply;
+        Price price;
+        int leavesQuantity;
+    };
+
+    int shardId;
+    int cpuCore;            // Core the thread is pinned to (-1 to leave unpinned)
+
+    std::unordered_map<std::string, std::unique_ptr<OrderBook>> books;
+    std::vector<OrderBook*> booksByIndex;   // Symbol index (top bits of every OrderId) -> book
+
+    MpscRing<EngineCommand> ingress;
+    std::vector<EngineCommand> batch;       // Commands popped together and committed as one group
+    std::thread thread;
+    std::atomic<bool> running;
+    std::atomic<bool> failed;               // Event log failed: commands are dropped, queries still served
+    // Held shared by a query from its running check through its push, and exclusively by
+    // start() and by stop() until the thread has exited: a query either lands in the ring
+    // before the thread's final drain or is answered inline once nothing else reads the books
+    std::shared_mutex queryMutex;
+    alignas(CACHE_LINE_SIZE) std::atomic<long long> commandsProcessed;  // Polled by monitoring threads
+    TradeHandler tradeHandler;
+    FillHandler fillHandler;
+    std::unordered_map<OrderId, OrderRoute> orderRoutes;    // Shard thread only
+    long long reportsDropped;
+
+    // Per-command scratch, reused so steady-state matching does not allocate
+    std::vector<Fill> fills;
+    std::vector<OrderResult> batchResults;
+    std::vector<Trade> tradeScratch;        // Only filled for a TradeHandler
+
+    // DAY/GTD expiries collected from the books' timer wheels, applied as cancels
+    std::vector<OrderId> pendingExpiries;
+    size_t nextExpiry;
+    long long lastExpiryCheck;
+
+    // Market data output (optional)
+    MarketDataFeed* marketDataFeed;
+    std::vector<OrderBook*> touchedBooks;   // Books changed by the current command batch
+
+    // Per-stage latency histograms (optional), written by the shard thread only
+    LatencyMonitor* latencyMonitor;
+    ThreadLatencyRecorder* latency;
+    std::uint64_t marketDataCycles;         // Trade publishing of the current batch
+
+    // Durability (optional)
+    WriteAheadLog* eventLog;
+    std::string snapshotDirectory;
+    long long snapshotInterval;             // Events between snapshots (0 to disable)
+    long long eventsSinceSnapshot;
+    SnapshotWriter* snapshotWriter;         // Background encoding and writing (optional)
+    SnapshotRound snapshotRound;
+    std::uint64_t replayedSequence;         // Last log event rebuilt by recover() or replicate()
+
+    void run();
+    size_t queueExpiries();
+    bool logBatch(size_t count);
+    void process(EngineCommand& command);
+    void deliverFills(const OrderBook& book);
+    OrderBook* apply(EngineCommand& command);
+    OrderBook* commandFor(const SequencedEvent& event, EngineCommand& command) const;
+    OrderBook* applyEntry(EngineCommand& command);
+    OrderBook* applyCancel(EngineCommand& command);
+    OrderBook* applyModify(EngineCommand& command);
+    void sendReport(const ReplyRoute& reply, ExecutionReport& report);
+    void reportFills(size_t first);
+    void reportFill(OrderId orderId, const Fill& fill);
+    void reportCancelledStops(const OrderBook& book);
+    void publishMarketData();
+    bool pushCommand(EngineCommand& command);
+    template<typename Result, typename Query>
+    std::future<Result> pushQuery(Query query);
+    std::string snapshotPath(const std::string& symbol) const;
+    bool queueSnapshots();
+    void pinToCore();
+    OrderBook* batchBook(const EngineCommand& command) const;
+    OrderBook* findBook(OrderId orderId) const;
+    OrderBook* findBookByIndex(std::uint16_t symbolIndex) const;
+
+public:
+    /**
+     * @brief Constructor
+     * @param shardId Identifier used in logs and statistics
+     * @param ingressCapacity Ring size, rounded up to a power of two
+     * @param cpuCore Core to pin the matching thread to, or -1 for no pinning
+     */
+    MatchingShard(int shardId, size_t ingressCapacity, int cpuCore = -1);
+    ~MatchingShard();
+
+    MatchingShard(const MatchingShard&) = delete;
+    MatchingShard& operator=(const MatchingShard&) = delete;
+
+    /**
+     * @brief Give this shard ownership of a symbol (before start() only)
+     * The book is always created in single-writer mode.
+     * @throws std::invalid_argument if the shard is running or already owns the symbol
+     */
+    OrderBook* addSymbol(const std::string& symbol, const SymbolConfig& config);
+
+    /**
+     * @brief Set the callback that receives the trades of every command (before start() only)
+     * It runs on the shard thread and must not block. Trades carry the symbol as a
+     * string, so each one is built from the command's fills; prefer a FillHandler.
+     */
+    void setTradeHandler(TradeHandler handler) { tradeHandler = std::move(handler); }
+
+    /**
+     * @brief Set the callback that receives the fills of every command and their book (before start() only)
+     * The fill buffer is reused by the next command. Runs on the shard thread and must not block.
+     */
+    void setFillHandler(FillHandler handler) { fillHandler = std::move(handler); }
+
+    /**
+     * @brief Publish L1/L2 deltas and trade prints once per command batch (before start() only)
+     * The shard's books are registered with the feed by start(), after any recovery,
+     * and the shard thread becomes the feed's only publisher.
+     */
+    void setMarketDataFeed(MarketDataFeed* feed) { marketDataFeed = feed; }
+
+    /**
+     * @brief Write every command to a log before it is applied (before start() only)
+     * Commands popped together share one commit, so one fdatasync covers the group.
+     * The shard thread becomes the log's only writer.
+     */
+    void setEventLog(WriteAheadLog* log) { eventLog = log; }
+
+    /**
+     * @brief Time every command's queue wait, match and end-to-end latency, and every
+     *        batch's journal and market data publishing (before start() only)
+     * The shard thread records into its own recorder in the monitor; without a
+     * monitor only the ingress stamp is taken.
+     */
+    void setLatencyMonitor(LatencyMonitor* monitor) { latencyMonitor = monitor; }
+
+    /**
+     * @brief Snapshot every book each intervalEvents commands (before start() only)
+     * After a complete round of snapshots the event log is truncated.
+     */
+    void setSnapshotPolicy(const std::string& directory, long long intervalEvents);
+
+    /**
+     * @brief Encode and write snapshots on a background writer instead of the shard thread (before start() only)
+     * The writer must outlive the shard and keep running while the shard does.
+     */
+    void setSnapshotWriter(SnapshotWriter* writer) { snapshotWriter = writer; }
+
+    /**
+     * @brief Write a snapshot of every book and truncate the event log
+     * Call from the shard thread, or while the shard is stopped. With a snapshot
+     * writer the books are only captured here: the log is rotated at the same
+     * point and its previous segment deleted once the writer has made every
+     * snapshot durable. A round still being written defers the next one.
+     * @return False if any snapshot could not be written or queued; the log is then kept
+     */
+    bool takeSnapshots();
+
+    /**
+     * @brief Rebuild the books from their latest snapshots and the log tail (before start() only)
+     * A previous segment left by a background snapshot round is read before logPath.
+     * @return Highest sequence number seen, to resume the log's numbering with
+     */
+    std::uint64_t recover(const std::string& logPath);
+
+    /**
+     * @brief Follow a primary: log and apply events of the primary's log for this shard (before start() only)
+     * Events are applied exactly as the primary applied them, so books, order
+     * and trade IDs and fill timestamps come out identical, and fills reach the
+     * fill and trade handlers. Events at or below getReplayedSequence() are
+     * skipped, so the stream may overlap what recover() rebuilt. With an event
+     * log set they are committed first under their primary sequence numbers,
+     * and books are snapshotted by the snapshot policy, as on the primary.
+     * @return Number of events applied
+     * @throws std::runtime_error if the events do not continue from getReplayedSequence()
+     *         without a hole, or the event log fails; none of the events is applied
+     */
+    size_t replicate(const std::vector<SequencedEvent>& events);
+
+    std::uint64_t getReplayedSequence() const { return replayedSequence; }
+
+    // Ingress - safe to call from any thread; false means the ring is full or the shard has failed
+    bool submitOrder(OrderPtr order);
+    bool submitOrders(std::vector<OrderPtr> orders);    // One symbol, applied in one addOrders call;
+                                                        // orders for another symbol are rejected
+    bool cancelOrder(OrderId orderId);
+    bool modifyOrder(OrderId orderId, Price newPrice = 0, int newQuantity = 0);
+
+    /**
+     * @brief Order entry path: submit plain order fields and report the outcome to a gateway
+     * The shard sends an ACCEPTED or REJECTED report, then a FILL report for every
+     * trade of the order for as long as it stays open, and CANCELLED when the unfilled
+     * remainder of a partly filled IOC, FOK or market order, or of a triggered stop,
+     * is cancelled. Cancel and replace requests
+     * with a reply route are answered the same way and only act on orders entered
+     * through the same session.
+     */
+    bool submitEntry(std::uint16_t symbolIndex, const OrderEntry& entry, const ReplyRoute& reply);
+    bool cancelOrder(OrderId orderId, const ReplyRoute& reply);
+    bool modifyOrder(OrderId orderId, Price newPrice, int newQuantity, const ReplyRoute& reply);
+
+    /**
+     * @brief Start the matching thread
+     */
+    void start();
+
+    /**
+     * @brief Drain the ingress ring and stop the matching thread
+     */
+    void stop();
+
+    bool isRunning() const { return running.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Whether the event log failed for good, e.g. on a lost fdatasync
+     * The failed batch and every later command are dropped without being applied;
+     * the thread only answers queries until stop().
+     */
+    bool hasFailed() const { return failed.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Read-only queries answered by the shard thread between command batches
+     * Per-order lookups and depth beyond MarketDataSnapshot::MAX_DEPTH read a
+     * book's pool and levels, which nobody but the shard thread may touch while
+     * it runs. Each call queues a QUERY command behind the commands already in
+     * the ring; the future is ready once the shard has served it. A stopped shard
+     * answers on the calling thread.
+     * @return The answer, or an invalid future if the ring is full
+     */
+    std::future<OrderPtr> queryOrder(OrderId orderId);
+    std::future<OrderId> queryOrderId(const std::string& symbol, const std::string& clientOrderId);
+    std::future<std::vector<OrderPtr>> queryUserOrders(const std::string& userId);  // Over all the shard's books
+    std::future<std::vector<std::pair<Price, int>>> queryMarketDepth(const std::string& symbol, int levels,
+                                                                     bool buySide);
+
+    /**
+     * @brief Get a book owned by this shard
+     * Only its published snapshot (getMarketData, and depth up to MAX_DEPTH) may be
+     * read from other threads while the shard runs; use the query methods for the rest.
+     */
+    OrderBook* getOrderBook(const std::string& symbol) const;
+
+    int getShardId() const { return shardId; }
+    long long getCommandsProcessed() const { return commandsProcessed.load(std::memory_order_relaxed); }
+    long long getReportsDropped() const { return reportsDropped; }     // Shard thread or after stop()
+};
+
+template<typename Result, typename Query>
+std::future<Result> MatchingShard::pushQuery(Query query) {
+    // std::function must be copyable, so the promise is shared with the command
+    auto promise = std::make_shared<std::promise<Result>>();
+    std::future<Result> result = promise->get_future();
+    std::shared_lock<std::shared_mutex> lifecycle(queryMutex);
+    if (!running.load(std::memory_order_relaxed)) {
+        promise->set_value(query());
+        return result;
+    }
+
+    EngineCommand command;
+    command.type = EngineCommand::Type::QUERY;
+    command.query = [promise, query]() { promise->set_value(query()); };
+    if (!pushCommand(command)) {
+        return std::future<Result>();
+    }
+    return result;
+}
+
+} // namespace OrderMatchingEngine
+
+#endif // MATCHING_SHARD_HPP
\ No newline at end of file
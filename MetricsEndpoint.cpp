@@ -0,0 +1,148 @@
+#include "MetricsEndpoint.hpp"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+namespace OrderMatchingEngine {
+
+namespace {
+
+const int ACCEPT_POLL_MILLIS = 100;     // How quickly stop() is noticed
+const int REQUEST_TIMEOUT_SECONDS = 2;
+const size_t MAX_REQUEST_SIZE = 8192;
+
+void sendAll(int socket, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t bytes = ::send(socket, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (bytes < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytes <= 0) {
+            return;     // Scraper went away or stalled past the timeout
+        }
+        sent += static_cast<size_t>(bytes);
+    }
+}
+
+std::string httpResponse(const char* status, const char* contentType, const std::string& body) {
+    std::string response = "HTTP/1.1 ";
+    response += status;
+    response += "\r\nContent-Type: ";
+    response += contentType;
+    response += "\r\nContent-Length: " + std::to_string(body.size());
+    response += "\r\nConnection: close\r\n\r\n";
+    response += body;
+    return response;
+}
+
+} // namespace
+
+MetricsEndpoint::MetricsEndpoint(const std::string& bindAddress, std::uint16_t port, Provider provider)
+    : bindAddress(bindAddress), port(port), boundPort(0), provider(std::move(provider)), listenSocket(-1),
+      running(false), scrapesServed(0) {
+}
+
+MetricsEndpoint::~MetricsEndpoint() {
+    stop();
+}
+
+bool MetricsEndpoint::start() {
+    if (running.load()) {
+        return true;
+    }
+
+    listenSocket = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listenSocket < 0) {
+        return false;
+    }
+    int enable = 1;
+    ::setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    if (::inet_pton(AF_INET, bindAddress.c_str(), &address.sin_addr) != 1 ||
+        ::bind(listenSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(listenSocket, 16) != 0) {
+        ::close(listenSocket);
+        listenSocket = -1;
+        return false;
+    }
+    socklen_t length = sizeof(address);
+    ::getsockname(listenSocket, reinterpret_cast<sockaddr*>(&address), &length);
+    boundPort = ntohs(address.sin_port);
+
+    running.store(true);
+    thread = std::thread(&MetricsEndpoint::run, this);
+    return true;
+}
+
+void MetricsEndpoint::stop() {
+    if (!running.exchange(false)) {
+        return;
+    }
+    if (thread.joinable()) {
+        thread.join();
+    }
+    ::close(listenSocket);
+    listenSocket = -1;
+}
+
+void MetricsEndpoint::run() {
+    while (running.load(std::memory_order_relaxed)) {
+        pollfd listener;
+        listener.fd = listenSocket;
+        listener.events = POLLIN;
+        listener.revents = 0;
+        if (::poll(&listener, 1, ACCEPT_POLL_MILLIS) <= 0) {
+            continue;
+        }
+        int socket = ::accept4(listenSocket, nullptr, nullptr, SOCK_CLOEXEC);
+        if (socket < 0) {
+            continue;
+        }
+        serve(socket);
+        ::close(socket);
+    }
+}
+
+void MetricsEndpoint::serve(int socket) {
+    // A scraper that connects and says nothing must not hold the endpoint for long
+    timeval timeout;
+    timeout.tv_sec = REQUEST_TIMEOUT_SECONDS;
+    timeout.tv_usec = 0;
+    ::setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    ::setsockopt(socket, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    // Only the request line matters; the headers are read so the client sees a clean close
+    std::string request;
+    char buffer[1024];
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < MAX_REQUEST_SIZE) {
+        ssize_t bytes = ::recv(socket, buffer, sizeof(buffer), 0);
+        if (bytes < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytes <= 0) {
+            break;
+        }
+        request.append(buffer, static_cast<size_t>(bytes));
+    }
+
+    std::string requestLine = request.substr(0, request.find("\r\n"));
+    bool scrape = requestLine.compare(0, 13, "GET /metrics ") == 0 || requestLine.compare(0, 6, "GET / ") == 0;
+    if (!scrape) {
+        sendAll(socket, httpResponse("404 Not Found", "text/plain", "Not found\n"));
+        return;
+    }
+    sendAll(socket, httpResponse("200 OK", "text/plain; version=0.0.4", provider ? provider() : std::string()));
+    scrapesServed.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace OrderMatchingEngine
\ No newline at end of file
@@ -0,0 +1,69 @@
+#ifndef METRICS_ENDPOINT_HPP
+#define METRICS_ENDPOINT_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+
+namespace OrderMatchingEngine {
+
+/**
+ * @brief Minimal HTTP endpoint that serves metrics text to a scraper
+ *
+ * One background thread accepts a connection at a time, reads the request
+ * line and answers GET /metrics (or /) with whatever the provider returns,
+ * as text/plain in the Prometheus exposition format. Scrapes run entirely on
+ * this thread, so the cost of building the text never lands on an engine
+ * thread. Anything else gets a 404; requests are not kept alive.
+ */
+class MetricsEndpoint {
+public:
+    using Provider = std::function<std::string()>;
+
+private:
+    std::string bindAddress;
+    std::uint16_t port;
+    std::uint16_t boundPort;
+    Provider provider;
+    int listenSocket;
+
+    std::thread thread;
+    std::atomic<bool> running;
+    std::atomic<long long> scrapesServed;
+
+    void run();
+    void serve(int socket);
+
+public:
+    /**
+     * @brief Constructor
+     * @param port 0 picks a free port, see getPort()
+     * @param provider Builds the response body; called on the endpoint's thread
+     */
+    MetricsEndpoint(const std::string& bindAddress, std::uint16_t port, Provider provider);
+    ~MetricsEndpoint();
+
+    MetricsEndpoint(const MetricsEndpoint&) = delete;
+    MetricsEndpoint& operator=(const MetricsEndpoint&) = delete;
+
+    /**
+     * @brief Listen and start the endpoint thread
+     * @return False if the listening socket could not be set up
+     */
+    bool start();
+
+    /**
+     * @brief Stop the endpoint thread and close the listening socket
+     */
+    void stop();
+
+    bool isRunning() const { return running.load(std::memory_order_relaxed); }
+    std::uint16_t getPort() const { return boundPort; }     // Valid after start()
+    long long getScrapesServed() const { return scrapesServed.load(std::memory_order_relaxed); }
+};
+
+} // namespace OrderMatchingEngine
+
+#endif // METRICS_ENDPOINT_HPP
\ No newline at end of file
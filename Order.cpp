@@ -4,23 +4,21 @@
 
 namespace OrderMatchingEngine {
 
-Order::Order(const std::string& orderId,
+Order::Order(const std::string& clientOrderId,
              const std::string& userId,
              const std::string& symbol,
              OrderType type,
              OrderSide side,
-             double price,
+             Price price,
              int quantity,
-             double triggerPrice)
-    : orderId(orderId), userId(userId), symbol(symbol), type(type), side(side),
+             Price triggerPrice)
+    : orderId(0), clientOrderId(clientOrderId), userId(userId), symbol(symbol),
+      type(type), side(side),
       price(price), quantity(quantity), remainingQuantity(quantity),
       status(OrderStatus::PENDING), timestamp(getCurrentTimestamp()),
-      triggerPrice(triggerPrice) {
+      triggerPrice(triggerPrice), timeInForce(TimeInForce::GTC), expireTime(0) {
 
     // Validation
-    if (orderId.empty()) {
-        throw std::invalid_argument("Order ID cannot be empty");
-    }
     if (userId.empty()) {
         throw std::invalid_argument("User ID cannot be empty");
     }
@@ -39,16 +37,19 @@ Order::Order(const std::string& orderId,
 }
 
 Order::Order(const Order& other)
-    : orderId(other.orderId), userId(other.userId), symbol(other.symbol),
+    : orderId(other.orderId), clientOrderId(other.clientOrderId),
+      userId(other.userId), symbol(other.symbol),
       type(other.type), side(other.side), price(other.price),
       quantity(other.quantity), remainingQuantity(other.remainingQuantity),
       status(other.status), timestamp(other.timestamp),
-      triggerPrice(other.triggerPrice) {
+      triggerPrice(other.triggerPrice), timeInForce(other.timeInForce),
+      expireTime(other.expireTime) {
 }
 
 Order& Order::operator=(const Order& other) {
     if (this != &other) {
         orderId = other.orderId;
+        clientOrderId = other.clientOrderId;
         userId = other.userId;
         symbol = other.symbol;
         type = other.type;
@@ -59,6 +60,8 @@ Order& Order::operator=(const Order& other) {
         status = other.status;
         timestamp = other.timestamp;
         triggerPrice = other.triggerPrice;
+        timeInForce = other.timeInForce;
+        expireTime = other.expireTime;
     }
     return *this;
 }
@@ -67,6 +70,14 @@ Order::~Order() {
     // Nothing to clean up explicitly
 }
 
+void Order::setTimeInForce(TimeInForce newTimeInForce, long long newExpireTime) {
+    if (newTimeInForce == TimeInForce::GTD && newExpireTime <= 0) {
+        throw std::invalid_argument("GTD orders need an expire time");
+    }
+    timeInForce = newTimeInForce;
+    expireTime = newTimeInForce == TimeInForce::GTD ? newExpireTime : 0;
+}
+
 void Order::setQuantity(int newQuantity) {
     if (newQuantity <= 0) {
         throw std::invalid_argument("Quantity must be positive");
@@ -75,6 +86,15 @@ void Order::setQuantity(int newQuantity) {
     remainingQuantity = newQuantity;
 }
 
+void Order::setRemainingQuantity(int newRemainingQuantity) {
+    if (newRemainingQuantity <= 0) {
+        throw std::invalid_argument("Remaining quantity must be positive");
+    }
+    // Keep the original quantity covering what was already filled
+    quantity += newRemainingQuantity - remainingQuantity;
+    remainingQuantity = newRemainingQuantity;
+}
+
 bool Order::fillOrder(int filledQuantity) {
     if (filledQuantity <= 0 || filledQuantity > remainingQuantity) {
         throw std::invalid_argument("Invalid filled quantity");
@@ -131,21 +151,31 @@ bool Order::isCompatibleWith(const Order& other) const {
     return false;
 }
 
-std::string Order::toString() const {
+std::string Order::toString(const PriceScale& scale) const {
     std::stringstream ss;
-    ss << "Order[ID=" << orderId 
-       << ", User=" << userId 
+    ss << "Order[ID=" << orderId;
+    if (!clientOrderId.empty()) {
+        ss << ", ClientID=" << clientOrderId;
+    }
+    ss << ", User=" << userId 
        << ", Symbol=" << symbol
        << ", Type=" << (type == OrderType::LIMIT ? "LIMIT" : 
                        type == OrderType::MARKET ? "MARKET" : "STOP_LOSS")
        << ", Side=" << (side == OrderSide::BUY ? "BUY" : "SELL")
-       << ", Price=" << price
+       << ", Price=" << scale.toDouble(price)
        << ", Qty=" << quantity
        << ", Remaining=" << remainingQuantity
        << ", Status=" << static_cast<int>(status)
        << ", Timestamp=" << timestamp;
     if (triggerPrice > 0) {
-        ss << ", TriggerPrice=" << triggerPrice;
+        ss << ", TriggerPrice=" << scale.toDouble(triggerPrice);
+    }
+    if (timeInForce != TimeInForce::GTC) {
+        static const char* const names[] = {"GTC", "DAY", "IOC", "FOK", "GTD"};
+        ss << ", TIF=" << names[static_cast<int>(timeInForce)];
+        if (expireTime > 0) {
+            ss << ", ExpireTime=" << expireTime;
+        }
     }
     ss << "]";
     return ss.str();
@@ -180,4 +210,13 @@ long long Order::getCurrentTimestamp() {
         std::chrono::high_resolution_clock::now().time_since_epoch()).count();
 }
 
+// OrderEntry implementation
+std::string OrderEntry::getUserId() const {
+    size_t length = 0;
+    while (length < USER_ID_SIZE && userId[length] != '\0') {
+        ++length;
+    }
+    return std::string(userId, length);
+}
+
 } // namespace OrderMatchingEngine
\ No newline at end of file
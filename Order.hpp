@@ -4,13 +4,59 @@
 #include <string>
 #include <chrono>
 #include <memory>
+#include <cstdint>
+#include <cmath>
 
 namespace OrderMatchingEngine {
 
+/**
+ * @brief Fixed-point price expressed as an integer number of ticks
+ */
+using Price = std::int64_t;
+
+/**
+ * @brief Conversion between decimal prices and integer ticks for one symbol
+ * 
+ * Prices stay in ticks everywhere inside the engine; converting to and from
+ * decimals only happens where orders enter and where prices are displayed.
+ */
+struct PriceScale {
+    static constexpr Price DEFAULT_TICKS_PER_UNIT = 10000; // 4 decimal places
+
+    Price ticksPerUnit;     // Number of ticks in one unit of currency
+
+    explicit PriceScale(Price ticksPerUnit = DEFAULT_TICKS_PER_UNIT)
+        : ticksPerUnit(ticksPerUnit) {}
+
+    Price toTicks(double price) const { return std::llround(price * ticksPerUnit); }
+    double toDouble(Price ticks) const { return static_cast<double>(ticks) / ticksPerUnit; }
+};
+
+/**
+ * @brief Engine-assigned 64-bit order and trade identifiers
+ * 
+ * The top bits carry the symbol index of the order book that owns the ID and
+ * the low bits a per-symbol sequence number, so an ID alone routes to its book
+ * and hashes as a plain integer. 0 is never assigned and means "no ID".
+ */
+using OrderId = std::uint64_t;
+using TradeId = std::uint64_t;
+
+constexpr int ID_SEQUENCE_BITS = 48;
+constexpr std::uint64_t ID_SEQUENCE_MASK = (std::uint64_t(1) << ID_SEQUENCE_BITS) - 1;
+
+inline std::uint64_t makeEngineId(std::uint16_t symbolIndex, std::uint64_t sequence) {
+    return (static_cast<std::uint64_t>(symbolIndex) << ID_SEQUENCE_BITS) | (sequence & ID_SEQUENCE_MASK);
+}
+
+inline std::uint16_t getSymbolIndex(std::uint64_t engineId) {
+    return static_cast<std::uint16_t>(engineId >> ID_SEQUENCE_BITS);
+}
+
 /**
  * @brief Enum representing the order type
  */
-enum class OrderType {
+enum class OrderType : std::uint8_t {
     LIMIT,      // Limit order - execute at specified price or better
     MARKET,     // Market order - execute immediately at best available price
     STOP_LOSS   // Stop-loss order - convert to market order when trigger price reached
@@ -19,15 +65,26 @@ enum class OrderType {
 /**
  * @brief Enum representing the order side (Buy or Sell)
  */
-enum class OrderSide {
+enum class OrderSide : std::uint8_t {
     BUY,    // Buy order
     SELL    // Sell order
 };
 
+/**
+ * @brief How long an order may stay open
+ */
+enum class TimeInForce : std::uint8_t {
+    GTC,    // Good till cancelled
+    DAY,    // Expires at the symbol's session close
+    IOC,    // Immediate or cancel - whatever does not fill on arrival is cancelled
+    FOK,    // Fill or kill - fills completely on arrival or not at all
+    GTD     // Good till date - expires at the order's expire time
+};
+
 /**
  * @brief Enum representing the current status of an order
  */
-enum class OrderStatus {
+enum class OrderStatus : std::uint8_t {
     PENDING,        // Order is waiting in the order book
     PARTIAL_FILL,   // Order is partially filled
     FILLED,         // Order is completely filled
@@ -44,39 +101,42 @@ enum class OrderStatus {
  */
 class Order {
 private:
-    std::string orderId;        // Unique identifier for the order
+    OrderId orderId;            // Engine-assigned unique identifier (0 until accepted)
+    std::string clientOrderId;  // Optional identifier chosen by the client
     std::string userId;         // User who placed the order
     std::string symbol;         // Trading symbol (e.g., "AAPL", "MSFT")
     OrderType type;             // Type of order (LIMIT, MARKET, STOP_LOSS)
     OrderSide side;             // Side of the order (BUY/SELL)
-    double price;               // Price per unit (0 for market orders)
+    Price price;                // Price per unit in ticks (0 for market orders)
     int quantity;               // Number of shares/units
     int remainingQuantity;      // Remaining quantity to be filled
     OrderStatus status;         // Current status of the order
     long long timestamp;        // Creation timestamp (microseconds since epoch)
-    double triggerPrice;        // Trigger price for stop-loss orders (0 if not applicable)
+    Price triggerPrice;         // Trigger price in ticks for stop-loss orders (0 if not applicable)
+    TimeInForce timeInForce;    // GTC unless set
+    long long expireTime;       // GTD deadline (microseconds since epoch, 0 if not applicable)
 
 public:
     /**
      * @brief Constructor for creating a new order
      * 
-     * @param orderId Unique identifier for the order
+     * @param clientOrderId Client-chosen identifier (may be empty)
      * @param userId User placing the order
      * @param symbol Trading symbol
      * @param type Type of order
      * @param side Buy or sell
-     * @param price Price per unit
+     * @param price Price per unit in ticks (see PriceScale)
      * @param quantity Number of units
-     * @param triggerPrice Trigger price for stop-loss orders (default: 0.0)
+     * @param triggerPrice Trigger price in ticks for stop-loss orders (default: 0)
      */
-    Order(const std::string& orderId,
+    Order(const std::string& clientOrderId,
           const std::string& userId,
           const std::string& symbol,
           OrderType type,
           OrderSide side,
-          double price,
+          Price price,
           int quantity,
-          double triggerPrice = 0.0);
+          Price triggerPrice = 0);
 
     // Copy constructor
     Order(const Order& other);
@@ -88,23 +148,36 @@ public:
     ~Order();
 
     // Getters
-    const std::string& getOrderId() const { return orderId; }
+    OrderId getOrderId() const { return orderId; }
+    const std::string& getClientOrderId() const { return clientOrderId; }
     const std::string& getUserId() const { return userId; }
     const std::string& getSymbol() const { return symbol; }
     OrderType getType() const { return type; }
     OrderSide getSide() const { return side; }
-    double getPrice() const { return price; }
+    Price getPrice() const { return price; }
     int getQuantity() const { return quantity; }
     int getRemainingQuantity() const { return remainingQuantity; }
     OrderStatus getStatus() const { return status; }
     long long getTimestamp() const { return timestamp; }
-    double getTriggerPrice() const { return triggerPrice; }
+    Price getTriggerPrice() const { return triggerPrice; }
+    TimeInForce getTimeInForce() const { return timeInForce; }
+    long long getExpireTime() const { return expireTime; }
 
     // Setters
-    void setPrice(double newPrice) { price = newPrice; }
+    void setOrderId(OrderId newOrderId) { orderId = newOrderId; }
+    void setPrice(Price newPrice) { price = newPrice; }
     void setQuantity(int newQuantity);
+    void setRemainingQuantity(int newRemainingQuantity);
     void setStatus(OrderStatus newStatus) { status = newStatus; }
-    void setTriggerPrice(double newTriggerPrice) { triggerPrice = newTriggerPrice; }
+    void setTriggerPrice(Price newTriggerPrice) { triggerPrice = newTriggerPrice; }
+    void setTimestamp(long long newTimestamp) { timestamp = newTimestamp; }
+
+    /**
+     * @brief Set the time in force
+     * @param newExpireTime Deadline in microseconds since epoch, required for GTD
+     * @throws std::invalid_argument if a GTD order has no expire time
+     */
+    void setTimeInForce(TimeInForce newTimeInForce, long long newExpireTime = 0);
 
     /**
      * @brief Reduces the remaining quantity after a partial or full fill
@@ -149,8 +222,9 @@ public:
 
     /**
      * @brief Converts the order to a string representation
+     * @param scale Price scale used to print prices as decimals
      */
-    std::string toString() const;
+    std::string toString(const PriceScale& scale = PriceScale()) const;
 
     /**
      * @brief Comparison operators for priority queue ordering
@@ -173,6 +247,27 @@ private:
  */
 using OrderPtr = std::shared_ptr<Order>;
 
+/**
+ * @brief New-order fields without strings or heap storage, as decoded from a binary
+ *        order entry message; the symbol is implied by the book it is submitted to
+ */
+struct OrderEntry {
+    static constexpr size_t USER_ID_SIZE = 16;
+
+    OrderId orderId;                // 0 to let the book assign one
+    Price price;                    // Limit price in ticks (ignored for market orders)
+    Price triggerPrice;             // Stop-loss trigger in ticks
+    long long timestamp;            // Receive time, microseconds since epoch
+    long long expireTime;           // GTD deadline, microseconds since epoch
+    int quantity;
+    OrderType type;
+    OrderSide side;
+    TimeInForce timeInForce;
+    char userId[USER_ID_SIZE];      // NUL-padded, at most 15 characters
+
+    std::string getUserId() const;  // Short enough for the small-string buffer: no allocation
+};
+
 /**
  * @brief Comparator for buy orders (max-heap - highest price first)
  */
@@ -1,4 +1,5 @@
 #include "OrderBook.hpp"
+#include "BinaryCodec.hpp"
 #include <algorithm>
 #include <iostream>
 #include <sstream>
@@ -8,81 +9,262 @@
 namespace OrderMatchingEngine {
 
 // Trade implementation
-Trade::Trade(const std::string& tradeId, const std::string& buyOrderId,
-             const std::string& sellOrderId, const std::string& symbol,
-             double price, int quantity)
+Trade::Trade(TradeId tradeId, OrderId buyOrderId, OrderId sellOrderId,
+             const std::string& symbol, Price price, int quantity, long long timestamp)
     : tradeId(tradeId), buyOrderId(buyOrderId), sellOrderId(sellOrderId),
-      symbol(symbol), price(price), quantity(quantity),
-      timestamp(std::chrono::duration_cast<std::chrono::microseconds>(
-          std::chrono::high_resolution_clock::now().time_since_epoch()).count()) {
+      symbol(symbol), price(price), quantity(quantity), timestamp(timestamp) {
 }
 
-std::string Trade::toString() const {
+Trade::Trade(const Fill& fill, const std::string& symbol)
+    : tradeId(fill.tradeId), buyOrderId(fill.buyOrderId), sellOrderId(fill.sellOrderId),
+      symbol(symbol), price(fill.price), quantity(fill.quantity), timestamp(fill.timestamp) {
+}
+
+std::string Trade::toString(const PriceScale& scale) const {
     std::stringstream ss;
     ss << "Trade[ID=" << tradeId 
        << ", BuyOrder=" << buyOrderId 
        << ", SellOrder=" << sellOrderId
        << ", Symbol=" << symbol
-       << ", Price=" << std::fixed << std::setprecision(2) << price
+       << ", Price=" << std::fixed << std::setprecision(2) << scale.toDouble(price)
        << ", Quantity=" << quantity
        << ", Timestamp=" << timestamp << "]";
     return ss.str();
 }
 
 // PriceLevel implementation
-PriceLevel::PriceLevel(double price) : price(price), totalQuantity(0), orderCount(0) {
+PriceLevel::PriceLevel(Price price)
+    : price(price), totalQuantity(0), orderCount(0),
+      head(NULL_ORDER_INDEX), tail(NULL_ORDER_INDEX) {
 }
 
-void PriceLevel::addOrder(const OrderPtr& order) {
-    orders.push(order);
-    totalQuantity += order->getRemainingQuantity();
+void PriceLevel::addOrder(OrderPool& pool, OrderIndex index) {
+    BookOrder& order = pool[index];
+    order.prevInLevel = tail;
+    order.nextInLevel = NULL_ORDER_INDEX;
+
+    if (tail != NULL_ORDER_INDEX) {
+        pool[tail].nextInLevel = index;
+    } else {
+        head = index;
+    }
+    tail = index;
+
+    totalQuantity += order.remainingQuantity;
     orderCount++;
 }
 
-OrderPtr PriceLevel::removeOrder(const std::string& orderId) {
-    std::queue<OrderPtr> tempQueue;
-    OrderPtr foundOrder = nullptr;
+void PriceLevel::removeOrder(OrderPool& pool, OrderIndex index) {
+    BookOrder& order = pool[index];
 
-    while (!orders.empty()) {
-        auto order = orders.front();
-        orders.pop();
+    if (order.prevInLevel != NULL_ORDER_INDEX) {
+        pool[order.prevInLevel].nextInLevel = order.nextInLevel;
+    } else {
+        head = order.nextInLevel;
+    }
 
-        if (order->getOrderId() == orderId) {
-            foundOrder = order;
-            totalQuantity -= order->getRemainingQuantity();
-            orderCount--;
-        } else {
-            tempQueue.push(order);
+    if (order.nextInLevel != NULL_ORDER_INDEX) {
+        pool[order.nextInLevel].prevInLevel = order.prevInLevel;
+    } else {
+        tail = order.prevInLevel;
+    }
+
+    order.prevInLevel = NULL_ORDER_INDEX;
+    order.nextInLevel = NULL_ORDER_INDEX;
+
+    totalQuantity -= order.remainingQuantity;
+    orderCount--;
+}
+
+std::vector<OrderIndex> PriceLevel::getAllOrders(const OrderPool& pool) const {
+    std::vector<OrderIndex> result;
+    result.reserve(orderCount);
+
+    for (OrderIndex index = head; index != NULL_ORDER_INDEX; index = pool[index].nextInLevel) {
+        result.push_back(index);
+    }
+
+    return result;
+}
+
+// PriceLadder implementation
+int PriceLadderConfig::getLevelCount() const {
+    return static_cast<int>((maxPrice - minPrice) / tickSize) + 1;
+}
+
+PriceLadder::PriceLadder(const PriceLadderConfig& config, bool bidSide)
+    : config(config), bidSide(bidSide), activeLevels(0), bestIndex(-1) {
+
+    if (config.tickSize <= 0) {
+        throw std::invalid_argument("Ladder tick size must be positive");
+    }
+    if (config.minPrice <= 0 || config.maxPrice < config.minPrice ||
+        (config.maxPrice - config.minPrice) % config.tickSize != 0) {
+        throw std::invalid_argument("Ladder price band is invalid");
+    }
+
+    int levelCount = config.getLevelCount();
+    levels.reserve(levelCount);
+    for (int i = 0; i < levelCount; ++i) {
+        levels.emplace_back(config.minPrice + i * config.tickSize);
+    }
+    occupied.assign((levelCount + 63) / 64, 0);
+}
+
+bool PriceLadder::acceptsPrice(Price price) const {
+    return price >= config.minPrice && price <= config.maxPrice &&
+           (price - config.minPrice) % config.tickSize == 0;
+}
+
+long PriceLadder::scanUp(long from) const {
+    if (from < 0) {
+        from = 0;
+    }
+    size_t word = static_cast<size_t>(from) >> 6;
+    if (word >= occupied.size()) {
+        return -1;
+    }
+
+    uint64_t bits = occupied[word] & (~0ULL << (from & 63));
+    while (true) {
+        if (bits) {
+            return static_cast<long>((word << 6) + __builtin_ctzll(bits));
+        }
+        if (++word == occupied.size()) {
+            return -1;
         }
+        bits = occupied[word];
+    }
+}
+
+long PriceLadder::scanDown(long from) const {
+    if (from < 0) {
+        return -1;
     }
+    size_t word = static_cast<size_t>(from) >> 6;
 
-    orders = tempQueue;
-    return foundOrder;
+    uint64_t bits = occupied[word] & (~0ULL >> (63 - (from & 63)));
+    while (true) {
+        if (bits) {
+            return static_cast<long>((word << 6) + 63 - __builtin_clzll(bits));
+        }
+        if (word == 0) {
+            return -1;
+        }
+        bits = occupied[--word];
+    }
 }
 
-OrderPtr PriceLevel::getFirstOrder() {
-    return orders.empty() ? nullptr : orders.front();
+PriceLevel& PriceLadder::getOrCreateLevel(Price price) {
+    if (!acceptsPrice(price)) {
+        throw std::invalid_argument("Price is off-tick or outside the ladder price band");
+    }
+
+    long index = static_cast<long>((price - config.minPrice) / config.tickSize);
+    uint64_t mask = 1ULL << (index & 63);
+    uint64_t& word = occupied[index >> 6];
+
+    if (!(word & mask)) {
+        word |= mask;
+        activeLevels++;
+        if (bestIndex < 0 || (bidSide ? index > bestIndex : index < bestIndex)) {
+            bestIndex = index;
+        }
+    }
+
+    return levels[index];
 }
 
-bool PriceLevel::isEmpty() const {
-    return orders.empty();
+void PriceLadder::removeLevel(PriceLevel* level) {
+    long index = indexOf(level);
+    uint64_t mask = 1ULL << (index & 63);
+    uint64_t& word = occupied[index >> 6];
+
+    if (!(word & mask)) {
+        return;
+    }
+
+    word &= ~mask;
+    activeLevels--;
+
+    // Move the best-price cursor to the next occupied level
+    if (index == bestIndex) {
+        bestIndex = bidSide ? scanDown(index - 1) : scanUp(index + 1);
+    }
 }
 
-std::vector<OrderPtr> PriceLevel::getAllOrders() const {
-    std::vector<OrderPtr> result;
-    std::queue<OrderPtr> tempQueue = orders;
+const PriceLevel* PriceLadder::nextLevel(const PriceLevel* level) const {
+    long index = indexOf(level);
+    long next = bidSide ? scanDown(index - 1) : scanUp(index + 1);
+    return next < 0 ? nullptr : &levels[next];
+}
 
-    while (!tempQueue.empty()) {
-        result.push_back(tempQueue.front());
-        tempQueue.pop();
+// BookSide implementation
+BookSide::BookSide(bool bidSide, const SymbolConfig& config) : bidSide(bidSide) {
+    if (config.usePriceLadder) {
+        ladder = std::make_unique<PriceLadder>(config.ladder, bidSide);
     }
+}
 
-    return result;
+bool BookSide::acceptsPrice(Price price) const {
+    return ladder ? ladder->acceptsPrice(price) : price > 0;
+}
+
+PriceLevel& BookSide::getOrCreateLevel(Price price) {
+    if (ladder) {
+        return ladder->getOrCreateLevel(price);
+    }
+    return tree.try_emplace(price, price).first->second;
+}
+
+void BookSide::removeLevel(PriceLevel* level) {
+    if (ladder) {
+        ladder->removeLevel(level);
+    } else {
+        tree.erase(level->getPrice());
+    }
+}
+
+PriceLevel* BookSide::bestLevel() {
+    if (ladder) {
+        return ladder->bestLevel();
+    }
+    if (tree.empty()) {
+        return nullptr;
+    }
+    return bidSide ? &tree.rbegin()->second : &tree.begin()->second;
+}
+
+const PriceLevel* BookSide::bestLevel() const {
+    return const_cast<BookSide*>(this)->bestLevel();
+}
+
+int BookSide::availableQuantity(Price limitPrice, bool anyPrice, int wanted) const {
+    auto crosses = [&](Price price) {
+        return anyPrice || (bidSide ? price >= limitPrice : price <= limitPrice);
+    };
+
+    int available = 0;
+    if (ladder) {
+        for (const PriceLevel* level = ladder->bestLevel();
+             level && available < wanted && crosses(level->getPrice()); level = ladder->nextLevel(level)) {
+            available += level->getTotalQuantity();
+        }
+    } else if (bidSide) {
+        for (auto it = tree.rbegin(); it != tree.rend() && available < wanted && crosses(it->first); ++it) {
+            available += it->second.getTotalQuantity();
+        }
+    } else {
+        for (auto it = tree.begin(); it != tree.end() && available < wanted && crosses(it->first); ++it) {
+            available += it->second.getTotalQuantity();
+        }
+    }
+    return available;
 }
 
 // AVL Tree implementation
 template<typename T, typename Compare>
-AVLTree<T, Compare>::AVLTree() : root(nullptr) {
+AVLTree<T, Compare>::AVLTree() : root(nullptr), nodeCount(0) {
 }
 
 template<typename T, typename Compare>
@@ -91,12 +273,12 @@ AVLTree<T, Compare>::~AVLTree() {
 }
 
 template<typename T, typename Compare>
-int AVLTree<T, Compare>::getHeight(std::shared_ptr<Node> node) {
+int AVLTree<T, Compare>::getHeight(const std::shared_ptr<Node>& node) const {
     return node ? node->height : 0;
 }
 
 template<typename T, typename Compare>
-int AVLTree<T, Compare>::getBalance(std::shared_ptr<Node> node) {
+int AVLTree<T, Compare>::getBalance(const std::shared_ptr<Node>& node) const {
     return node ? getHeight(node->left) - getHeight(node->right) : 0;
 }
 
@@ -130,11 +312,37 @@ AVLTree<T, Compare>::rotateLeft(std::shared_ptr<Node> x) {
     return y;
 }
 
+template<typename T, typename Compare>
+std::shared_ptr<typename AVLTree<T, Compare>::Node> 
+AVLTree<T, Compare>::rebalance(std::shared_ptr<Node> node) {
+    node->height = 1 + std::max(getHeight(node->left), getHeight(node->right));
+    int balance = getBalance(node);
+
+    // Left heavy: rotate the left child first if it leans right
+    if (balance > 1) {
+        if (getBalance(node->left) < 0) {
+            node->left = rotateLeft(node->left);
+        }
+        return rotateRight(node);
+    }
+
+    // Right heavy: rotate the right child first if it leans left
+    if (balance < -1) {
+        if (getBalance(node->right) > 0) {
+            node->right = rotateRight(node->right);
+        }
+        return rotateLeft(node);
+    }
+
+    return node;
+}
+
 template<typename T, typename Compare>
 std::shared_ptr<typename AVLTree<T, Compare>::Node> 
 AVLTree<T, Compare>::insert(std::shared_ptr<Node> node, const T& data) {
     // Standard BST insertion
     if (!node) {
+        nodeCount++;
         return std::make_shared<Node>(data);
     }
 
@@ -146,34 +354,38 @@ AVLTree<T, Compare>::insert(std::shared_ptr<Node> node, const T& data) {
         return node; // Equal keys not allowed
     }
 
-    // Update height
-    node->height = 1 + std::max(getHeight(node->left), getHeight(node->right));
-
-    // Get balance factor
-    int balance = getBalance(node);
+    return rebalance(node);
+}
 
-    // Left Left Case
-    if (balance > 1 && comp(data, node->left->data)) {
-        return rotateRight(node);
+template<typename T, typename Compare>
+std::shared_ptr<typename AVLTree<T, Compare>::Node> 
+AVLTree<T, Compare>::remove(std::shared_ptr<Node> node, const T& data) {
+    if (!node) {
+        return node; // Not found
     }
 
-    // Right Right Case
-    if (balance < -1 && comp(node->right->data, data)) {
-        return rotateLeft(node);
+    if (comp(data, node->data)) {
+        node->left = remove(node->left, data);
+    } else if (comp(node->data, data)) {
+        node->right = remove(node->right, data);
+    } else if (!node->left || !node->right) {
+        // Zero or one child: splice the node out
+        nodeCount--;
+        return node->left ? node->left : node->right;
+    } else {
+        // Two children: take the in-order successor's value, then delete the successor
+        node->data = findMin(node->right.get())->data;
+        node->right = remove(node->right, node->data);
     }
 
-    // Left Right Case
-    if (balance > 1 && comp(node->left->data, data)) {
-        node->left = rotateLeft(node->left);
-        return rotateRight(node);
-    }
+    return rebalance(node);
+}
 
-    // Right Left Case
-    if (balance < -1 && comp(data, node->right->data)) {
-        node->right = rotateRight(node->right);
-        return rotateLeft(node);
+template<typename T, typename Compare>
+typename AVLTree<T, Compare>::Node* AVLTree<T, Compare>::findMin(Node* node) const {
+    while (node && node->left) {
+        node = node->left.get();
     }
-
     return node;
 }
 
@@ -182,23 +394,167 @@ void AVLTree<T, Compare>::insert(const T& data) {
     root = insert(root, data);
 }
 
+template<typename T, typename Compare>
+void AVLTree<T, Compare>::remove(const T& data) {
+    root = remove(root, data);
+}
+
+template<typename T, typename Compare>
+T* AVLTree<T, Compare>::find(const T& data) {
+    Node* node = root.get();
+    while (node) {
+        if (comp(data, node->data)) {
+            node = node->left.get();
+        } else if (comp(node->data, data)) {
+            node = node->right.get();
+        } else {
+            return &node->data;
+        }
+    }
+    return nullptr;
+}
+
+template<typename T, typename Compare>
+T* AVLTree<T, Compare>::getMin() {
+    Node* node = findMin(root.get());
+    return node ? &node->data : nullptr;
+}
+
+template<typename T, typename Compare>
+T* AVLTree<T, Compare>::getMax() {
+    Node* node = root.get();
+    while (node && node->right) {
+        node = node->right.get();
+    }
+    return node ? &node->data : nullptr;
+}
+
 template<typename T, typename Compare>
 bool AVLTree<T, Compare>::empty() const {
     return root == nullptr;
 }
 
+template<typename T, typename Compare>
+std::vector<T> AVLTree<T, Compare>::inOrderTraversal() const {
+    std::vector<T> result;
+    result.reserve(nodeCount);
+
+    std::vector<const Node*> path;
+    const Node* node = root.get();
+    while (node || !path.empty()) {
+        while (node) {
+            path.push_back(node);
+            node = node->left.get();
+        }
+        node = path.back();
+        path.pop_back();
+        result.push_back(node->data);
+        node = node->right.get();
+    }
+    return result;
+}
+
 // OrderBook implementation
-OrderBook::OrderBook(const std::string& symbol) 
-    : symbol(symbol), totalTrades(0), totalVolume(0.0), lastTradePrice(0.0) {
+namespace {
+
+const long long EXPIRY_RESOLUTION_MICROS = 1000;   // DAY/GTD orders expire within a millisecond
+
+long long wallClockMicros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::high_resolution_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+OrderBook::OrderBook(const std::string& symbol, const SymbolConfig& config) 
+    : symbol(symbol), symbolIndex(config.symbolIndex), priceScale(config.priceScale),
+      nextOrderSequence(0), nextTradeSequence(0),
+      buyLevels(true, config), sellLevels(false, config),
+      buyOrderCount(0), sellOrderCount(0), singleWriter(config.singleWriter),
+      totalTrades(0), totalVolume(0), lastTradePrice(0), lastTradeTimestamp(0),
+      inputTimestamp(0), expiryTimers(EXPIRY_RESOLUTION_MICROS), sessionCloseMicros(config.sessionCloseMicros),
+      marketDataVersion(0) {
+    publishMarketData();
 }
 
 OrderBook::~OrderBook() {
-    // Smart pointers will handle cleanup
+    // Records live in the pool's slabs and are freed with it
 }
 
 std::vector<Trade> OrderBook::addOrder(const OrderPtr& order) {
-    std::lock_guard<std::mutex> lock(orderBookMutex);
+    auto lock = lockBook();
+
+    cancelledStops.clear();
+    fillScratch.clear();
+    submitOrder(order, fillScratch);
+    publishMarketData();
+
+    std::vector<Trade> trades;
+    appendTrades(fillScratch, trades);
+    return trades;
+}
+
+void OrderBook::addOrder(const OrderPtr& order, std::vector<Fill>& fills) {
+    auto lock = lockBook();
+
+    cancelledStops.clear();
+    submitOrder(order, fills);
+    publishMarketData();
+}
+
+void OrderBook::addOrders(const std::vector<OrderPtr>& orders, BatchResult& result) {
+    auto lock = lockBook();
+
+    cancelledStops.clear();
+    fillScratch.clear();
+    size_t firstResult = result.orders.size();
+    submitOrders(orders, fillScratch, result.orders);
+
+    // Trade ranges were counted in fillScratch; shift them past the trades already in result
+    for (size_t i = firstResult; i < result.orders.size(); ++i) {
+        result.orders[i].firstTrade += result.trades.size();
+    }
+    appendTrades(fillScratch, result.trades);
+}
+
+void OrderBook::addOrders(const std::vector<OrderPtr>& orders, std::vector<Fill>& fills,
+                          std::vector<OrderResult>& results) {
+    auto lock = lockBook();
 
+    cancelledStops.clear();
+    submitOrders(orders, fills, results);
+}
+
+void OrderBook::submitOrders(const std::vector<OrderPtr>& orders, std::vector<Fill>& fills,
+                             std::vector<OrderResult>& results) {
+    results.reserve(results.size() + orders.size());
+    for (const auto& order : orders) {
+        size_t firstTrade = fills.size();
+        try {
+            submitOrder(order, fills);
+        } catch (const std::invalid_argument&) {
+            if (order) {
+                order->setStatus(OrderStatus::REJECTED);
+            }
+        }
+        results.emplace_back(order ? order->getOrderId() : 0,
+                             order ? order->getStatus() : OrderStatus::REJECTED,
+                             firstTrade, fills.size() - firstTrade,
+                             order && (order->getStatus() == OrderStatus::PENDING ||
+                                       order->getStatus() == OrderStatus::PARTIAL_FILL)
+                                 ? order->getRemainingQuantity() : 0);
+    }
+    publishMarketData();
+}
+
+void OrderBook::appendTrades(const std::vector<Fill>& fills, std::vector<Trade>& trades) const {
+    trades.reserve(trades.size() + fills.size());
+    for (const Fill& fill : fills) {
+        trades.emplace_back(fill, symbol);
+    }
+}
+
+void OrderBook::submitOrder(const OrderPtr& order, std::vector<Fill>& fills) {
     if (!order) {
         throw std::invalid_argument("Order cannot be null");
     }
@@ -207,243 +563,1079 @@ std::vector<Trade> OrderBook::addOrder(const OrderPtr& order) {
         throw std::invalid_argument("Order symbol does not match order book symbol");
     }
 
-    std::vector<Trade> trades;
+    if (order->isLimit() && !buyLevels.acceptsPrice(order->getPrice())) {
+        throw std::invalid_argument("Order price is not valid for this order book");
+    }
 
-    // Handle stop-loss orders
-    if (order->isStopLoss()) {
-        if (order->isBuy()) {
-            buyStopLossOrders.insert(order);
-        } else {
-            sellStopLossOrders.insert(order);
-        }
-        addToOrderBook(order);
-        return trades; // Stop-loss orders don't immediately match
+    if (order->getOrderId() != 0 && orderMap.count(order->getOrderId())) {
+        throw std::invalid_argument("Duplicate order ID");
+    }
+
+    if (!order->getClientOrderId().empty() && clientOrderIds.count(order->getClientOrderId())) {
+        throw std::invalid_argument("Duplicate client order ID");
     }
 
-    // Attempt to match the order
-    trades = matchOrder(order);
+    long long expireTime = resolveExpireTime(order->getTimeInForce(), order->getExpireTime(),
+                                             order->getTimestamp());
 
-    // If the order is not completely filled, add it to the order book
-    if (order->getRemainingQuantity() > 0) {
-        addToOrderBook(order);
+    // Orders that did not come through the engine get an ID from this book
+    if (order->getOrderId() == 0) {
+        order->setOrderId(makeEngineId(symbolIndex, ++nextOrderSequence));
     }
 
-    // Check if any stop-loss orders should be triggered
-    if (!trades.empty()) {
-        checkStopLossOrders(trades.back().price);
+    OrderIndex index = createRecord(*order);
+    orderPool.details(index).expireTime = expireTime;
+    int remainingQuantity;
+    OrderStatus status = submitRecord(index, fills, remainingQuantity);
+
+    // Report the outcome on the caller's order
+    if (remainingQuantity < order->getRemainingQuantity()) {
+        order->fillOrder(order->getRemainingQuantity() - remainingQuantity);
     }
+    if (status == OrderStatus::CANCELLED) {
+        order->setStatus(OrderStatus::CANCELLED);
+    }
+}
 
-    return trades;
+OrderResult OrderBook::addOrder(const OrderEntry& entry, std::vector<Trade>& trades) {
+    auto lock = lockBook();
+
+    cancelledStops.clear();
+    fillScratch.clear();
+    OrderResult result = submitEntry(entry, fillScratch);
+    result.firstTrade = trades.size();
+    appendTrades(fillScratch, trades);
+    return result;
 }
 
-std::vector<Trade> OrderBook::matchOrder(const OrderPtr& incomingOrder) {
-    std::vector<Trade> trades;
+OrderResult OrderBook::addOrder(const OrderEntry& entry, std::vector<Fill>& fills) {
+    auto lock = lockBook();
 
-    if (incomingOrder->isBuy()) {
-        // Match buy order against sell orders
-        while (!sellOrders.empty() && incomingOrder->getRemainingQuantity() > 0) {
-            auto bestSellOrder = sellOrders.top();
+    cancelledStops.clear();
+    return submitEntry(entry, fills);
+}
 
-            // Check if orders can be matched
-            if (!incomingOrder->isCompatibleWith(*bestSellOrder)) {
-                break;
-            }
+OrderResult OrderBook::submitEntry(const OrderEntry& entry, std::vector<Fill>& fills) {
+    if (entry.quantity <= 0) {
+        throw std::invalid_argument("Quantity must be positive");
+    }
+    if (entry.userId[0] == '\0') {
+        throw std::invalid_argument("User ID cannot be empty");
+    }
+    if (entry.type == OrderType::LIMIT &&
+        (entry.price <= 0 || !buyLevels.acceptsPrice(entry.price))) {
+        throw std::invalid_argument("Order price is not valid for this order book");
+    }
+    if (entry.type == OrderType::STOP_LOSS && entry.triggerPrice <= 0) {
+        throw std::invalid_argument("Stop-loss trigger price must be positive");
+    }
+    if (entry.orderId != 0 && orderMap.count(entry.orderId)) {
+        throw std::invalid_argument("Duplicate order ID");
+    }
+    long long expireTime = resolveExpireTime(entry.timeInForce, entry.expireTime, entry.timestamp);
+
+    OrderIndex index = orderPool.acquire();
+    BookOrder& record = orderPool[index];
+    OrderDetails& details = orderPool.details(index);
+    record.price = entry.type == OrderType::MARKET ? 0 : entry.price;
+    details.triggerPrice = entry.triggerPrice;
+    details.timestamp = entry.timestamp;
+    details.quantity = record.remainingQuantity = entry.quantity;
+    details.userIndex = userIds.intern(entry.getUserId());
+    record.type = entry.type;
+    record.side = entry.side;
+    record.status = OrderStatus::PENDING;
+    record.timeInForce = entry.timeInForce;
+    record.prevInLevel = record.nextInLevel = NULL_ORDER_INDEX;
+    details.prevForUser = details.nextForUser = NULL_ORDER_INDEX;
+    details.level = nullptr;
+    record.orderId = entry.orderId != 0 ? entry.orderId : makeEngineId(symbolIndex, ++nextOrderSequence);
+    details.clientOrderId = nullptr;    // Gateways keep their own client ID mapping
+    details.expireTime = expireTime;
+    details.expiryTimer = NULL_TIMER_ID;
+
+    OrderId orderId = record.orderId;
+    size_t firstTrade = fills.size();
+    int remainingQuantity;
+    OrderStatus status = submitRecord(index, fills, remainingQuantity);
+    publishMarketData();
+
+    return OrderResult(orderId, status, firstTrade, fills.size() - firstTrade,
+                       status == OrderStatus::CANCELLED ? 0 : remainingQuantity);
+}
 
-            sellOrders.pop();
+OrderStatus OrderBook::submitRecord(OrderIndex index, std::vector<Fill>& fills, int& remainingQuantity) {
+    size_t firstTrade = fills.size();
+    BookOrder& record = orderPool[index];
+    OrderDetails& details = orderPool.details(index);
+    inputTimestamp = details.timestamp != 0 ? details.timestamp : wallClockMicros();
 
-            // Determine trade price and quantity
-            double tradePrice = bestSellOrder->getPrice();
-            if (bestSellOrder->isMarket()) {
-                tradePrice = incomingOrder->isMarket() ? lastTradePrice : incomingOrder->getPrice();
-            }
+    // Handle stop-loss orders
+    if (record.isStopLoss()) {
+        addStopLoss(index);
+        addToOrderBook(index);
+
+        // A stop whose trigger has already been crossed fires straight away, and
+        // is filled or cancelled and released before checkStopLossOrders returns
+        StopOutcome outcome{index, record.remainingQuantity, record.status};
+        checkStopLossOrders(fills, &outcome);
+        remainingQuantity = outcome.remainingQuantity;
+        return outcome.status;
+    }
 
-            int tradeQuantity = std::min(incomingOrder->getRemainingQuantity(),
-                                       bestSellOrder->getRemainingQuantity());
+    // Attempt to match the order; fill-or-kill only trades if it can fill completely
+    if (record.timeInForce != TimeInForce::FOK || canFillCompletely(record)) {
+        matchOrder(index, fills);
+    }
+    remainingQuantity = record.remainingQuantity;
+    OrderStatus status = record.status;
+
+    // If the order is not completely filled, rest it in the order book.
+    // Market, IOC and FOK orders never rest: whatever could not be filled is cancelled.
+    bool mayRest = !record.isMarket() && record.timeInForce != TimeInForce::IOC &&
+                   record.timeInForce != TimeInForce::FOK;
+    if (record.remainingQuantity > 0 && mayRest) {
+        addToOrderBook(index);
+    } else {
+        if (record.remainingQuantity > 0) {
+            status = OrderStatus::CANCELLED;
+        }
+        orderPool.release(index);
+    }
 
-            // Execute the trade
-            Trade trade = executeTrade(incomingOrder, bestSellOrder, tradePrice, tradeQuantity);
-            trades.push_back(trade);
+    // Check if any stop-loss orders should be triggered
+    if (fills.size() > firstTrade) {
+        checkStopLossOrders(fills);
+    }
+    return status;
+}
 
-            // If sell order still has remaining quantity, put it back
-            if (bestSellOrder->getRemainingQuantity() > 0) {
-                sellOrders.push(bestSellOrder);
-            } else {
-                removeFromOrderBook(bestSellOrder->getOrderId());
-            }
+void OrderBook::matchOrder(OrderIndex incomingIndex, std::vector<Fill>& fills) {
+    // Side and order type are fixed for the whole sweep, so they are resolved once here
+    const BookOrder& incomingOrder = orderPool[incomingIndex];
+    if (incomingOrder.isBuy()) {
+        if (incomingOrder.isMarket()) {
+            sweepLevels<OrderSide::BUY, OrderType::MARKET>(incomingIndex, fills);
+        } else {
+            sweepLevels<OrderSide::BUY, OrderType::LIMIT>(incomingIndex, fills);
         }
     } else {
-        // Match sell order against buy orders
-        while (!buyOrders.empty() && incomingOrder->getRemainingQuantity() > 0) {
-            auto bestBuyOrder = buyOrders.top();
+        if (incomingOrder.isMarket()) {
+            sweepLevels<OrderSide::SELL, OrderType::MARKET>(incomingIndex, fills);
+        } else {
+            sweepLevels<OrderSide::SELL, OrderType::LIMIT>(incomingIndex, fills);
+        }
+    }
+}
 
-            // Check if orders can be matched
-            if (!incomingOrder->isCompatibleWith(*bestBuyOrder)) {
-                break;
-            }
+template<OrderSide Side, OrderType Type>
+void OrderBook::sweepLevels(OrderIndex incomingIndex, std::vector<Fill>& fills) {
+    static_assert(Type == OrderType::LIMIT || Type == OrderType::MARKET,
+                  "Stops are matched as market orders once triggered");
+    constexpr bool isBuy = Side == OrderSide::BUY;
 
-            buyOrders.pop();
+    BookOrder& incomingOrder = orderPool[incomingIndex];
+    BookSide& opposite = isBuy ? sellLevels : buyLevels;    // Best (lowest) asks or best (highest) bids first
+    int& oppositeOrderCount = isBuy ? sellOrderCount : buyOrderCount;
+    const Price limitPrice = incomingOrder.price;
 
-            // Determine trade price and quantity
-            double tradePrice = bestBuyOrder->getPrice();
-            if (bestBuyOrder->isMarket()) {
-                tradePrice = incomingOrder->isMarket() ? lastTradePrice : incomingOrder->getPrice();
-            }
+    // Every fill of one input happens at its time, never the wall clock's
+    const long long timestamp = inputTimestamp;
 
-            int tradeQuantity = std::min(incomingOrder->getRemainingQuantity(),
-                                       bestBuyOrder->getRemainingQuantity());
+    while (incomingOrder.remainingQuantity > 0 && !opposite.empty()) {
+        PriceLevel& level = *opposite.bestLevel();
+        const Price levelPrice = level.getPrice();
 
-            // Execute the trade
-            Trade trade = executeTrade(bestBuyOrder, incomingOrder, tradePrice, tradeQuantity);
-            trades.push_back(trade);
+        // Check if the best level crosses; a market order takes any price
+        if constexpr (Type == OrderType::LIMIT) {
+            if (isBuy ? limitPrice < levelPrice : limitPrice > levelPrice) {
+                break;
+            }
+        }
 
-            // If buy order still has remaining quantity, put it back
-            if (bestBuyOrder->getRemainingQuantity() > 0) {
-                buyOrders.push(bestBuyOrder);
+        while (incomingOrder.remainingQuantity > 0 && !level.isEmpty()) {
+            OrderIndex restingIndex = level.getFirstOrder();
+            BookOrder& restingOrder = orderPool[restingIndex];
+
+            // Resting orders are always limit orders, so they set the trade price
+            int tradeQuantity = std::min(incomingOrder.remainingQuantity, restingOrder.remainingQuantity);
+            if constexpr (isBuy) {
+                fills.push_back(executeTrade(incomingOrder, restingOrder, levelPrice, tradeQuantity, timestamp));
             } else {
-                removeFromOrderBook(bestBuyOrder->getOrderId());
+                fills.push_back(executeTrade(restingOrder, incomingOrder, levelPrice, tradeQuantity, timestamp));
+            }
+            level.reduceQuantity(tradeQuantity);
+
+            // Fully filled resting orders leave the book
+            if (restingOrder.remainingQuantity == 0) {
+                level.removeOrder(orderPool, restingIndex);
+                orderPool.details(restingIndex).level = nullptr;
+                oppositeOrderCount--;
+                removeFromOrderBook(restingIndex);
             }
         }
-    }
 
-    return trades;
+        if (level.isEmpty()) {
+            opposite.removeLevel(&level);
+        }
+    }
 }
 
-Trade OrderBook::executeTrade(const OrderPtr& buyOrder, const OrderPtr& sellOrder,
-                             double price, int quantity) {
+Fill OrderBook::executeTrade(BookOrder& buyOrder, BookOrder& sellOrder,
+                            Price price, int quantity, long long timestamp) {
     // Fill both orders
-    buyOrder->fillOrder(quantity);
-    sellOrder->fillOrder(quantity);
-
-    // Generate trade
-    std::string tradeId = generateTradeId();
-    Trade trade(tradeId, buyOrder->getOrderId(), sellOrder->getOrderId(),
-                symbol, price, quantity);
+    buyOrder.fill(quantity);
+    sellOrder.fill(quantity);
+
+    // Generate the fill record; strings are only attached if a consumer asks for a Trade
+    Fill fill;
+    fill.tradeId = generateTradeId();
+    fill.buyOrderId = buyOrder.orderId;
+    fill.sellOrderId = sellOrder.orderId;
+    fill.price = price;
+    fill.quantity = quantity;
+    fill.timestamp = timestamp;
 
     // Update statistics
     totalTrades++;
     totalVolume += quantity;
     lastTradePrice = price;
+    lastTradeTimestamp = timestamp;
+
+    return fill;
+}
 
-    return trade;
+OrderIndex OrderBook::createRecord(const Order& order) {
+    OrderIndex index = orderPool.acquire();
+    BookOrder& record = orderPool[index];
+    OrderDetails& details = orderPool.details(index);
+
+    record.price = order.getPrice();
+    details.triggerPrice = order.getTriggerPrice();
+    details.timestamp = order.getTimestamp();
+    details.quantity = order.getQuantity();
+    record.remainingQuantity = order.getRemainingQuantity();
+    details.userIndex = userIds.intern(order.getUserId());
+    record.type = order.getType();
+    record.side = order.getSide();
+    record.status = order.getStatus();
+    record.timeInForce = order.getTimeInForce();
+    record.prevInLevel = record.nextInLevel = NULL_ORDER_INDEX;
+    details.prevForUser = details.nextForUser = NULL_ORDER_INDEX;
+    details.level = nullptr;
+    record.orderId = order.getOrderId();
+
+    // Repointed at the side-mapping key if the order rests
+    details.clientOrderId = order.getClientOrderId().empty() ? nullptr : &order.getClientOrderId();
+    details.expireTime = order.getExpireTime();
+    details.expiryTimer = NULL_TIMER_ID;
+
+    return index;
 }
 
-void OrderBook::addToOrderBook(const OrderPtr& order) {
-    orderMap[order->getOrderId()] = order;
-    userOrders[order->getUserId()].push_back(order);
+void OrderBook::addToOrderBook(OrderIndex index) {
+    registerOrder(index);
 
-    if (order->isBuy()) {
-        buyOrders.push(order);
+    // Stop-loss orders wait in their own trees until triggered
+    if (!orderPool[index].isStopLoss()) {
+        addToPriceLevel(index);
+    }
+}
+
+void OrderBook::registerOrder(OrderIndex index) {
+    BookOrder& record = orderPool[index];
+    OrderDetails& details = orderPool.details(index);
+    orderMap.emplace(record.orderId, index);
+    if (details.clientOrderId) {
+        details.clientOrderId = &clientOrderIds.emplace(*details.clientOrderId, record.orderId).first->first;
+    }
+
+    // Append to the owner's order list
+    if (details.userIndex >= userOrders.size()) {
+        userOrders.resize(details.userIndex + 1);
+    }
+    UserOrderList& userList = userOrders[details.userIndex];
+    details.prevForUser = userList.tail;
+    details.nextForUser = NULL_ORDER_INDEX;
+    if (userList.tail != NULL_ORDER_INDEX) {
+        orderPool.details(userList.tail).nextForUser = index;
     } else {
-        sellOrders.push(order);
+        userList.head = index;
+    }
+    userList.tail = index;
+    userList.count++;
+
+    if (details.expireTime > 0) {
+        expiryTimers.rebase(details.timestamp);  // An idle wheel follows the order clock
+        details.expiryTimer = expiryTimers.schedule(details.expireTime, record.orderId);
     }
 }
 
-void OrderBook::removeFromOrderBook(const std::string& orderId) {
-    auto it = orderMap.find(orderId);
-    if (it != orderMap.end()) {
-        auto order = it->second;
-        orderMap.erase(it);
+void OrderBook::addToPriceLevel(OrderIndex index) {
+    BookOrder& record = orderPool[index];
+    OrderDetails& details = orderPool.details(index);
 
-        // Remove from user orders
-        auto& userOrdersList = userOrders[order->getUserId()];
-        userOrdersList.erase(
-            std::remove_if(userOrdersList.begin(), userOrdersList.end(),
-                          [&orderId](const OrderPtr& o) { 
-                              return o->getOrderId() == orderId; 
-                          }),
-            userOrdersList.end());
+    if (record.isBuy()) {
+        details.level = &buyLevels.getOrCreateLevel(record.price);
+        buyOrderCount++;
+    } else {
+        details.level = &sellLevels.getOrCreateLevel(record.price);
+        sellOrderCount++;
     }
+    details.level->addOrder(orderPool, index);
 }
 
-bool OrderBook::cancelOrder(const std::string& orderId) {
-    std::lock_guard<std::mutex> lock(orderBookMutex);
+void OrderBook::removeFromOrderBook(OrderIndex index) {
+    BookOrder& record = orderPool[index];
+    OrderDetails& details = orderPool.details(index);
+
+    // Unlink from the owner's order list
+    UserOrderList& userList = userOrders[details.userIndex];
+    if (details.prevForUser != NULL_ORDER_INDEX) {
+        orderPool.details(details.prevForUser).nextForUser = details.nextForUser;
+    } else {
+        userList.head = details.nextForUser;
+    }
+    if (details.nextForUser != NULL_ORDER_INDEX) {
+        orderPool.details(details.nextForUser).prevForUser = details.prevForUser;
+    } else {
+        userList.tail = details.prevForUser;
+    }
+    userList.count--;
+
+    orderMap.erase(record.orderId);
+    if (details.clientOrderId) {
+        clientOrderIds.erase(clientOrderIds.find(*details.clientOrderId));
+    }
+    if (details.expiryTimer != NULL_TIMER_ID) {
+        expiryTimers.cancel(details.expiryTimer);
+    }
+    orderPool.release(index);
+}
+
+void OrderBook::removeFromPriceLevel(OrderIndex index) {
+    BookOrder& record = orderPool[index];
+    OrderDetails& details = orderPool.details(index);
+    PriceLevel* level = details.level;
+    if (!level) {
+        return;
+    }
+
+    level->removeOrder(orderPool, index);
+    details.level = nullptr;
+
+    // Only dropping an emptied level from a tree side needs a lookup, keyed by price
+    if (record.isBuy()) {
+        buyOrderCount--;
+        if (level->isEmpty()) {
+            buyLevels.removeLevel(level);
+        }
+    } else {
+        sellOrderCount--;
+        if (level->isEmpty()) {
+            sellLevels.removeLevel(level);
+        }
+    }
+}
+
+OrderPtr OrderBook::materializeOrder(OrderIndex index) const {
+    const BookOrder& record = orderPool[index];
+    const OrderDetails& details = orderPool.details(index);
+
+    auto order = std::make_shared<Order>(details.clientOrderId ? *details.clientOrderId : std::string(),
+                                         userIds.lookup(details.userIndex),
+                                         symbol, record.type, record.side, record.price,
+                                         details.quantity, details.triggerPrice);
+    order->setOrderId(record.orderId);
+    if (record.remainingQuantity < details.quantity) {
+        order->fillOrder(details.quantity - record.remainingQuantity);
+    }
+    order->setStatus(record.status);
+    order->setTimestamp(details.timestamp);
+    order->setTimeInForce(record.timeInForce, details.expireTime);
+
+    return order;
+}
+
+size_t OrderBook::collectExpiredOrders(long long nowMicros, std::vector<OrderId>& expired) {
+    auto lock = lockBook();
+
+    return expiryTimers.advance(nowMicros, [&](std::uint64_t orderId) {
+        auto it = orderMap.find(orderId);
+        if (it != orderMap.end()) {
+            orderPool.details(it->second).expiryTimer = NULL_TIMER_ID;
+            expired.push_back(orderId);
+        }
+    });
+}
+
+bool OrderBook::cancelOrder(OrderId orderId) {
+    auto lock = lockBook();
 
     auto it = orderMap.find(orderId);
     if (it == orderMap.end()) {
         return false;
     }
 
-    auto order = it->second;
-    order->setStatus(OrderStatus::CANCELLED);
-    removeFromOrderBook(orderId);
+    OrderIndex index = it->second;
+    if (orderPool[index].isStopLoss()) {
+        removeStopLoss(index);
+    } else {
+        removeFromPriceLevel(index);
+    }
+    orderPool[index].status = OrderStatus::CANCELLED;
+    removeFromOrderBook(index);
+    publishMarketData();
 
     return true;
 }
 
-OrderPtr OrderBook::getOrder(const std::string& orderId) const {
-    std::lock_guard<std::mutex> lock(orderBookMutex);
+std::vector<Trade> OrderBook::modifyOrder(OrderId orderId,
+                                          Price newPrice, int newQuantity) {
+    auto lock = lockBook();
+
+    cancelledStops.clear();
+    fillScratch.clear();
+    modifyRecord(orderId, newPrice, newQuantity, fillScratch, 0);
+
+    std::vector<Trade> trades;
+    appendTrades(fillScratch, trades);
+    return trades;
+}
+
+void OrderBook::modifyOrder(OrderId orderId, Price newPrice, int newQuantity, std::vector<Fill>& fills,
+                            long long timestamp) {
+    auto lock = lockBook();
+
+    cancelledStops.clear();
+    modifyRecord(orderId, newPrice, newQuantity, fills, timestamp);
+}
+
+void OrderBook::modifyRecord(OrderId orderId, Price newPrice, int newQuantity, std::vector<Fill>& fills,
+                             long long timestamp) {
+    auto it = orderMap.find(orderId);
+    if (it == orderMap.end()) {
+        return;
+    }
+
+    OrderIndex index = it->second;
+    BookOrder& record = orderPool[index];
+    OrderDetails& details = orderPool.details(index);
+    int targetQuantity = newQuantity > 0 ? newQuantity : record.remainingQuantity;
+
+    // A resting stop's price is its trigger price, and the trigger index is keyed by it
+    if (record.isStopLoss()) {
+        details.quantity += targetQuantity - record.remainingQuantity;
+        record.remainingQuantity = targetQuantity;
+        if (newPrice <= 0 || newPrice == details.triggerPrice) {
+            return;  // Resting stops are not part of the published depth
+        }
+
+        removeStopLoss(index);
+        details.triggerPrice = newPrice;
+        addStopLoss(index);
+
+        // Moved to or past the last trade price, it fires straight away, as on arrival
+        inputTimestamp = timestamp != 0 ? timestamp : wallClockMicros();
+        checkStopLossOrders(fills);
+        publishMarketData();
+        return;
+    }
+
+    bool priceChanged = newPrice > 0 && newPrice != record.price;
+    if (priceChanged && !buyLevels.acceptsPrice(newPrice)) {
+        throw std::invalid_argument("Order price is not valid for this order book");
+    }
+
+    // Reducing size at the same price keeps time priority and is done in place
+    if (!priceChanged && targetQuantity <= record.remainingQuantity) {
+        details.level->reduceQuantity(record.remainingQuantity - targetQuantity);
+        details.quantity -= record.remainingQuantity - targetQuantity;
+        record.remainingQuantity = targetQuantity;
+        publishMarketData();
+        return;
+    }
+
+    // Any other change loses time priority: pull the order and match it again
+    removeFromPriceLevel(index);
+
+    if (priceChanged) {
+        record.price = newPrice;
+    }
+    details.quantity += targetQuantity - record.remainingQuantity;
+    record.remainingQuantity = targetQuantity;
+
+    size_t firstTrade = fills.size();
+    inputTimestamp = timestamp != 0 ? timestamp : wallClockMicros();
+    matchOrder(index, fills);
+    if (record.remainingQuantity > 0) {
+        addToPriceLevel(index);
+    } else {
+        removeFromOrderBook(index);
+    }
+
+    if (fills.size() > firstTrade) {
+        checkStopLossOrders(fills);
+    }
+    publishMarketData();
+}
+
+OrderPtr OrderBook::getOrder(OrderId orderId) const {
+    auto lock = lockBook();
+
+    auto it = orderMap.find(orderId);
+    return it != orderMap.end() ? materializeOrder(it->second) : nullptr;
+}
+
+int OrderBook::getOpenQuantity(OrderId orderId) const {
+    auto lock = lockBook();
 
     auto it = orderMap.find(orderId);
-    return it != orderMap.end() ? it->second : nullptr;
+    return it != orderMap.end() ? orderPool[it->second].remainingQuantity : 0;
+}
+
+OrderId OrderBook::findOrderId(const std::string& clientOrderId) const {
+    auto lock = lockBook();
+
+    auto it = clientOrderIds.find(clientOrderId);
+    return it != clientOrderIds.end() ? it->second : 0;
 }
 
 std::vector<OrderPtr> OrderBook::getUserOrders(const std::string& userId) const {
-    std::lock_guard<std::mutex> lock(orderBookMutex);
+    auto lock = lockBook();
+
+    std::vector<OrderPtr> result;
+    std::uint32_t userIndex = userIds.find(userId);
+    if (userIndex == StringInterner::NOT_FOUND || userIndex >= userOrders.size()) {
+        return result;
+    }
 
-    auto it = userOrders.find(userId);
-    return it != userOrders.end() ? it->second : std::vector<OrderPtr>();
+    const UserOrderList& userList = userOrders[userIndex];
+    result.reserve(userList.count);
+    for (OrderIndex index = userList.head; index != NULL_ORDER_INDEX;
+         index = orderPool.details(index).nextForUser) {
+        result.push_back(materializeOrder(index));
+    }
+
+    return result;
 }
 
-double OrderBook::getBestBid() const {
-    std::lock_guard<std::mutex> lock(orderBookMutex);
-    return buyOrders.empty() ? 0.0 : buyOrders.top()->getPrice();
+Price OrderBook::bestBid() const {
+    const PriceLevel* level = buyLevels.bestLevel();
+    return level ? level->getPrice() : 0;
 }
 
-double OrderBook::getBestAsk() const {
-    std::lock_guard<std::mutex> lock(orderBookMutex);
-    return sellOrders.empty() ? 0.0 : sellOrders.top()->getPrice();
+Price OrderBook::bestAsk() const {
+    const PriceLevel* level = sellLevels.bestLevel();
+    return level ? level->getPrice() : 0;
 }
 
-double OrderBook::getSpread() const {
-    double bid = getBestBid();
-    double ask = getBestAsk();
-    return (bid > 0 && ask > 0) ? ask - bid : 0.0;
+Price OrderBook::getBestBid() const {
+    return marketData.load().bestBid;
+}
+
+Price OrderBook::getBestAsk() const {
+    return marketData.load().bestAsk;
+}
+
+Price OrderBook::getSpread() const {
+    return marketData.load().getSpread();
+}
+
+std::vector<std::pair<Price, int>> OrderBook::getMarketDepth(int levels, bool buySide) const {
+    std::vector<std::pair<Price, int>> depth;
+    if (levels <= 0) {
+        return depth;
+    }
+
+    // Only the owning thread may walk a single-writer book; other readers get the snapshot
+    if (singleWriter) {
+        levels = std::min(levels, MarketDataSnapshot::MAX_DEPTH);
+    }
+
+    if (levels <= MarketDataSnapshot::MAX_DEPTH) {
+        MarketDataSnapshot snapshot = marketData.load();
+        const DepthLevel* published = buySide ? snapshot.bids : snapshot.asks;
+        int count = std::min(levels, buySide ? snapshot.bidLevelCount : snapshot.askLevelCount);
+        depth.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            depth.emplace_back(published[i].price, published[i].quantity);
+        }
+        return depth;
+    }
+
+    return walkMarketDepth(levels, buySide);
+}
+
+std::vector<std::pair<Price, int>> OrderBook::walkMarketDepth(int levels, bool buySide) const {
+    auto lock = lockBook();
+
+    std::vector<std::pair<Price, int>> depth;
+    if (levels <= 0) {
+        return depth;
+    }
+    const BookSide& side = buySide ? buyLevels : sellLevels;
+    depth.reserve(std::min<size_t>(levels, side.levelCount()));
+    side.forEachLevel(levels, [&depth](const PriceLevel& level) {
+        depth.emplace_back(level.getPrice(), level.getTotalQuantity());
+    });
+
+    return depth;
+}
+
+int OrderBook::getDepth(bool buySide, int levels, Price* prices, int* quantities,
+                        std::uint64_t* version) const {
+    if (levels <= 0) {
+        return 0;
+    }
+    if (singleWriter) {
+        levels = std::min(levels, MarketDataSnapshot::MAX_DEPTH);
+    }
+
+    if (levels <= MarketDataSnapshot::MAX_DEPTH) {
+        MarketDataSnapshot snapshot = marketData.load();
+        const DepthLevel* published = buySide ? snapshot.bids : snapshot.asks;
+        int count = std::min(levels, buySide ? snapshot.bidLevelCount : snapshot.askLevelCount);
+        for (int i = 0; i < count; ++i) {
+            prices[i] = published[i].price;
+            quantities[i] = published[i].quantity;
+        }
+        if (version) {
+            *version = snapshot.version;
+        }
+        return count;
+    }
+
+    auto lock = lockBook();
+    int count = 0;
+    const BookSide& side = buySide ? buyLevels : sellLevels;
+    side.forEachLevel(levels, [&](const PriceLevel& level) {
+        prices[count] = level.getPrice();
+        quantities[count] = level.getTotalQuantity();
+        ++count;
+    });
+    if (version) {
+        *version = 0;
+    }
+    return count;
 }
 
 OrderBook::OrderBookStats OrderBook::getStatistics() const {
-    std::lock_guard<std::mutex> lock(orderBookMutex);
+    MarketDataSnapshot snapshot = marketData.load();
 
     OrderBookStats stats;
-    stats.totalTrades = totalTrades;
-    stats.totalVolume = totalVolume;
-    stats.lastTradePrice = lastTradePrice;
-    stats.totalBuyOrders = buyOrders.size();
-    stats.totalSellOrders = sellOrders.size();
-    stats.bestBid = getBestBid();
-    stats.bestAsk = getBestAsk();
-    stats.spread = getSpread();
+    stats.totalTrades = snapshot.totalTrades;
+    stats.totalVolume = snapshot.totalVolume;
+    stats.lastTradePrice = snapshot.lastTradePrice;
+    stats.totalBuyOrders = snapshot.totalBuyOrders;
+    stats.totalSellOrders = snapshot.totalSellOrders;
+    stats.bestBid = snapshot.bestBid;
+    stats.bestAsk = snapshot.bestAsk;
+    stats.spread = snapshot.getSpread();
 
     return stats;
 }
 
 void OrderBook::printOrderBook() const {
-    std::lock_guard<std::mutex> lock(orderBookMutex);
+    auto lock = lockBook();
+
+    Price bid = bestBid();
+    Price ask = bestAsk();
 
     std::cout << "\n=== Order Book for " << symbol << " ===\n";
-    std::cout << "Best Bid: " << getBestBid() << ", Best Ask: " << getBestAsk() << "\n";
-    std::cout << "Spread: " << getSpread() << "\n";
-    std::cout << "Total Buy Orders: " << buyOrders.size() << "\n";
-    std::cout << "Total Sell Orders: " << sellOrders.size() << "\n";
-    std::cout << "Last Trade Price: " << lastTradePrice << "\n";
+    std::cout << "Best Bid: " << priceScale.toDouble(bid)
+              << ", Best Ask: " << priceScale.toDouble(ask) << "\n";
+    std::cout << "Spread: " << priceScale.toDouble((bid > 0 && ask > 0) ? ask - bid : 0) << "\n";
+    std::cout << "Total Buy Orders: " << buyOrderCount << " in " << buyLevels.levelCount() << " levels\n";
+    std::cout << "Total Sell Orders: " << sellOrderCount << " in " << sellLevels.levelCount() << " levels\n";
+    std::cout << "Last Trade Price: " << priceScale.toDouble(lastTradePrice) << "\n";
     std::cout << "Total Trades: " << totalTrades << "\n";
     std::cout << "Total Volume: " << totalVolume << "\n";
     std::cout << "================================\n\n";
 }
 
 bool OrderBook::isEmpty() const {
-    std::lock_guard<std::mutex> lock(orderBookMutex);
-    return buyOrders.empty() && sellOrders.empty();
+    MarketDataSnapshot snapshot = marketData.load();
+    return snapshot.bidLevelCount == 0 && snapshot.askLevelCount == 0;
+}
+
+void OrderBook::checkStopLossOrders(std::vector<Fill>& fills, StopOutcome* watched) {
+    // Each triggered stop trades as a market order and moves the last price,
+    // which can cross further triggers; keep firing until none is crossed
+    OrderIndex index;
+    while ((index = popTriggeredStopLoss()) != NULL_ORDER_INDEX) {
+        BookOrder& record = orderPool[index];
+        record.type = OrderType::MARKET;
+        record.status = OrderStatus::TRIGGERED;
+
+        if (record.timeInForce != TimeInForce::FOK || canFillCompletely(record)) {
+            matchOrder(index, fills);
+        }
+
+        // Like any market order, an unfilled remainder is cancelled
+        if (record.remainingQuantity > 0) {
+            record.status = OrderStatus::CANCELLED;
+            cancelledStops.push_back({record.orderId, record.remainingQuantity});
+        }
+        if (watched && watched->index == index) {
+            watched->remainingQuantity = record.remainingQuantity;
+            watched->status = record.status;
+        }
+        removeFromOrderBook(index);
+    }
+}
+
+OrderIndex OrderBook::popTriggeredStopLoss() {
+    if (lastTradePrice == 0) {
+        return NULL_ORDER_INDEX; // No trade yet, nothing can have been crossed
+    }
+
+    const StopLossKey* buyStop = buyStopLossOrders.getMin();
+    if (buyStop && buyStop->triggerPrice <= lastTradePrice) {
+        StopLossKey key = *buyStop;
+        buyStopLossOrders.remove(key);
+        return key.index;
+    }
+
+    const StopLossKey* sellStop = sellStopLossOrders.getMin();
+    if (sellStop && sellStop->triggerPrice >= lastTradePrice) {
+        StopLossKey key = *sellStop;
+        sellStopLossOrders.remove(key);
+        return key.index;
+    }
+
+    return NULL_ORDER_INDEX;
+}
+
+bool OrderBook::canFillCompletely(const BookOrder& order) const {
+    const BookSide& opposite = order.isBuy() ? sellLevels : buyLevels;
+    return opposite.availableQuantity(order.price, order.isMarket(), order.remainingQuantity) >=
+           order.remainingQuantity;
+}
+
+long long OrderBook::resolveExpireTime(TimeInForce timeInForce, long long expireTime, long long timestamp) const {
+    switch (timeInForce) {
+        case TimeInForce::GTC:
+        case TimeInForce::IOC:
+        case TimeInForce::FOK:
+            return 0;
+        case TimeInForce::DAY: {
+            // The session close of the order's UTC day, or of the next day once it has passed
+            long long close = timestamp - timestamp % SymbolConfig::MICROS_PER_DAY + sessionCloseMicros;
+            return close > timestamp ? close : close + SymbolConfig::MICROS_PER_DAY;
+        }
+        case TimeInForce::GTD:
+            if (expireTime <= timestamp) {
+                throw std::invalid_argument("GTD expire time must be after the order time");
+            }
+            return expireTime;
+    }
+    throw std::invalid_argument("Unknown time in force");
+}
+
+void OrderBook::addStopLoss(OrderIndex index) {
+    const BookOrder& record = orderPool[index];
+    const OrderDetails& details = orderPool.details(index);
+    if (record.isBuy()) {
+        buyStopLossOrders.insert({details.triggerPrice, record.orderId, index});
+    } else {
+        sellStopLossOrders.insert({details.triggerPrice, record.orderId, index});
+    }
+}
+
+void OrderBook::removeStopLoss(OrderIndex index) {
+    const BookOrder& record = orderPool[index];
+    const OrderDetails& details = orderPool.details(index);
+    if (record.isBuy()) {
+        buyStopLossOrders.remove({details.triggerPrice, record.orderId, index});
+    } else {
+        sellStopLossOrders.remove({details.triggerPrice, record.orderId, index});
+    }
+}
+
+namespace {
+
+const std::uint32_t SNAPSHOT_MAGIC = 0x534D454F; // "OEMS"
+const std::uint32_t SNAPSHOT_VERSION = 3;
+
+} // namespace
+
+void BookImage::encode(std::string& image) const {
+    image.clear();
+    image.reserve(128 + orders.size() * 64);
+    ByteWriter writer(image);
+    writer.put(SNAPSHOT_MAGIC);
+    writer.put(SNAPSHOT_VERSION);
+    writer.putString(symbol);
+    writer.put(lastSequence);
+    writer.put(nextOrderSequence);
+    writer.put(nextTradeSequence);
+    writer.put(totalTrades);
+    writer.put(totalVolume);
+    writer.put(lastTradePrice);
+    writer.put(lastTradeTimestamp);
+    writer.put(static_cast<std::uint64_t>(orders.size()));
+
+    writer.put(static_cast<std::uint32_t>(userIds.size()));
+    for (const auto& userId : userIds) {
+        writer.putString(userId);
+    }
+
+    auto writeOrder = [&](const OrderRecord& order) {
+        writer.put(order.orderId);
+        writer.put(order.triggerPrice);
+        writer.put(order.timestamp);
+        writer.put(order.quantity);
+        writer.put(order.remainingQuantity);
+        writer.put(order.type);
+        writer.put(order.status);
+        writer.put(order.timeInForce);
+        writer.put(order.expireTime);
+        writer.put(order.userIndex);
+        writer.putString(order.clientOrderIdIndex ? clientOrderIds[order.clientOrderIdIndex] : std::string());
+    };
+
+    // Resting orders as runs per level; the level carries the price and the section the side
+    size_t next = 0;
+    for (const auto* levels : {&bidLevels, &askLevels}) {
+        writer.put(static_cast<std::uint32_t>(levels->size()));
+        for (const LevelRecord& level : *levels) {
+            writer.put(level.price);
+            writer.put(level.orderCount);
+            for (std::uint32_t i = 0; i < level.orderCount; ++i) {
+                writeOrder(orders[next++]);
+            }
+        }
+    }
+
+    // Stops are not in levels, so each keeps its own price and side
+    writer.put(buyStopCount + sellStopCount);
+    for (; next < orders.size(); ++next) {
+        writer.put(orders[next].price);
+        writer.put(orders[next].side);
+        writeOrder(orders[next]);
+    }
+
+    writer.put(checksum32(image.data(), image.size()));
+}
+
+void OrderBook::writeSnapshot(std::string& image, std::uint64_t lastSequence) const {
+    BookImage state;
+    captureSnapshot(state, lastSequence);
+    state.encode(image);
+}
+
+void OrderBook::captureSnapshot(BookImage& image, std::uint64_t lastSequence) const {
+    auto lock = lockBook();
+
+    image.symbol = symbol;
+    image.lastSequence = lastSequence;
+    image.nextOrderSequence = nextOrderSequence;
+    image.nextTradeSequence = nextTradeSequence;
+    image.totalTrades = totalTrades;
+    image.totalVolume = totalVolume;
+    image.lastTradePrice = lastTradePrice;
+    image.lastTradeTimestamp = lastTradeTimestamp;
+
+    // The interner only grows, so a reused image already holds every earlier user
+    for (size_t userIndex = image.userIds.size(); userIndex < userIds.size(); ++userIndex) {
+        image.userIds.push_back(userIds.lookup(static_cast<std::uint32_t>(userIndex)));
+    }
+
+    image.orders.clear();
+    image.orders.reserve(orderMap.size());
+    image.bidLevels.clear();
+    image.askLevels.clear();
+    size_t clientOrderIdCount = 1;
+    if (image.clientOrderIds.empty()) {
+        image.clientOrderIds.emplace_back();
+    }
+
+    auto copyOrder = [&](OrderIndex index) {
+        const BookOrder& record = orderPool[index];
+        const OrderDetails& details = orderPool.details(index);
+        BookImage::OrderRecord order;
+        order.orderId = record.orderId;
+        order.price = record.price;
+        order.triggerPrice = details.triggerPrice;
+        order.timestamp = details.timestamp;
+        order.expireTime = details.expireTime;
+        order.quantity = details.quantity;
+        order.remainingQuantity = record.remainingQuantity;
+        order.userIndex = details.userIndex;
+        order.clientOrderIdIndex = 0;
+        order.type = record.type;
+        order.side = record.side;
+        order.status = record.status;
+        order.timeInForce = record.timeInForce;
+        if (details.clientOrderId) {
+            // Assigning into a kept string reuses its buffer
+            if (clientOrderIdCount == image.clientOrderIds.size()) {
+                image.clientOrderIds.emplace_back();
+            }
+            image.clientOrderIds[clientOrderIdCount] = *details.clientOrderId;
+            order.clientOrderIdIndex = static_cast<std::uint32_t>(clientOrderIdCount++);
+        }
+        image.orders.push_back(order);
+    };
+    auto copySide = [&](const BookSide& side, std::vector<BookImage::LevelRecord>& levels) {
+        side.forEachLevel(static_cast<int>(side.levelCount()), [&](const PriceLevel& level) {
+            levels.push_back({level.getPrice(), static_cast<std::uint32_t>(level.getOrderCount())});
+            for (OrderIndex index = level.getFirstOrder(); index != NULL_ORDER_INDEX;
+                 index = orderPool[index].nextInLevel) {
+                copyOrder(index);
+            }
+        });
+    };
+
+    // Best price first and oldest first within a level: loading in this order rebuilds priority
+    copySide(buyLevels, image.bidLevels);
+    copySide(sellLevels, image.askLevels);
+    image.buyStopCount = static_cast<std::uint32_t>(buyStopLossOrders.size());
+    image.sellStopCount = static_cast<std::uint32_t>(sellStopLossOrders.size());
+    for (const auto& key : buyStopLossOrders.inOrderTraversal()) {
+        copyOrder(key.index);
+    }
+    for (const auto& key : sellStopLossOrders.inOrderTraversal()) {
+        copyOrder(key.index);
+    }
+    image.clientOrderIds.resize(clientOrderIdCount);
+}
+
+std::uint64_t OrderBook::restoreSnapshot(const std::string& image) {
+    auto lock = lockBook();
+
+    if (!orderMap.empty()) {
+        throw std::runtime_error("Snapshots can only be restored into an empty order book");
+    }
+    if (image.size() < sizeof(std::uint32_t)) {
+        throw std::runtime_error("Snapshot image is truncated");
+    }
+    size_t bodySize = image.size() - sizeof(std::uint32_t);
+    std::uint32_t storedChecksum;
+    std::memcpy(&storedChecksum, image.data() + bodySize, sizeof(storedChecksum));
+    if (storedChecksum != checksum32(image.data(), bodySize)) {
+        throw std::runtime_error("Snapshot checksum mismatch");
+    }
+
+    ByteReader reader(image.data(), bodySize);
+    if (reader.get<std::uint32_t>() != SNAPSHOT_MAGIC ||
+        reader.get<std::uint32_t>() != SNAPSHOT_VERSION) {
+        throw std::runtime_error("Not an order book snapshot");
+    }
+    if (reader.getString() != symbol) {
+        throw std::runtime_error("Snapshot belongs to another symbol");
+    }
+
+    std::uint64_t lastSequence = reader.get<std::uint64_t>();
+    nextOrderSequence = reader.get<std::uint64_t>();
+    nextTradeSequence = reader.get<std::uint64_t>();
+    totalTrades = reader.get<long long>();
+    totalVolume = reader.get<long long>();
+    lastTradePrice = reader.get<Price>();
+    lastTradeTimestamp = reader.get<long long>();
+    std::uint64_t orderCount = reader.get<std::uint64_t>();
+
+    // Intern each user once, not once per order
+    std::vector<std::uint32_t> userIndexMap(reader.get<std::uint32_t>());
+    for (auto& userIndex : userIndexMap) {
+        userIndex = userIds.intern(reader.getString());
+    }
+
+    orderPool.reserve(orderCount);
+    orderMap.reserve(orderCount);
+    auto readOrder = [&](Price price, OrderSide side) {
+        OrderIndex index = orderPool.acquire();
+        BookOrder& record = orderPool[index];
+        OrderDetails& details = orderPool.details(index);
+        record.orderId = reader.get<OrderId>();
+        record.price = price;
+        record.side = side;
+        details.triggerPrice = reader.get<Price>();
+        details.timestamp = reader.get<long long>();
+        details.quantity = reader.get<int>();
+        record.remainingQuantity = reader.get<int>();
+        record.type = reader.get<OrderType>();
+        record.status = reader.get<OrderStatus>();
+        record.timeInForce = reader.get<TimeInForce>();
+        details.expireTime = reader.get<long long>();
+        details.expiryTimer = NULL_TIMER_ID;
+        std::uint32_t userIndex = reader.get<std::uint32_t>();
+        if (userIndex >= userIndexMap.size()) {
+            throw std::runtime_error("Snapshot order refers to an unknown user");
+        }
+        details.userIndex = userIndexMap[userIndex];
+        std::string clientOrderId = reader.getString();
+        details.clientOrderId = clientOrderId.empty() ? nullptr : &clientOrderId;
+        record.prevInLevel = record.nextInLevel = NULL_ORDER_INDEX;
+        details.level = nullptr;
+        registerOrder(index);
+        return index;
+    };
+
+    // Each level is created once and filled in queue order
+    for (BookSide* side : {&buyLevels, &sellLevels}) {
+        OrderSide orderSide = side == &buyLevels ? OrderSide::BUY : OrderSide::SELL;
+        int& sideCount = side == &buyLevels ? buyOrderCount : sellOrderCount;
+        std::uint32_t levelCount = reader.get<std::uint32_t>();
+        for (std::uint32_t i = 0; i < levelCount; ++i) {
+            Price price = reader.get<Price>();
+            std::uint32_t levelOrders = reader.get<std::uint32_t>();
+            PriceLevel& level = side->getOrCreateLevel(price);
+            for (std::uint32_t j = 0; j < levelOrders; ++j) {
+                OrderIndex index = readOrder(price, orderSide);
+                orderPool.details(index).level = &level;
+                level.addOrder(orderPool, index);
+            }
+            sideCount += static_cast<int>(levelOrders);
+        }
+    }
+
+    std::uint32_t stopCount = reader.get<std::uint32_t>();
+    for (std::uint32_t i = 0; i < stopCount; ++i) {
+        Price price = reader.get<Price>();
+        OrderSide side = reader.get<OrderSide>();
+        OrderIndex index = readOrder(price, side);
+        const BookOrder& record = orderPool[index];
+        if (record.isBuy()) {
+            buyStopLossOrders.insert({orderPool.details(index).triggerPrice, record.orderId, index});
+        } else {
+            sellStopLossOrders.insert({orderPool.details(index).triggerPrice, record.orderId, index});
+        }
+    }
+    publishMarketData();
+
+    return lastSequence;
 }
 
-void OrderBook::checkStopLossOrders(double currentPrice) {
-    // Implementation for checking and triggering stop-loss orders
-    // This would iterate through stop-loss orders and convert them to market orders
-    // when their trigger prices are hit
+TradeId OrderBook::generateTradeId() {
+    return makeEngineId(symbolIndex, ++nextTradeSequence);
 }
 
-std::string OrderBook::generateTradeId() {
-    static std::atomic<long long> tradeIdCounter(0);
-    return "TRADE_" + symbol + "_" + std::to_string(++tradeIdCounter);
+void OrderBook::publishMarketData() {
+    MarketDataSnapshot snapshot;
+    snapshot.version = ++marketDataVersion;
+    snapshot.bestBid = bestBid();
+    snapshot.bestAsk = bestAsk();
+    snapshot.lastTradePrice = lastTradePrice;
+    snapshot.lastTradeTimestamp = lastTradeTimestamp;
+    snapshot.totalTrades = totalTrades;
+    snapshot.totalVolume = totalVolume;
+    snapshot.totalBuyOrders = buyOrderCount;
+    snapshot.totalSellOrders = sellOrderCount;
+
+    auto fill = [](const BookSide& side, DepthLevel* levels) {
+        int count = 0;
+        side.forEachLevel(MarketDataSnapshot::MAX_DEPTH, [&](const PriceLevel& level) {
+            levels[count++] = {level.getPrice(), level.getTotalQuantity(), level.getOrderCount()};
+        });
+        std::fill(levels + count, levels + MarketDataSnapshot::MAX_DEPTH, DepthLevel{0, 0, 0});
+        return count;
+    };
+    snapshot.bidLevelCount = fill(buyLevels, snapshot.bids);
+    snapshot.askLevelCount = fill(sellLevels, snapshot.asks);
+
+    marketData.store(snapshot);
 }
 
 } // namespace OrderMatchingEngine
\ No newline at end of file
@@ -2,104 +2,290 @@
 #define ORDERBOOK_HPP
 
 #include "Order.hpp"
-#include <queue>
+#include "OrderPool.hpp"
+#include "SeqLock.hpp"
+#include "TimerWheel.hpp"
 #include <unordered_map>
 #include <vector>
 #include <mutex>
 #include <memory>
 #include <map>
 #include <set>
+#include <cstdint>
 
 
 namespace OrderMatchingEngine {
 
+/**
+ * @brief Fixed-size record of one execution, produced by the match loop
+ * Holds nothing that allocates, so a caller-owned buffer of fills that is
+ * cleared and reused reaches a steady state with no allocation per trade.
+ * The symbol is implied by the book that produced it.
+ */
+struct Fill {
+    TradeId tradeId;
+    OrderId buyOrderId;
+    OrderId sellOrderId;
+    Price price;            // Trade price in ticks
+    int quantity;
+    long long timestamp;
+};
+
+/**
+ * @brief Remainder of a triggered stop-loss that found no liquidity and was cancelled
+ * Reported next to the fills, as nothing else tells the owner the order is gone.
+ */
+struct CancelledStop {
+    OrderId orderId;
+    int quantity;           // Open quantity cancelled
+};
+
 /**
  * @brief Represents a trade execution result
+ * The timestamp is always the time of the input that caused the trade, never
+ * the clock at construction, so trades replayed from a log come out identical.
  */
 struct Trade {
-    std::string tradeId;
-    std::string buyOrderId;
-    std::string sellOrderId;
+    TradeId tradeId;
+    OrderId buyOrderId;
+    OrderId sellOrderId;
     std::string symbol;
-    double price;
+    Price price;            // Trade price in ticks
     int quantity;
     long long timestamp;
 
-    Trade(const std::string& tradeId, const std::string& buyOrderId,
-          const std::string& sellOrderId, const std::string& symbol,
-          double price, int quantity);
+    Trade(TradeId tradeId, OrderId buyOrderId, OrderId sellOrderId,
+          const std::string& symbol, Price price, int quantity, long long timestamp);
+    Trade(const Fill& fill, const std::string& symbol);
+
+    std::string toString(const PriceScale& scale = PriceScale()) const;
+};
+
+/**
+ * @brief Outcome of one order in a batch submission
+ */
+struct OrderResult {
+    OrderId orderId;        // Assigned order ID (0 if rejected before one was assigned)
+    OrderStatus status;     // Status after matching, or REJECTED
+    size_t firstTrade;      // Index of the order's first trade in the trade or fill buffer
+    size_t tradeCount;      // Trades caused by the order, including triggered stops
+    int remainingQuantity;  // Open quantity left after matching (0 once filled or cancelled)
+
+    OrderResult(OrderId orderId, OrderStatus status, size_t firstTrade, size_t tradeCount,
+                int remainingQuantity = 0)
+        : orderId(orderId), status(status), firstTrade(firstTrade), tradeCount(tradeCount),
+          remainingQuantity(remainingQuantity) {}
+};
+
+/**
+ * @brief Trades and per-order outcomes of a batch submission
+ * Orders are reported in submission order; trades are contiguous per order.
+ */
+struct BatchResult {
+    std::vector<Trade> trades;
+    std::vector<OrderResult> orders;
+};
+
+/**
+ * @brief One aggregated price level in a market data snapshot
+ */
+struct DepthLevel {
+    Price price;            // In ticks
+    int quantity;
+    int orderCount;
+};
 
-    std::string toString() const;
+/**
+ * @brief Top of book, the best MAX_DEPTH levels per side and book statistics
+ * Published by the book after every mutation; readers get the latest one
+ * (intermediate states are conflated) without taking the book lock.
+ */
+struct MarketDataSnapshot {
+    static constexpr int MAX_DEPTH = 10;
+
+    std::uint64_t version;          // Increments with every publication
+    Price bestBid;                  // 0 when the side is empty
+    Price bestAsk;
+    Price lastTradePrice;
+    long long lastTradeTimestamp;
+    long long totalTrades;
+    long long totalVolume;
+    int totalBuyOrders;
+    int totalSellOrders;
+    int bidLevelCount;              // Entries used in bids
+    int askLevelCount;              // Entries used in asks
+    DepthLevel bids[MAX_DEPTH];     // Best price first
+    DepthLevel asks[MAX_DEPTH];
+
+    Price getSpread() const { return (bestBid > 0 && bestAsk > 0) ? bestAsk - bestBid : 0; }
 };
 
 /**
  * @brief Price level for maintaining orders at specific price points
- * Uses AVL-like balanced approach for efficient insertion/deletion
+ * Orders are kept in an intrusive doubly linked FIFO list for time priority,
+ * giving O(1) append, O(1) access to the oldest order and O(1) unlink.
+ * The links are pool indices stored in the BookOrder records themselves.
  */
 class PriceLevel {
 private:
-    double price;
-    int totalQuantity;
+    Price price;
+    int totalQuantity;      // Aggregated remaining quantity of all orders at this level
     int orderCount;
-    std::queue<OrderPtr> orders; // FIFO queue for time priority
+    OrderIndex head;        // Oldest order (first to match)
+    OrderIndex tail;        // Newest order
 
 public:
-    explicit PriceLevel(double price);
+    explicit PriceLevel(Price price);
 
-    void addOrder(const OrderPtr& order);
-    OrderPtr removeOrder(const std::string& orderId);
-    OrderPtr getFirstOrder();
-    bool isEmpty() const;
+    void addOrder(OrderPool& pool, OrderIndex index);
+    void removeOrder(OrderPool& pool, OrderIndex index);
+    OrderIndex getFirstOrder() const { return head; }
+    bool isEmpty() const { return head == NULL_ORDER_INDEX; }
+
+    /**
+     * @brief Keeps the aggregated quantity in sync after a resting order is filled
+     */
+    void reduceQuantity(int filledQuantity) { totalQuantity -= filledQuantity; }
 
-    double getPrice() const { return price; }
+    Price getPrice() const { return price; }
     int getTotalQuantity() const { return totalQuantity; }
     int getOrderCount() const { return orderCount; }
 
-    std::vector<OrderPtr> getAllOrders() const;
+    std::vector<OrderIndex> getAllOrders(const OrderPool& pool) const;
 };
 
 /**
- * @brief Custom Red-Black Tree implementation for price levels
- * Provides O(log n) insertion, deletion, and search operations
+ * @brief Tick size and price band of an instrument traded on a price ladder
+ * All values are in ticks of the symbol's PriceScale
  */
-template<typename Comparator>
-class PriceLevelTree {
+struct PriceLadderConfig {
+    Price tickSize;     // Minimum price increment
+    Price minPrice;     // Lowest price accepted by the ladder
+    Price maxPrice;     // Highest price accepted by the ladder
+
+    PriceLadderConfig(Price tickSize = 1, Price minPrice = 1, Price maxPrice = 100000)
+        : tickSize(tickSize), minPrice(minPrice), maxPrice(maxPrice) {}
+
+    int getLevelCount() const;
+};
+
+/**
+ * @brief Per-symbol order book configuration
+ */
+struct SymbolConfig {
+    std::uint16_t symbolIndex;      // Engine-wide index stored in the top bits of order and trade IDs
+    PriceScale priceScale;          // Ticks per unit of currency for this symbol
+    bool usePriceLadder;            // Store levels in array ladders instead of a tree
+    PriceLadderConfig ladder;       // Tick size and price band, used when usePriceLadder is set
+    bool singleWriter;              // Book is only ever touched by its owning matching thread,
+                                    // so it skips orderBookMutex entirely
+    long long sessionCloseMicros;   // DAY orders expire at this time of day (microseconds after UTC midnight)
+
+    static constexpr long long MICROS_PER_DAY = 86400LL * 1000000LL;
+
+    SymbolConfig()
+        : symbolIndex(0), usePriceLadder(false), singleWriter(false), sessionCloseMicros(MICROS_PER_DAY) {}
+    explicit SymbolConfig(const PriceLadderConfig& ladder,
+                          const PriceScale& priceScale = PriceScale())
+        : symbolIndex(0), priceScale(priceScale), usePriceLadder(true), ladder(ladder),
+          singleWriter(false), sessionCloseMicros(MICROS_PER_DAY) {}
+};
+
+/**
+ * @brief Contiguous array of price levels indexed by tick offset from the band floor
+ * 
+ * Non-empty levels are tracked in an occupancy bitmap, so finding the next best
+ * level is a word-at-a-time scan and depth queries walk memory sequentially.
+ * Levels never move once the ladder is built, so PriceLevel pointers stay valid.
+ */
+class PriceLadder {
 private:
-    enum class Color { RED, BLACK };
+    PriceLadderConfig config;
+    bool bidSide;                       // Bids improve upwards, asks improve downwards
+    std::vector<PriceLevel> levels;     // levels[i] holds price minPrice + i * tickSize
+    std::vector<uint64_t> occupied;     // Bit i set when levels[i] has orders
+    size_t activeLevels;
+    long bestIndex;                     // Index of the best level, -1 when empty
 
-    struct Node {
-        std::shared_ptr<PriceLevel> priceLevel;
-        std::shared_ptr<Node> left;
-        std::shared_ptr<Node> right;
-        std::shared_ptr<Node> parent;
-        Color color;
+    long scanUp(long from) const;       // First occupied index >= from
+    long scanDown(long from) const;     // Last occupied index <= from
+    long indexOf(const PriceLevel* level) const { return static_cast<long>(level - levels.data()); }
 
-        Node(std::shared_ptr<PriceLevel> level) 
-            : priceLevel(level), left(nullptr), right(nullptr), 
-              parent(nullptr), color(Color::RED) {}
-    };
+public:
+    PriceLadder(const PriceLadderConfig& config, bool bidSide);
 
-    std::shared_ptr<Node> root;
-    Comparator comp;
+    /**
+     * @brief Check that a price lies on the tick grid inside the band
+     */
+    bool acceptsPrice(Price price) const;
 
-    void rotateLeft(std::shared_ptr<Node> node);
-    void rotateRight(std::shared_ptr<Node> node);
-    void insertFixup(std::shared_ptr<Node> node);
-    void deleteFixup(std::shared_ptr<Node> node);
-    std::shared_ptr<Node> minimum(std::shared_ptr<Node> node);
-    std::shared_ptr<Node> successor(std::shared_ptr<Node> node);
+    PriceLevel& getOrCreateLevel(Price price);
+    void removeLevel(PriceLevel* level);
+    PriceLevel* bestLevel() { return bestIndex < 0 ? nullptr : &levels[bestIndex]; }
+    const PriceLevel* bestLevel() const { return bestIndex < 0 ? nullptr : &levels[bestIndex]; }
+
+    /**
+     * @brief Next non-empty level after the given one in priority order
+     */
+    const PriceLevel* nextLevel(const PriceLevel* level) const;
+
+    bool empty() const { return activeLevels == 0; }
+    size_t levelCount() const { return activeLevels; }
+    const PriceLadderConfig& getConfig() const { return config; }
+};
+
+/**
+ * @brief One side of the order book, backed by a sorted tree or a price ladder
+ * The tree handles arbitrary prices; the ladder is selected per symbol for
+ * instruments with a known tick size and price band
+ */
+class BookSide {
+private:
+    bool bidSide;
+    std::map<Price, PriceLevel> tree;       // Ascending; bids are read from the back
+    std::unique_ptr<PriceLadder> ladder;    // Set when the symbol trades on a ladder
 
 public:
-    PriceLevelTree();
-    ~PriceLevelTree();
+    BookSide(bool bidSide, const SymbolConfig& config);
 
-    void insert(std::shared_ptr<PriceLevel> priceLevel);
-    void remove(double price);
-    std::shared_ptr<PriceLevel> find(double price);
-    std::shared_ptr<PriceLevel> getBest(); // Get best price level
-    bool empty() const;
+    bool acceptsPrice(Price price) const;
+    PriceLevel& getOrCreateLevel(Price price);
+    void removeLevel(PriceLevel* level);    // Level must be empty
+    PriceLevel* bestLevel();
+    const PriceLevel* bestLevel() const;
+
+    bool empty() const { return ladder ? ladder->empty() : tree.empty(); }
+    size_t levelCount() const { return ladder ? ladder->levelCount() : tree.size(); }
+    bool isLadder() const { return ladder != nullptr; }
 
-    std::vector<std::shared_ptr<PriceLevel>> getAllLevels() const;
+    /**
+     * @brief Quantity an incoming order could take from this side, best price first
+     * Stops counting once wanted is reached, so a large book is not walked.
+     * @param limitPrice Worst price the incoming order accepts (ignored if anyPrice)
+     */
+    int availableQuantity(Price limitPrice, bool anyPrice, int wanted) const;
+
+    /**
+     * @brief Visit up to maxLevels non-empty levels, best price first
+     */
+    template<typename Visitor>
+    void forEachLevel(int maxLevels, Visitor&& visit) const {
+        int visited = 0;
+        if (ladder) {
+            for (const PriceLevel* level = ladder->bestLevel();
+                 level && visited < maxLevels; level = ladder->nextLevel(level), ++visited) {
+                visit(*level);
+            }
+        } else if (bidSide) {
+            for (auto it = tree.rbegin(); it != tree.rend() && visited < maxLevels; ++it, ++visited) {
+                visit(it->second);
+            }
+        } else {
+            for (auto it = tree.begin(); it != tree.end() && visited < maxLevels; ++it, ++visited) {
+                visit(it->second);
+            }
+        }
+    }
 };
 
 /**
@@ -121,13 +307,16 @@ private:
     std::shared_ptr<Node> root;
     Compare comp;
 
-    int getHeight(std::shared_ptr<Node> node);
-    int getBalance(std::shared_ptr<Node> node);
+    size_t nodeCount;
+
+    int getHeight(const std::shared_ptr<Node>& node) const;
+    int getBalance(const std::shared_ptr<Node>& node) const;
     std::shared_ptr<Node> rotateRight(std::shared_ptr<Node> y);
     std::shared_ptr<Node> rotateLeft(std::shared_ptr<Node> x);
+    std::shared_ptr<Node> rebalance(std::shared_ptr<Node> node);
     std::shared_ptr<Node> insert(std::shared_ptr<Node> node, const T& data);
     std::shared_ptr<Node> remove(std::shared_ptr<Node> node, const T& data);
-    std::shared_ptr<Node> findMin(std::shared_ptr<Node> node);
+    Node* findMin(Node* node) const;
 
 public:
     AVLTree();
@@ -136,37 +325,129 @@ public:
     void insert(const T& data);
     void remove(const T& data);
     T* find(const T& data);
+
+    /**
+     * @brief Smallest element under Compare, or nullptr if the tree is empty
+     */
     T* getMin();
+
+    /**
+     * @brief Largest element under Compare, or nullptr if the tree is empty
+     */
     T* getMax();
     bool empty() const;
+    size_t size() const { return nodeCount; }
 
     std::vector<T> inOrderTraversal() const;
 };
 
+/**
+ * @brief Flat copy of a book's persistent state at one sequence point
+ *
+ * Filled by OrderBook::captureSnapshot on the book's own thread in one pass
+ * over the resting orders; encode() then produces the snapshot image on any
+ * thread while the book trades on. Reusing an image for the same book keeps
+ * its buffers and copies only the users added since the last capture.
+ */
+struct BookImage {
+    struct OrderRecord {
+        OrderId orderId;
+        Price price;
+        Price triggerPrice;
+        long long timestamp;
+        long long expireTime;
+        int quantity;
+        int remainingQuantity;
+        std::uint32_t userIndex;            // Into userIds
+        std::uint32_t clientOrderIdIndex;   // Into clientOrderIds, 0 for none
+        OrderType type;
+        OrderSide side;
+        OrderStatus status;
+        TimeInForce timeInForce;
+    };
+
+    struct LevelRecord {
+        Price price;
+        std::uint32_t orderCount;
+    };
+
+    std::string symbol;
+    std::uint64_t lastSequence;
+    std::uint64_t nextOrderSequence;
+    std::uint64_t nextTradeSequence;
+    long long totalTrades;
+    long long totalVolume;
+    Price lastTradePrice;
+    long long lastTradeTimestamp;
+
+    std::vector<std::string> userIds;           // The book's interned users, by index
+    std::vector<std::string> clientOrderIds;    // [0] unused
+    std::vector<LevelRecord> bidLevels;         // Best price first
+    std::vector<LevelRecord> askLevels;
+    std::vector<OrderRecord> orders;            // Bid levels, ask levels, then buy and sell stops
+    std::uint32_t buyStopCount;
+    std::uint32_t sellStopCount;
+
+    BookImage()
+        : lastSequence(0), nextOrderSequence(0), nextTradeSequence(0), totalTrades(0), totalVolume(0),
+          lastTradePrice(0), lastTradeTimestamp(0), buyStopCount(0), sellStopCount(0) {}
+
+    /**
+     * @brief Encode as a snapshot image for OrderBook::restoreSnapshot
+     * Orders are grouped by level, so prices and sides are stored once per level.
+     */
+    void encode(std::string& image) const;
+};
+
 /**
  * @brief Order Book class managing buy and sell orders for a specific symbol
  * 
  * Uses advanced data structures:
- * - Priority queues (heaps) for fast best price access
+ * - Sorted maps of price levels, or a tick-indexed price ladder per symbol
+ * - Intrusive FIFO lists inside each price level for time priority
+ * - A slab pool of order records, linked by index instead of shared_ptr and split
+ *   into the fields matching touches and the bookkeeping it does not
  * - Hash maps for O(1) order lookup by ID
- * - AVL trees for maintaining price levels
- * - Red-Black trees for balanced price level management
+ * - AVL trees for stop-loss order management
+ *
+ * Orders passed in are copied into pooled records; the caller's Order object is
+ * updated with the outcome, and queries return snapshots built from the records.
  */
 class OrderBook {
 private:
     std::string symbol;
+    std::uint16_t symbolIndex;
+    PriceScale priceScale;
+
+    // Per-book sequences behind engine-style order and trade IDs
+    std::uint64_t nextOrderSequence;
+    std::uint64_t nextTradeSequence;
+
+    // Price levels, best price first; each level holds its orders in time priority
+    BookSide buyLevels;     // Higher prices first
+    BookSide sellLevels;    // Lower prices first
+    int buyOrderCount;
+    int sellOrderCount;
 
-    // Priority queues for fast access to best prices
-    std::priority_queue<OrderPtr, std::vector<OrderPtr>, BuyOrderComparator> buyOrders;
-    std::priority_queue<OrderPtr, std::vector<OrderPtr>, SellOrderComparator> sellOrders;
+    // Pooled records for every order the book holds
+    OrderPool orderPool;
+    StringInterner userIds;
 
-    // Hash maps for O(1) order lookup and modification
-    std::unordered_map<std::string, OrderPtr> orderMap;
-    std::unordered_map<std::string, std::vector<OrderPtr>> userOrders;
+    /**
+     * @brief Intrusive list of one user's orders, linked through OrderDetails records
+     */
+    struct UserOrderList {
+        OrderIndex head = NULL_ORDER_INDEX;
+        OrderIndex tail = NULL_ORDER_INDEX;
+        int count = 0;
+    };
 
-    // Price level trees for efficient range queries and market depth
-    PriceLevelTree<std::greater<double>> buyPriceLevels;  // Higher prices first
-    PriceLevelTree<std::less<double>> sellPriceLevels;    // Lower prices first
+    // Hash map for O(1) order lookup by engine ID
+    std::unordered_map<OrderId, OrderIndex> orderMap;
+    std::vector<UserOrderList> userOrders;  // Indexed by interned user ID
+
+    // Optional client order ID side-mapping; records point at its keys for the strings
+    std::unordered_map<std::string, OrderId> clientOrderIds;
 
     // // AVL trees for stop-loss order management
     // AVLTree<OrderPtr, [](const OrderPtr& a, const OrderPtr& b) { 
@@ -176,48 +457,133 @@ private:
     //     return a->getTriggerPrice() > b->getTriggerPrice(); 
     // }> sellStopLossOrders;
 
+    // Stop-loss orders keyed by trigger price, then order ID for time priority, ordered
+    // so that the minimum of each tree is the next stop to fire: buy stops trigger as
+    // the price rises to their trigger, sell stops as it falls to theirs
+    struct StopLossKey {
+        Price triggerPrice;
+        OrderId orderId;
+        OrderIndex index;   // Record of the stop; not part of the ordering
+    };
+
     struct StopLossBuyComparator
     {
-        bool operator()(const OrderPtr &a, const OrderPtr &b) const
+        bool operator()(const StopLossKey &a, const StopLossKey &b) const
         {
-            return a->getTriggerPrice() < b->getTriggerPrice();
+            return a.triggerPrice != b.triggerPrice ? a.triggerPrice < b.triggerPrice
+                                                    : a.orderId < b.orderId;
         }
     };
 
     struct StopLossSellComparator
     {
-        bool operator()(const OrderPtr &a, const OrderPtr &b) const
+        bool operator()(const StopLossKey &a, const StopLossKey &b) const
         {
-            return a->getTriggerPrice() > b->getTriggerPrice();
+            return a.triggerPrice != b.triggerPrice ? a.triggerPrice > b.triggerPrice
+                                                    : a.orderId < b.orderId;
         }
     };
-    AVLTree<OrderPtr, StopLossBuyComparator> buyStopLossOrders;
-    AVLTree<OrderPtr, StopLossSellComparator> sellStopLossOrders;
+    AVLTree<StopLossKey, StopLossBuyComparator> buyStopLossOrders;
+    AVLTree<StopLossKey, StopLossSellComparator> sellStopLossOrders;
 
-    // Thread safety
-    mutable std::mutex orderBookMutex;
+    // Thread safety; the mutex gets its own line so contending lockers do not
+    // invalidate the book state around it
+    alignas(CACHE_LINE_SIZE) mutable std::mutex orderBookMutex;
+    bool singleWriter;
 
-    // Statistics
-    long long totalTrades;
-    double totalVolume;
-    double lastTradePrice;
+    /**
+     * @brief Lock the book unless it is owned by a single matching thread
+     */
+    std::unique_lock<std::mutex> lockBook() const {
+        return singleWriter ? std::unique_lock<std::mutex>()
+                            : std::unique_lock<std::mutex>(orderBookMutex);
+    }
+
+    // Statistics, written on every trade
+    alignas(CACHE_LINE_SIZE) long long totalTrades;
+    long long totalVolume;
+    Price lastTradePrice;
+    long long lastTradeTimestamp;
+
+    // Time of the input being applied: the incoming order's own timestamp, or the
+    // receive time of a modify. Its fills and any stops it triggers carry it, so
+    // replaying the same inputs gives bit-identical trades.
+    long long inputTimestamp;
+
+    // DAY and GTD deadlines of the orders the book holds, keyed by order ID
+    TimerWheel expiryTimers;
+    long long sessionCloseMicros;
+
+    // Latest top of book and depth, read by market data consumers without the book lock
+    SeqLock<MarketDataSnapshot> marketData;
+    std::uint64_t marketDataVersion;
+
+    // Reused by the Trade-returning calls, which match into fills and convert at the end
+    std::vector<Fill> fillScratch;
+
+    // Triggered stops cancelled by the latest addOrder/addOrders/modifyOrder call
+    std::vector<CancelledStop> cancelledStops;
 
     // Internal helper methods
-    std::vector<Trade> matchOrder(const OrderPtr& incomingOrder);
-    Trade executeTrade(const OrderPtr& buyOrder, const OrderPtr& sellOrder, 
-                      double price, int quantity);
-    void addToOrderBook(const OrderPtr& order);
-    void removeFromOrderBook(const std::string& orderId);
-    void updatePriceLevels(const OrderPtr& order);
-    void checkStopLossOrders(double currentPrice);
-    std::string generateTradeId();
+    void submitOrder(const OrderPtr& order, std::vector<Fill>& fills);
+    void submitOrders(const std::vector<OrderPtr>& orders, std::vector<Fill>& fills,
+                      std::vector<OrderResult>& results);
+    OrderResult submitEntry(const OrderEntry& entry, std::vector<Fill>& fills);
+    OrderStatus submitRecord(OrderIndex index, std::vector<Fill>& fills, int& remainingQuantity);
+    void modifyRecord(OrderId orderId, Price newPrice, int newQuantity, std::vector<Fill>& fills,
+                      long long timestamp);
+    void matchOrder(OrderIndex incomingIndex, std::vector<Fill>& fills);
+
+    /**
+     * @brief Match an incoming order of a given side and type against the opposite side
+     * Instantiated per combination, so the crossing rule and the buyer/seller
+     * roles are fixed at compile time and the per-fill loop has no order-type tests.
+     */
+    template<OrderSide Side, OrderType Type>
+    void sweepLevels(OrderIndex incomingIndex, std::vector<Fill>& fills);
+
+    Fill executeTrade(BookOrder& buyOrder, BookOrder& sellOrder,
+                      Price price, int quantity, long long timestamp);
+    void appendTrades(const std::vector<Fill>& fills, std::vector<Trade>& trades) const;
+    OrderIndex createRecord(const Order& order);
+    void addToOrderBook(OrderIndex index);
+    void registerOrder(OrderIndex index);
+    void addToPriceLevel(OrderIndex index);
+    void removeFromOrderBook(OrderIndex index);
+    void removeFromPriceLevel(OrderIndex index);
+    OrderPtr materializeOrder(OrderIndex index) const;
+
+    // A stop's outcome, taken while checkStopLossOrders fires it and before its record is released
+    struct StopOutcome {
+        OrderIndex index;
+        int remainingQuantity;
+        OrderStatus status;
+    };
+
+    void checkStopLossOrders(std::vector<Fill>& fills, StopOutcome* watched = nullptr);
+    OrderIndex popTriggeredStopLoss();
+    void addStopLoss(OrderIndex index);
+    void removeStopLoss(OrderIndex index);
+    bool canFillCompletely(const BookOrder& order) const;
+    long long resolveExpireTime(TimeInForce timeInForce, long long expireTime, long long timestamp) const;
+    TradeId generateTradeId();
+
+    /**
+     * @brief Rebuild and publish the market data snapshot (book must be locked)
+     */
+    void publishMarketData();
+
+    // Unlocked helpers for use while orderBookMutex is already held
+    Price bestBid() const;
+    Price bestAsk() const;
 
 public:
     /**
      * @brief Constructor
      * @param symbol Trading symbol for this order book
+     * @param config Price scale and level storage (tree or tick ladder) for the symbol
      */
-    explicit OrderBook(const std::string& symbol);
+    explicit OrderBook(const std::string& symbol, const SymbolConfig& config = SymbolConfig());
 
     /**
      * @brief Destructor
@@ -227,71 +593,177 @@ public:
     // Core order operations
     /**
      * @brief Add a new order to the order book
-     * @param order Order to be added
+     * @param order Order to be added; it is assigned an order ID if it has none, and its
+     *              fill state and status are updated with the outcome
      * @return Vector of trades executed as a result of this order
      */
     std::vector<Trade> addOrder(const OrderPtr& order);
 
+    /**
+     * @brief Add a burst of orders under a single lock
+     * Invalid orders are rejected individually instead of failing the batch.
+     * @param orders Orders for this symbol, processed in sequence; each is updated
+     *               as by addOrder, and rejected ones are set to REJECTED
+     * @param result Receives the trades and per-order outcomes (appended)
+     */
+    void addOrders(const std::vector<OrderPtr>& orders, BatchResult& result);
+
+    /**
+     * @brief Allocation-free variants of addOrder / addOrders
+     * Fills are appended to a caller-owned buffer; one that is cleared and reused
+     * between calls stops allocating once it has grown to the largest burst.
+     * OrderResult trade ranges index into fills.
+     */
+    void addOrder(const OrderPtr& order, std::vector<Fill>& fills);
+    void addOrders(const std::vector<OrderPtr>& orders, std::vector<Fill>& fills,
+                   std::vector<OrderResult>& results);
+
+    /**
+     * @brief Add an order given as plain fields, without building an Order object
+     * Used by the binary order entry path; matching is identical to addOrder.
+     * @param trades Receives the trades caused by the order (appended)
+     * @return The assigned ID, status after matching and the order's trade range in trades
+     * @throws std::invalid_argument if the fields do not form a valid order for this book
+     */
+    OrderResult addOrder(const OrderEntry& entry, std::vector<Trade>& trades);
+    OrderResult addOrder(const OrderEntry& entry, std::vector<Fill>& fills);
+
+    /**
+     * @brief Stops triggered by the latest addOrder, addOrders or modifyOrder call whose
+     *        unfilled remainder was cancelled, in the order they fired
+     * Read by the single writer after the call; the next such call clears the list.
+     */
+    const std::vector<CancelledStop>& getCancelledStops() const { return cancelledStops; }
+
+    /**
+     * @brief Advance the expiry clock and collect the DAY/GTD orders whose time ran out
+     * Each expiry costs O(1); the book is never swept. The orders stay in the book
+     * until the caller cancels them, so an expiry can be logged before it takes effect.
+     * @param expired Receives the expired order IDs (appended), in deadline order
+     * @return Number of orders collected
+     */
+    size_t collectExpiredOrders(long long nowMicros, std::vector<OrderId>& expired);
+
+    /**
+     * @brief Number of resting orders with a pending DAY/GTD expiry
+     */
+    size_t getPendingExpiryCount() const { return expiryTimers.size(); }
+
     /**
      * @brief Cancel an existing order
      * @param orderId ID of the order to cancel
      * @return True if order was successfully cancelled, false otherwise
      */
-    bool cancelOrder(const std::string& orderId);
+    bool cancelOrder(OrderId orderId);
 
     /**
      * @brief Modify an existing order
      * @param orderId ID of the order to modify
-     * @param newPrice New price (0 to keep current price)
+     * @param newPrice New price in ticks (0 to keep current price); for a resting
+     *                 stop-loss, its new trigger price, which fires it at once if
+     *                 the last trade price has already reached it
      * @param newQuantity New quantity (0 to keep current quantity)
      * @return Vector of trades if modification triggers matching
      */
-    std::vector<Trade> modifyOrder(const std::string& orderId, 
-                                  double newPrice = 0, int newQuantity = 0);
+    std::vector<Trade> modifyOrder(OrderId orderId, 
+                                  Price newPrice = 0, int newQuantity = 0);
+
+    /**
+     * @brief Modify an existing order, appending any fills to a caller-owned buffer
+     * @param timestamp Receive time of the request, stamped on the fills it causes (0 for now)
+     */
+    void modifyOrder(OrderId orderId, Price newPrice, int newQuantity, std::vector<Fill>& fills,
+                     long long timestamp = 0);
 
     // Query operations
+    // Per-order queries read the pool directly: on a single-writer book they are
+    // only safe on the owning thread (see MatchingShard::queryOrder and friends)
+
+    /**
+     * @brief Get a snapshot of an order by ID
+     */
+    OrderPtr getOrder(OrderId orderId) const;
+
+    /**
+     * @brief Open quantity of an order without materializing it
+     * @return 0 if the order is not in the book
+     */
+    int getOpenQuantity(OrderId orderId) const;
+
     /**
-     * @brief Get order by ID
+     * @brief Look up the engine ID of a resting order by its client order ID
+     * @return The order ID, or 0 if no resting order has that client ID
      */
-    OrderPtr getOrder(const std::string& orderId) const;
+    OrderId findOrderId(const std::string& clientOrderId) const;
 
     /**
-     * @brief Get all orders for a specific user
+     * @brief Get snapshots of all orders for a specific user
      */
     std::vector<OrderPtr> getUserOrders(const std::string& userId) const;
 
     /**
-     * @brief Get current best bid (highest buy price)
+     * @brief Get the latest published top of book, depth and statistics
+     * Lock-free: readers never contend with matching, however many of them poll.
+     */
+    MarketDataSnapshot getMarketData() const { return marketData.load(); }
+
+    /**
+     * @brief Number of snapshots published so far, to poll for changes without copying one
      */
-    double getBestBid() const;
+    std::uint64_t getMarketDataVersion() const { return marketData.getVersion(); }
 
     /**
-     * @brief Get current best ask (lowest sell price)  
+     * @brief Get current best bid (highest buy price) in ticks, from the published snapshot
      */
-    double getBestAsk() const;
+    Price getBestBid() const;
+
+    /**
+     * @brief Get current best ask (lowest sell price) in ticks, from the published snapshot
+     */
+    Price getBestAsk() const;
 
     /**
      * @brief Get bid-ask spread
      */
-    double getSpread() const;
+    Price getSpread() const;
+
+    /**
+     * @brief Get market depth up to specified levels as (price in ticks, quantity)
+     * Up to MarketDataSnapshot::MAX_DEPTH levels come from the published snapshot;
+     * deeper requests walk the book under its lock. A single-writer book has no
+     * lock to take, so for it the answer is capped at MAX_DEPTH levels; deeper
+     * depth comes from the owning thread (MatchingShard::queryMarketDepth).
+     */
+    std::vector<std::pair<Price, int>> getMarketDepth(int levels, bool buySide) const;
 
     /**
-     * @brief Get market depth up to specified levels
+     * @brief Walk up to levels levels of one side, however deep, as (price in ticks, quantity)
+     * Takes the book lock; on a single-writer book, call it from the owning thread only.
      */
-    std::vector<std::pair<double, int>> getMarketDepth(int levels, bool buySize) const;
+    std::vector<std::pair<Price, int>> walkMarketDepth(int levels, bool buySide) const;
 
     /**
-     * @brief Get order book statistics
+     * @brief Copy up to levels levels of one side into caller-provided arrays, best price first
+     * Same sources as getMarketDepth, without allocating, and the same MAX_DEPTH
+     * cap on single-writer books.
+     * @param version Receives the snapshot version, or 0 if the book was walked under its lock
+     * @return Number of levels written
+     */
+    int getDepth(bool buySide, int levels, Price* prices, int* quantities,
+                 std::uint64_t* version = nullptr) const;
+
+    /**
+     * @brief Get order book statistics, from the published snapshot
      */
     struct OrderBookStats {
         long long totalTrades;
-        double totalVolume;
-        double lastTradePrice;
+        long long totalVolume;
+        Price lastTradePrice;
         int totalBuyOrders;
         int totalSellOrders;
-        double bestBid;
-        double bestAsk;
-        double spread;
+        Price bestBid;
+        Price bestAsk;
+        Price spread;
     };
 
     OrderBookStats getStatistics() const;
@@ -308,22 +780,52 @@ public:
     const std::string& getSymbol() const { return symbol; }
 
     /**
-     * @brief Check if order book is empty
+     * @brief Get the engine-wide index stored in the top bits of this book's IDs
      */
-    bool isEmpty() const;
-};
+    std::uint16_t getSymbolIndex() const { return symbolIndex; }
 
-// Comparators for price levels
-struct BuyPriceLevelComparator {
-    bool operator()(double a, double b) const {
-        return a < b; // Higher prices first for buy orders
-    }
-};
+    /**
+     * @brief Get the scale used to convert this symbol's tick prices to decimals
+     */
+    const PriceScale& getPriceScale() const { return priceScale; }
 
-struct SellPriceLevelComparator {
-    bool operator()(double a, double b) const {
-        return a > b; // Lower prices first for sell orders
-    }
+    /**
+     * @brief Check if this order book stores its levels in price ladders
+     */
+    bool usesPriceLadder() const { return buyLevels.isLadder(); }
+
+    /**
+     * @brief Check if this book runs without its mutex on a single owning thread
+     */
+    bool isSingleWriter() const { return singleWriter; }
+
+    // Persistence
+    /**
+     * @brief Serialize resting orders, stops, ID sequences and statistics into a snapshot image
+     * Orders are written in price-time priority, so a restore keeps every queue position.
+     * @param lastSequence Sequence number of the last event-log entry applied to this book
+     */
+    void writeSnapshot(std::string& image, std::uint64_t lastSequence) const;
+
+    /**
+     * @brief Copy the state writeSnapshot would serialize into image, leaving the encoding for later
+     * This is the only part of a background snapshot that runs on the book's thread.
+     */
+    void captureSnapshot(BookImage& image, std::uint64_t lastSequence) const;
+
+    /**
+     * @brief Load a snapshot image into this book, which must be empty
+     * Levels are rebuilt whole from the image's sorted runs: each level is created
+     * once and its orders appended in queue order, and each user is interned once.
+     * @return The event-log sequence number the snapshot was taken at
+     * @throws std::runtime_error if the image is corrupt or belongs to another symbol
+     */
+    std::uint64_t restoreSnapshot(const std::string& image);
+
+    /**
+     * @brief Check if order book is empty
+     */
+    bool isEmpty() const;
 };
 
 } // namespace OrderMatchingEngine
@@ -0,0 +1,221 @@
+#ifndef ORDER_ENTRY_PROTOCOL_HPP
+#define ORDER_ENTRY_PROTOCOL_HPP
+
+#include "Order.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace OrderMatchingEngine {
+
+/**
+ * @brief Fixed-layout binary order entry protocol spoken by OrderGateway over TCP
+ *
+ * Every message starts with a MessageHeader whose length covers the whole
+ * message, and has a fixed size per type, so a receiver can frame and decode
+ * messages in place in its receive buffer. Integers are little-endian (host
+ * order on the supported platforms), prices are ticks of the symbol's
+ * PriceScale and symbols are engine symbol indices from reference data.
+ */
+namespace Protocol {
+
+constexpr std::uint8_t PROTOCOL_VERSION = 2;
+
+enum class MessageType : std::uint8_t {
+    // Client to gateway
+    LOGIN = 1,
+    NEW_ORDER = 2,
+    CANCEL_ORDER = 3,
+    REPLACE_ORDER = 4,
+
+    // Gateway to client
+    LOGIN_ACK = 101,
+    ORDER_ACK = 102,
+    ORDER_REJECT = 103,
+    FILL = 104,
+    CANCEL_ACK = 105,
+    CANCEL_REJECT = 106,
+    REPLACE_ACK = 107,
+    REPLACE_REJECT = 108
+};
+
+/**
+ * @brief Why a request was refused
+ */
+enum class RejectReason : std::uint8_t {
+    NONE = 0,
+    NOT_LOGGED_IN,
+    UNKNOWN_SYMBOL,
+    INVALID_ORDER,      // Failed validation in the book (quantity, price, tick, duplicate ID)
+    UNKNOWN_ORDER,      // No open order with that ID owned by this session
+    ENGINE_BUSY         // The shard's ingress ring was full
+};
+
+#pragma pack(push, 1)
+
+struct MessageHeader {
+    std::uint16_t length;           // Whole message, header included
+    MessageType type;
+    std::uint8_t version;
+};
+
+struct Login {
+    MessageHeader header;
+    char userId[16];                // NUL-padded, at most 15 characters
+};
+
+struct NewOrder {
+    MessageHeader header;
+    std::uint64_t clientOrderId;    // Echoed in every report about the order
+    Price price;
+    Price triggerPrice;
+    std::int64_t expireTime;        // GTD only: microseconds since epoch
+    std::int32_t quantity;
+    std::uint16_t symbolIndex;
+    OrderSide side;
+    OrderType orderType;
+    TimeInForce timeInForce;
+};
+
+struct CancelOrder {
+    MessageHeader header;
+    std::uint64_t clientOrderId;
+    OrderId orderId;
+};
+
+struct ReplaceOrder {
+    MessageHeader header;
+    std::uint64_t clientOrderId;
+    OrderId orderId;
+    Price newPrice;                 // 0 to keep the current price
+    std::int32_t newQuantity;       // 0 to keep the current quantity
+};
+
+struct LoginAck {
+    MessageHeader header;
+    std::uint32_t sessionId;
+};
+
+struct OrderAck {
+    MessageHeader header;
+    std::uint64_t clientOrderId;
+    OrderId orderId;
+    OrderStatus status;             // After matching on arrival
+    std::int32_t leavesQuantity;
+};
+
+struct OrderReject {
+    MessageHeader header;
+    std::uint64_t clientOrderId;
+    RejectReason reason;
+};
+
+struct Fill {
+    MessageHeader header;
+    std::uint64_t clientOrderId;
+    OrderId orderId;
+    TradeId tradeId;
+    Price price;
+    std::int32_t quantity;
+    std::int32_t leavesQuantity;
+};
+
+struct CancelAck {
+    MessageHeader header;
+    std::uint64_t clientOrderId;
+    OrderId orderId;
+};
+
+struct CancelReject {
+    MessageHeader header;
+    std::uint64_t clientOrderId;
+    OrderId orderId;
+    RejectReason reason;
+};
+
+struct ReplaceAck {
+    MessageHeader header;
+    std::uint64_t clientOrderId;
+    OrderId orderId;
+    Price price;
+    std::int32_t leavesQuantity;
+};
+
+struct ReplaceReject {
+    MessageHeader header;
+    std::uint64_t clientOrderId;
+    OrderId orderId;
+    RejectReason reason;
+};
+
+#pragma pack(pop)
+
+/**
+ * @brief Largest message a client may send, and largest one the gateway sends
+ * A session's receive and send buffers must hold at least one of each.
+ */
+constexpr size_t MAX_INBOUND_MESSAGE_SIZE =
+    std::max({sizeof(Login), sizeof(NewOrder), sizeof(CancelOrder), sizeof(ReplaceOrder)});
+constexpr size_t MAX_OUTBOUND_MESSAGE_SIZE =
+    std::max({sizeof(LoginAck), sizeof(OrderAck), sizeof(OrderReject), sizeof(Fill), sizeof(CancelAck),
+              sizeof(CancelReject), sizeof(ReplaceAck), sizeof(ReplaceReject)});
+
+/**
+ * @brief Size of a message type, or 0 for an unknown type
+ */
+inline size_t messageSize(MessageType type) {
+    switch (type) {
+        case MessageType::LOGIN:          return sizeof(Login);
+        case MessageType::NEW_ORDER:      return sizeof(NewOrder);
+        case MessageType::CANCEL_ORDER:   return sizeof(CancelOrder);
+        case MessageType::REPLACE_ORDER:  return sizeof(ReplaceOrder);
+        case MessageType::LOGIN_ACK:      return sizeof(LoginAck);
+        case MessageType::ORDER_ACK:      return sizeof(OrderAck);
+        case MessageType::ORDER_REJECT:   return sizeof(OrderReject);
+        case MessageType::FILL:           return sizeof(Fill);
+        case MessageType::CANCEL_ACK:     return sizeof(CancelAck);
+        case MessageType::CANCEL_REJECT:  return sizeof(CancelReject);
+        case MessageType::REPLACE_ACK:    return sizeof(ReplaceAck);
+        case MessageType::REPLACE_REJECT: return sizeof(ReplaceReject);
+    }
+    return 0;
+}
+
+/**
+ * @brief Outcome of framing the bytes at the front of a receive buffer
+ */
+enum class FrameStatus {
+    COMPLETE,       // A whole, well-formed message is available
+    INCOMPLETE,     // Wait for more bytes
+    MALFORMED       // Unknown type, wrong length or version: drop the connection
+};
+
+/**
+ * @brief Check for a complete message at the front of a buffer, without copying it
+ */
+inline FrameStatus frameMessage(const char* data, size_t available, const MessageHeader*& header) {
+    if (available < sizeof(MessageHeader)) {
+        return FrameStatus::INCOMPLETE;
+    }
+    header = reinterpret_cast<const MessageHeader*>(data);
+    if (header->version != PROTOCOL_VERSION || header->length != messageSize(header->type)) {
+        return FrameStatus::MALFORMED;
+    }
+    return available < header->length ? FrameStatus::INCOMPLETE : FrameStatus::COMPLETE;
+}
+
+/**
+ * @brief Fill in the header of an outgoing message
+ */
+template<typename T>
+void initMessage(T& message, MessageType type) {
+    message.header.length = static_cast<std::uint16_t>(sizeof(T));
+    message.header.type = type;
+    message.header.version = PROTOCOL_VERSION;
+}
+
+} // namespace Protocol
+
+} // namespace OrderMatchingEngine
+
+#endif // ORDER_ENTRY_PROTOCOL_HPP
\ No newline at end of file
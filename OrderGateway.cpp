@@ -0,0 +1,597 @@
+#include "OrderGateway.hpp"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdexcept>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace OrderMatchingEngine {
+
+namespace {
+
+const std::uint64_t LISTEN_TOKEN = ~std::uint64_t(0);
+const size_t MAX_SESSION_SLOTS = 65536;
+const int MAX_EVENTS = 64;
+const size_t MAX_REPORTS_PER_LOOP = 4096;
+
+long long currentTimestamp() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+template<typename T>
+const T& messageAs(const Protocol::MessageHeader& header) {
+    // Packed structs have alignment 1, so any offset in the receive buffer is fine
+    return *reinterpret_cast<const T*>(&header);
+}
+
+bool isValidSide(OrderSide side) {
+    return side == OrderSide::BUY || side == OrderSide::SELL;
+}
+
+bool isValidType(OrderType type) {
+    return type == OrderType::LIMIT || type == OrderType::MARKET || type == OrderType::STOP_LOSS;
+}
+
+bool isValidTimeInForce(TimeInForce timeInForce) {
+    return static_cast<std::uint8_t>(timeInForce) <= static_cast<std::uint8_t>(TimeInForce::GTD);
+}
+
+} // namespace
+
+OrderGateway::OrderGateway(const GatewayConfig& config)
+    : config(config), listenSocket(-1), epollDescriptor(-1), boundPort(0), partitionRouter(nullptr),
+      reports(config.reportRingSize),
+      running(false), latencyMonitor(nullptr), latency(nullptr), sessionsAccepted(0), sessionsDropped(0),
+      messagesReceived(0), messagesSent(0) {
+    if (config.maxSessions == 0 || config.maxSessions > MAX_SESSION_SLOTS) {
+        throw std::invalid_argument("Gateway session limit must be between 1 and 65536");
+    }
+    if (config.receiveBufferSize < Protocol::MAX_INBOUND_MESSAGE_SIZE ||
+        config.sendBufferSize < Protocol::MAX_OUTBOUND_MESSAGE_SIZE) {
+        throw std::invalid_argument("Gateway buffers must hold at least one message");
+    }
+
+    sessions.resize(config.maxSessions);
+    for (size_t slot = 0; slot < sessions.size(); ++slot) {
+        Session& session = sessions[slot];
+        session.socket = -1;
+        session.sessionId = static_cast<std::uint32_t>(slot);
+        session.loggedIn = false;
+        session.flushQueued = false;
+        session.waitingForWrite = false;
+        std::memset(session.userId, 0, sizeof(session.userId));
+        session.received = 0;
+        session.sendStart = session.sendEnd = 0;
+    }
+    pendingFlush.reserve(config.maxSessions);
+}
+
+OrderGateway::~OrderGateway() {
+    stop();
+}
+
+void OrderGateway::addRoute(std::uint16_t symbolIndex, MatchingShard* shard) {
+    if (running.load()) {
+        throw std::invalid_argument("Routes must be added before the gateway is started");
+    }
+    if (shardsByIndex.size() <= symbolIndex) {
+        shardsByIndex.resize(static_cast<size_t>(symbolIndex) + 1, nullptr);
+    }
+    shardsByIndex[symbolIndex] = shard;
+}
+
+void OrderGateway::setPartitionRouter(PartitionRouter* router) {
+    if (running.load()) {
+        throw std::invalid_argument("The partition router must be set before the gateway is started");
+    }
+    partitionRouter = router;
+}
+
+MatchingShard* OrderGateway::findShard(std::uint16_t symbolIndex) const {
+    return symbolIndex < shardsByIndex.size() ? shardsByIndex[symbolIndex] : nullptr;
+}
+
+bool OrderGateway::isRemote(std::uint16_t symbolIndex) const {
+    return partitionRouter && partitionRouter->getPartitionMap().getPartition(symbolIndex) >= 0;
+}
+
+bool OrderGateway::start() {
+    if (running.load()) {
+        return true;
+    }
+
+    listenSocket = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenSocket < 0) {
+        return false;
+    }
+    int enable = 1;
+    ::setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(config.port);
+    if (::inet_pton(AF_INET, config.bindAddress.c_str(), &address.sin_addr) != 1 ||
+        ::bind(listenSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(listenSocket, SOMAXCONN) != 0) {
+        closeSockets();
+        return false;
+    }
+    socklen_t length = sizeof(address);
+    ::getsockname(listenSocket, reinterpret_cast<sockaddr*>(&address), &length);
+    boundPort = ntohs(address.sin_port);
+
+    epollDescriptor = ::epoll_create1(EPOLL_CLOEXEC);
+    epoll_event event;
+    event.events = EPOLLIN;
+    event.data.u64 = LISTEN_TOKEN;
+    if (epollDescriptor < 0 || ::epoll_ctl(epollDescriptor, EPOLL_CTL_ADD, listenSocket, &event) != 0) {
+        closeSockets();
+        return false;
+    }
+
+    if (latencyMonitor && !latency) {
+        latency = latencyMonitor->registerThread("gateway", std::thread::id());
+    }
+    running.store(true);
+    thread = std::thread(&OrderGateway::run, this);
+    return true;
+}
+
+void OrderGateway::stop() {
+    if (!running.exchange(false)) {
+        return;
+    }
+    if (thread.joinable()) {
+        thread.join();
+    }
+    for (auto& session : sessions) {
+        if (session.socket >= 0) {
+            closeSession(session);
+        }
+    }
+    closeSockets();
+}
+
+void OrderGateway::closeSockets() {
+    if (epollDescriptor >= 0) {
+        ::close(epollDescriptor);
+        epollDescriptor = -1;
+    }
+    if (listenSocket >= 0) {
+        ::close(listenSocket);
+        listenSocket = -1;
+    }
+}
+
+void OrderGateway::run() {
+    epoll_event events[MAX_EVENTS];
+    while (running.load(std::memory_order_relaxed)) {
+        int count = ::epoll_wait(epollDescriptor, events, MAX_EVENTS, config.pollTimeoutMillis);
+        for (int i = 0; i < count; ++i) {
+            if (events[i].data.u64 == LISTEN_TOKEN) {
+                acceptSessions();
+                continue;
+            }
+            Session* session = findSession(static_cast<std::uint32_t>(events[i].data.u64));
+            if (!session) {
+                continue;   // Closed earlier in this iteration
+            }
+            if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                closeSession(*session);
+                continue;
+            }
+            if (events[i].events & EPOLLIN) {
+                readSession(*session);
+            }
+            if (session->socket >= 0 && (events[i].events & EPOLLOUT)) {
+                flushSession(*session);
+            }
+        }
+        drainReports();
+    }
+}
+
+OrderGateway::Session* OrderGateway::findSession(std::uint32_t sessionId) {
+    size_t slot = sessionId & 0xFFFF;
+    if (slot >= sessions.size()) {
+        return nullptr;
+    }
+    Session& session = sessions[slot];
+    return session.socket >= 0 && session.sessionId == sessionId ? &session : nullptr;
+}
+
+void OrderGateway::acceptSessions() {
+    while (true) {
+        int socket = ::accept4(listenSocket, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (socket < 0) {
+            return; // EAGAIN once the backlog is empty
+        }
+
+        Session* session = nullptr;
+        for (auto& candidate : sessions) {
+            if (candidate.socket < 0) {
+                session = &candidate;
+                break;
+            }
+        }
+        if (!session) {
+            ::close(socket);    // Session limit reached
+            continue;
+        }
+
+        int enable = 1;
+        ::setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+
+        // A new generation makes reports still in flight for the slot's previous session miss
+        session->sessionId += 0x10000;
+        session->socket = socket;
+        session->loggedIn = false;
+        session->flushQueued = false;
+        session->waitingForWrite = false;
+        std::memset(session->userId, 0, sizeof(session->userId));
+        session->received = 0;
+        session->sendStart = session->sendEnd = 0;
+        if (!session->receiveBuffer) {
+            // Allocated once per slot and kept across sessions
+            session->receiveBuffer.reset(new char[config.receiveBufferSize]);
+            session->sendBuffer.reset(new char[config.sendBufferSize]);
+        }
+
+        epoll_event event;
+        event.events = EPOLLIN;
+        event.data.u64 = session->sessionId;
+        if (::epoll_ctl(epollDescriptor, EPOLL_CTL_ADD, socket, &event) != 0) {
+            ::close(socket);
+            session->socket = -1;
+            continue;
+        }
+        sessionsAccepted.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void OrderGateway::closeSession(Session& session) {
+    ::epoll_ctl(epollDescriptor, EPOLL_CTL_DEL, session.socket, nullptr);
+    ::close(session.socket);
+    session.socket = -1;
+    session.loggedIn = false;
+}
+
+void OrderGateway::readSession(Session& session) {
+    ssize_t bytes = ::recv(session.socket, session.receiveBuffer.get() + session.received,
+                           config.receiveBufferSize - session.received, 0);
+    if (bytes == 0 || (bytes < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+        closeSession(session);
+        return;
+    }
+    if (bytes < 0) {
+        return;
+    }
+    session.received += static_cast<size_t>(bytes);
+
+    const char* data = session.receiveBuffer.get();
+    size_t offset = 0;
+    while (true) {
+        const Protocol::MessageHeader* header = nullptr;
+        Protocol::FrameStatus status = Protocol::frameMessage(data + offset, session.received - offset, header);
+        if (status == Protocol::FrameStatus::INCOMPLETE) {
+            break;
+        }
+        if (status == Protocol::FrameStatus::MALFORMED) {
+            sessionsDropped.fetch_add(1, std::memory_order_relaxed);
+            closeSession(session);
+            return;
+        }
+        messagesReceived.fetch_add(1, std::memory_order_relaxed);
+        std::uint64_t start = latency ? CycleClock::now() : 0;
+        handleMessage(session, *header);
+        if (latency) {
+            latency->recordSince(LatencyStage::VALIDATION, start);
+        }
+        if (session.socket < 0) {
+            return;
+        }
+        offset += header->length;
+    }
+
+    // Keep a partial message at the front for the next read
+    if (offset > 0) {
+        std::memmove(session.receiveBuffer.get(), data + offset, session.received - offset);
+        session.received -= offset;
+    }
+}
+
+void OrderGateway::handleMessage(Session& session, const Protocol::MessageHeader& header) {
+    switch (header.type) {
+        case Protocol::MessageType::LOGIN:
+            handleLogin(session, messageAs<Protocol::Login>(header));
+            return;
+        case Protocol::MessageType::NEW_ORDER:
+            handleNewOrder(session, messageAs<Protocol::NewOrder>(header));
+            return;
+        case Protocol::MessageType::CANCEL_ORDER:
+            handleCancel(session, messageAs<Protocol::CancelOrder>(header));
+            return;
+        case Protocol::MessageType::REPLACE_ORDER:
+            handleReplace(session, messageAs<Protocol::ReplaceOrder>(header));
+            return;
+        default:
+            // Well-formed but only valid from the gateway to a client
+            sessionsDropped.fetch_add(1, std::memory_order_relaxed);
+            closeSession(session);
+            return;
+    }
+}
+
+void OrderGateway::handleLogin(Session& session, const Protocol::Login& message) {
+    // The user ID has to fit an OrderEntry with its terminator
+    if (session.loggedIn || message.userId[0] == '\0' ||
+        message.userId[sizeof(message.userId) - 1] != '\0') {
+        sessionsDropped.fetch_add(1, std::memory_order_relaxed);
+        closeSession(session);
+        return;
+    }
+    std::memcpy(session.userId, message.userId, sizeof(session.userId));
+    session.loggedIn = true;
+
+    Protocol::LoginAck ack;
+    Protocol::initMessage(ack, Protocol::MessageType::LOGIN_ACK);
+    ack.sessionId = session.sessionId;
+    send(session, ack);
+}
+
+void OrderGateway::handleNewOrder(Session& session, const Protocol::NewOrder& message) {
+    Protocol::RejectReason reason = Protocol::RejectReason::NONE;
+    MatchingShard* shard = findShard(message.symbolIndex);
+    bool remote = !shard && isRemote(message.symbolIndex);
+    if (!session.loggedIn) {
+        reason = Protocol::RejectReason::NOT_LOGGED_IN;
+    } else if (!shard && !remote) {
+        reason = Protocol::RejectReason::UNKNOWN_SYMBOL;
+    } else if (!isValidSide(message.side) || !isValidType(message.orderType) ||
+               !isValidTimeInForce(message.timeInForce)) {
+        reason = Protocol::RejectReason::INVALID_ORDER;
+    } else {
+        OrderEntry entry;
+        entry.orderId = 0;
+        entry.price = message.price;
+        entry.triggerPrice = message.triggerPrice;
+        entry.timestamp = currentTimestamp();
+        entry.expireTime = message.expireTime;
+        entry.quantity = message.quantity;
+        entry.type = message.orderType;
+        entry.side = message.side;
+        entry.timeInForce = message.timeInForce;
+        std::memcpy(entry.userId, session.userId, sizeof(entry.userId));
+        bool queued = remote
+            ? partitionRouter->submitEntry(message.symbolIndex, entry, session.sessionId, message.clientOrderId)
+            : shard->submitEntry(message.symbolIndex, entry,
+                                 ReplyRoute(&reports, session.sessionId, message.clientOrderId));
+        if (!queued) {
+            reason = Protocol::RejectReason::ENGINE_BUSY;
+        }
+    }
+
+    if (reason != Protocol::RejectReason::NONE) {
+        Protocol::OrderReject reject;
+        Protocol::initMessage(reject, Protocol::MessageType::ORDER_REJECT);
+        reject.clientOrderId = message.clientOrderId;
+        reject.reason = reason;
+        send(session, reject);
+    }
+}
+
+void OrderGateway::handleCancel(Session& session, const Protocol::CancelOrder& message) {
+    Protocol::RejectReason reason = Protocol::RejectReason::NONE;
+    MatchingShard* shard = findShard(getSymbolIndex(message.orderId));
+    bool remote = !shard && isRemote(getSymbolIndex(message.orderId));
+    if (!session.loggedIn) {
+        reason = Protocol::RejectReason::NOT_LOGGED_IN;
+    } else if (!shard && !remote) {
+        reason = Protocol::RejectReason::UNKNOWN_ORDER;
+    } else if (remote ? !partitionRouter->cancelOrder(message.orderId, session.sessionId, message.clientOrderId)
+                      : !shard->cancelOrder(message.orderId,
+                                            ReplyRoute(&reports, session.sessionId, message.clientOrderId))) {
+        reason = Protocol::RejectReason::ENGINE_BUSY;
+    }
+
+    if (reason != Protocol::RejectReason::NONE) {
+        Protocol::CancelReject reject;
+        Protocol::initMessage(reject, Protocol::MessageType::CANCEL_REJECT);
+        reject.clientOrderId = message.clientOrderId;
+        reject.orderId = message.orderId;
+        reject.reason = reason;
+        send(session, reject);
+    }
+}
+
+void OrderGateway::handleReplace(Session& session, const Protocol::ReplaceOrder& message) {
+    Protocol::RejectReason reason = Protocol::RejectReason::NONE;
+    MatchingShard* shard = findShard(getSymbolIndex(message.orderId));
+    bool remote = !shard && isRemote(getSymbolIndex(message.orderId));
+    if (!session.loggedIn) {
+        reason = Protocol::RejectReason::NOT_LOGGED_IN;
+    } else if (!shard && !remote) {
+        reason = Protocol::RejectReason::UNKNOWN_ORDER;
+    } else if (message.newPrice < 0 || message.newQuantity < 0) {
+        reason = Protocol::RejectReason::INVALID_ORDER;
+    } else if (remote ? !partitionRouter->modifyOrder(message.orderId, message.newPrice, message.newQuantity,
+                                                      session.sessionId, message.clientOrderId)
+                      : !shard->modifyOrder(message.orderId, message.newPrice, message.newQuantity,
+                                            ReplyRoute(&reports, session.sessionId, message.clientOrderId))) {
+        reason = Protocol::RejectReason::ENGINE_BUSY;
+    }
+
+    if (reason != Protocol::RejectReason::NONE) {
+        Protocol::ReplaceReject reject;
+        Protocol::initMessage(reject, Protocol::MessageType::REPLACE_REJECT);
+        reject.clientOrderId = message.clientOrderId;
+        reject.orderId = message.orderId;
+        reject.reason = reason;
+        send(session, reject);
+    }
+}
+
+void OrderGateway::drainReports() {
+    ExecutionReport report;
+    for (size_t i = 0; i < MAX_REPORTS_PER_LOOP && reports.tryPop(report); ++i) {
+        Session* session = findSession(report.sessionId);
+        if (session) {
+            encodeReport(*session, report);
+        }
+    }
+    if (partitionRouter) {
+        partitionRouter->pollReports([this](const ExecutionReport& remoteReport) {
+            Session* session = findSession(remoteReport.sessionId);
+            if (session) {
+                encodeReport(*session, remoteReport);
+            }
+        }, MAX_REPORTS_PER_LOOP);
+    }
+
+    // One send per session for everything queued in this iteration
+    for (std::uint32_t slot : pendingFlush) {
+        Session& session = sessions[slot];
+        session.flushQueued = false;
+        if (session.socket >= 0 && !session.waitingForWrite) {
+            flushSession(session);
+        }
+    }
+    pendingFlush.clear();
+}
+
+void OrderGateway::encodeReport(Session& session, const ExecutionReport& report) {
+    switch (report.type) {
+        case ExecutionReport::Type::ACCEPTED: {
+            Protocol::OrderAck ack;
+            Protocol::initMessage(ack, Protocol::MessageType::ORDER_ACK);
+            ack.clientOrderId = report.clientOrderId;
+            ack.orderId = report.orderId;
+            ack.status = report.status;
+            ack.leavesQuantity = report.leavesQuantity;
+            send(session, ack);
+            return;
+        }
+        case ExecutionReport::Type::REJECTED: {
+            Protocol::OrderReject reject;
+            Protocol::initMessage(reject, Protocol::MessageType::ORDER_REJECT);
+            reject.clientOrderId = report.clientOrderId;
+            reject.reason = report.reason;
+            send(session, reject);
+            return;
+        }
+        case ExecutionReport::Type::FILL: {
+            Protocol::Fill fill;
+            Protocol::initMessage(fill, Protocol::MessageType::FILL);
+            fill.clientOrderId = report.clientOrderId;
+            fill.orderId = report.orderId;
+            fill.tradeId = report.tradeId;
+            fill.price = report.price;
+            fill.quantity = report.quantity;
+            fill.leavesQuantity = report.leavesQuantity;
+            send(session, fill);
+            return;
+        }
+        case ExecutionReport::Type::CANCELLED: {
+            Protocol::CancelAck ack;
+            Protocol::initMessage(ack, Protocol::MessageType::CANCEL_ACK);
+            ack.clientOrderId = report.clientOrderId;
+            ack.orderId = report.orderId;
+            send(session, ack);
+            return;
+        }
+        case ExecutionReport::Type::CANCEL_REJECTED: {
+            Protocol::CancelReject reject;
+            Protocol::initMessage(reject, Protocol::MessageType::CANCEL_REJECT);
+            reject.clientOrderId = report.clientOrderId;
+            reject.orderId = report.orderId;
+            reject.reason = report.reason;
+            send(session, reject);
+            return;
+        }
+        case ExecutionReport::Type::REPLACED: {
+            Protocol::ReplaceAck ack;
+            Protocol::initMessage(ack, Protocol::MessageType::REPLACE_ACK);
+            ack.clientOrderId = report.clientOrderId;
+            ack.orderId = report.orderId;
+            ack.price = report.price;
+            ack.leavesQuantity = report.leavesQuantity;
+            send(session, ack);
+            return;
+        }
+        case ExecutionReport::Type::REPLACE_REJECTED: {
+            Protocol::ReplaceReject reject;
+            Protocol::initMessage(reject, Protocol::MessageType::REPLACE_REJECT);
+            reject.clientOrderId = report.clientOrderId;
+            reject.orderId = report.orderId;
+            reject.reason = report.reason;
+            send(session, reject);
+            return;
+        }
+    }
+}
+
+bool OrderGateway::queueMessage(Session& session, const void* message, size_t size) {
+    if (session.sendEnd + size > config.sendBufferSize && session.sendStart > 0) {
+        std::memmove(session.sendBuffer.get(), session.sendBuffer.get() + session.sendStart,
+                     session.sendEnd - session.sendStart);
+        session.sendEnd -= session.sendStart;
+        session.sendStart = 0;
+    }
+    if (session.sendEnd + size > config.sendBufferSize) {
+        // The client is not reading its reports; holding more would only delay everyone else
+        sessionsDropped.fetch_add(1, std::memory_order_relaxed);
+        closeSession(session);
+        return false;
+    }
+
+    std::memcpy(session.sendBuffer.get() + session.sendEnd, message, size);
+    session.sendEnd += size;
+    messagesSent.fetch_add(1, std::memory_order_relaxed);
+    if (!session.flushQueued) {
+        session.flushQueued = true;
+        pendingFlush.push_back(session.sessionId & 0xFFFF);
+    }
+    return true;
+}
+
+void OrderGateway::flushSession(Session& session) {
+    while (session.sendStart < session.sendEnd) {
+        ssize_t bytes = ::send(session.socket, session.sendBuffer.get() + session.sendStart,
+                               session.sendEnd - session.sendStart, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (bytes < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                setWriteInterest(session, true);   // Resume when the socket drains
+                return;
+            }
+            closeSession(session);
+            return;
+        }
+        session.sendStart += static_cast<size_t>(bytes);
+    }
+    session.sendStart = session.sendEnd = 0;
+    setWriteInterest(session, false);
+}
+
+void OrderGateway::setWriteInterest(Session& session, bool enabled) {
+    if (session.waitingForWrite == enabled) {
+        return;
+    }
+    epoll_event event;
+    event.events = enabled ? (EPOLLIN | EPOLLOUT) : EPOLLIN;
+    event.data.u64 = session.sessionId;
+    ::epoll_ctl(epollDescriptor, EPOLL_CTL_MOD, session.socket, &event);
+    session.waitingForWrite = enabled;
+}
+
+} // namespace OrderMatchingEngine
\ No newline at end of file
@@ -0,0 +1,149 @@
+#ifndef ORDER_GATEWAY_HPP
+#define ORDER_GATEWAY_HPP
+
+#include "MatchingShard.hpp"
+#include "OrderEntryProtocol.hpp"
+#include "Partitioning.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace OrderMatchingEngine {
+
+/**
+ * @brief TCP front end speaking the binary order entry protocol
+ *
+ * One thread runs an epoll loop over the listening socket and every session.
+ * Requests are framed and decoded in place in the session's fixed receive
+ * buffer and pushed straight into the owning shard's ingress ring as plain
+ * OrderEntry commands: no Order object, string or other heap allocation is
+ * made per message. Shards answer on the gateway's report ring, which the
+ * same loop drains into each session's fixed send buffer.
+ *
+ * A session that sends a malformed message, or reads its reports too slowly
+ * for its send buffer to hold them, is disconnected.
+ */
+class OrderGateway {
+public:
+    struct GatewayConfig {
+        std::string bindAddress;        // IPv4 address to listen on
+        std::uint16_t port;             // 0 picks a free port, see getPort()
+        size_t maxSessions;             // At most 65536
+        size_t receiveBufferSize;       // Per session
+        size_t sendBufferSize;          // Per session
+        size_t reportRingSize;          // Execution reports in flight from all shards
+        int pollTimeoutMillis;          // epoll wait when idle; 0 busy-polls for the lowest report latency
+
+        GatewayConfig()
+            : bindAddress("0.0.0.0"), port(9001), maxSessions(256), receiveBufferSize(64 * 1024),
+              sendBufferSize(256 * 1024), reportRingSize(65536), pollTimeoutMillis(0) {}
+    };
+
+private:
+    struct Session {
+        int socket;                     // -1 while the slot is free
+        std::uint32_t sessionId;        // Generation in the high bits, slot in the low 16
+        bool loggedIn;
+        bool flushQueued;
+        bool waitingForWrite;           // EPOLLOUT armed because the socket was full
+        char userId[OrderEntry::USER_ID_SIZE];
+        std::unique_ptr<char[]> receiveBuffer;
+        size_t received;
+        std::unique_ptr<char[]> sendBuffer;
+        size_t sendStart;
+        size_t sendEnd;
+    };
+
+    GatewayConfig config;
+    int listenSocket;
+    int epollDescriptor;
+    std::uint16_t boundPort;
+
+    std::vector<Session> sessions;              // Gateway thread only
+    std::vector<std::uint32_t> pendingFlush;    // Slots with reports queued this loop iteration
+    std::vector<MatchingShard*> shardsByIndex;  // Symbol index -> owning shard
+    PartitionRouter* partitionRouter;           // Symbols of other partitions (may be null)
+    ReportRing reports;
+
+    std::thread thread;
+    std::atomic<bool> running;
+    LatencyMonitor* latencyMonitor;
+    ThreadLatencyRecorder* latency;             // Gateway thread only
+
+    std::atomic<long long> sessionsAccepted;
+    std::atomic<long long> sessionsDropped;     // Malformed input or a send buffer overrun
+    std::atomic<long long> messagesReceived;
+    std::atomic<long long> messagesSent;
+
+    void run();
+    void acceptSessions();
+    void readSession(Session& session);
+    void handleMessage(Session& session, const Protocol::MessageHeader& header);
+    void handleLogin(Session& session, const Protocol::Login& message);
+    void handleNewOrder(Session& session, const Protocol::NewOrder& message);
+    void handleCancel(Session& session, const Protocol::CancelOrder& message);
+    void handleReplace(Session& session, const Protocol::ReplaceOrder& message);
+    void drainReports();
+    void encodeReport(Session& session, const ExecutionReport& report);
+    bool queueMessage(Session& session, const void* message, size_t size);
+    void flushSession(Session& session);
+    void setWriteInterest(Session& session, bool enabled);
+    void closeSession(Session& session);
+    Session* findSession(std::uint32_t sessionId);
+    MatchingShard* findShard(std::uint16_t symbolIndex) const;
+    bool isRemote(std::uint16_t symbolIndex) const;
+    void closeSockets();
+
+    template<typename T>
+    bool send(Session& session, const T& message) { return queueMessage(session, &message, sizeof(T)); }
+
+public:
+    explicit OrderGateway(const GatewayConfig& config = GatewayConfig());
+    ~OrderGateway();
+
+    OrderGateway(const OrderGateway&) = delete;
+    OrderGateway& operator=(const OrderGateway&) = delete;
+
+    /**
+     * @brief Send orders for a symbol index to the shard that owns it (before start() only)
+     */
+    void addRoute(std::uint16_t symbolIndex, MatchingShard* shard);
+
+    /**
+     * @brief Send orders for symbols without a local route to their partition process (before start() only)
+     * The gateway thread becomes the router's single routing and polling thread.
+     */
+    void setPartitionRouter(PartitionRouter* router);
+
+    /**
+     * @brief Time the handling of every request, up to its push into a shard (before start() only)
+     * Recorded as LatencyStage::VALIDATION by the gateway thread.
+     */
+    void setLatencyMonitor(LatencyMonitor* monitor) { latencyMonitor = monitor; }
+
+    /**
+     * @brief Listen and start the gateway thread
+     * @return False if the listening socket could not be set up
+     */
+    bool start();
+
+    /**
+     * @brief Stop the gateway thread and disconnect every session
+     */
+    void stop();
+
+    bool isRunning() const { return running.load(std::memory_order_relaxed); }
+    std::uint16_t getPort() const { return boundPort; }     // Valid after start()
+
+    long long getSessionsAccepted() const { return sessionsAccepted.load(std::memory_order_relaxed); }
+    long long getSessionsDropped() const { return sessionsDropped.load(std::memory_order_relaxed); }
+    long long getMessagesReceived() const { return messagesReceived.load(std::memory_order_relaxed); }
+    long long getMessagesSent() const { return messagesSent.load(std::memory_order_relaxed); }
+};
+
+} // namespace OrderMatchingEngine
+
+#endif // ORDER_GATEWAY_HPP
\ No newline at end of file
@@ -0,0 +1,38 @@
+#include "OrderPool.hpp"
+#include <stdexcept>
+
+namespace OrderMatchingEngine {
+
+// OrderPool implementation
+OrderPool::OrderPool() : freeHead(NULL_ORDER_INDEX), nextUnused(0), liveCount(0) {
+}
+
+void OrderPool::addSlab() {
+    if (capacity() + SLAB_SIZE > NULL_ORDER_INDEX) {
+        throw std::length_error("Order pool exhausted");
+    }
+    slabs.emplace_back(new BookOrder[SLAB_SIZE]);
+    detailSlabs.emplace_back(new OrderDetails[SLAB_SIZE]);
+}
+
+void OrderPool::reserve(size_t records) {
+    while (capacity() < records) {
+        addSlab();
+    }
+}
+
+// StringInterner implementation
+std::uint32_t StringInterner::intern(const std::string& value) {
+    auto [it, inserted] = ids.try_emplace(value, static_cast<std::uint32_t>(names.size()));
+    if (inserted) {
+        names.push_back(&it->first);
+    }
+    return it->second;
+}
+
+std::uint32_t StringInterner::find(const std::string& value) const {
+    auto it = ids.find(value);
+    return it != ids.end() ? it->second : NOT_FOUND;
+}
+
+} // namespace OrderMatchingEngine
\ No newline at end of file
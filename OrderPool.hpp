@@ -0,0 +1,189 @@
+#ifndef ORDER_POOL_HPP
+#define ORDER_POOL_HPP
+
+#include "Order.hpp"
+#include "RingBuffer.hpp"
+#include "TimerWheel.hpp"
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <cstdint>
+#include <limits>
+
+namespace OrderMatchingEngine {
+
+class PriceLevel;
+
+/**
+ * @brief Index of an order record inside an OrderPool
+ */
+using OrderIndex = std::uint32_t;
+constexpr OrderIndex NULL_ORDER_INDEX = std::numeric_limits<OrderIndex>::max();
+
+/**
+ * @brief Hot part of the order record kept by an OrderBook for every order it holds
+ *
+ * Only what the match loop reads and writes lives here, packed into half a
+ * cache line: walking a price level's FIFO and filling its orders touches
+ * one line per order and nothing else. Everything matching does not need is
+ * in the record's OrderDetails, kept in a parallel array under the same index.
+ */
+struct alignas(32) BookOrder {
+    OrderId orderId;                // Engine-assigned order ID
+    Price price;                    // Limit price in ticks (0 for market orders)
+    int remainingQuantity;          // Quantity still open
+
+    // FIFO links within the price level
+    OrderIndex prevInLevel;
+    OrderIndex nextInLevel;
+
+    OrderType type;
+    OrderSide side;
+    OrderStatus status;
+    TimeInForce timeInForce;
+
+    bool isBuy() const { return side == OrderSide::BUY; }
+    bool isMarket() const { return type == OrderType::MARKET; }
+    bool isStopLoss() const { return type == OrderType::STOP_LOSS; }
+
+    /**
+     * @brief Reduces the remaining quantity after a fill and updates the status
+     */
+    void fill(int filledQuantity) {
+        remainingQuantity -= filledQuantity;
+        status = remainingQuantity == 0 ? OrderStatus::FILLED : OrderStatus::PARTIAL_FILL;
+    }
+};
+
+static_assert(sizeof(BookOrder) == 32, "BookOrder must stay half a cache line");
+
+/**
+ * @brief Cold part of an order record: bookkeeping read when an order enters,
+ * leaves or is queried, never while it is matched
+ * Strings are interned or stored out of line, and records reference each
+ * other by index rather than by shared_ptr.
+ */
+struct alignas(CACHE_LINE_SIZE) OrderDetails {
+    PriceLevel* level;              // Level the order rests in (nullptr if not resting)
+    Price triggerPrice;             // Stop-loss trigger in ticks (0 if not applicable)
+    long long timestamp;            // Creation timestamp (microseconds since epoch)
+    long long expireTime;           // DAY/GTD deadline (0 if the order does not expire)
+    TimerId expiryTimer;            // Pending expiry in the book's timer wheel
+    const std::string* clientOrderId; // Out-of-line client order ID (nullptr if none)
+    int quantity;                   // Original quantity
+    std::uint32_t userIndex;        // Interned user ID
+
+    // Links within the owner's order list
+    OrderIndex prevForUser;
+    OrderIndex nextForUser;
+};
+
+static_assert(sizeof(OrderDetails) == CACHE_LINE_SIZE, "OrderDetails must stay one cache line");
+
+/**
+ * @brief Slab allocator for order records with free-list recycling
+ *
+ * Records are carved out of fixed-size slabs, so a record never moves once
+ * allocated and references stay valid while the pool grows. Released records
+ * are chained through nextInLevel and handed out again before a new slab is
+ * allocated, which keeps the steady-state submit path free of malloc/free.
+ *
+ * Each slab is a pair of arrays, hot BookOrder parts and cold OrderDetails,
+ * so the orders of a busy level share cache lines with each other rather
+ * than with their own bookkeeping.
+ */
+class OrderPool {
+private:
+    static constexpr OrderIndex SLAB_BITS = 12;
+    static constexpr OrderIndex SLAB_SIZE = OrderIndex(1) << SLAB_BITS;
+
+    std::vector<std::unique_ptr<BookOrder[]>> slabs;
+    std::vector<std::unique_ptr<OrderDetails[]>> detailSlabs;  // Parallel to slabs
+    OrderIndex freeHead;        // Most recently released record
+    OrderIndex nextUnused;      // First never-used index in the last slab
+    size_t liveCount;
+
+    void addSlab();
+
+public:
+    OrderPool();
+
+    /**
+     * @brief Take a record from the pool; its contents are unspecified
+     */
+    OrderIndex acquire() {
+        OrderIndex index;
+        if (freeHead != NULL_ORDER_INDEX) {
+            index = freeHead;
+            freeHead = (*this)[index].nextInLevel;
+        } else {
+            if (nextUnused == slabs.size() * SLAB_SIZE) {
+                addSlab();
+            }
+            index = nextUnused++;
+        }
+        liveCount++;
+        return index;
+    }
+
+    /**
+     * @brief Return a record to the pool for reuse
+     */
+    void release(OrderIndex index) {
+        (*this)[index].nextInLevel = freeHead;
+        freeHead = index;
+        liveCount--;
+    }
+
+    BookOrder& operator[](OrderIndex index) {
+        return slabs[index >> SLAB_BITS][index & (SLAB_SIZE - 1)];
+    }
+    const BookOrder& operator[](OrderIndex index) const {
+        return slabs[index >> SLAB_BITS][index & (SLAB_SIZE - 1)];
+    }
+
+    OrderDetails& details(OrderIndex index) {
+        return detailSlabs[index >> SLAB_BITS][index & (SLAB_SIZE - 1)];
+    }
+    const OrderDetails& details(OrderIndex index) const {
+        return detailSlabs[index >> SLAB_BITS][index & (SLAB_SIZE - 1)];
+    }
+
+    /**
+     * @brief Pre-allocate slabs so that at least the given number of records fit
+     */
+    void reserve(size_t records);
+
+    size_t size() const { return liveCount; }
+    size_t capacity() const { return slabs.size() * SLAB_SIZE; }
+};
+
+/**
+ * @brief Maps strings to dense integer IDs and back
+ */
+class StringInterner {
+private:
+    std::unordered_map<std::string, std::uint32_t> ids;
+    std::vector<const std::string*> names;  // Points at the keys of ids, which never move
+
+public:
+    static constexpr std::uint32_t NOT_FOUND = std::numeric_limits<std::uint32_t>::max();
+
+    /**
+     * @brief Get the ID of a string, assigning the next free ID on first use
+     */
+    std::uint32_t intern(const std::string& value);
+
+    /**
+     * @brief Get the ID of a string without interning it
+     * @return The ID, or NOT_FOUND if the string was never interned
+     */
+    std::uint32_t find(const std::string& value) const;
+
+    const std::string& lookup(std::uint32_t id) const { return *names[id]; }
+    size_t size() const { return names.size(); }
+};
+
+} // namespace OrderMatchingEngine
+
+#endif // ORDER_POOL_HPP
\ No newline at end of file
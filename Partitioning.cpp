@@ -0,0 +1,516 @@
+#include "Partitioning.hpp"
+#include <cerrno>
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <sys/stat.h>
+
+namespace OrderMatchingEngine {
+
+namespace {
+
+const std::uint64_t SEQUENCER_MAGIC = 0x4F4D455345513031ull;   // "OMESEQ01"
+const std::uint64_t CHANNEL_MAGIC = 0x4F4D455041525431ull;     // "OMEPART1"
+const size_t MAX_COMMANDS_PER_LOOP = 256;
+const size_t MAX_REPORTS_PER_LOOP = 1024;
+const long long SNAPSHOT_INTERVAL_MICROS = 100;     // Also the heartbeat interval
+const int CONNECT_RETRY_MILLIS = 10;
+
+// Monotonic and system-wide on Linux, so heartbeats compare across processes
+long long monotonicMicros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+// PartitionMap implementation
+PartitionMap::PartitionMap(size_t partitionCount) : partitionCount(partitionCount) {
+    if (partitionCount == 0) {
+        throw std::invalid_argument("A deployment needs at least one partition");
+    }
+}
+
+int PartitionMap::hashPartition(const std::string& symbol, size_t partitionCount) {
+    std::uint64_t hash = 0xcbf29ce484222325ull;
+    for (unsigned char c : symbol) {
+        hash = (hash ^ c) * 0x100000001b3ull;
+    }
+    return static_cast<int>(hash % partitionCount);
+}
+
+void PartitionMap::addSymbol(const std::string& symbol, const SymbolConfig& config, int partition) {
+    if (partition < -1 || partition >= static_cast<int>(partitionCount)) {
+        throw std::invalid_argument("Partition is out of range");
+    }
+    if (indexBySymbol.count(symbol) ||
+        (config.symbolIndex < symbolsByIndex.size() && symbolsByIndex[config.symbolIndex].partition >= 0)) {
+        throw std::invalid_argument("Symbol or symbol index is already mapped");
+    }
+    if (symbolsByIndex.size() <= config.symbolIndex) {
+        symbolsByIndex.resize(static_cast<size_t>(config.symbolIndex) + 1, SymbolEntry{"", SymbolConfig(), -1});
+    }
+    symbolsByIndex[config.symbolIndex] = SymbolEntry{
+        symbol, config, partition >= 0 ? partition : hashPartition(symbol, partitionCount)};
+    indexBySymbol[symbol] = config.symbolIndex;
+}
+
+int PartitionMap::getPartition(const std::string& symbol) const {
+    auto it = indexBySymbol.find(symbol);
+    return it != indexBySymbol.end() ? getPartition(it->second) : -1;
+}
+
+const std::string* PartitionMap::getSymbol(std::uint16_t symbolIndex) const {
+    return getPartition(symbolIndex) >= 0 ? &symbolsByIndex[symbolIndex].symbol : nullptr;
+}
+
+const SymbolConfig* PartitionMap::getSymbolConfig(std::uint16_t symbolIndex) const {
+    return getPartition(symbolIndex) >= 0 ? &symbolsByIndex[symbolIndex].config : nullptr;
+}
+
+std::vector<std::uint16_t> PartitionMap::getSymbolIndexes(int partition) const {
+    std::vector<std::uint16_t> indexes;
+    for (size_t index = 0; index < symbolsByIndex.size(); ++index) {
+        int owner = symbolsByIndex[index].partition;
+        if (owner >= 0 && (partition < 0 || owner == partition)) {
+            indexes.push_back(static_cast<std::uint16_t>(index));
+        }
+    }
+    return indexes;
+}
+
+// Sequencer implementation
+Sequencer::Sequencer() : state(nullptr) {
+}
+
+bool Sequencer::create(const std::string& name, std::uint64_t startAfter) {
+    state = nullptr;
+    if (!region.create(name, sizeof(State))) {
+        return false;
+    }
+    State* created = new (region.getAddress()) State();
+    created->sequence.store(startAfter, std::memory_order_relaxed);
+    created->magic.store(SEQUENCER_MAGIC, std::memory_order_release);
+    state = created;
+    return true;
+}
+
+bool Sequencer::open(const std::string& name) {
+    state = nullptr;
+    if (!region.open(name) || region.getSize() < sizeof(State)) {
+        return false;
+    }
+    State* opened = static_cast<State*>(region.getAddress());
+    if (opened->magic.load(std::memory_order_acquire) != SEQUENCER_MAGIC) {
+        region.close();
+        return false;
+    }
+    state = opened;
+    return true;
+}
+
+// PartitionChannel implementation
+PartitionChannel::PartitionChannel() : header(nullptr), snapshots(nullptr) {
+}
+
+std::string PartitionChannel::nameFor(const std::string& prefix, int partition) {
+    return prefix + "-partition-" + std::to_string(partition);
+}
+
+size_t PartitionChannel::commandOffset() {
+    return alignToCacheLine(sizeof(Header));
+}
+
+size_t PartitionChannel::reportOffset(const ChannelConfig& config) {
+    return commandOffset() + SharedSpscRing<PartitionCommand>::bytesFor(config.commandCapacity);
+}
+
+size_t PartitionChannel::snapshotOffset(const ChannelConfig& config) {
+    return reportOffset(config) + SharedSpscRing<ExecutionReport>::bytesFor(config.reportCapacity);
+}
+
+void PartitionChannel::attachLayout(const ChannelConfig& config) {
+    char* base = static_cast<char*>(region.getAddress());
+    commandRing.attach(base + commandOffset());
+    reportRing.attach(base + reportOffset(config));
+    snapshots = reinterpret_cast<SeqLock<MarketDataSnapshot>*>(base + snapshotOffset(config));
+}
+
+bool PartitionChannel::create(const std::string& name, int partitionId, const ChannelConfig& config) {
+    close();
+    size_t size = snapshotOffset(config) + config.symbolCapacity * sizeof(SeqLock<MarketDataSnapshot>);
+    if (!region.create(name, size)) {
+        return false;
+    }
+
+    char* base = static_cast<char*>(region.getAddress());
+    Header* created = new (base) Header();
+    created->magic = CHANNEL_MAGIC;
+    created->partitionId = static_cast<std::uint32_t>(partitionId);
+    created->symbolCapacity = static_cast<std::uint32_t>(config.symbolCapacity);
+    created->commandCapacity = config.commandCapacity;
+    created->reportCapacity = config.reportCapacity;
+    created->heartbeatMicros.store(monotonicMicros(), std::memory_order_relaxed);
+
+    SharedSpscRing<PartitionCommand> commandLayout;
+    commandLayout.initialize(base + commandOffset(), config.commandCapacity);
+    SharedSpscRing<ExecutionReport> reportLayout;
+    reportLayout.initialize(base + reportOffset(config), config.reportCapacity);
+    SeqLock<MarketDataSnapshot>* slots = reinterpret_cast<SeqLock<MarketDataSnapshot>*>(base + snapshotOffset(config));
+    for (size_t i = 0; i < config.symbolCapacity; ++i) {
+        new (&slots[i]) SeqLock<MarketDataSnapshot>();
+    }
+
+    attachLayout(config);
+    created->ready.store(1, std::memory_order_release);
+    header = created;
+    return true;
+}
+
+bool PartitionChannel::open(const std::string& name) {
+    close();
+    if (!region.open(name) || region.getSize() < sizeof(Header)) {
+        region.close();
+        return false;
+    }
+    Header* opened = static_cast<Header*>(region.getAddress());
+    if (opened->ready.load(std::memory_order_acquire) != 1 || opened->magic != CHANNEL_MAGIC) {
+        region.close();
+        return false;   // Not initialized yet: the partition is still starting
+    }
+
+    ChannelConfig config;
+    config.commandCapacity = opened->commandCapacity;
+    config.reportCapacity = opened->reportCapacity;
+    config.symbolCapacity = opened->symbolCapacity;
+    if (region.getSize() < snapshotOffset(config) + config.symbolCapacity * sizeof(SeqLock<MarketDataSnapshot>)) {
+        region.close();
+        return false;
+    }
+    attachLayout(config);
+    header = opened;
+    return true;
+}
+
+void PartitionChannel::close() {
+    header = nullptr;
+    snapshots = nullptr;
+    region.close();
+}
+
+// PartitionServer implementation
+PartitionServer::PartitionServer(const PartitionMap& partitionMap, const ServerConfig& config)
+    : partitionMap(partitionMap), config(config), reports(config.channel.reportCapacity), running(false),
+      hasPendingCommand(false), pendingCommand(), hasPendingReport(false), commandsForwarded(0),
+      reportsForwarded(0), snapshotsPublished(0), rejectsDropped(0) {
+    if (config.partitionId < 0 || config.partitionId >= static_cast<int>(partitionMap.getPartitionCount())) {
+        throw std::invalid_argument("Partition ID is not in the partition map");
+    }
+
+    // The partition's symbols are dealt round robin over its shards
+    int shardCount = std::max(1, config.numShards);
+    for (int i = 0; i < shardCount; ++i) {
+        int core = config.firstCore >= 0 ? config.firstCore + i : -1;
+        shards.push_back(std::make_unique<MatchingShard>(i, config.ingressRingSize, core));
+    }
+    shardsByIndex.resize(partitionMap.getSymbolIndexLimit(), nullptr);
+    size_t next = 0;
+    for (std::uint16_t index : partitionMap.getSymbolIndexes(config.partitionId)) {
+        MatchingShard* shard = shards[next++ % shards.size()].get();
+        books.push_back(shard->addSymbol(*partitionMap.getSymbol(index), *partitionMap.getSymbolConfig(index)));
+        shardsByIndex[index] = shard;
+    }
+    publishedVersions.resize(books.size(), 0);
+}
+
+PartitionServer::~PartitionServer() {
+    stop();
+}
+
+bool PartitionServer::start() {
+    if (running.load()) {
+        return true;
+    }
+    if (!config.sequencerName.empty() && !sequencer.isOpen() && !sequencer.open(config.sequencerName)) {
+        return false;
+    }
+
+    if (!config.eventLogDirectory.empty() && eventLogs.empty()) {
+        if (::mkdir(config.eventLogDirectory.c_str(), 0755) != 0 && errno != EEXIST) {
+            return false;
+        }
+        for (const auto& shard : shards) {
+            std::string path = config.eventLogDirectory + "/partition-" + std::to_string(config.partitionId) +
+                               "-shard-" + std::to_string(shard->getShardId()) + ".log";
+            shard->setSnapshotPolicy(config.eventLogDirectory, config.snapshotIntervalEvents);
+            std::uint64_t recovered = shard->recover(path);
+
+            // Opening raises the shared sequence past everything this partition recovered
+            auto log = std::make_unique<WriteAheadLog>(sequencer.getCounter());
+            if (!log->open(path, recovered)) {
+                return false;
+            }
+            shard->setEventLog(log.get());
+            eventLogs.push_back(std::move(log));
+        }
+    }
+
+    PartitionChannel::ChannelConfig channelConfig = config.channel;
+    channelConfig.symbolCapacity = std::max(channelConfig.symbolCapacity, partitionMap.getSymbolIndexLimit());
+    if (!channel.create(config.channelName, config.partitionId, channelConfig)) {
+        return false;
+    }
+
+    for (const auto& shard : shards) {
+        shard->start();
+    }
+    hasPendingCommand = hasPendingReport = false;
+    std::fill(publishedVersions.begin(), publishedVersions.end(), 0);
+    publishSnapshots();
+    running.store(true);
+    pump = std::thread(&PartitionServer::run, this);
+    return true;
+}
+
+void PartitionServer::stop() {
+    if (!running.exchange(false)) {
+        return;
+    }
+    if (pump.joinable()) {
+        pump.join();
+    }
+
+    // Shards drain what was already forwarded; pass on the reports that produces
+    for (const auto& shard : shards) {
+        shard->stop();
+    }
+    while (forwardReports()) {
+    }
+    publishSnapshots();
+    channel.close();
+}
+
+void PartitionServer::run() {
+    long long lastPublish = 0;
+    int idleSpins = 0;
+    while (running.load(std::memory_order_relaxed)) {
+        bool busy = forwardCommands();
+        busy = forwardReports() || busy;
+
+        long long now = monotonicMicros();
+        if (now - lastPublish >= SNAPSHOT_INTERVAL_MICROS) {
+            publishSnapshots();
+            channel.setHeartbeat(now);
+            lastPublish = now;
+        }
+
+        if (busy) {
+            idleSpins = 0;
+        } else if (++idleSpins > 1000) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+bool PartitionServer::forwardCommands() {
+    bool moved = false;
+    for (size_t i = 0; i < MAX_COMMANDS_PER_LOOP; ++i) {
+        if (!hasPendingCommand) {
+            if (!channel.commands().tryPop(pendingCommand)) {
+                break;
+            }
+            hasPendingCommand = true;
+        }
+        if (!dispatch(pendingCommand)) {
+            break;  // Shard ring full: retry in order on the next pass
+        }
+        hasPendingCommand = false;
+        moved = true;
+        commandsForwarded.fetch_add(1, std::memory_order_relaxed);
+    }
+    return moved;
+}
+
+bool PartitionServer::dispatch(const PartitionCommand& command) {
+    ReplyRoute reply(&reports, command.sessionId, command.clientOrderId);
+    std::uint16_t symbolIndex = command.type == PartitionCommand::Type::SUBMIT
+        ? command.symbolIndex : getSymbolIndex(command.orderId);
+    MatchingShard* shard = symbolIndex < shardsByIndex.size() ? shardsByIndex[symbolIndex] : nullptr;
+    if (!shard) {
+        reject(command);    // Misrouted: the router's map disagrees with ours
+        return true;
+    }
+
+    switch (command.type) {
+        case PartitionCommand::Type::SUBMIT:
+            return shard->submitEntry(command.symbolIndex, command.entry, reply);
+        case PartitionCommand::Type::CANCEL:
+            return shard->cancelOrder(command.orderId, reply);
+        case PartitionCommand::Type::MODIFY:
+            return shard->modifyOrder(command.orderId, command.newPrice, command.newQuantity, reply);
+    }
+    return true;
+}
+
+void PartitionServer::reject(const PartitionCommand& command) {
+    ExecutionReport report;
+    report.sessionId = command.sessionId;
+    report.clientOrderId = command.clientOrderId;
+    report.orderId = command.orderId;
+    switch (command.type) {
+        case PartitionCommand::Type::SUBMIT:
+            report.type = ExecutionReport::Type::REJECTED;
+            report.reason = Protocol::RejectReason::UNKNOWN_SYMBOL;
+            break;
+        case PartitionCommand::Type::CANCEL:
+            report.type = ExecutionReport::Type::CANCEL_REJECTED;
+            report.reason = Protocol::RejectReason::UNKNOWN_ORDER;
+            break;
+        case PartitionCommand::Type::MODIFY:
+            report.type = ExecutionReport::Type::REPLACE_REJECTED;
+            report.reason = Protocol::RejectReason::UNKNOWN_ORDER;
+            break;
+    }
+    // Like the shards, the pump never waits on the report ring; a full one loses the reject
+    if (!reports.tryPush(report)) {
+        rejectsDropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+bool PartitionServer::forwardReports() {
+    bool moved = false;
+    for (size_t i = 0; i < MAX_REPORTS_PER_LOOP; ++i) {
+        if (!hasPendingReport) {
+            if (!reports.tryPop(pendingReport)) {
+                break;
+            }
+            hasPendingReport = true;
+        }
+        if (!channel.reports().tryPush(pendingReport)) {
+            break;  // Router is behind; the shards' report ring absorbs the rest
+        }
+        hasPendingReport = false;
+        moved = true;
+        reportsForwarded.fetch_add(1, std::memory_order_relaxed);
+    }
+    return moved;
+}
+
+void PartitionServer::publishSnapshots() {
+    for (size_t i = 0; i < books.size(); ++i) {
+        std::uint64_t version = books[i]->getMarketDataVersion();
+        if (version == publishedVersions[i]) {
+            continue;
+        }
+        SeqLock<MarketDataSnapshot>* slot = channel.snapshot(books[i]->getSymbolIndex());
+        if (slot) {
+            slot->store(books[i]->getMarketData());
+            snapshotsPublished.fetch_add(1, std::memory_order_relaxed);
+        }
+        publishedVersions[i] = version;
+    }
+}
+
+// PartitionRouter implementation
+PartitionRouter::PartitionRouter(const PartitionMap& partitionMap)
+    : partitionMap(partitionMap), nextReportChannel(0) {
+    for (size_t i = 0; i < partitionMap.getPartitionCount(); ++i) {
+        channels.push_back(std::make_unique<PartitionChannel>());
+    }
+}
+
+bool PartitionRouter::connect(const std::string& channelPrefix, int timeoutMillis) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMillis);
+    for (size_t partition = 0; partition < channels.size(); ++partition) {
+        PartitionChannel& channel = *channels[partition];
+        std::string name = PartitionChannel::nameFor(channelPrefix, static_cast<int>(partition));
+        while (!channel.open(name) || channel.getPartitionId() != static_cast<int>(partition)) {
+            channel.close();
+            if (std::chrono::steady_clock::now() >= deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(CONNECT_RETRY_MILLIS));
+        }
+    }
+    return true;
+}
+
+bool PartitionRouter::submitEntry(std::uint16_t symbolIndex, const OrderEntry& entry, std::uint32_t sessionId,
+                                  std::uint64_t clientOrderId) {
+    PartitionChannel* channel = channelFor(partitionMap.getPartition(symbolIndex));
+    if (!channel) {
+        return false;
+    }
+    PartitionCommand command = PartitionCommand();
+    command.type = PartitionCommand::Type::SUBMIT;
+    command.symbolIndex = symbolIndex;
+    command.sessionId = sessionId;
+    command.clientOrderId = clientOrderId;
+    command.entry = entry;
+    return channel->commands().tryPush(command);
+}
+
+bool PartitionRouter::cancelOrder(OrderId orderId, std::uint32_t sessionId, std::uint64_t clientOrderId) {
+    PartitionChannel* channel = channelFor(partitionMap.getPartition(getSymbolIndex(orderId)));
+    if (!channel) {
+        return false;
+    }
+    PartitionCommand command = PartitionCommand();
+    command.type = PartitionCommand::Type::CANCEL;
+    command.sessionId = sessionId;
+    command.clientOrderId = clientOrderId;
+    command.orderId = orderId;
+    return channel->commands().tryPush(command);
+}
+
+bool PartitionRouter::modifyOrder(OrderId orderId, Price newPrice, int newQuantity, std::uint32_t sessionId,
+                                  std::uint64_t clientOrderId) {
+    PartitionChannel* channel = channelFor(partitionMap.getPartition(getSymbolIndex(orderId)));
+    if (!channel) {
+        return false;
+    }
+    PartitionCommand command = PartitionCommand();
+    command.type = PartitionCommand::Type::MODIFY;
+    command.sessionId = sessionId;
+    command.clientOrderId = clientOrderId;
+    command.orderId = orderId;
+    command.newPrice = newPrice;
+    command.newQuantity = newQuantity;
+    return channel->commands().tryPush(command);
+}
+
+bool PartitionRouter::getMarketData(std::uint16_t symbolIndex, MarketDataSnapshot& snapshot) const {
+    PartitionChannel* channel = channelFor(partitionMap.getPartition(symbolIndex));
+    SeqLock<MarketDataSnapshot>* slot = channel ? channel->snapshot(symbolIndex) : nullptr;
+    if (!slot) {
+        return false;
+    }
+    snapshot = slot->load();
+    return true;
+}
+
+std::vector<std::pair<std::string, MarketDataSnapshot>> PartitionRouter::getAllMarketData() const {
+    std::vector<std::pair<std::string, MarketDataSnapshot>> result;
+    MarketDataSnapshot snapshot;
+    for (std::uint16_t index : partitionMap.getSymbolIndexes()) {
+        if (getMarketData(index, snapshot)) {
+            result.emplace_back(*partitionMap.getSymbol(index), snapshot);
+        }
+    }
+    return result;
+}
+
+std::vector<std::string> PartitionRouter::getSupportedSymbols() const {
+    std::vector<std::string> symbols;
+    for (std::uint16_t index : partitionMap.getSymbolIndexes()) {
+        symbols.push_back(*partitionMap.getSymbol(index));
+    }
+    return symbols;
+}
+
+bool PartitionRouter::isPartitionAlive(int partition, long long staleAfterMicros) const {
+    PartitionChannel* channel = channelFor(partition);
+    return channel && monotonicMicros() - channel->getHeartbeat() <= staleAfterMicros;
+}
+
+} // namespace OrderMatchingEngine
\ No newline at end of file
@@ -0,0 +1,385 @@
+#ifndef PARTITIONING_HPP
+#define PARTITIONING_HPP
+
+#include "MatchingShard.hpp"
+#include "SharedMemory.hpp"
+#include "SeqLock.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace OrderMatchingEngine {
+
+/**
+ * @brief Assignment of symbols to engine partitions
+ *
+ * Every process of a partitioned deployment builds the same map from the same
+ * configuration: gateways use it to route, partitions to know which books they
+ * own. Symbols without an explicit partition are placed by an FNV-1a hash of
+ * the symbol, which (unlike std::hash) is identical in every process.
+ */
+class PartitionMap {
+private:
+    struct SymbolEntry {
+        std::string symbol;
+        SymbolConfig config;
+        int partition;              // -1 for an unused index
+    };
+
+    size_t partitionCount;
+    std::vector<SymbolEntry> symbolsByIndex;    // Symbol index -> entry
+    std::unordered_map<std::string, std::uint16_t> indexBySymbol;
+
+public:
+    /**
+     * @throws std::invalid_argument if partitionCount is 0
+     */
+    explicit PartitionMap(size_t partitionCount);
+
+    /**
+     * @brief Add a symbol under its config's symbol index
+     * @param partition Owning partition, or -1 to place it by hash
+     * @throws std::invalid_argument if the symbol or its index is taken, or the partition is out of range
+     */
+    void addSymbol(const std::string& symbol, const SymbolConfig& config, int partition = -1);
+
+    /**
+     * @brief Partition owning a symbol index, or -1 if it is not mapped
+     */
+    int getPartition(std::uint16_t symbolIndex) const {
+        return symbolIndex < symbolsByIndex.size() ? symbolsByIndex[symbolIndex].partition : -1;
+    }
+    int getPartition(const std::string& symbol) const;
+
+    /**
+     * @brief Symbol at an index, or nullptr if it is not mapped
+     */
+    const std::string* getSymbol(std::uint16_t symbolIndex) const;
+    const SymbolConfig* getSymbolConfig(std::uint16_t symbolIndex) const;
+
+    /**
+     * @brief Symbol indexes of one partition, or of every partition for -1, in index order
+     */
+    std::vector<std::uint16_t> getSymbolIndexes(int partition = -1) const;
+
+    size_t getPartitionCount() const { return partitionCount; }
+    size_t getSymbolIndexLimit() const { return symbolsByIndex.size(); }    // One past the highest index
+
+    static int hashPartition(const std::string& symbol, size_t partitionCount);
+};
+
+/**
+ * @brief Global input sequence shared by the event logs of every partition on a host
+ *
+ * A single 64-bit counter in shared memory. Each partition passes getCounter()
+ * to its WriteAheadLogs as their sequence source, so events are numbered from
+ * one sequence across processes exactly as they are across shards in one
+ * process. Recovery needs nothing extra: every log raises the counter to the
+ * highest sequence it recovered when it is opened.
+ */
+class Sequencer {
+private:
+    struct State {
+        std::atomic<std::uint64_t> magic;   // Stored last by the creator, polled by openers
+        alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> sequence;
+    };
+
+    SharedMemoryRegion region;
+    State* state;
+
+public:
+    Sequencer();
+
+    /**
+     * @brief Create the counter (one process per host, usually the first partition or the gateway)
+     * @param startAfter Highest sequence already used
+     */
+    bool create(const std::string& name, std::uint64_t startAfter = 0);
+
+    /**
+     * @brief Attach to a counter created by another process
+     * @return False if it does not exist or is not initialized yet
+     */
+    bool open(const std::string& name);
+
+    std::atomic<std::uint64_t>* getCounter() { return state ? &state->sequence : nullptr; }
+    std::uint64_t next() { return state->sequence.fetch_add(1, std::memory_order_relaxed) + 1; }
+    std::uint64_t getLastSequence() const { return state ? state->sequence.load(std::memory_order_relaxed) : 0; }
+    bool isOpen() const { return state != nullptr; }
+};
+
+/**
+ * @brief Request sent from a gateway-side router to the partition owning the symbol
+ */
+struct PartitionCommand {
+    enum class Type : std::uint8_t {
+        SUBMIT,
+        CANCEL,
+        MODIFY
+    };
+
+    Type type;
+    std::uint16_t symbolIndex;      // SUBMIT only
+    std::uint32_t sessionId;        // Gateway session the reports go back to
+    std::uint64_t clientOrderId;
+    OrderId orderId;                // CANCEL and MODIFY
+    Price newPrice;                 // MODIFY only (0 to keep current)
+    int newQuantity;                // MODIFY only (0 to keep current)
+    OrderEntry entry;               // SUBMIT only
+};
+
+/**
+ * @brief Shared-memory link between one partition process and the gateway-side router
+ *
+ * One region holds a command ring (router to partition), a report ring
+ * (partition to router), the partition's heartbeat and one SeqLock-published
+ * MarketDataSnapshot per symbol index, so routers read any partition's quotes
+ * without a round trip. The partition creates the channel; the router opens it.
+ * Each ring has exactly one producer and one consumer process.
+ */
+class PartitionChannel {
+public:
+    struct ChannelConfig {
+        size_t commandCapacity;
+        size_t reportCapacity;
+        size_t symbolCapacity;      // Snapshot slots: one past the highest symbol index served
+
+        ChannelConfig() : commandCapacity(65536), reportCapacity(65536), symbolCapacity(1024) {}
+    };
+
+private:
+    struct Header {
+        std::uint64_t magic;
+        std::uint32_t partitionId;
+        std::uint32_t symbolCapacity;
+        std::uint64_t commandCapacity;
+        std::uint64_t reportCapacity;
+        alignas(CACHE_LINE_SIZE) std::atomic<long long> heartbeatMicros;
+        std::atomic<std::uint32_t> ready;   // Set last by the creator
+    };
+
+    SharedMemoryRegion region;
+    Header* header;
+    SharedSpscRing<PartitionCommand> commandRing;
+    SharedSpscRing<ExecutionReport> reportRing;
+    SeqLock<MarketDataSnapshot>* snapshots;
+
+    static size_t commandOffset();
+    static size_t reportOffset(const ChannelConfig& config);
+    static size_t snapshotOffset(const ChannelConfig& config);
+    void attachLayout(const ChannelConfig& config);
+
+public:
+    PartitionChannel();
+
+    /**
+     * @brief Shared memory name of a partition's channel
+     */
+    static std::string nameFor(const std::string& prefix, int partition);
+
+    /**
+     * @brief Create and initialize the channel (partition side)
+     */
+    bool create(const std::string& name, int partitionId, const ChannelConfig& config);
+
+    /**
+     * @brief Open a channel once its partition has initialized it (router side)
+     */
+    bool open(const std::string& name);
+
+    void close();
+
+    SharedSpscRing<PartitionCommand>& commands() { return commandRing; }
+    SharedSpscRing<ExecutionReport>& reports() { return reportRing; }
+
+    /**
+     * @brief Snapshot slot of a symbol index, or nullptr past the channel's capacity
+     */
+    SeqLock<MarketDataSnapshot>* snapshot(std::uint16_t symbolIndex) const {
+        return header && symbolIndex < header->symbolCapacity ? &snapshots[symbolIndex] : nullptr;
+    }
+
+    void setHeartbeat(long long micros) { header->heartbeatMicros.store(micros, std::memory_order_relaxed); }
+    long long getHeartbeat() const { return header ? header->heartbeatMicros.load(std::memory_order_relaxed) : 0; }
+    int getPartitionId() const { return header ? static_cast<int>(header->partitionId) : -1; }
+    bool isOpen() const { return header != nullptr; }
+};
+
+/**
+ * @brief Partition process side: owns the shards of one partition's symbols behind a channel
+ *
+ * A pump thread moves commands from the channel into the shards' ingress
+ * rings, execution reports from the shards back into the channel, and
+ * publishes each book's latest MarketDataSnapshot into the channel when it
+ * changes. Commands wait in the channel when a shard is full, so backpressure
+ * reaches the router instead of dropping orders.
+ */
+class PartitionServer {
+public:
+    struct ServerConfig {
+        int partitionId;
+        std::string channelName;            // See PartitionChannel::nameFor
+        PartitionChannel::ChannelConfig channel;
+        int numShards;
+        int firstCore;                      // Shard i is pinned to core firstCore + i (-1 for no pinning)
+        size_t ingressRingSize;
+        std::string eventLogDirectory;      // Empty to run without a write-ahead log
+        std::string sequencerName;          // Shared sequence for the logs (empty to number locally)
+        long long snapshotIntervalEvents;
+
+        ServerConfig()
+            : partitionId(0), numShards(1), firstCore(-1), ingressRingSize(65536),
+              snapshotIntervalEvents(1000000) {}
+    };
+
+private:
+    PartitionMap partitionMap;
+    ServerConfig config;
+    PartitionChannel channel;
+    Sequencer sequencer;
+
+    std::vector<std::unique_ptr<MatchingShard>> shards;
+    std::vector<std::unique_ptr<WriteAheadLog>> eventLogs;
+    std::vector<MatchingShard*> shardsByIndex;      // Symbol index -> owning shard
+    std::vector<const OrderBook*> books;
+    std::vector<std::uint64_t> publishedVersions;   // Per entry of books
+    ReportRing reports;                             // Shards -> pump thread
+
+    std::thread pump;
+    std::atomic<bool> running;
+    bool hasPendingCommand;
+    PartitionCommand pendingCommand;
+    bool hasPendingReport;
+    ExecutionReport pendingReport;
+
+    std::atomic<long long> commandsForwarded;
+    std::atomic<long long> reportsForwarded;
+    std::atomic<long long> snapshotsPublished;
+    std::atomic<long long> rejectsDropped;          // Misroute rejects lost to a full report ring
+
+    void run();
+    bool forwardCommands();
+    bool forwardReports();
+    void publishSnapshots();
+    bool dispatch(const PartitionCommand& command);
+    void reject(const PartitionCommand& command);
+
+public:
+    /**
+     * @brief Constructor
+     * @throws std::invalid_argument if the partition ID is not in the map
+     */
+    PartitionServer(const PartitionMap& partitionMap, const ServerConfig& config);
+    ~PartitionServer();
+
+    PartitionServer(const PartitionServer&) = delete;
+    PartitionServer& operator=(const PartitionServer&) = delete;
+
+    /**
+     * @brief Build the shards, recover them from their logs, create the channel and start serving
+     * @return False if the channel, the sequencer or an event log could not be opened
+     */
+    bool start();
+
+    /**
+     * @brief Stop the pump, then the shards, and remove the channel
+     */
+    void stop();
+
+    bool isRunning() const { return running.load(std::memory_order_relaxed); }
+    size_t getShardCount() const { return shards.size(); }
+    MatchingShard* getShard(size_t index) const { return index < shards.size() ? shards[index].get() : nullptr; }
+
+    long long getCommandsForwarded() const { return commandsForwarded.load(std::memory_order_relaxed); }
+    long long getReportsForwarded() const { return reportsForwarded.load(std::memory_order_relaxed); }
+    long long getSnapshotsPublished() const { return snapshotsPublished.load(std::memory_order_relaxed); }
+    long long getRejectsDropped() const { return rejectsDropped.load(std::memory_order_relaxed); }
+};
+
+/**
+ * @brief Gateway side of a partitioned deployment: routes by symbol and aggregates market data
+ *
+ * Holds one channel per partition. Commands and report polling must come from
+ * a single thread (the gateway loop), since each channel ring has one
+ * producer and one consumer; market data reads may come from any thread.
+ */
+class PartitionRouter {
+private:
+    PartitionMap partitionMap;
+    std::vector<std::unique_ptr<PartitionChannel>> channels;
+    size_t nextReportChannel;
+
+    PartitionChannel* channelFor(int partition) const {
+        return partition >= 0 && static_cast<size_t>(partition) < channels.size() &&
+               channels[partition]->isOpen() ? channels[partition].get() : nullptr;
+    }
+
+public:
+    explicit PartitionRouter(const PartitionMap& partitionMap);
+
+    /**
+     * @brief Open every partition's channel, waiting up to timeoutMillis for partitions still starting
+     * @return False if some partition's channel did not appear in time
+     */
+    bool connect(const std::string& channelPrefix, int timeoutMillis = 5000);
+
+    // Routing - single thread only; false means the symbol is unmapped, its partition
+    // is not connected, or its command ring is full
+    bool submitEntry(std::uint16_t symbolIndex, const OrderEntry& entry, std::uint32_t sessionId,
+                     std::uint64_t clientOrderId);
+    bool cancelOrder(OrderId orderId, std::uint32_t sessionId, std::uint64_t clientOrderId);
+    bool modifyOrder(OrderId orderId, Price newPrice, int newQuantity, std::uint32_t sessionId,
+                     std::uint64_t clientOrderId);
+
+    /**
+     * @brief Pass up to maxReports execution reports from all partitions to handler (same thread as routing)
+     * Channels are visited round robin, so a busy partition cannot starve the others.
+     * @return Number of reports handled
+     */
+    template<typename Handler>
+    size_t pollReports(Handler&& handler, size_t maxReports) {
+        size_t handled = 0;
+        ExecutionReport report;
+        for (size_t visited = 0; visited < channels.size() && handled < maxReports; ++visited) {
+            PartitionChannel& channel = *channels[nextReportChannel];
+            nextReportChannel = (nextReportChannel + 1) % channels.size();
+            while (handled < maxReports && channel.isOpen() && channel.reports().tryPop(report)) {
+                handler(report);
+                ++handled;
+            }
+        }
+        return handled;
+    }
+
+    /**
+     * @brief Latest published snapshot of a symbol, from whichever partition owns it
+     * @return False if the symbol is unmapped or its partition is not connected
+     */
+    bool getMarketData(std::uint16_t symbolIndex, MarketDataSnapshot& snapshot) const;
+
+    /**
+     * @brief Snapshots of every symbol of every connected partition, in symbol index order
+     */
+    std::vector<std::pair<std::string, MarketDataSnapshot>> getAllMarketData() const;
+
+    /**
+     * @brief Every symbol of the deployment, whichever partition owns it
+     */
+    std::vector<std::string> getSupportedSymbols() const;
+
+    /**
+     * @brief Whether a partition has beaten its heartbeat within staleAfterMicros
+     */
+    bool isPartitionAlive(int partition, long long staleAfterMicros = 1000000) const;
+
+    const PartitionMap& getPartitionMap() const { return partitionMap; }
+};
+
+} // namespace OrderMatchingEngine
+
+#endif // PARTITIONING_HPP
\ No newline at end of file
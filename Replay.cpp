@@ -0,0 +1,358 @@
+#include "Replay.hpp"
+#include "BinaryCodec.hpp"
+#include "TradeJournal.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace OrderMatchingEngine {
+
+namespace {
+
+constexpr char CAPTURE_MAGIC[8] = {'O', 'M', 'E', 'C', 'A', 'P', '0', '1'};
+constexpr std::uint32_t CAPTURE_VERSION = 2;
+
+constexpr char JOURNAL_USER[] = "replay";
+
+CaptureRecord makeRecord(EventType type, std::uint16_t symbolIndex) {
+    CaptureRecord record;
+    std::memset(&record, 0, sizeof(record));
+    record.type = type;
+    record.symbolIndex = symbolIndex;
+    return record;
+}
+
+} // namespace
+
+ReplayDriver::ReplayDriver(const ReplayConfig& config) : config(config), expiriesLogged(false) {}
+
+OrderBook* ReplayDriver::addSymbol(const std::string& symbol, const SymbolConfig& symbolConfig) {
+    if (indexBySymbol.count(symbol) ||
+        (symbolConfig.symbolIndex < booksByIndex.size() && booksByIndex[symbolConfig.symbolIndex])) {
+        throw std::invalid_argument("Symbol is already added: " + symbol);
+    }
+
+    SymbolConfig bookConfig = symbolConfig;
+    bookConfig.singleWriter = true;
+    books.push_back(std::make_unique<OrderBook>(symbol, bookConfig));
+    if (booksByIndex.size() <= symbolConfig.symbolIndex) {
+        booksByIndex.resize(symbolConfig.symbolIndex + 1, nullptr);
+        bookEvents.resize(symbolConfig.symbolIndex + 1, 0);
+    }
+    booksByIndex[symbolConfig.symbolIndex] = books.back().get();
+    indexBySymbol[symbol] = symbolConfig.symbolIndex;
+    return books.back().get();
+}
+
+OrderBook* ReplayDriver::bookFor(std::uint16_t symbolIndex) {
+    if (symbolIndex < booksByIndex.size() && booksByIndex[symbolIndex]) {
+        return booksByIndex[symbolIndex];
+    }
+    if (!config.addUnknownSymbols) {
+        return nullptr;
+    }
+    SymbolConfig symbolConfig;
+    symbolConfig.symbolIndex = symbolIndex;
+    return addSymbol("SYM" + std::to_string(symbolIndex), symbolConfig);
+}
+
+void ReplayDriver::addEvents(const std::vector<CaptureRecord>& records) {
+    events.insert(events.end(), records.begin(), records.end());
+}
+
+bool ReplayDriver::loadCapture(const std::string& path) {
+    std::string contents;
+    if (!SnapshotStore::readFile(path, contents) || contents.size() < sizeof(CaptureFileHeader)) {
+        return false;
+    }
+    CaptureFileHeader header;
+    std::memcpy(&header, contents.data(), sizeof(header));
+    if (std::memcmp(header.magic, CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC)) != 0 ||
+        header.version != CAPTURE_VERSION || header.recordSize != sizeof(CaptureRecord)) {
+        return false;
+    }
+    if (header.flags & CaptureFileHeader::EXPIRIES_LOGGED) {
+        expiriesLogged = true;
+    }
+
+    size_t count = (contents.size() - sizeof(header)) / sizeof(CaptureRecord);
+    size_t first = events.size();
+    events.resize(first + count);
+    std::memcpy(events.data() + first, contents.data() + sizeof(header), count * sizeof(CaptureRecord));
+    return true;
+}
+
+bool ReplayDriver::loadEventLog(const std::string& path) {
+    EventLogReader reader;
+    if (!reader.open(path)) {
+        return false;
+    }
+
+    // The shard logs every expiry as a cancel before applying it
+    expiriesLogged = true;
+
+    SequencedEvent event;
+    while (reader.next(event)) {
+        if (event.type != EventType::SUBMIT) {
+            CaptureRecord record = makeRecord(event.type, getSymbolIndex(event.orderId));
+            record.entry.orderId = event.orderId;
+            record.entry.price = event.price;
+            record.entry.quantity = event.quantity;
+            record.entry.timestamp = event.timestamp;
+            events.push_back(record);
+            continue;
+        }
+
+        // The log names the book; unknown names get the next free index
+        auto it = indexBySymbol.find(event.symbol);
+        std::uint16_t symbolIndex;
+        if (it != indexBySymbol.end()) {
+            symbolIndex = it->second;
+        } else if (config.addUnknownSymbols) {
+            SymbolConfig symbolConfig;
+            symbolConfig.symbolIndex = static_cast<std::uint16_t>(booksByIndex.size());
+            addSymbol(event.symbol, symbolConfig);
+            symbolIndex = symbolConfig.symbolIndex;
+        } else {
+            continue;
+        }
+
+        CaptureRecord record = makeRecord(EventType::SUBMIT, symbolIndex);
+        record.entry.orderId = event.orderId;
+        record.entry.price = event.price;
+        record.entry.triggerPrice = event.triggerPrice;
+        record.entry.timestamp = event.timestamp;
+        record.entry.expireTime = event.expireTime;
+        record.entry.quantity = event.quantity;
+        record.entry.type = event.orderType;
+        record.entry.side = event.side;
+        record.entry.timeInForce = event.timeInForce;
+        std::strncpy(record.entry.userId, event.userId.c_str(), OrderEntry::USER_ID_SIZE - 1);
+        events.push_back(record);
+    }
+    return true;
+}
+
+bool ReplayDriver::loadJournal(const std::string& path) {
+    JournalReader reader;
+    try {
+        reader.open(path);
+    } catch (const std::runtime_error&) {
+        return false;
+    }
+
+    // Each producer's records are in order, but producers interleave: restore time order
+    size_t first = events.size();
+    JournalRecord journal;
+    while (reader.next(journal)) {
+        CaptureRecord record;
+        if (journal.type == JournalRecordType::ORDER_SUBMITTED) {
+            record = makeRecord(EventType::SUBMIT, journal.symbolIndex);
+            record.entry.price = journal.price;
+            record.entry.triggerPrice = journal.auxPrice;
+            record.entry.type = journal.orderType;
+            record.entry.side = journal.side;
+            record.entry.timeInForce = TimeInForce::GTC;
+            std::memcpy(record.entry.userId, JOURNAL_USER, sizeof(JOURNAL_USER));
+        } else if (journal.type == JournalRecordType::ORDER_CANCELLED) {
+            record = makeRecord(EventType::CANCEL, journal.symbolIndex);
+        } else if (journal.type == JournalRecordType::ORDER_MODIFIED) {
+            record = makeRecord(EventType::MODIFY, journal.symbolIndex);
+            record.entry.price = journal.price;
+        } else {
+            continue;
+        }
+        record.entry.orderId = journal.id;
+        record.entry.quantity = journal.quantity;
+        record.entry.timestamp = journal.timestamp;
+        events.push_back(record);
+    }
+
+    std::stable_sort(events.begin() + first, events.end(),
+                     [](const CaptureRecord& a, const CaptureRecord& b) {
+                         return a.entry.timestamp < b.entry.timestamp;
+                     });
+    return true;
+}
+
+void ReplayDriver::expireUntil(OrderBook& book, long long virtualTime, ReplayResult& result) {
+    if (book.getPendingExpiryCount() == 0) {
+        return;
+    }
+    expired.clear();
+    book.collectExpiredOrders(virtualTime, expired);
+    for (OrderId orderId : expired) {
+        if (book.cancelOrder(orderId)) {
+            ++result.expiries;
+        }
+    }
+}
+
+void ReplayDriver::apply(const CaptureRecord& record, OrderBook& book, ReplayResult& result) {
+    size_t fillsBefore = fills.size();
+    bool applied = true;
+    switch (record.type) {
+        case EventType::SUBMIT:
+            try {
+                book.addOrder(record.entry, fills);
+            } catch (const std::invalid_argument&) {
+                applied = false;
+            }
+            break;
+        case EventType::CANCEL:
+            applied = book.cancelOrder(record.entry.orderId);
+            break;
+        case EventType::MODIFY:
+            // modifyOrder ignores an unknown order, so that is checked first, as the shard does
+            applied = book.getOpenQuantity(record.entry.orderId) > 0;
+            if (applied) {
+                try {
+                    book.modifyOrder(record.entry.orderId, record.entry.price, record.entry.quantity, fills,
+                                     record.entry.timestamp);
+                } catch (const std::invalid_argument&) {
+                    applied = false;
+                }
+            }
+            break;
+    }
+
+    ++(applied ? result.eventsApplied : result.eventsRejected);
+    result.fills += static_cast<long long>(fills.size() - fillsBefore);
+    if (!config.collectFills) {
+        fills.clear();
+    }
+}
+
+void ReplayDriver::checkpoint(const OrderBook& book) {
+    book.writeSnapshot(imageScratch, 0);
+
+    ReplayCheckpoint state;
+    state.symbolIndex = indexBySymbol[book.getSymbol()];
+    state.bookEvents = bookEvents[state.symbolIndex];
+    state.imageChecksum = checksum32(imageScratch.data(), imageScratch.size());
+    state.snapshot = book.getMarketData();
+    checkpoints.push_back(state);
+}
+
+ReplayResult ReplayDriver::run() {
+    ReplayResult result;
+    auto start = std::chrono::steady_clock::now();
+
+    // Logged expiries are already cancels in the events; expiring them again would diverge
+    bool expire = config.expireOnVirtualClock && !expiriesLogged;
+
+    for (const CaptureRecord& record : events) {
+        OrderBook* book = bookFor(record.symbolIndex);
+        if (!book) {
+            ++result.eventsRejected;
+            continue;
+        }
+
+        // Virtual clock, per book: how the events are split across drivers cannot move an expiry
+        if (expire) {
+            expireUntil(*book, record.entry.timestamp, result);
+        }
+
+        apply(record, *book, result);
+        long long count = ++bookEvents[record.symbolIndex];
+        if (config.checkpointInterval > 0 && count % config.checkpointInterval == 0) {
+            checkpoint(*book);
+        }
+    }
+
+    for (std::uint16_t index = 0; index < booksByIndex.size(); ++index) {
+        bool justTaken = config.checkpointInterval > 0 && bookEvents[index] > 0 &&
+                         bookEvents[index] % config.checkpointInterval == 0;
+        if (booksByIndex[index] && !justTaken) {
+            checkpoint(*booksByIndex[index]);
+        }
+    }
+
+    result.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+bool ReplayDriver::writeCapture(const std::string& path, const std::vector<CaptureRecord>& records,
+                                bool expiriesLogged) {
+    CaptureFileHeader header;
+    std::memcpy(header.magic, CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC));
+    header.version = CAPTURE_VERSION;
+    header.recordSize = sizeof(CaptureRecord);
+    header.flags = expiriesLogged ? CaptureFileHeader::EXPIRIES_LOGGED : 0;
+    header.reserved = 0;
+
+    std::string contents(sizeof(header) + records.size() * sizeof(CaptureRecord), '\0');
+    std::memcpy(&contents[0], &header, sizeof(header));
+    if (!records.empty()) {
+        std::memcpy(&contents[sizeof(header)], records.data(), records.size() * sizeof(CaptureRecord));
+    }
+    return SnapshotStore::writeFile(path, contents);
+}
+
+std::vector<std::vector<CaptureRecord>> ReplayDriver::splitBySymbol(const std::vector<CaptureRecord>& records,
+                                                                    size_t groups) {
+    std::vector<std::vector<CaptureRecord>> split(groups > 0 ? groups : 1);
+    for (const CaptureRecord& record : records) {
+        split[record.symbolIndex % split.size()].push_back(record);
+    }
+    return split;
+}
+
+std::vector<ReplayResult> ReplayDriver::runAll(const std::vector<ReplayDriver*>& drivers, unsigned threads) {
+    std::vector<ReplayResult> results(drivers.size());
+    std::atomic<size_t> next(0);
+    auto work = [&]() {
+        for (size_t i = next.fetch_add(1); i < drivers.size(); i = next.fetch_add(1)) {
+            results[i] = drivers[i]->run();
+        }
+    };
+
+    unsigned count = std::max(1u, std::min<unsigned>(threads, static_cast<unsigned>(drivers.size())));
+    std::vector<std::thread> workers;
+    for (unsigned i = 1; i < count; ++i) {
+        workers.emplace_back(work);
+    }
+    work();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return results;
+}
+
+std::string ReplayDriver::formatFills(std::vector<Fill> fills) {
+    std::sort(fills.begin(), fills.end(), [](const Fill& a, const Fill& b) { return a.tradeId < b.tradeId; });
+
+    std::ostringstream out;
+    out << "tradeId,buyOrderId,sellOrderId,price,quantity,timestamp\n";
+    for (const Fill& fill : fills) {
+        out << fill.tradeId << ',' << fill.buyOrderId << ',' << fill.sellOrderId << ','
+            << fill.price << ',' << fill.quantity << ',' << fill.timestamp << '\n';
+    }
+    return out.str();
+}
+
+std::string ReplayDriver::formatCheckpoints(std::vector<ReplayCheckpoint> checkpoints) {
+    std::stable_sort(checkpoints.begin(), checkpoints.end(),
+                     [](const ReplayCheckpoint& a, const ReplayCheckpoint& b) {
+                         return a.symbolIndex != b.symbolIndex ? a.symbolIndex < b.symbolIndex
+                                                               : a.bookEvents < b.bookEvents;
+                     });
+
+    std::ostringstream out;
+    for (const ReplayCheckpoint& state : checkpoints) {
+        const MarketDataSnapshot& snapshot = state.snapshot;
+        out << "symbol=" << state.symbolIndex << " events=" << state.bookEvents
+            << " checksum=" << std::hex << state.imageChecksum << std::dec
+            << " bid=" << snapshot.bestBid << " ask=" << snapshot.bestAsk
+            << " buyOrders=" << snapshot.totalBuyOrders << " sellOrders=" << snapshot.totalSellOrders
+            << " trades=" << snapshot.totalTrades << " volume=" << snapshot.totalVolume
+            << " last=" << snapshot.lastTradePrice << '\n';
+    }
+    return out.str();
+}
+
+} // namespace OrderMatchingEngine
\ No newline at end of file
@@ -0,0 +1,209 @@
+#ifndef REPLAY_HPP
+#define REPLAY_HPP
+
+#include "EventLog.hpp"
+#include "OrderBook.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace OrderMatchingEngine {
+
+/**
+ * @brief One recorded input in the compact capture format
+ *
+ * Field use by type:
+ * - SUBMIT: the whole entry (orderId 0 lets the book number the order)
+ * - CANCEL: entry.orderId, entry.timestamp
+ * - MODIFY: entry.orderId, entry.price and entry.quantity (new values, 0 to keep), entry.timestamp
+ * Capture files are a CaptureFileHeader followed by the records as-is.
+ */
+struct CaptureRecord {
+    OrderEntry entry;
+    std::uint16_t symbolIndex;
+    EventType type;
+    std::uint8_t reserved[5];
+};
+
+static_assert(std::is_trivially_copyable<CaptureRecord>::value, "Capture records are written to disk as-is");
+
+/**
+ * @brief File header in front of the capture records
+ */
+struct CaptureFileHeader {
+    static constexpr std::uint32_t EXPIRIES_LOGGED = 1;    // Expiries are among the records as cancels
+
+    char magic[8];                  // "OMECAP01"
+    std::uint32_t version;
+    std::uint32_t recordSize;
+    std::uint32_t flags;
+    std::uint32_t reserved;
+};
+
+/**
+ * @brief State of one book at a point in its replay, for diffing two runs
+ */
+struct ReplayCheckpoint {
+    std::uint16_t symbolIndex;
+    long long bookEvents;           // Events of this book applied so far
+    std::uint32_t imageChecksum;    // Of the book's full snapshot image: every order, in priority order
+    MarketDataSnapshot snapshot;
+};
+
+/**
+ * @brief Counters of one replay run
+ */
+struct ReplayResult {
+    long long eventsApplied;
+    long long eventsRejected;       // Invalid orders, and cancels and modifies of unknown orders,
+                                    // as they were rejected originally
+    long long fills;
+    long long expiries;             // Cancelled by the virtual clock
+    double elapsedSeconds;
+
+    ReplayResult() : eventsApplied(0), eventsRejected(0), fills(0), expiries(0), elapsedSeconds(0.0) {}
+    double getEventsPerSecond() const { return elapsedSeconds > 0.0 ? eventsApplied / elapsedSeconds : 0.0; }
+};
+
+/**
+ * @brief Drives recorded order flow through OrderBooks as fast as one core allows
+ *
+ * Events are loaded up front, so the run itself does no I/O. Books are
+ * single-writer and the driver owns them, so there are no threads, locks,
+ * journals or logs on the path: each event is one call into its book. Time
+ * is virtual: fills carry their input's recorded timestamp, and a book's
+ * DAY/GTD orders expire once the timestamp of its next input passes their
+ * deadline, never by the wall clock. The same events therefore always give the same fills and
+ * checkpoints, run after run and on any machine.
+ *
+ * Symbols never interact, so a capture split by symbol replays on several
+ * drivers at once (see splitBySymbol and runAll) with the same output.
+ */
+class ReplayDriver {
+public:
+    struct ReplayConfig {
+        bool collectFills;              // Keep every fill for getFills() (off for pure throughput runs)
+        long long checkpointInterval;   // Checkpoint a book every N of its events (0: only at the end)
+        bool expireOnVirtualClock;      // Ignored when hasLoggedExpiries(): the cancels include every expiry
+        bool addUnknownSymbols;         // Create a default book for a symbol index first seen in the events
+
+        ReplayConfig()
+            : collectFills(true), checkpointInterval(0), expireOnVirtualClock(true), addUnknownSymbols(true) {}
+    };
+
+private:
+    ReplayConfig config;
+    std::vector<std::unique_ptr<OrderBook>> books;
+    std::vector<OrderBook*> booksByIndex;
+    std::vector<long long> bookEvents;              // By symbol index
+    std::unordered_map<std::string, std::uint16_t> indexBySymbol;
+    std::vector<CaptureRecord> events;
+    bool expiriesLogged;
+
+    std::vector<Fill> fills;
+    std::vector<OrderId> expired;
+    std::vector<ReplayCheckpoint> checkpoints;
+    std::string imageScratch;
+
+    OrderBook* bookFor(std::uint16_t symbolIndex);
+    void expireUntil(OrderBook& book, long long virtualTime, ReplayResult& result);
+    void apply(const CaptureRecord& record, OrderBook& book, ReplayResult& result);
+    void checkpoint(const OrderBook& book);
+
+public:
+    explicit ReplayDriver(const ReplayConfig& config = ReplayConfig());
+
+    ReplayDriver(const ReplayDriver&) = delete;
+    ReplayDriver& operator=(const ReplayDriver&) = delete;
+
+    /**
+     * @brief Create the book a symbol's events are replayed into
+     * Use the original configuration for identical results; the book is made single-writer.
+     * @throws std::invalid_argument if the symbol or its index is already added
+     */
+    OrderBook* addSymbol(const std::string& symbol, const SymbolConfig& config);
+
+    // Loading - events are appended in the order given
+    void addEvent(const CaptureRecord& record) { events.push_back(record); }
+    void addEvents(const std::vector<CaptureRecord>& records);
+
+    /**
+     * @brief Append a capture file
+     * @return False if it is missing, not a capture or of an older version
+     */
+    bool loadCapture(const std::string& path);
+
+    /**
+     * @brief Append a write-ahead log's events; submits are placed by symbol name
+     * Add the symbols first with their original indices, or cancels and modifies,
+     * which are placed by order ID, miss their books: unknown names get the next free index.
+     * @return False if the file does not exist
+     */
+    bool loadEventLog(const std::string& path);
+
+    /**
+     * @brief Append the order events of a binary trade journal, in timestamp order
+     * Journals do not record time in force, deadlines or users: orders replay as
+     * GTC under a placeholder user, so this suits capacity tests more than diffs.
+     * @return False if the file is missing or not a journal
+     */
+    bool loadJournal(const std::string& path);
+
+    /**
+     * @brief Apply every loaded event, then checkpoint every book
+     */
+    ReplayResult run();
+
+    /**
+     * @brief Whether loaded events already hold their expiries as cancels (write-ahead logs,
+     *        and captures converted from one)
+     * Expiring on the virtual clock as well would cancel live orders early: the engine
+     * expires on its own ticks, and an order can still trade between its deadline and
+     * the next one, so run() then never expires on the virtual clock.
+     */
+    bool hasLoggedExpiries() const { return expiriesLogged; }
+
+    const std::vector<CaptureRecord>& getEvents() const { return events; }
+    const std::vector<Fill>& getFills() const { return fills; }
+    const std::vector<ReplayCheckpoint>& getCheckpoints() const { return checkpoints; }
+    OrderBook* getOrderBook(std::uint16_t symbolIndex) const {
+        return symbolIndex < booksByIndex.size() ? booksByIndex[symbolIndex] : nullptr;
+    }
+    size_t getSymbolIndexLimit() const { return booksByIndex.size(); }     // Above the highest index in use
+
+    /**
+     * @brief Write events as a capture file
+     * @param expiriesLogged Whether the records hold their expiries as cancels (see hasLoggedExpiries)
+     */
+    static bool writeCapture(const std::string& path, const std::vector<CaptureRecord>& records,
+                             bool expiriesLogged = false);
+
+    /**
+     * @brief Deal events into groups by symbol index, keeping each symbol's order
+     */
+    static std::vector<std::vector<CaptureRecord>> splitBySymbol(const std::vector<CaptureRecord>& records,
+                                                                 size_t groups);
+
+    /**
+     * @brief Run independent drivers on up to threads threads, each driver on one thread
+     * @return The drivers' results, in the drivers' order
+     */
+    static std::vector<ReplayResult> runAll(const std::vector<ReplayDriver*>& drivers, unsigned threads);
+
+    /**
+     * @brief Fills as CSV sorted by trade ID, so the text does not depend on how the replay was split
+     */
+    static std::string formatFills(std::vector<Fill> fills);
+
+    /**
+     * @brief Checkpoints as text sorted by symbol and position, one line per book state
+     */
+    static std::string formatCheckpoints(std::vector<ReplayCheckpoint> checkpoints);
+};
+
+} // namespace OrderMatchingEngine
+
+#endif // REPLAY_HPP
\ No newline at end of file
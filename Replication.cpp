@@ -0,0 +1,458 @@
+#include "Replication.hpp"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace OrderMatchingEngine {
+
+namespace {
+
+const int IDLE_POLL_MILLIS = 1;                 // Publisher wait when no commit is queued
+const int RECEIVE_POLL_MILLIS = 10;             // How quickly a standby notices promote()
+const int CONNECT_RETRY_MILLIS = 10;
+const size_t MAX_CHUNKS_PER_STREAM = 64;        // Per loop, so one busy shard cannot starve the rest
+const size_t RECEIVE_BLOCK_SIZE = 64 * 1024;
+const size_t SEND_COMPACT_THRESHOLD = 1024 * 1024;
+
+long long monotonicMicros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void setNoDelay(int socket) {
+    int enable = 1;
+    ::setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+}
+
+} // namespace
+
+// ReplicationPublisher implementation
+ReplicationPublisher::ReplicationPublisher(const PublisherConfig& config)
+    : config(config), listenSocket(-1), standbySocket(-1), boundPort(0), sendOffset(0), running(false),
+      standbyConnected(false), bytesSent(0), standbysDisconnected(0), streamOverruns(0) {
+}
+
+ReplicationPublisher::~ReplicationPublisher() {
+    stop();
+}
+
+void ReplicationPublisher::addLog(std::uint16_t shardId, WriteAheadLog& log) {
+    if (running.load()) {
+        throw std::invalid_argument("Logs must be added before the publisher is started");
+    }
+    streams.push_back(std::make_unique<Stream>(shardId, config.streamCapacity));
+    Stream* stream = streams.back().get();
+    log.setCommitListener([stream](const char* records, size_t size, std::uint64_t) {
+        publish(*stream, records, size);
+    });
+}
+
+void ReplicationPublisher::publish(Stream& stream, const char* records, size_t size) {
+    // Runs on the shard thread inside commit(): copy and return, never wait
+    Chunk chunk;
+    chunk.startsBatch = 1;
+    for (size_t offset = 0; offset < size; offset += chunk.size) {
+        chunk.size = static_cast<std::uint32_t>(std::min(CHUNK_PAYLOAD, size - offset));
+        std::memcpy(chunk.data, records + offset, chunk.size);
+        if (!stream.chunks.tryPush(chunk)) {
+            stream.overrun.store(true, std::memory_order_release);
+            return;
+        }
+        chunk.startsBatch = 0;
+    }
+}
+
+bool ReplicationPublisher::start() {
+    if (running.load()) {
+        return true;
+    }
+
+    listenSocket = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listenSocket < 0) {
+        return false;
+    }
+    int enable = 1;
+    ::setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(config.port);
+    if (::inet_pton(AF_INET, config.bindAddress.c_str(), &address.sin_addr) != 1 ||
+        ::bind(listenSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(listenSocket, 4) != 0) {
+        ::close(listenSocket);
+        listenSocket = -1;
+        return false;
+    }
+    socklen_t length = sizeof(address);
+    ::getsockname(listenSocket, reinterpret_cast<sockaddr*>(&address), &length);
+    boundPort = ntohs(address.sin_port);
+
+    running.store(true);
+    thread = std::thread(&ReplicationPublisher::run, this);
+    return true;
+}
+
+void ReplicationPublisher::stop() {
+    if (!running.exchange(false)) {
+        return;
+    }
+    if (thread.joinable()) {
+        thread.join();
+    }
+    if (standbySocket >= 0) {
+        ::close(standbySocket);
+        standbySocket = -1;
+        standbyConnected.store(false);
+    }
+    ::close(listenSocket);
+    listenSocket = -1;
+}
+
+void ReplicationPublisher::run() {
+    long long nextHeartbeat = monotonicMicros();
+    bool busy = false;
+    while (running.load(std::memory_order_relaxed)) {
+        pollfd descriptors[2];
+        descriptors[0].fd = listenSocket;
+        descriptors[0].events = POLLIN;
+        descriptors[0].revents = 0;
+        nfds_t count = 1;
+        if (standbySocket >= 0) {
+            descriptors[1].fd = standbySocket;
+            descriptors[1].events = POLLIN | (sendOffset < sendBuffer.size() ? POLLOUT : 0);
+            descriptors[1].revents = 0;
+            count = 2;
+        }
+        ::poll(descriptors, count, busy ? 0 : IDLE_POLL_MILLIS);
+
+        if (count == 2 && (descriptors[1].revents & (POLLIN | POLLERR | POLLHUP))) {
+            // A standby never sends: readable means it hung up
+            char discard[256];
+            ssize_t bytes = ::recv(standbySocket, discard, sizeof(discard), MSG_DONTWAIT);
+            if (bytes == 0 || (bytes < 0 && errno != EAGAIN && errno != EINTR)) {
+                disconnectStandby();
+            }
+        }
+        if (descriptors[0].revents & POLLIN) {
+            acceptStandby();
+        }
+
+        busy = forwardStreams();
+        long long now = monotonicMicros();
+        if (standbySocket >= 0 && now >= nextHeartbeat) {
+            queueFrame(Replication::FrameHeader::Type::HEARTBEAT, 0, nullptr, 0);
+            nextHeartbeat = now + static_cast<long long>(config.heartbeatIntervalMillis) * 1000;
+        }
+        flush();
+    }
+}
+
+void ReplicationPublisher::acceptStandby() {
+    int socket = ::accept4(listenSocket, nullptr, nullptr, SOCK_CLOEXEC | SOCK_NONBLOCK);
+    if (socket < 0) {
+        return;
+    }
+    if (standbySocket >= 0) {
+        ::close(socket);    // One standby at a time
+        return;
+    }
+    setNoDelay(socket);
+    standbySocket = socket;
+    for (const auto& stream : streams) {
+        stream->synchronized = false;
+    }
+    queueFrame(Replication::FrameHeader::Type::HELLO, static_cast<std::uint16_t>(streams.size()), nullptr, 0);
+    standbyConnected.store(true);
+}
+
+bool ReplicationPublisher::forwardStreams() {
+    bool moved = false;
+    Chunk chunk;
+    for (const auto& entry : streams) {
+        Stream& stream = *entry;
+        for (size_t i = 0; i < MAX_CHUNKS_PER_STREAM && stream.chunks.tryPop(chunk); ++i) {
+            moved = true;
+            // Checked after the pop: a chunk pushed after a lost one is never forwarded
+            if (stream.overrun.exchange(false, std::memory_order_acquire)) {
+                streamOverruns.fetch_add(1, std::memory_order_relaxed);
+                if (standbySocket >= 0) {
+                    disconnectStandby();
+                }
+            }
+            if (standbySocket < 0) {
+                continue;   // Nobody is following: the ring is only kept from filling up
+            }
+            if (!stream.synchronized) {
+                if (!chunk.startsBatch) {
+                    continue;
+                }
+                stream.synchronized = true;
+            }
+            queueFrame(Replication::FrameHeader::Type::RECORDS, stream.shardId, chunk.data, chunk.size);
+        }
+    }
+    return moved;
+}
+
+void ReplicationPublisher::queueFrame(Replication::FrameHeader::Type type, std::uint16_t shardId,
+                                      const char* data, size_t size) {
+    if (standbySocket < 0) {
+        return;
+    }
+    if (sendBuffer.size() - sendOffset + size > config.maxSendBufferBytes) {
+        disconnectStandby();    // Too far behind to catch up without a hole
+        return;
+    }
+    Replication::FrameHeader header;
+    header.type = type;
+    header.reserved = 0;
+    header.shardId = shardId;
+    header.size = static_cast<std::uint32_t>(size);
+    sendBuffer.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (size > 0) {
+        sendBuffer.append(data, size);
+    }
+}
+
+void ReplicationPublisher::flush() {
+    while (standbySocket >= 0 && sendOffset < sendBuffer.size()) {
+        ssize_t bytes = ::send(standbySocket, sendBuffer.data() + sendOffset, sendBuffer.size() - sendOffset,
+                               MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (bytes < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                disconnectStandby();
+            }
+            break;
+        }
+        sendOffset += static_cast<size_t>(bytes);
+        bytesSent.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    if (sendOffset == sendBuffer.size()) {
+        sendBuffer.clear();
+        sendOffset = 0;
+    } else if (sendOffset >= SEND_COMPACT_THRESHOLD) {
+        sendBuffer.erase(0, sendOffset);
+        sendOffset = 0;
+    }
+}
+
+void ReplicationPublisher::disconnectStandby() {
+    ::close(standbySocket);
+    standbySocket = -1;
+    sendBuffer.clear();
+    sendOffset = 0;
+    for (const auto& stream : streams) {
+        stream->synchronized = false;
+    }
+    standbyConnected.store(false);
+    standbysDisconnected.fetch_add(1, std::memory_order_relaxed);
+}
+
+// StandbyReplica implementation
+StandbyReplica::StandbyReplica(const StandbyConfig& config, const std::vector<MatchingShard*>& shards)
+    : config(config), shards(shards), decoders(shards.size()), pending(shards.size()), socket(-1),
+      running(false), following(false), connected(false), diverged(false), lastFrameMicros(0), eventsApplied(0),
+      lastSequence(0) {
+    for (MatchingShard* shard : shards) {
+        if (!shard) {
+            throw std::invalid_argument("Every shard ID needs a shard");
+        }
+        lastSequence = std::max(lastSequence.load(), shard->getReplayedSequence());
+    }
+}
+
+StandbyReplica::~StandbyReplica() {
+    running.store(false);
+    if (thread.joinable()) {
+        thread.join();
+    }
+    closeSocket();
+}
+
+bool StandbyReplica::connect() {
+    if (running.load()) {
+        return true;
+    }
+
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(config.primaryPort);
+    if (::inet_pton(AF_INET, config.primaryHost.c_str(), &address.sin_addr) != 1) {
+        return false;
+    }
+
+    // The primary may still be starting: retry until the deadline
+    long long deadline = monotonicMicros() + static_cast<long long>(config.connectTimeoutMillis) * 1000;
+    while (true) {
+        socket = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (socket >= 0 && ::connect(socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0) {
+            break;
+        }
+        closeSocket();
+        if (monotonicMicros() >= deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(CONNECT_RETRY_MILLIS));
+    }
+    setNoDelay(socket);
+
+    // The primary introduces itself with its shard count; a different layout cannot be followed
+    Replication::FrameHeader hello;
+    size_t received = 0;
+    while (received < sizeof(hello)) {
+        pollfd descriptor;
+        descriptor.fd = socket;
+        descriptor.events = POLLIN;
+        descriptor.revents = 0;
+        int waitMillis = static_cast<int>(std::max(0LL, (deadline - monotonicMicros()) / 1000));
+        ssize_t bytes = ::poll(&descriptor, 1, waitMillis) == 1
+            ? ::recv(socket, reinterpret_cast<char*>(&hello) + received, sizeof(hello) - received, 0) : -1;
+        if (bytes <= 0) {
+            closeSocket();
+            return false;
+        }
+        received += static_cast<size_t>(bytes);
+    }
+    if (hello.type != Replication::FrameHeader::Type::HELLO || hello.shardId != shards.size() ||
+        hello.size != 0) {
+        closeSocket();
+        return false;
+    }
+
+    lastFrameMicros.store(monotonicMicros());
+    connected.store(true);
+    running.store(true);
+    thread = std::thread(&StandbyReplica::run, this);
+    return true;
+}
+
+void StandbyReplica::follow() {
+    following.store(true, std::memory_order_release);
+}
+
+std::uint64_t StandbyReplica::promote() {
+    running.store(false);
+    if (thread.joinable()) {
+        thread.join();
+    }
+    closeSocket();
+    connected.store(false);
+
+    // The shards are this thread's now; nothing else is coming, so apply what arrived
+    applyPending();
+    following.store(false);
+    if (diverged.load()) {
+        throw std::runtime_error("Standby has diverged from the primary and has to be reseeded");
+    }
+    return lastSequence.load();
+}
+
+bool StandbyReplica::isPrimaryAlive(long long staleAfterMicros) const {
+    return connected.load(std::memory_order_relaxed) &&
+           monotonicMicros() - lastFrameMicros.load(std::memory_order_relaxed) <= staleAfterMicros;
+}
+
+void StandbyReplica::run() {
+    while (running.load(std::memory_order_relaxed)) {
+        pollfd descriptor;
+        descriptor.fd = socket;
+        descriptor.events = POLLIN;
+        descriptor.revents = 0;
+        if (::poll(&descriptor, 1, RECEIVE_POLL_MILLIS) > 0 && !receive()) {
+            connected.store(false);     // Primary gone: keep what was received for promote()
+            break;
+        }
+        if (following.load(std::memory_order_acquire)) {
+            applyPending();
+        }
+    }
+}
+
+bool StandbyReplica::receive() {
+    char block[RECEIVE_BLOCK_SIZE];
+    bool open = true;
+    while (true) {
+        ssize_t bytes = ::recv(socket, block, sizeof(block), MSG_DONTWAIT);
+        if (bytes > 0) {
+            receiveBuffer.append(block, static_cast<size_t>(bytes));
+            continue;
+        }
+        if (bytes < 0 && errno == EINTR) {
+            continue;
+        }
+        open = bytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+        break;
+    }
+
+    // Split complete frames off the buffer; each shard's records go to its decoder
+    size_t offset = 0;
+    Replication::FrameHeader header;
+    while (receiveBuffer.size() - offset >= sizeof(header)) {
+        std::memcpy(&header, receiveBuffer.data() + offset, sizeof(header));
+        if (receiveBuffer.size() - offset - sizeof(header) < header.size) {
+            break;
+        }
+        if (header.type == Replication::FrameHeader::Type::RECORDS && header.shardId < decoders.size()) {
+            decoders[header.shardId].feed(receiveBuffer.data() + offset + sizeof(header), header.size);
+        }
+        offset += sizeof(header) + header.size;
+    }
+    if (offset > 0) {
+        receiveBuffer.erase(0, offset);
+        lastFrameMicros.store(monotonicMicros(), std::memory_order_relaxed);
+    }
+
+    SequencedEvent event;
+    for (size_t shard = 0; shard < decoders.size(); ++shard) {
+        while (decoders[shard].next(event)) {
+            pending[shard].push_back(event);
+        }
+    }
+    return open;
+}
+
+void StandbyReplica::applyPending() {
+    for (size_t shard = 0; shard < shards.size(); ++shard) {
+        if (diverged.load(std::memory_order_relaxed)) {
+            pending[shard].clear();     // Nothing can be applied on top of a hole
+            continue;
+        }
+        if (pending[shard].empty()) {
+            continue;
+        }
+        try {
+            eventsApplied.fetch_add(static_cast<long long>(shards[shard]->replicate(pending[shard])),
+                                    std::memory_order_relaxed);
+        } catch (const std::runtime_error&) {
+            diverged.store(true);
+        }
+        pending[shard].clear();
+        if (shards[shard]->getReplayedSequence() > lastSequence.load(std::memory_order_relaxed)) {
+            lastSequence.store(shards[shard]->getReplayedSequence(), std::memory_order_relaxed);
+        }
+    }
+}
+
+void StandbyReplica::closeSocket() {
+    if (socket >= 0) {
+        ::close(socket);
+        socket = -1;
+    }
+}
+
+} // namespace OrderMatchingEngine
\ No newline at end of file
@@ -0,0 +1,244 @@
+#ifndef REPLICATION_HPP
+#define REPLICATION_HPP
+
+#include "EventLog.hpp"
+#include "MatchingShard.hpp"
+#include "RingBuffer.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace OrderMatchingEngine {
+
+namespace Replication {
+
+/**
+ * @brief Header of every message on a replication stream, followed by size bytes
+ */
+struct FrameHeader {
+    enum class Type : std::uint8_t {
+        HELLO = 1,      // First frame; shardId carries the primary's shard count
+        RECORDS,        // Committed log records of one shard, in the log file's encoding
+        HEARTBEAT
+    };
+
+    Type type;
+    std::uint8_t reserved;
+    std::uint16_t shardId;
+    std::uint32_t size;
+};
+
+static_assert(sizeof(FrameHeader) == 8, "Replication frames have a fixed 8-byte header");
+
+} // namespace Replication
+
+/**
+ * @brief Primary side of hot-standby replication: streams every shard's committed log to a standby
+ *
+ * Each shard's WriteAheadLog hands its commits to this publisher through a
+ * commit listener, which copies the batch into a per-shard SPSC ring; the
+ * shard thread never waits for the network. The publisher thread forwards
+ * the rings to one connected standby over TCP and sends a heartbeat every
+ * heartbeatIntervalMillis. A new standby joins each shard's stream at the
+ * start of its next commit, so it only ever sees whole records.
+ *
+ * Replication is asynchronous: a batch is shipped after it is committed and
+ * applied on the primary. If a ring overflows or the standby falls more than
+ * maxSendBufferBytes behind, its stream would have a hole, so it is
+ * disconnected and must be reseeded.
+ */
+class ReplicationPublisher {
+public:
+    struct PublisherConfig {
+        std::string bindAddress;
+        std::uint16_t port;                 // 0 picks a free port, see getPort()
+        size_t streamCapacity;              // Chunks buffered per shard
+        int heartbeatIntervalMillis;
+        size_t maxSendBufferBytes;
+
+        PublisherConfig()
+            : bindAddress("0.0.0.0"), port(9200), streamCapacity(4096), heartbeatIntervalMillis(100),
+              maxSendBufferBytes(64 * 1024 * 1024) {}
+    };
+
+private:
+    static constexpr size_t CHUNK_PAYLOAD = 4096 - 2 * sizeof(std::uint32_t);
+
+    struct Chunk {
+        std::uint32_t size;
+        std::uint32_t startsBatch;          // First chunk of a commit: a record boundary
+        char data[CHUNK_PAYLOAD];
+    };
+
+    struct Stream {
+        std::uint16_t shardId;
+        SpscRing<Chunk> chunks;             // Shard thread -> publisher thread
+        std::atomic<bool> overrun;          // A commit did not fit: the stream has a hole
+        bool synchronized;                  // Standby joined at a batch boundary (publisher thread)
+
+        Stream(std::uint16_t shardId, size_t capacity)
+            : shardId(shardId), chunks(capacity), overrun(false), synchronized(false) {}
+    };
+
+    PublisherConfig config;
+    std::vector<std::unique_ptr<Stream>> streams;
+    int listenSocket;
+    int standbySocket;
+    std::uint16_t boundPort;
+    std::string sendBuffer;                 // Frames not yet accepted by the standby's socket
+    size_t sendOffset;
+
+    std::thread thread;
+    std::atomic<bool> running;
+    std::atomic<bool> standbyConnected;
+    std::atomic<long long> bytesSent;
+    std::atomic<long long> standbysDisconnected;
+    std::atomic<long long> streamOverruns;
+
+    void run();
+    void acceptStandby();
+    bool forwardStreams();
+    void queueFrame(Replication::FrameHeader::Type type, std::uint16_t shardId, const char* data, size_t size);
+    void flush();
+    void disconnectStandby();
+    static void publish(Stream& stream, const char* records, size_t size);
+
+public:
+    explicit ReplicationPublisher(const PublisherConfig& config = PublisherConfig());
+    ~ReplicationPublisher();
+
+    ReplicationPublisher(const ReplicationPublisher&) = delete;
+    ReplicationPublisher& operator=(const ReplicationPublisher&) = delete;
+
+    /**
+     * @brief Replicate a shard's log (before start() only)
+     * Installs the log's commit listener, so it runs on the shard thread from then on.
+     */
+    void addLog(std::uint16_t shardId, WriteAheadLog& log);
+
+    /**
+     * @brief Listen for a standby and start the publisher thread
+     * @return False if the listening socket could not be set up
+     */
+    bool start();
+
+    /**
+     * @brief Stop the publisher thread and disconnect the standby
+     */
+    void stop();
+
+    bool isRunning() const { return running.load(std::memory_order_relaxed); }
+    bool isStandbyConnected() const { return standbyConnected.load(std::memory_order_relaxed); }
+    std::uint16_t getPort() const { return boundPort; }     // Valid after start()
+    long long getBytesSent() const { return bytesSent.load(std::memory_order_relaxed); }
+    long long getStandbysDisconnected() const { return standbysDisconnected.load(std::memory_order_relaxed); }
+    long long getStreamOverruns() const { return streamOverruns.load(std::memory_order_relaxed); }
+};
+
+/**
+ * @brief Standby side of hot-standby replication: keeps shards identical to the primary's
+ *
+ * The standby owns shards built from the same configuration as the primary's
+ * (same shard count and symbol placement) and never starts them while it
+ * follows. Its thread receives the primary's committed records and applies
+ * them through MatchingShard::replicate, so books, order and trade IDs and the
+ * fill handlers' downstream state (accounts, positions) track the primary
+ * event for event. Failing over is promote() followed by starting the shards:
+ * nothing is replayed at that point, the books are already current.
+ *
+ * Seeding a standby while the primary runs: connect() first, so the stream is
+ * buffered from then on, recover each shard from a copy of the primary's
+ * snapshots and logs, then follow(). Events both in the copy and in the stream
+ * are applied once. The stream has no way to fill a hole, so a standby whose
+ * connection drops stays as it was at the drop and has to be reseeded. A hole
+ * between the copy and the stream, or within the stream, marks the standby
+ * diverged: it applies nothing more and refuses to be promoted.
+ */
+class StandbyReplica {
+public:
+    struct StandbyConfig {
+        std::string primaryHost;            // IPv4 address
+        std::uint16_t primaryPort;
+        int connectTimeoutMillis;
+
+        StandbyConfig() : primaryHost("127.0.0.1"), primaryPort(9200), connectTimeoutMillis(5000) {}
+    };
+
+private:
+    StandbyConfig config;
+    std::vector<MatchingShard*> shards;                 // By shard ID
+    std::vector<EventLogReader> decoders;               // Per shard: records received, not yet decoded
+    std::vector<std::vector<SequencedEvent>> pending;   // Per shard: decoded, not yet applied
+    int socket;
+    std::string receiveBuffer;
+
+    std::thread thread;
+    std::atomic<bool> running;
+    std::atomic<bool> following;
+    std::atomic<bool> connected;
+    std::atomic<bool> diverged;
+    std::atomic<long long> lastFrameMicros;
+    std::atomic<long long> eventsApplied;
+    std::atomic<std::uint64_t> lastSequence;
+
+    void run();
+    bool receive();
+    void applyPending();
+    void closeSocket();
+
+public:
+    /**
+     * @brief Constructor
+     * @param shards The standby's shards, indexed by shard ID; they must not be started while following
+     */
+    StandbyReplica(const StandbyConfig& config, const std::vector<MatchingShard*>& shards);
+    ~StandbyReplica();
+
+    StandbyReplica(const StandbyReplica&) = delete;
+    StandbyReplica& operator=(const StandbyReplica&) = delete;
+
+    /**
+     * @brief Connect to the primary and start buffering its stream
+     * @return False if the primary could not be reached in time or runs a different number of shards
+     */
+    bool connect();
+
+    /**
+     * @brief Start applying the stream, beginning with what was buffered since connect()
+     * From here on the shards belong to the standby's thread until promote().
+     */
+    void follow();
+
+    /**
+     * @brief Stop following and apply every complete record already received
+     * The shards are then ready to be started as the new primary; their event
+     * logs, if set, continue numbering after getLastSequence().
+     * @return Highest sequence number applied
+     * @throws std::runtime_error if the standby has diverged from the primary; it has to be reseeded
+     */
+    std::uint64_t promote();
+
+    bool isFollowing() const { return following.load(std::memory_order_relaxed); }
+    bool isConnected() const { return connected.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Whether a hole in the events received left the shards behind the primary for good
+     */
+    bool isDiverged() const { return diverged.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Whether the primary has sent anything, heartbeats included, within staleAfterMicros
+     * A supervisor promotes the standby once this turns false, unless isDiverged().
+     */
+    bool isPrimaryAlive(long long staleAfterMicros = 300000) const;
+
+    long long getEventsApplied() const { return eventsApplied.load(std::memory_order_relaxed); }
+    std::uint64_t getLastSequence() const { return lastSequence.load(std::memory_order_relaxed); }
+};
+
+} // namespace OrderMatchingEngine
+
+#endif // REPLICATION_HPP
\ No newline at end of file
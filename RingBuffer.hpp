@@ -0,0 +1,291 @@
+#ifndef RING_BUFFER_HPP
+#define RING_BUFFER_HPP
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+namespace OrderMatchingEngine {
+
+/**
+ * @brief Size in bytes of a cache line, used to keep producer and consumer state apart
+ */
+constexpr size_t CACHE_LINE_SIZE = 64;
+
+/**
+ * @brief Round a ring capacity up to the next power of two (minimum 2)
+ */
+inline size_t roundUpToPowerOfTwo(size_t value) {
+    size_t capacity = 2;
+    while (capacity < value) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+/**
+ * @brief Bounded lock-free single-producer/single-consumer ring buffer
+ *
+ * Each side caches the other side's index so the shared atomics are only
+ * re-read when the ring looks full (producer) or empty (consumer).
+ */
+template<typename T>
+class SpscRing {
+private:
+    std::unique_ptr<T[]> slots;
+    size_t mask;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> head;     // Next slot to read (consumer)
+    size_t cachedTail;                                      // Consumer's view of tail
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail;     // Next slot to write (producer)
+    size_t cachedHead;                                      // Producer's view of head
+
+public:
+    explicit SpscRing(size_t capacity)
+        : slots(new T[roundUpToPowerOfTwo(capacity)]), mask(roundUpToPowerOfTwo(capacity) - 1),
+          head(0), cachedTail(0), tail(0), cachedHead(0) {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    /**
+     * @brief Append an element (producer thread only)
+     * @return False if the ring is full; the value is left untouched
+     */
+    template<typename U>
+    bool tryPush(U&& value) {
+        size_t currentTail = tail.load(std::memory_order_relaxed);
+        if (currentTail - cachedHead > mask) {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (currentTail - cachedHead > mask) {
+                return false;
+            }
+        }
+        slots[currentTail & mask] = std::forward<U>(value);
+        tail.store(currentTail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Remove the oldest element (consumer thread only)
+     * @return False if the ring is empty
+     */
+    bool tryPop(T& out) {
+        size_t currentHead = head.load(std::memory_order_relaxed);
+        if (currentHead == cachedTail) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (currentHead == cachedTail) {
+                return false;
+            }
+        }
+        out = std::move(slots[currentHead & mask]);
+        head.store(currentHead + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Remove up to maxCount elements at once (consumer thread only)
+     * @return Number of elements written to out
+     */
+    size_t tryPopBatch(T* out, size_t maxCount) {
+        size_t currentHead = head.load(std::memory_order_relaxed);
+        cachedTail = tail.load(std::memory_order_acquire);
+        size_t count = std::min(maxCount, cachedTail - currentHead);
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = std::move(slots[(currentHead + i) & mask]);
+        }
+        head.store(currentHead + count, std::memory_order_release);
+        return count;
+    }
+
+    size_t capacity() const { return mask + 1; }
+    size_t sizeApprox() const {
+        return tail.load(std::memory_order_relaxed) - head.load(std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @brief Bounded lock-free multi-producer/single-consumer ring buffer
+ *
+ * Producers claim slots with a CAS on the enqueue position and publish them
+ * through a per-slot sequence number (Vyukov's bounded queue), so a slow
+ * producer never blocks the others and the consumer never takes a lock.
+ */
+template<typename T>
+class MpscRing {
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    size_t mask;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> enqueuePos;   // Shared by producers
+    alignas(CACHE_LINE_SIZE) size_t dequeuePos;                // Consumer only
+
+public:
+    explicit MpscRing(size_t capacity)
+        : cells(new Cell[roundUpToPowerOfTwo(capacity)]), mask(roundUpToPowerOfTwo(capacity) - 1),
+          enqueuePos(0), dequeuePos(0) {
+        for (size_t i = 0; i <= mask; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRing(const MpscRing&) = delete;
+    MpscRing& operator=(const MpscRing&) = delete;
+
+    /**
+     * @brief Append an element (any thread)
+     * @return False if the ring is full; the value is left untouched
+     */
+    template<typename U>
+    bool tryPush(U&& value) {
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[pos & mask];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            std::intptr_t diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = std::forward<U>(value);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // Full
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Remove the oldest published element (consumer thread only)
+     * @return False if the ring is empty
+     */
+    bool tryPop(T& out) {
+        Cell& cell = cells[dequeuePos & mask];
+        size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        if (static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(dequeuePos + 1) < 0) {
+            return false;
+        }
+        out = std::move(cell.value);
+        cell.sequence.store(dequeuePos + mask + 1, std::memory_order_release);
+        ++dequeuePos;
+        return true;
+    }
+
+    size_t capacity() const { return mask + 1; }
+};
+
+/**
+ * @brief Bounded lock-free single-producer/multi-consumer broadcast ring
+ *
+ * Every reader sees every element, reading at its own cursor. The producer never
+ * waits for readers: it overwrites the oldest slot, and each slot carries the
+ * sequence of the element it holds, so a reader that fell a full ring behind
+ * detects the overrun instead of reading a torn or newer element. Written
+ * elements become visible in groups, when the producer calls publish().
+ */
+template<typename T>
+class BroadcastRing {
+    static_assert(std::is_trivially_copyable<T>::value, "BroadcastRing needs a trivially copyable value");
+
+public:
+    enum class ReadResult {
+        OK,
+        NOT_READY,  // Not published yet
+        OVERRUN     // Overwritten before it was read
+    };
+
+private:
+    static constexpr size_t WORD_COUNT = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+    struct Slot {
+        std::atomic<std::uint64_t> version;     // 2 * sequence when complete, odd while being written
+        std::atomic<std::uint64_t> words[WORD_COUNT];
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    size_t mask;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> publishedSequence;
+    alignas(CACHE_LINE_SIZE) std::uint64_t writtenSequence;    // Producer only
+
+public:
+    explicit BroadcastRing(size_t capacity)
+        : slots(new Slot[roundUpToPowerOfTwo(capacity)]), mask(roundUpToPowerOfTwo(capacity) - 1),
+          publishedSequence(0), writtenSequence(0) {
+        for (size_t i = 0; i <= mask; ++i) {
+            slots[i].version.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    BroadcastRing(const BroadcastRing&) = delete;
+    BroadcastRing& operator=(const BroadcastRing&) = delete;
+
+    /**
+     * @brief Write the next element (producer thread only); invisible until publish()
+     * @return Its sequence number, starting at 1
+     */
+    std::uint64_t write(const T& value) {
+        std::uint64_t buffer[WORD_COUNT] = {};
+        std::memcpy(buffer, &value, sizeof(T));
+
+        std::uint64_t sequence = ++writtenSequence;
+        Slot& slot = slots[sequence & mask];
+        slot.version.store(2 * sequence - 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORD_COUNT; ++i) {
+            slot.words[i].store(buffer[i], std::memory_order_relaxed);
+        }
+        slot.version.store(2 * sequence, std::memory_order_release);
+        return sequence;
+    }
+
+    /**
+     * @brief Make every written element visible to readers (producer thread only)
+     */
+    void publish() { publishedSequence.store(writtenSequence, std::memory_order_release); }
+
+    std::uint64_t getPublishedSequence() const { return publishedSequence.load(std::memory_order_acquire); }
+    std::uint64_t getWrittenSequence() const { return writtenSequence; }   // Producer thread only
+
+    /**
+     * @brief Copy the element with the given sequence (any thread)
+     */
+    ReadResult read(std::uint64_t sequence, T& out) const {
+        if (sequence == 0 || sequence > publishedSequence.load(std::memory_order_acquire)) {
+            return ReadResult::NOT_READY;
+        }
+        const Slot& slot = slots[sequence & mask];
+        if (slot.version.load(std::memory_order_acquire) != 2 * sequence) {
+            return ReadResult::OVERRUN;
+        }
+        std::uint64_t buffer[WORD_COUNT];
+        for (size_t i = 0; i < WORD_COUNT; ++i) {
+            buffer[i] = slot.words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.version.load(std::memory_order_relaxed) != 2 * sequence) {
+            return ReadResult::OVERRUN;
+        }
+        std::memcpy(&out, buffer, sizeof(T));
+        return ReadResult::OK;
+    }
+
+    size_t capacity() const { return mask + 1; }
+};
+
+} // namespace OrderMatchingEngine
+
+#endif // RING_BUFFER_HPP
\ No newline at end of file
@@ -0,0 +1,169 @@
+#include "RiskEngine.hpp"
+#include <cmath>
+#include <stdexcept>
+
+namespace OrderMatchingEngine {
+
+namespace {
+
+/**
+ * @brief Take back notional counted as open, never going below zero
+ * A risk factor changed between check and fill can make the amounts differ slightly.
+ */
+void releaseNotional(std::atomic<CashAmount>& counter, CashAmount amount) {
+    CashAmount current = counter.load(std::memory_order_relaxed);
+    CashAmount next;
+    do {
+        next = current > amount ? current - amount : 0;
+    } while (!counter.compare_exchange_weak(current, next, std::memory_order_relaxed));
+}
+
+} // namespace
+
+RiskEngine::RiskEngine(const RiskEngineConfig& config)
+    : config(config), accounts(new AccountExposure[config.maxAccounts]), accountCount(0), symbolTable(nullptr) {
+    std::lock_guard<std::mutex> lock(configMutex);
+    publishSymbolTable();
+}
+
+RiskEngine::SymbolEntry RiskEngine::compile(const SymbolRiskLimits& limits) {
+    SymbolEntry entry;
+    entry.maxOrderQuantity = limits.maxOrderQuantity;
+    entry.maxOrderNotional = limits.maxOrderNotional;
+    entry.riskWeight = std::llround(limits.riskFactor * static_cast<double>(RISK_WEIGHT_SCALE));
+    entry.tradingEnabled = limits.tradingEnabled;
+    return entry;
+}
+
+void RiskEngine::publishSymbolTable() {
+    auto table = std::make_unique<SymbolTable>();
+    table->defaults = compile(defaultLimits);
+    for (const auto& entry : symbolLimits) {
+        if (table->entries.size() <= entry.first) {
+            table->entries.resize(static_cast<size_t>(entry.first) + 1, table->defaults);
+        }
+        table->entries[entry.first] = compile(entry.second);
+    }
+    symbolTable.store(table.get(), std::memory_order_release);
+    symbolTables.push_back(std::move(table));
+}
+
+RiskAccountId RiskEngine::registerAccount(AccountRiskState* account) {
+    std::lock_guard<std::mutex> lock(configMutex);
+    std::uint32_t id = accountCount.load(std::memory_order_relaxed);
+    if (id >= config.maxAccounts) {
+        throw std::runtime_error("Risk engine account capacity exhausted");
+    }
+
+    AccountExposure& exposure = accounts[id];
+    exposure.account = account;
+    exposure.orderRate.configure(config.defaultOrdersPerSecond, config.orderBurst);
+    exposure.openNotional.store(0, std::memory_order_relaxed);
+    exposure.tradedNotionalToday.store(0, std::memory_order_relaxed);
+    accountCount.store(id + 1, std::memory_order_release);
+    return id;
+}
+
+void RiskEngine::setSymbolLimits(std::uint16_t symbolIndex, const SymbolRiskLimits& limits) {
+    std::lock_guard<std::mutex> lock(configMutex);
+    symbolLimits[symbolIndex] = limits;
+    publishSymbolTable();
+}
+
+void RiskEngine::setDefaultSymbolLimits(const SymbolRiskLimits& limits) {
+    std::lock_guard<std::mutex> lock(configMutex);
+    defaultLimits = limits;
+    publishSymbolTable();
+}
+
+void RiskEngine::setOrderRate(RiskAccountId id, double ordersPerSecond, int burst) {
+    if (id < accountCount.load(std::memory_order_acquire)) {
+        accounts[id].orderRate.configure(ordersPerSecond, burst);
+    }
+}
+
+RiskCheckResult RiskEngine::checkOrder(RiskAccountId id, const PreTradeOrder& order, long long nowMicros) {
+    if (id >= accountCount.load(std::memory_order_acquire)) {
+        return RiskCheckResult::UNKNOWN_ACCOUNT;
+    }
+    AccountExposure& exposure = accounts[id];
+    const SymbolEntry& symbol = lookup(*symbolTable.load(std::memory_order_acquire), order.symbolIndex);
+
+    if (!symbol.tradingEnabled) {
+        return RiskCheckResult::TRADING_HALTED;
+    }
+    if (symbol.maxOrderQuantity > 0 && order.quantity > symbol.maxOrderQuantity) {
+        return RiskCheckResult::ORDER_TOO_LARGE;
+    }
+    CashAmount weighted = weigh(order.getValue(), symbol);
+    if (symbol.maxOrderNotional > 0 && weighted > symbol.maxOrderNotional) {
+        return RiskCheckResult::ORDER_TOO_LARGE;
+    }
+    if (config.maxDailyNotional > 0 &&
+        exposure.tradedNotionalToday.load(std::memory_order_relaxed) + weighted > config.maxDailyNotional) {
+        return RiskCheckResult::DAILY_VOLUME_LIMIT;
+    }
+    if (!exposure.orderRate.tryAcquire(nowMicros)) {
+        return RiskCheckResult::ORDER_RATE_LIMIT;
+    }
+
+    // Claim the exposure before the account check so concurrent orders cannot overshoot it together
+    CashAmount open = exposure.openNotional.load(std::memory_order_relaxed);
+    do {
+        if (config.maxOpenNotional > 0 && open + weighted > config.maxOpenNotional) {
+            return RiskCheckResult::EXPOSURE_LIMIT;
+        }
+    } while (!exposure.openNotional.compare_exchange_weak(open, open + weighted, std::memory_order_relaxed));
+
+    RiskCheckResult result = exposure.account->checkAndReserve(order, nowMicros);
+    if (result != RiskCheckResult::ACCEPTED) {
+        releaseNotional(exposure.openNotional, weighted);
+    }
+    return result;
+}
+
+void RiskEngine::onFill(RiskAccountId id, const PreTradeOrder& order, int fillQuantity, CashAmount fillPrice) {
+    if (id >= accountCount.load(std::memory_order_acquire)) {
+        return;
+    }
+    AccountExposure& exposure = accounts[id];
+    const SymbolEntry& symbol = lookup(*symbolTable.load(std::memory_order_acquire), order.symbolIndex);
+
+    CashAmount reservedPart = order.side == OrderSide::BUY ? order.unitPrice * fillQuantity : 0;
+    exposure.account->applyFill(order.symbolIndex, order.side, fillQuantity, fillPrice, reservedPart);
+    releaseNotional(exposure.openNotional, weigh(order.unitPrice * fillQuantity, symbol));
+    exposure.tradedNotionalToday.fetch_add(weigh(fillPrice * fillQuantity, symbol), std::memory_order_relaxed);
+}
+
+void RiskEngine::onCancel(RiskAccountId id, const PreTradeOrder& order, int cancelledQuantity) {
+    if (id >= accountCount.load(std::memory_order_acquire)) {
+        return;
+    }
+    AccountExposure& exposure = accounts[id];
+    const SymbolEntry& symbol = lookup(*symbolTable.load(std::memory_order_acquire), order.symbolIndex);
+
+    if (order.side == OrderSide::BUY) {
+        exposure.account->releaseReservation(order.unitPrice * cancelledQuantity);
+    }
+    releaseNotional(exposure.openNotional, weigh(order.unitPrice * cancelledQuantity, symbol));
+}
+
+void RiskEngine::resetDay() {
+    std::uint32_t count = accountCount.load(std::memory_order_acquire);
+    for (std::uint32_t id = 0; id < count; ++id) {
+        accounts[id].tradedNotionalToday.store(0, std::memory_order_relaxed);
+        accounts[id].account->resetDay();
+    }
+}
+
+CashAmount RiskEngine::getOpenNotional(RiskAccountId id) const {
+    return id < accountCount.load(std::memory_order_acquire)
+        ? accounts[id].openNotional.load(std::memory_order_relaxed) : 0;
+}
+
+CashAmount RiskEngine::getTradedNotionalToday(RiskAccountId id) const {
+    return id < accountCount.load(std::memory_order_acquire)
+        ? accounts[id].tradedNotionalToday.load(std::memory_order_relaxed) : 0;
+}
+
+} // namespace OrderMatchingEngine
\ No newline at end of file
@@ -0,0 +1,156 @@
+#ifndef RISK_ENGINE_HPP
+#define RISK_ENGINE_HPP
+
+#include "AccountRisk.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace OrderMatchingEngine {
+
+using RiskAccountId = std::uint32_t;
+
+/**
+ * @brief Limits for one symbol, compiled from string-keyed configuration
+ */
+struct SymbolRiskLimits {
+    int maxOrderQuantity;           // 0 for no limit
+    CashAmount maxOrderNotional;    // Risk-weighted; 0 for no limit
+    double riskFactor;              // Weight applied to notional (1.0 = face value)
+    bool tradingEnabled;
+
+    SymbolRiskLimits() : maxOrderQuantity(0), maxOrderNotional(0), riskFactor(1.0), tradingEnabled(true) {}
+};
+
+/**
+ * @brief Pre-trade risk with every check a constant-time comparison against cached state
+ *
+ * Limits keyed by symbol name are compiled into a table indexed by symbol
+ * index; accounts are registered once and addressed by a dense RiskAccountId
+ * the session keeps. Risk-weighted open and traded notional are maintained
+ * incrementally from acks, fills and cancels, so a check never walks a
+ * portfolio or looks anything up by string. Everything on the check path is
+ * lock-free; only configuration and registration take a mutex.
+ */
+class RiskEngine {
+public:
+    struct RiskEngineConfig {
+        size_t maxAccounts;                 // Registration capacity, fixed so checks index a flat array
+        CashAmount maxOpenNotional;         // Per account, risk-weighted open orders; 0 for no limit
+        CashAmount maxDailyNotional;        // Per account, risk-weighted traded today; 0 for no limit
+        double defaultOrdersPerSecond;      // Token bucket per account; 0 for no limit
+        int orderBurst;
+
+        RiskEngineConfig()
+            : maxAccounts(65536), maxOpenNotional(0), maxDailyNotional(0), defaultOrdersPerSecond(0.0),
+              orderBurst(1) {}
+    };
+
+private:
+    /**
+     * @brief Compiled per-symbol limits; risk factors are fixed point for integer math
+     */
+    struct SymbolEntry {
+        int maxOrderQuantity;
+        CashAmount maxOrderNotional;
+        std::int64_t riskWeight;    // riskFactor * RISK_WEIGHT_SCALE
+        bool tradingEnabled;
+    };
+
+    struct SymbolTable {
+        std::vector<SymbolEntry> entries;   // By symbol index
+        SymbolEntry defaults;
+    };
+
+    struct alignas(CACHE_LINE_SIZE) AccountExposure {
+        AccountRiskState* account;
+        TokenBucket orderRate;
+        std::atomic<CashAmount> openNotional;
+        std::atomic<CashAmount> tradedNotionalToday;
+    };
+
+    static constexpr std::int64_t RISK_WEIGHT_SCALE = 10000;
+
+    RiskEngineConfig config;
+    std::unique_ptr<AccountExposure[]> accounts;
+    std::atomic<std::uint32_t> accountCount;
+
+    // Tables are immutable once published; replaced ones are kept until destruction
+    // so a check that loaded the old pointer can finish with it
+    std::atomic<const SymbolTable*> symbolTable;
+    std::vector<std::unique_ptr<SymbolTable>> symbolTables;
+    std::unordered_map<std::uint16_t, SymbolRiskLimits> symbolLimits;
+    SymbolRiskLimits defaultLimits;
+    std::mutex configMutex;
+
+    void publishSymbolTable();      // Caller holds configMutex
+    static SymbolEntry compile(const SymbolRiskLimits& limits);
+    static CashAmount weigh(CashAmount notional, const SymbolEntry& entry) {
+        return notional * entry.riskWeight / RISK_WEIGHT_SCALE;
+    }
+    const SymbolEntry& lookup(const SymbolTable& table, std::uint16_t symbolIndex) const {
+        return symbolIndex < table.entries.size() ? table.entries[symbolIndex] : table.defaults;
+    }
+
+public:
+    explicit RiskEngine(const RiskEngineConfig& config = RiskEngineConfig());
+
+    RiskEngine(const RiskEngine&) = delete;
+    RiskEngine& operator=(const RiskEngine&) = delete;
+
+    /**
+     * @brief Register an account and get its risk handle (once per account, e.g. at login)
+     * The state must outlive the engine; UserManager never destroys registered accounts.
+     * @throws std::runtime_error if maxAccounts accounts are already registered
+     */
+    RiskAccountId registerAccount(AccountRiskState* account);
+
+    /**
+     * @brief Set the limits of one symbol; other symbols keep theirs
+     */
+    void setSymbolLimits(std::uint16_t symbolIndex, const SymbolRiskLimits& limits);
+
+    /**
+     * @brief Set the limits of every symbol without its own
+     */
+    void setDefaultSymbolLimits(const SymbolRiskLimits& limits);
+
+    /**
+     * @brief Change an account's order rate (0 for no limit)
+     */
+    void setOrderRate(RiskAccountId id, double ordersPerSecond, int burst);
+
+    /**
+     * @brief Every pre-trade check for a new order, then the account's cash reservation
+     * On ACCEPTED the order's weighted notional counts as open until onFill/onCancel.
+     */
+    RiskCheckResult checkOrder(RiskAccountId id, const PreTradeOrder& order, long long nowMicros);
+
+    /**
+     * @brief Account for part of a checked order trading
+     * @param order The order as it was checked
+     */
+    void onFill(RiskAccountId id, const PreTradeOrder& order, int fillQuantity, CashAmount fillPrice);
+
+    /**
+     * @brief Account for part of a checked order leaving the book untraded
+     * (cancel, market remainder, or the reduction of a replace)
+     */
+    void onCancel(RiskAccountId id, const PreTradeOrder& order, int cancelledQuantity);
+
+    /**
+     * @brief Start a new trading day for every account
+     */
+    void resetDay();
+
+    CashAmount getOpenNotional(RiskAccountId id) const;
+    CashAmount getTradedNotionalToday(RiskAccountId id) const;
+    size_t getAccountCount() const { return accountCount.load(std::memory_order_acquire); }
+};
+
+} // namespace OrderMatchingEngine
+
+#endif // RISK_ENGINE_HPP
\ No newline at end of file
@@ -0,0 +1,103 @@
+#ifndef SEQ_LOCK_HPP
+#define SEQ_LOCK_HPP
+
+#include "RingBuffer.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+namespace OrderMatchingEngine {
+
+/**
+ * @brief Single-writer sequence lock publishing a trivially copyable value
+ *
+ * The writer bumps the sequence to odd, copies the value in, then bumps it to
+ * even again; readers copy the value and retry if the sequence was odd or moved
+ * meanwhile. Readers never block the writer and never write shared memory, so
+ * any number of them can poll without bouncing the writer's cache lines.
+ * The value is stored as relaxed atomic words to keep the racing copy defined.
+ * The lock occupies whole cache lines, so readers polling it never share a
+ * line with whatever the writer keeps next to it.
+ */
+template<typename T>
+class alignas(CACHE_LINE_SIZE) SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock needs a trivially copyable value");
+
+private:
+    static constexpr size_t WORD_COUNT = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+    std::atomic<std::uint64_t> sequence;
+    std::atomic<std::uint64_t> words[WORD_COUNT];
+
+public:
+    SeqLock() : sequence(0) {
+        for (auto& word : words) {
+            word.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    /**
+     * @brief Publish a new value (one writer at a time)
+     */
+    void store(const T& value) {
+        std::uint64_t buffer[WORD_COUNT] = {};
+        std::memcpy(buffer, &value, sizeof(T));
+
+        std::uint64_t current = sequence.load(std::memory_order_relaxed);
+        sequence.store(current + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORD_COUNT; ++i) {
+            words[i].store(buffer[i], std::memory_order_relaxed);
+        }
+        sequence.store(current + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief Copy the latest value without waiting
+     * @return False if a write was in progress; the output is then unspecified
+     */
+    bool tryLoad(T& value) const {
+        std::uint64_t before = sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            return false;
+        }
+        std::uint64_t buffer[WORD_COUNT];
+        for (size_t i = 0; i < WORD_COUNT; ++i) {
+            buffer[i] = words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence.load(std::memory_order_relaxed) != before) {
+            return false;
+        }
+        std::memcpy(&value, buffer, sizeof(T));
+        return true;
+    }
+
+    /**
+     * @brief Copy the latest consistent value, retrying across concurrent writes
+     */
+    T load() const {
+        T value;
+        for (int attempt = 0; !tryLoad(value); ++attempt) {
+            if (attempt >= 64) {
+                std::this_thread::yield(); // Writer was preempted mid-store
+            }
+        }
+        return value;
+    }
+
+    /**
+     * @brief Number of values published so far
+     */
+    std::uint64_t getVersion() const { return sequence.load(std::memory_order_acquire) / 2; }
+};
+
+} // namespace OrderMatchingEngine
+
+#endif // SEQ_LOCK_HPP
\ No newline at end of file
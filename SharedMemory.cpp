@@ -0,0 +1,81 @@
+#include "SharedMemory.hpp"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace OrderMatchingEngine {
+
+SharedMemoryRegion::SharedMemoryRegion() : address(nullptr), size(0), owner(false) {
+}
+
+SharedMemoryRegion::~SharedMemoryRegion() {
+    close();
+}
+
+bool SharedMemoryRegion::create(const std::string& regionName, size_t regionSize) {
+    close();
+    ::shm_unlink(regionName.c_str());   // A previous owner that crashed leaves its region behind
+
+    int descriptor = ::shm_open(regionName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (descriptor < 0) {
+        return false;
+    }
+    if (::ftruncate(descriptor, static_cast<off_t>(regionSize)) != 0) {
+        ::close(descriptor);
+        ::shm_unlink(regionName.c_str());
+        return false;
+    }
+    void* mapping = ::mmap(nullptr, regionSize, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+    ::close(descriptor);
+    if (mapping == MAP_FAILED) {
+        ::shm_unlink(regionName.c_str());
+        return false;
+    }
+
+    name = regionName;
+    address = mapping;
+    size = regionSize;
+    owner = true;
+    return true;
+}
+
+bool SharedMemoryRegion::open(const std::string& regionName) {
+    close();
+    int descriptor = ::shm_open(regionName.c_str(), O_RDWR, 0600);
+    if (descriptor < 0) {
+        return false;
+    }
+    struct stat status;
+    if (::fstat(descriptor, &status) != 0 || status.st_size <= 0) {
+        ::close(descriptor);
+        return false;   // Still being sized by its creator
+    }
+    size_t regionSize = static_cast<size_t>(status.st_size);
+    void* mapping = ::mmap(nullptr, regionSize, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+    ::close(descriptor);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+
+    name = regionName;
+    address = mapping;
+    size = regionSize;
+    owner = false;
+    return true;
+}
+
+void SharedMemoryRegion::close() {
+    if (!address) {
+        return;
+    }
+    ::munmap(address, size);
+    if (owner) {
+        ::shm_unlink(name.c_str());
+    }
+    address = nullptr;
+    size = 0;
+    owner = false;
+}
+
+} // namespace OrderMatchingEngine
\ No newline at end of file
@@ -0,0 +1,166 @@
+#ifndef SHARED_MEMORY_HPP
+#define SHARED_MEMORY_HPP
+
+#include "RingBuffer.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <type_traits>
+
+namespace OrderMatchingEngine {
+
+/**
+ * @brief Named POSIX shared memory mapping shared between processes on one host
+ *
+ * The creating process owns the name and unlinks it when the region is
+ * closed; other processes open it by name and only unmap. A fresh region is
+ * zero-filled, so structures placed in it start from all-zero state.
+ */
+class SharedMemoryRegion {
+private:
+    std::string name;
+    void* address;
+    size_t size;
+    bool owner;
+
+public:
+    SharedMemoryRegion();
+    ~SharedMemoryRegion();
+
+    SharedMemoryRegion(const SharedMemoryRegion&) = delete;
+    SharedMemoryRegion& operator=(const SharedMemoryRegion&) = delete;
+
+    /**
+     * @brief Create the region, replacing any stale one left under the name by a crashed owner
+     * @param name POSIX shared memory name, starting with '/'
+     * @return False if it could not be created or mapped
+     */
+    bool create(const std::string& name, size_t size);
+
+    /**
+     * @brief Map a region created by another process
+     * @return False if it does not exist (yet) or could not be mapped
+     */
+    bool open(const std::string& name);
+
+    void close();
+
+    void* getAddress() const { return address; }
+    size_t getSize() const { return size; }
+    bool isOpen() const { return address != nullptr; }
+    bool isOwner() const { return owner; }
+    const std::string& getName() const { return name; }
+};
+
+/**
+ * @brief Round a byte count up to a whole number of cache lines
+ */
+inline size_t alignToCacheLine(size_t bytes) {
+    return (bytes + CACHE_LINE_SIZE - 1) & ~(CACHE_LINE_SIZE - 1);
+}
+
+/**
+ * @brief Single-producer/single-consumer ring laid out in caller-provided shared memory
+ *
+ * Same protocol as SpscRing, but the indices and slots live in the mapping so
+ * the producer and consumer can be different processes. Each side attaches its
+ * own view; the index each side caches of the other stays in the view, so it
+ * never crosses the process boundary. Elements are copied bytewise, hence the
+ * trivially copyable requirement.
+ */
+template<typename T>
+class SharedSpscRing {
+    static_assert(std::is_trivially_copyable<T>::value, "Shared rings carry trivially copyable values");
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "Shared rings need lock-free 64-bit atomics");
+
+private:
+    struct Header {
+        std::uint64_t capacity;
+        alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> head;     // Next slot to read (consumer)
+        alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> tail;     // Next slot to write (producer)
+    };
+
+    Header* header;
+    T* slots;
+    std::uint64_t mask;
+    std::uint64_t cachedHead;   // Producer's view of head
+    std::uint64_t cachedTail;   // Consumer's view of tail
+
+public:
+    SharedSpscRing() : header(nullptr), slots(nullptr), mask(0), cachedHead(0), cachedTail(0) {}
+
+    /**
+     * @brief Bytes of shared memory a ring of this capacity needs (capacity rounded up to a power of two)
+     */
+    static size_t bytesFor(size_t capacity) {
+        return alignToCacheLine(sizeof(Header)) + alignToCacheLine(roundUpToPowerOfTwo(capacity) * sizeof(T));
+    }
+
+    /**
+     * @brief Lay out a new, empty ring (creating side, before the other side attaches)
+     */
+    void initialize(void* memory, size_t capacity) {
+        header = new (memory) Header();
+        header->capacity = roundUpToPowerOfTwo(capacity);
+        header->head.store(0, std::memory_order_relaxed);
+        header->tail.store(0, std::memory_order_release);
+        attach(memory);
+    }
+
+    /**
+     * @brief Use a ring another process initialized
+     */
+    void attach(void* memory) {
+        header = static_cast<Header*>(memory);
+        slots = reinterpret_cast<T*>(static_cast<char*>(memory) + alignToCacheLine(sizeof(Header)));
+        mask = header->capacity - 1;
+        cachedHead = header->head.load(std::memory_order_acquire);
+        cachedTail = header->tail.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Append an element (producer only)
+     * @return False if the ring is full
+     */
+    bool tryPush(const T& value) {
+        std::uint64_t currentTail = header->tail.load(std::memory_order_relaxed);
+        if (currentTail - cachedHead > mask) {
+            cachedHead = header->head.load(std::memory_order_acquire);
+            if (currentTail - cachedHead > mask) {
+                return false;
+            }
+        }
+        slots[currentTail & mask] = value;
+        header->tail.store(currentTail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Remove the oldest element (consumer only)
+     * @return False if the ring is empty
+     */
+    bool tryPop(T& out) {
+        std::uint64_t currentHead = header->head.load(std::memory_order_relaxed);
+        if (currentHead == cachedTail) {
+            cachedTail = header->tail.load(std::memory_order_acquire);
+            if (currentHead == cachedTail) {
+                return false;
+            }
+        }
+        out = slots[currentHead & mask];
+        header->head.store(currentHead + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t capacity() const { return static_cast<size_t>(mask + 1); }
+    size_t sizeApprox() const {
+        return static_cast<size_t>(header->tail.load(std::memory_order_relaxed) -
+                                   header->head.load(std::memory_order_relaxed));
+    }
+};
+
+} // namespace OrderMatchingEngine
+
+#endif // SHARED_MEMORY_HPP
\ No newline at end of file
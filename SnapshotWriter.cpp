@@ -0,0 +1,89 @@
+#include "SnapshotWriter.hpp"
+#include <chrono>
+
+namespace OrderMatchingEngine {
+
+SnapshotWriter::SnapshotWriter(size_t queueCapacity, int idleSleepMicros)
+    : queue(queueCapacity), idleSleepMicros(idleSleepMicros), running(false),
+      roundsWritten(0), roundsFailed(0), bytesWritten(0) {
+}
+
+SnapshotWriter::~SnapshotWriter() {
+    stop();
+}
+
+void SnapshotWriter::start() {
+    std::unique_lock<std::shared_mutex> lifecycle(lifecycleMutex);
+    if (running.exchange(true)) {
+        return;
+    }
+    thread = std::thread(&SnapshotWriter::run, this);
+}
+
+void SnapshotWriter::stop() {
+    {
+        // Waits out submits already past their running check; later ones are turned away
+        std::unique_lock<std::shared_mutex> lifecycle(lifecycleMutex);
+        if (!running.exchange(false)) {
+            return;
+        }
+    }
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+bool SnapshotWriter::submit(SnapshotRound& round) {
+    std::shared_lock<std::shared_mutex> lifecycle(lifecycleMutex);
+    if (!running.load(std::memory_order_relaxed)) {
+        return false;
+    }
+    round.inFlight.store(true, std::memory_order_relaxed);
+    if (!queue.tryPush(&round)) {
+        // Never queued, so nothing else would ever clear it
+        round.inFlight.store(false, std::memory_order_release);
+        return false;
+    }
+    return true;
+}
+
+void SnapshotWriter::run() {
+    SnapshotRound* round = nullptr;
+    while (true) {
+        if (queue.tryPop(round)) {
+            write(*round);
+            continue;
+        }
+        if (!running.load(std::memory_order_acquire)) {
+            // A round pushed just before stop() flipped running is only certain to be
+            // visible now, so drain once more: every accepted round gets written
+            while (queue.tryPop(round)) {
+                write(*round);
+            }
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(idleSleepMicros));
+    }
+}
+
+void SnapshotWriter::write(SnapshotRound& round) {
+    bool complete = true;
+    for (size_t i = 0; i < round.images.size(); ++i) {
+        round.images[i].encode(image);
+        if (SnapshotStore::writeFile(round.paths[i], image)) {
+            bytesWritten.fetch_add(static_cast<long long>(image.size()), std::memory_order_relaxed);
+        } else {
+            complete = false;
+        }
+    }
+
+    // Everything in the previous segment is now covered by a durable snapshot
+    if (complete && round.log) {
+        round.log->releasePreviousSegment();
+    }
+    (complete ? roundsWritten : roundsFailed).fetch_add(1, std::memory_order_relaxed);
+    round.lastSucceeded.store(complete, std::memory_order_relaxed);
+    round.inFlight.store(false, std::memory_order_release);
+}
+
+} // namespace OrderMatchingEngine
\ No newline at end of file
@@ -0,0 +1,95 @@
+#ifndef SNAPSHOT_WRITER_HPP
+#define SNAPSHOT_WRITER_HPP
+
+#include "EventLog.hpp"
+#include "OrderBook.hpp"
+#include "RingBuffer.hpp"
+#include <atomic>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace OrderMatchingEngine {
+
+/**
+ * @brief Book images captured together at one sequence point, written as a unit
+ *
+ * The owner fills images and paths only while isInFlight() is false, then
+ * hands the round to a SnapshotWriter; from then until the writer clears the
+ * flag the round belongs to the writer thread.
+ */
+struct SnapshotRound {
+    std::vector<BookImage> images;
+    std::vector<const OrderBook*> sources;  // Book each image was captured from, to detect reuse for another
+    std::vector<std::string> paths;         // Snapshot file of each image
+    WriteAheadLog* log;                     // Previous segment released once every image is durable (optional)
+
+    std::atomic<bool> inFlight;
+    std::atomic<bool> lastSucceeded;
+
+    SnapshotRound() : log(nullptr), inFlight(false), lastSucceeded(true) {}
+
+    SnapshotRound(const SnapshotRound&) = delete;
+    SnapshotRound& operator=(const SnapshotRound&) = delete;
+
+    bool isInFlight() const { return inFlight.load(std::memory_order_acquire); }
+};
+
+/**
+ * @brief Background thread that encodes and durably writes snapshot rounds
+ *
+ * Snapshots used to be encoded and fsynced on the matching thread, which
+ * stalled it for as long as the largest book took to reach the disk. Now the
+ * matching thread only copies its books into a round (OrderBook::captureSnapshot)
+ * and submits it; encoding, checksumming, writing and fsyncing happen here.
+ * One writer serves any number of shards, in submission order.
+ */
+class SnapshotWriter {
+private:
+    MpscRing<SnapshotRound*> queue;
+    int idleSleepMicros;
+    std::string image;                      // Encoding buffer, reused
+
+    std::thread thread;
+    std::atomic<bool> running;
+    // Held shared by submit() from its running check through its push, and exclusively
+    // by start() and stop() around flipping running: an accepted round is always in the
+    // queue before the thread's final drain, so its inFlight flag is always cleared
+    std::shared_mutex lifecycleMutex;
+    std::atomic<long long> roundsWritten;
+    std::atomic<long long> roundsFailed;
+    std::atomic<long long> bytesWritten;
+
+    void run();
+    void write(SnapshotRound& round);
+
+public:
+    explicit SnapshotWriter(size_t queueCapacity = 256, int idleSleepMicros = 1000);
+    ~SnapshotWriter();
+
+    SnapshotWriter(const SnapshotWriter&) = delete;
+    SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+
+    void start();
+
+    /**
+     * @brief Write every round already submitted, then stop the thread
+     */
+    void stop();
+
+    /**
+     * @brief Queue a filled round (any thread, never blocks)
+     * @return False if the writer is stopped or its queue is full; the round stays with the caller
+     */
+    bool submit(SnapshotRound& round);
+
+    bool isRunning() const { return running.load(std::memory_order_relaxed); }
+    long long getRoundsWritten() const { return roundsWritten.load(std::memory_order_relaxed); }
+    long long getRoundsFailed() const { return roundsFailed.load(std::memory_order_relaxed); }
+    long long getBytesWritten() const { return bytesWritten.load(std::memory_order_relaxed); }
+};
+
+} // namespace OrderMatchingEngine
+
+#endif // SNAPSHOT_WRITER_HPP
\ No newline at end of file
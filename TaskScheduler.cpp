@@ -0,0 +1,313 @@
+#include "TaskScheduler.hpp"
+#include <limits>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace OrderMatchingEngine {
+
+namespace {
+
+const size_t NOT_A_WORKER = std::numeric_limits<size_t>::max();
+
+// Lets a task's submissions and waits use its own worker's queues
+thread_local const TaskScheduler* currentScheduler = nullptr;
+thread_local size_t currentWorker = NOT_A_WORKER;
+
+} // namespace
+
+TaskScheduler::TaskScheduler(const SchedulerConfig& config)
+    : config(config), nextWorker(0), queuedTasks(0), running(false), nextPeriodicId(1),
+      tasksExecuted(0), tasksStolen(0), tasksFailed(0) {
+}
+
+TaskScheduler::~TaskScheduler() {
+    stop();
+}
+
+std::vector<int> TaskScheduler::getUsableCores(const SchedulerConfig& config) {
+    std::vector<int> cores = config.cores;
+    if (cores.empty()) {
+        unsigned online = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned core = 0; core < online; ++core) {
+            cores.push_back(static_cast<int>(core));
+        }
+    }
+    cores.erase(std::remove_if(cores.begin(), cores.end(), [&](int core) {
+                    return std::find(config.reservedCores.begin(), config.reservedCores.end(), core) !=
+                           config.reservedCores.end();
+                }),
+                cores.end());
+    return cores;
+}
+
+bool TaskScheduler::start() {
+    std::unique_lock<std::shared_mutex> lifecycle(lifecycleMutex);
+    if (running.load()) {
+        return true;
+    }
+    usableCores = getUsableCores(config);
+    if (usableCores.empty()) {
+        return false;
+    }
+
+    // Every queue exists before any worker can steal from it
+    size_t count = config.threadCount > 0 ? static_cast<size_t>(config.threadCount) : usableCores.size();
+    for (size_t i = 0; i < count; ++i) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+    running.store(true);
+    for (size_t i = 0; i < count; ++i) {
+        workers[i]->thread = std::thread(&TaskScheduler::run, this, i);
+    }
+    return true;
+}
+
+void TaskScheduler::stop() {
+    {
+        // Waits out submits already past their running check; later ones are turned away
+        std::unique_lock<std::shared_mutex> lifecycle(lifecycleMutex);
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        if (!running.load()) {
+            return;
+        }
+        running.store(false);
+    }
+    // Not held while joining: tasks still draining may submit, and are turned away too
+    wake.notify_all();
+    for (auto& worker : workers) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+    std::unique_lock<std::shared_mutex> lifecycle(lifecycleMutex);
+    workers.clear();
+}
+
+bool TaskScheduler::submit(Task task, TaskPriority priority) {
+    std::shared_lock<std::shared_mutex> lifecycle(lifecycleMutex);
+    if (!running.load(std::memory_order_relaxed)) {
+        return false;
+    }
+    push(std::move(task), priority);
+    return true;
+}
+
+void TaskScheduler::submit(TaskGroup& group, Task task, TaskPriority priority) {
+    group.pending.fetch_add(1, std::memory_order_relaxed);
+    Task member = [&group, task = std::move(task)]() {
+        try {
+            task();
+        } catch (...) {
+            group.pending.fetch_sub(1, std::memory_order_release);
+            throw;
+        }
+        group.pending.fetch_sub(1, std::memory_order_release);
+    };
+    {
+        std::shared_lock<std::shared_mutex> lifecycle(lifecycleMutex);
+        if (running.load(std::memory_order_relaxed)) {
+            push(std::move(member), priority);
+            return;
+        }
+    }
+    execute(member);
+}
+
+void TaskScheduler::wait(TaskGroup& group) {
+    size_t index = currentScheduler == this ? currentWorker : NOT_A_WORKER;
+    while (!group.isDone()) {
+        // Help instead of blocking: the group's own tasks may be queued behind this thread.
+        // The queues are only walked under the lock, as stop() may be tearing them down,
+        // and the task runs after it is released, so it can submit in turn.
+        Task task;
+        bool taken;
+        {
+            std::shared_lock<std::shared_mutex> lifecycle(lifecycleMutex);
+            taken = takeTask(index, task);
+        }
+        if (taken) {
+            execute(task);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void TaskScheduler::push(Task task, TaskPriority priority) {
+    size_t index = currentScheduler == this
+        ? currentWorker
+        : nextWorker.fetch_add(1, std::memory_order_relaxed) % workers.size();
+    {
+        std::lock_guard<std::mutex> lock(workers[index]->mutex);
+        workers[index]->queues[static_cast<int>(priority)].push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        queuedTasks.fetch_add(1, std::memory_order_relaxed);
+    }
+    wake.notify_one();
+}
+
+std::uint64_t TaskScheduler::schedulePeriodic(std::chrono::milliseconds interval, Task task,
+                                              TaskPriority priority) {
+    std::uint64_t id;
+    {
+        std::lock_guard<std::mutex> lock(timerMutex);
+        id = nextPeriodicId++;
+        PeriodicTask periodic;
+        periodic.id = id;
+        periodic.interval = std::max(interval, std::chrono::milliseconds(1));
+        periodic.nextRun = std::chrono::steady_clock::now() + periodic.interval;
+        periodic.priority = priority;
+        periodic.task = std::make_shared<Task>(std::move(task));
+        periodic.queued = std::make_shared<std::atomic<bool>>(false);
+        periodicTasks.push_back(std::move(periodic));
+    }
+    // Sleeping workers recompute when they next have to wake up
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+    }
+    wake.notify_all();
+    return id;
+}
+
+bool TaskScheduler::cancelPeriodic(std::uint64_t id) {
+    std::lock_guard<std::mutex> lock(timerMutex);
+    auto it = std::find_if(periodicTasks.begin(), periodicTasks.end(),
+                           [id](const PeriodicTask& periodic) { return periodic.id == id; });
+    if (it == periodicTasks.end()) {
+        return false;
+    }
+    periodicTasks.erase(it);
+    return true;
+}
+
+bool TaskScheduler::queueDuePeriodicTasks(std::chrono::steady_clock::time_point& nextDue) {
+    std::lock_guard<std::mutex> lock(timerMutex);
+    auto now = std::chrono::steady_clock::now();
+    bool queued = false;
+    for (PeriodicTask& periodic : periodicTasks) {
+        if (periodic.nextRun <= now) {
+            // A slow run is not stacked up behind itself
+            if (!periodic.queued->exchange(true)) {
+                std::shared_ptr<Task> task = periodic.task;
+                std::shared_ptr<std::atomic<bool>> pending = periodic.queued;
+                push([task, pending]() {
+                    pending->store(false);
+                    (*task)();
+                }, periodic.priority);
+                queued = true;
+            }
+            periodic.nextRun += periodic.interval;
+            if (periodic.nextRun <= now) {
+                periodic.nextRun = now + periodic.interval; // Missed runs are skipped, not caught up
+            }
+        }
+        nextDue = std::min(nextDue, periodic.nextRun);
+    }
+    return queued;
+}
+
+bool TaskScheduler::takeTask(size_t index, Task& task) {
+    if (queuedTasks.load(std::memory_order_relaxed) == 0) {
+        return false;
+    }
+
+    // Highest priority first across the pool: own oldest task, else another worker's newest
+    size_t count = workers.size();
+    for (int priority = 0; priority < PRIORITY_COUNT; ++priority) {
+        if (index < count) {
+            Worker& own = *workers[index];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.queues[priority].empty()) {
+                task = std::move(own.queues[priority].front());
+                own.queues[priority].pop_front();
+                queuedTasks.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        for (size_t offset = 1; offset <= count; ++offset) {
+            size_t victim = (index < count ? index + offset : offset) % count;
+            if (victim == index) {
+                continue;
+            }
+            Worker& other = *workers[victim];
+            std::lock_guard<std::mutex> lock(other.mutex);
+            if (!other.queues[priority].empty()) {
+                task = std::move(other.queues[priority].back());
+                other.queues[priority].pop_back();
+                queuedTasks.fetch_sub(1, std::memory_order_relaxed);
+                tasksStolen.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool TaskScheduler::runOne(size_t index) {
+    Task task;
+    if (!takeTask(index, task)) {
+        return false;
+    }
+    execute(task);
+    return true;
+}
+
+void TaskScheduler::execute(Task& task) {
+    try {
+        task();
+    } catch (...) {
+        tasksFailed.fetch_add(1, std::memory_order_relaxed);
+    }
+    tasksExecuted.fetch_add(1, std::memory_order_relaxed);
+}
+
+void TaskScheduler::pinToCores() {
+#ifdef __linux__
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    for (int core : usableCores) {
+        CPU_SET(core, &cpuSet);
+    }
+    pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+#endif
+}
+
+void TaskScheduler::run(size_t index) {
+    currentScheduler = this;
+    currentWorker = index;
+    pinToCores();
+
+    while (true) {
+        if (runOne(index)) {
+            continue;
+        }
+        // Runs queued here after stop() are still drained: this worker pushed them and checks again below
+        auto nextDue = std::chrono::steady_clock::time_point::max();
+        if (running.load(std::memory_order_relaxed) && queueDuePeriodicTasks(nextDue)) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        if (queuedTasks.load(std::memory_order_relaxed) > 0) {
+            continue;
+        }
+        if (!running.load(std::memory_order_relaxed)) {
+            break; // Queues drained after stop()
+        }
+        if (nextDue == std::chrono::steady_clock::time_point::max()) {
+            wake.wait(lock);
+        } else {
+            wake.wait_until(lock, nextDue);
+        }
+    }
+
+    currentScheduler = nullptr;
+    currentWorker = NOT_A_WORKER;
+}
+
+} // namespace OrderMatchingEngine
\ No newline at end of file
@@ -0,0 +1,203 @@
+#ifndef TASK_SCHEDULER_HPP
+#define TASK_SCHEDULER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+namespace OrderMatchingEngine {
+
+/**
+ * @brief Order in which queued background work runs; HIGH work anywhere in the pool goes first
+ */
+enum class TaskPriority : std::uint8_t {
+    HIGH = 0,       // Someone waits for it: a report, an on-demand statistics query
+    NORMAL,         // Parallel analytics
+    LOW             // Housekeeping: flushing, rotation, archiving, session cleanup
+};
+
+/**
+ * @brief Engine-wide work-stealing pool for everything that is not matching
+ *
+ * Each worker has one queue per priority. Tasks submitted from a worker go to
+ * its own queue, others are dealt round-robin; an idle worker takes the oldest
+ * task of its own queues, or steals the newest of another worker's, highest
+ * priority first. Workers are confined to the configured cores minus the
+ * reserved ones, so giving the matching shards' cores as reserved keeps
+ * logging, analytics and cleanup from ever preempting a matching thread.
+ *
+ * Periodic tasks replace per-component housekeeping threads: each run is
+ * queued like any other task when it falls due. A task that throws is counted
+ * and dropped; the worker carries on.
+ */
+class TaskScheduler {
+public:
+    using Task = std::function<void()>;
+
+    struct SchedulerConfig {
+        int threadCount;                    // Workers (0: one per usable core)
+        std::vector<int> cores;             // Cores the workers may run on (empty: every online core)
+        std::vector<int> reservedCores;     // Never used, e.g. the cores the matching shards are pinned to
+
+        SchedulerConfig() : threadCount(0) {}
+    };
+
+    /**
+     * @brief Tasks submitted together, to be waited for as one
+     */
+    class TaskGroup {
+    private:
+        friend class TaskScheduler;
+        std::atomic<size_t> pending;
+
+    public:
+        TaskGroup() : pending(0) {}
+        TaskGroup(const TaskGroup&) = delete;
+        TaskGroup& operator=(const TaskGroup&) = delete;
+
+        bool isDone() const { return pending.load(std::memory_order_acquire) == 0; }
+    };
+
+private:
+    static constexpr int PRIORITY_COUNT = 3;
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> queues[PRIORITY_COUNT];
+        std::thread thread;
+    };
+
+    struct PeriodicTask {
+        std::uint64_t id;
+        std::chrono::steady_clock::duration interval;
+        std::chrono::steady_clock::time_point nextRun;
+        TaskPriority priority;
+        std::shared_ptr<Task> task;         // Shared with the queued run, which may outlive a cancel
+        std::shared_ptr<std::atomic<bool>> queued;  // A run is queued and has not started yet
+    };
+
+    SchedulerConfig config;
+    std::vector<int> usableCores;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<size_t> nextWorker;
+
+    // Held shared by submits from their running check through their push and by wait()
+    // while it looks for a task, and exclusively by start() and stop() around changing
+    // running or the workers: a submit either lands in a queue stop() will drain or sees
+    // the scheduler stopped, and nothing walks a worker that is being torn down
+    std::shared_mutex lifecycleMutex;
+
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    std::atomic<size_t> queuedTasks;
+    std::atomic<bool> running;
+
+    std::mutex timerMutex;
+    std::vector<PeriodicTask> periodicTasks;
+    std::uint64_t nextPeriodicId;
+
+    std::atomic<long long> tasksExecuted;
+    std::atomic<long long> tasksStolen;
+    std::atomic<long long> tasksFailed;
+
+    void run(size_t index);
+    bool runOne(size_t index);
+    bool takeTask(size_t index, Task& task);
+    void execute(Task& task);
+    void push(Task task, TaskPriority priority);
+    bool queueDuePeriodicTasks(std::chrono::steady_clock::time_point& nextDue);
+    void pinToCores();
+
+public:
+    explicit TaskScheduler(const SchedulerConfig& config = SchedulerConfig());
+    ~TaskScheduler();
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    /**
+     * @brief Start the workers on the usable cores
+     * @return False if the reservations leave no core to run on
+     */
+    bool start();
+
+    /**
+     * @brief Run every task already queued, then stop the workers
+     * Stop whatever submits to the pool first. Periodic tasks stay registered
+     * and resume on the next start().
+     */
+    void stop();
+
+    /**
+     * @brief Queue a task (any thread)
+     * @return False if the scheduler is not running or is stopping; the task is not run
+     */
+    bool submit(Task task, TaskPriority priority = TaskPriority::NORMAL);
+
+    /**
+     * @brief Queue a task as part of a group; runs it on the calling thread if the scheduler is stopped
+     *        or stopping
+     */
+    void submit(TaskGroup& group, Task task, TaskPriority priority = TaskPriority::NORMAL);
+
+    /**
+     * @brief Wait until every task of the group has run, running queued tasks meanwhile
+     */
+    void wait(TaskGroup& group);
+
+    /**
+     * @brief Run body(first, last) over [begin, end) in chunks of grain across the pool and wait
+     * The calling thread takes part, so this may be called from inside a task.
+     */
+    template<typename Body>
+    void parallelFor(size_t begin, size_t end, size_t grain, Body&& body,
+                     TaskPriority priority = TaskPriority::NORMAL) {
+        TaskGroup group;
+        grain = std::max<size_t>(grain, 1);
+        for (size_t first = begin; first < end; first += grain) {
+            size_t last = std::min(end, first + grain);
+            submit(group, [&body, first, last]() { body(first, last); }, priority);
+        }
+        wait(group);
+    }
+
+    /**
+     * @brief Queue task every interval, the first run one interval from now
+     * A run is not queued again until the previous one has started.
+     * @return ID for cancelPeriodic()
+     */
+    std::uint64_t schedulePeriodic(std::chrono::milliseconds interval, Task task,
+                                   TaskPriority priority = TaskPriority::LOW);
+
+    /**
+     * @brief Stop queuing a periodic task; a run already queued still happens
+     * @return False if the ID is unknown
+     */
+    bool cancelPeriodic(std::uint64_t id);
+
+    /**
+     * @brief The configured cores, or every online core, minus the reserved ones
+     */
+    static std::vector<int> getUsableCores(const SchedulerConfig& config);
+
+    bool isRunning() const { return running.load(std::memory_order_relaxed); }
+    size_t getThreadCount() const { return workers.size(); }
+    const std::vector<int>& getWorkerCores() const { return usableCores; }    // Valid after start()
+    size_t getQueuedTasks() const { return queuedTasks.load(std::memory_order_relaxed); }
+    long long getTasksExecuted() const { return tasksExecuted.load(std::memory_order_relaxed); }
+    long long getTasksStolen() const { return tasksStolen.load(std::memory_order_relaxed); }
+    long long getTasksFailed() const { return tasksFailed.load(std::memory_order_relaxed); }
+};
+
+} // namespace OrderMatchingEngine
+
+#endif // TASK_SCHEDULER_HPP
\ No newline at end of file
@@ -0,0 +1,147 @@
+#include "TimerWheel.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace OrderMatchingEngine {
+
+TimerWheel::TimerWheel(long long resolutionMicros, long long startMicros)
+    : resolutionMicros(resolutionMicros), currentTick(0), freeHead(NO_TIMER), activeCount(0) {
+    if (resolutionMicros <= 0) {
+        throw std::invalid_argument("Timer resolution must be positive");
+    }
+    currentTick = toTick(startMicros);
+    std::fill(slots, slots + OVERFLOW_SLOT + 1, NO_TIMER);
+    std::fill(occupied, occupied + LEVEL_COUNT, 0);
+}
+
+TimerId TimerWheel::schedule(long long expiryMicros, std::uint64_t payload) {
+    std::uint32_t index;
+    if (freeHead != NO_TIMER) {
+        index = freeHead;
+        freeHead = timers[index].next;
+    } else {
+        index = static_cast<std::uint32_t>(timers.size());
+        timers.push_back(Timer{0, 0, NO_TIMER, NO_TIMER, NO_TIMER, 0});
+    }
+
+    Timer& timer = timers[index];
+    // Round up so a timer never fires before its deadline
+    timer.expiryTick = expiryMicros <= 0 ? 0
+        : static_cast<std::uint64_t>((expiryMicros + resolutionMicros - 1) / resolutionMicros);
+    timer.payload = payload;
+    place(index, currentTick + 1);  // The current tick's slot has already fired
+    activeCount++;
+
+    return (static_cast<TimerId>(timer.generation) << 32) | (index + 1);
+}
+
+bool TimerWheel::cancel(TimerId id) {
+    if (id == NULL_TIMER_ID) {
+        return false;
+    }
+    std::uint32_t index = static_cast<std::uint32_t>(id & 0xFFFFFFFFu) - 1;
+    if (index >= timers.size() || timers[index].slot == NO_TIMER ||
+        timers[index].generation != static_cast<std::uint32_t>(id >> 32)) {
+        return false;
+    }
+    unlink(index);
+    release(index);
+    return true;
+}
+
+void TimerWheel::rebase(long long nowMicros) {
+    if (activeCount == 0) {
+        currentTick = toTick(nowMicros);
+    }
+}
+
+void TimerWheel::place(std::uint32_t index, std::uint64_t earliestTick) {
+    Timer& timer = timers[index];
+    std::uint64_t tick = std::max(timer.expiryTick, earliestTick);
+    std::uint64_t delta = tick - currentTick;
+
+    std::uint32_t slot = OVERFLOW_SLOT;
+    for (int level = 0; level < LEVEL_COUNT; ++level) {
+        int shift = LEVEL_BITS * level;
+        if (delta < (std::uint64_t(1) << (shift + LEVEL_BITS))) {
+            std::uint32_t position = static_cast<std::uint32_t>((tick >> shift) & SLOT_MASK);
+            slot = level * SLOTS_PER_LEVEL + position;
+            occupied[level] |= std::uint64_t(1) << position;
+            break;
+        }
+    }
+
+    // Push at the head; a slot holds timers of one tick at level 0, so order within it is free
+    timer.slot = slot;
+    timer.prev = NO_TIMER;
+    timer.next = slots[slot];
+    if (slots[slot] != NO_TIMER) {
+        timers[slots[slot]].prev = index;
+    }
+    slots[slot] = index;
+}
+
+void TimerWheel::unlink(std::uint32_t index) {
+    Timer& timer = timers[index];
+    if (timer.prev != NO_TIMER) {
+        timers[timer.prev].next = timer.next;
+    } else {
+        slots[timer.slot] = timer.next;
+    }
+    if (timer.next != NO_TIMER) {
+        timers[timer.next].prev = timer.prev;
+    }
+    if (slots[timer.slot] == NO_TIMER && timer.slot != OVERFLOW_SLOT) {
+        occupied[timer.slot / SLOTS_PER_LEVEL] &= ~(std::uint64_t(1) << (timer.slot & SLOT_MASK));
+    }
+}
+
+void TimerWheel::release(std::uint32_t index) {
+    Timer& timer = timers[index];
+    timer.slot = NO_TIMER;
+    timer.generation++;
+    timer.next = freeHead;
+    freeHead = index;
+    activeCount--;
+}
+
+void TimerWheel::cascade(std::uint32_t slot) {
+    std::uint32_t index = slots[slot];
+    if (index == NO_TIMER) {
+        return;
+    }
+    slots[slot] = NO_TIMER;
+    if (slot != OVERFLOW_SLOT) {
+        occupied[slot / SLOTS_PER_LEVEL] &= ~(std::uint64_t(1) << (slot & SLOT_MASK));
+    }
+
+    // Timers due at the current tick land in its level-0 slot, which fires next
+    while (index != NO_TIMER) {
+        std::uint32_t next = timers[index].next;
+        place(index, currentTick);
+        index = next;
+    }
+}
+
+std::uint64_t TimerWheel::nextEventTick() const {
+    // The earliest occupied slot of each level: a firing at level 0, a cascade above it
+    std::uint64_t next = ~std::uint64_t(0);
+    for (int level = 0; level < LEVEL_COUNT; ++level) {
+        if (occupied[level] == 0) {
+            continue;
+        }
+        int shift = LEVEL_BITS * level;
+        std::uint64_t position = (currentTick >> shift) + 1;
+        unsigned offset = static_cast<unsigned>(position & SLOT_MASK);
+        std::uint64_t ahead = offset == 0 ? occupied[level]
+            : (occupied[level] >> offset) | (occupied[level] << (SLOTS_PER_LEVEL - offset));
+        next = std::min(next, (position + static_cast<std::uint64_t>(__builtin_ctzll(ahead))) << shift);
+    }
+    if (slots[OVERFLOW_SLOT] != NO_TIMER) {
+        int shift = LEVEL_BITS * LEVEL_COUNT;
+        next = std::min(next, ((currentTick >> shift) + 1) << shift);
+    }
+    return next;
+}
+
+} // namespace OrderMatchingEngine
\ No newline at end of file
@@ -0,0 +1,144 @@
+#ifndef TIMER_WHEEL_HPP
+#define TIMER_WHEEL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace OrderMatchingEngine {
+
+/**
+ * @brief Handle of a scheduled timer; 0 is never handed out
+ * Handles of fired or cancelled timers go stale and are ignored by cancel().
+ */
+using TimerId = std::uint64_t;
+constexpr TimerId NULL_TIMER_ID = 0;
+
+/**
+ * @brief Hierarchical timing wheel for large numbers of deadlines
+ *
+ * LEVEL_COUNT wheels of 64 slots each cover ticks at 1, 64, 64^2... times the
+ * resolution; a timer sits in the coarsest slot that resolves its deadline and
+ * is cascaded one level down as the wheel turns. Scheduling and cancelling are
+ * O(1) through intrusive lists in a pooled timer array, and advancing costs
+ * O(1) per expired timer plus a bit scan per level between events, so time
+ * with nothing due is skipped instead of walked tick by tick. Deadlines past
+ * the last level wait in an overflow list that is re-placed when the top
+ * level wraps.
+ *
+ * Not thread-safe: each wheel belongs to one thread, like the book it serves.
+ */
+class TimerWheel {
+public:
+    static constexpr int LEVEL_BITS = 6;
+    static constexpr int LEVEL_COUNT = 6;
+
+private:
+    static constexpr std::uint32_t SLOTS_PER_LEVEL = std::uint32_t(1) << LEVEL_BITS;
+    static constexpr std::uint32_t SLOT_MASK = SLOTS_PER_LEVEL - 1;
+    static constexpr std::uint32_t OVERFLOW_SLOT = LEVEL_COUNT * SLOTS_PER_LEVEL;
+    static constexpr std::uint32_t NO_TIMER = 0xFFFFFFFFu;
+
+    struct Timer {
+        std::uint64_t expiryTick;
+        std::uint64_t payload;
+        std::uint32_t prev;
+        std::uint32_t next;         // Also links the free list
+        std::uint32_t slot;         // NO_TIMER while free
+        std::uint32_t generation;   // Bumped on release so old handles go stale
+    };
+
+    long long resolutionMicros;
+    std::uint64_t currentTick;
+    std::vector<Timer> timers;
+    std::uint32_t freeHead;
+    size_t activeCount;
+    std::uint32_t slots[OVERFLOW_SLOT + 1];     // List heads; the last one is the overflow list
+    std::uint64_t occupied[LEVEL_COUNT];        // Bit s set when slot s of a level is non-empty
+
+    void place(std::uint32_t index, std::uint64_t earliestTick);
+    void unlink(std::uint32_t index);
+    void release(std::uint32_t index);
+    void cascade(std::uint32_t slot);
+    std::uint64_t nextEventTick() const;
+    std::uint64_t toTick(long long micros) const {
+        return micros <= 0 ? 0 : static_cast<std::uint64_t>(micros / resolutionMicros);
+    }
+
+public:
+    /**
+     * @brief Constructor
+     * @param resolutionMicros Tick length; timers fire up to one tick after their deadline
+     * @param startMicros Current time
+     */
+    explicit TimerWheel(long long resolutionMicros = 1000, long long startMicros = 0);
+
+    /**
+     * @brief Schedule a timer; a deadline already passed fires on the next advance()
+     * @param payload Returned to the expiry handler
+     */
+    TimerId schedule(long long expiryMicros, std::uint64_t payload);
+
+    /**
+     * @brief Cancel a pending timer
+     * @return False if it already fired, was cancelled, or the handle is stale
+     */
+    bool cancel(TimerId id);
+
+    /**
+     * @brief Move the clock to nowMicros, calling onExpiry(payload) for every timer due by then
+     * Timers fire in deadline order, tick by tick. The handler may schedule and
+     * cancel timers, including ones due in the same advance.
+     * @return Number of timers fired
+     */
+    template<typename Handler>
+    size_t advance(long long nowMicros, Handler&& onExpiry) {
+        std::uint64_t targetTick = toTick(nowMicros);
+        size_t fired = 0;
+        while (currentTick < targetTick) {
+            std::uint64_t tick = activeCount == 0 ? targetTick : nextEventTick();
+            if (tick > targetTick) {
+                currentTick = targetTick;
+                break;
+            }
+            currentTick = tick;
+
+            // Coarser levels first, so cascaded timers can drop all the way to level 0
+            if ((tick & ((std::uint64_t(1) << (LEVEL_BITS * LEVEL_COUNT)) - 1)) == 0) {
+                cascade(OVERFLOW_SLOT);
+            }
+            for (int level = LEVEL_COUNT - 1; level > 0; --level) {
+                int shift = LEVEL_BITS * level;
+                if ((tick & ((std::uint64_t(1) << shift) - 1)) == 0) {
+                    cascade(level * SLOTS_PER_LEVEL + static_cast<std::uint32_t>((tick >> shift) & SLOT_MASK));
+                }
+            }
+
+            std::uint32_t slot = static_cast<std::uint32_t>(tick & SLOT_MASK);
+            while (slots[slot] != NO_TIMER) {
+                std::uint32_t index = slots[slot];
+                std::uint64_t payload = timers[index].payload;
+                unlink(index);
+                release(index);
+                ++fired;
+                onExpiry(payload);
+            }
+        }
+        return fired;
+    }
+
+    /**
+     * @brief Set the clock of an empty wheel, backwards included (no-op if timers are pending)
+     * Lets a wheel follow a replayed or simulated clock between bursts of timers.
+     */
+    void rebase(long long nowMicros);
+
+    size_t size() const { return activeCount; }
+    bool empty() const { return activeCount == 0; }
+    long long getResolution() const { return resolutionMicros; }
+    long long getTime() const { return static_cast<long long>(currentTick) * resolutionMicros; }
+};
+
+} // namespace OrderMatchingEngine
+
+#endif // TIMER_WHEEL_HPP
\ No newline at end of file
@@ -0,0 +1,263 @@
+#include "TradeJournal.hpp"
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace OrderMatchingEngine {
+
+namespace {
+
+const char JOURNAL_MAGIC[8] = {'O', 'M', 'E', 'J', 'R', 'N', 'L', '1'};
+const std::uint32_t JOURNAL_VERSION = 1;
+
+std::atomic<std::uint64_t> nextJournalInstance(1);
+
+/**
+ * @brief A ring the calling thread owns in one journal
+ * Journals are told apart by instance number, which is never reused.
+ */
+struct LocalRing {
+    std::uint64_t instance;
+    void* ring;
+    std::uint32_t producer;
+};
+
+thread_local std::vector<LocalRing> localRings;
+
+bool writeFully(int fd, const void* data, size_t bytes) {
+    const char* cursor = static_cast<const char*>(data);
+    while (bytes > 0) {
+        ssize_t written = ::write(fd, cursor, bytes);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        cursor += written;
+        bytes -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+} // namespace
+
+// JournalRecord implementation
+JournalRecord JournalRecord::fromTrade(const Trade& trade) {
+    JournalRecord record = {};
+    record.timestamp = trade.timestamp;
+    record.id = trade.tradeId;
+    record.buyOrderId = trade.buyOrderId;
+    record.sellOrderId = trade.sellOrderId;
+    record.price = trade.price;
+    record.quantity = trade.quantity;
+    record.symbolIndex = getSymbolIndex(trade.tradeId);
+    record.type = JournalRecordType::TRADE;
+    return record;
+}
+
+JournalRecord JournalRecord::fromOrder(JournalRecordType type, const Order& order) {
+    JournalRecord record = {};
+    record.timestamp = order.getTimestamp();
+    record.id = order.getOrderId();
+    record.price = order.getPrice();
+    record.auxPrice = order.getTriggerPrice();
+    record.quantity = order.getRemainingQuantity();
+    record.symbolIndex = getSymbolIndex(order.getOrderId());
+    record.type = type;
+    record.side = order.getSide();
+    record.orderType = order.getType();
+    return record;
+}
+
+// TradeJournal implementation
+TradeJournal::TradeJournal(const JournalConfig& config)
+    : config(config), instanceId(nextJournalInstance.fetch_add(1)), fileDescriptor(-1),
+      producerCount(0), running(false),
+      recordsWritten(0), recordsDropped(0), writeCalls(0) {
+    for (auto& ring : rings) {
+        ring.store(nullptr, std::memory_order_relaxed);
+    }
+    writeBuffer.resize(config.batchRecords > 0 ? config.batchRecords : 1);
+}
+
+TradeJournal::~TradeJournal() {
+    stop();
+}
+
+bool TradeJournal::start() {
+    if (running.load()) {
+        return true;
+    }
+
+    fileDescriptor = ::open(config.path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fileDescriptor < 0) {
+        return false;
+    }
+
+    // A new file gets a header; an existing journal is appended to
+    if (::lseek(fileDescriptor, 0, SEEK_END) == 0) {
+        JournalFileHeader header;
+        std::memcpy(header.magic, JOURNAL_MAGIC, sizeof(header.magic));
+        header.version = JOURNAL_VERSION;
+        header.recordSize = sizeof(JournalRecord);
+        if (!writeFully(fileDescriptor, &header, sizeof(header))) {
+            ::close(fileDescriptor);
+            fileDescriptor = -1;
+            return false;
+        }
+    }
+
+    running.store(true);
+    drainThread = std::thread(&TradeJournal::drainLoop, this);
+    return true;
+}
+
+void TradeJournal::stop() {
+    if (!running.exchange(false)) {
+        return;
+    }
+    if (drainThread.joinable()) {
+        drainThread.join();
+    }
+
+    // Pick up anything recorded while the drain thread was exiting
+    while (drainOnce() > 0) {
+    }
+    ::fdatasync(fileDescriptor);
+    ::close(fileDescriptor);
+    fileDescriptor = -1;
+}
+
+TradeJournal::RecordRing& TradeJournal::localRing(std::uint32_t& producer) {
+    for (const auto& entry : localRings) {
+        if (entry.instance == instanceId) {
+            producer = entry.producer;
+            return *static_cast<RecordRing*>(entry.ring);
+        }
+    }
+
+    // First write from this thread: give it a ring of its own
+    std::lock_guard<std::mutex> lock(registrationMutex);
+    std::uint32_t index = producerCount.load(std::memory_order_relaxed);
+    if (index >= MAX_PRODUCERS) {
+        throw std::length_error("Too many journal writer threads");
+    }
+    ownedRings.push_back(std::make_unique<RecordRing>(config.ringCapacity));
+    RecordRing* ring = ownedRings.back().get();
+    rings[index].store(ring, std::memory_order_release);
+    producerCount.store(index + 1, std::memory_order_release);
+
+    localRings.push_back({instanceId, ring, index});
+    producer = index;
+    return *ring;
+}
+
+bool TradeJournal::record(const JournalRecord& record) {
+    std::uint32_t producer;
+    RecordRing& ring = localRing(producer);
+
+    JournalRecord stamped = record;
+    stamped.producer = producer;
+    while (!ring.tryPush(stamped)) {
+        if (config.dropWhenFull) {
+            recordsDropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+void TradeJournal::recordTrades(const std::vector<Trade>& trades) {
+    for (const auto& trade : trades) {
+        recordTrade(trade);
+    }
+}
+
+size_t TradeJournal::drainOnce() {
+    size_t buffered = 0;
+    size_t drained = 0;
+    std::uint32_t count = producerCount.load(std::memory_order_acquire);
+
+    for (std::uint32_t i = 0; i < count; ++i) {
+        RecordRing* ring = rings[i].load(std::memory_order_acquire);
+        size_t popped;
+        while ((popped = ring->tryPopBatch(writeBuffer.data() + buffered,
+                                           writeBuffer.size() - buffered)) > 0) {
+            buffered += popped;
+            drained += popped;
+            if (buffered == writeBuffer.size()) {
+                writeRecords(writeBuffer.data(), buffered);
+                buffered = 0;
+            }
+        }
+    }
+
+    if (buffered > 0) {
+        writeRecords(writeBuffer.data(), buffered);
+    }
+    return drained;
+}
+
+void TradeJournal::writeRecords(const JournalRecord* records, size_t count) {
+    if (writeFully(fileDescriptor, records, count * sizeof(JournalRecord))) {
+        recordsWritten.fetch_add(static_cast<long long>(count), std::memory_order_relaxed);
+    } else {
+        recordsDropped.fetch_add(static_cast<long long>(count), std::memory_order_relaxed);
+    }
+    writeCalls.fetch_add(1, std::memory_order_relaxed);
+}
+
+void TradeJournal::drainLoop() {
+    while (running.load(std::memory_order_relaxed)) {
+        if (drainOnce() == 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(config.idleSleepMicros));
+        }
+    }
+}
+
+// JournalReader implementation
+JournalReader::JournalReader() : fileDescriptor(-1), buffer(1024), position(0), available(0) {
+}
+
+JournalReader::~JournalReader() {
+    if (fileDescriptor >= 0) {
+        ::close(fileDescriptor);
+    }
+}
+
+void JournalReader::open(const std::string& path) {
+    fileDescriptor = ::open(path.c_str(), O_RDONLY);
+    if (fileDescriptor < 0) {
+        throw std::runtime_error("Cannot open journal " + path);
+    }
+
+    JournalFileHeader header;
+    if (::read(fileDescriptor, &header, sizeof(header)) != static_cast<ssize_t>(sizeof(header)) ||
+        std::memcmp(header.magic, JOURNAL_MAGIC, sizeof(header.magic)) != 0 ||
+        header.recordSize != sizeof(JournalRecord)) {
+        throw std::runtime_error("Not a trade journal: " + path);
+    }
+}
+
+bool JournalReader::next(JournalRecord& record) {
+    if (position == available) {
+        ssize_t bytes = ::read(fileDescriptor, buffer.data(), buffer.size() * sizeof(JournalRecord));
+        if (bytes <= 0) {
+            return false;
+        }
+        position = 0;
+        available = static_cast<size_t>(bytes) / sizeof(JournalRecord); // A torn tail record is ignored
+        if (available == 0) {
+            return false;
+        }
+    }
+    record = buffer[position++];
+    return true;
+}
+
+} // namespace OrderMatchingEngine
\ No newline at end of file
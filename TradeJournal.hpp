@@ -0,0 +1,185 @@
+#ifndef TRADE_JOURNAL_HPP
+#define TRADE_JOURNAL_HPP
+
+#include "OrderBook.hpp"
+#include "RingBuffer.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace OrderMatchingEngine {
+
+/**
+ * @brief Kind of event stored in a journal record
+ */
+enum class JournalRecordType : std::uint8_t {
+    TRADE = 1,
+    ORDER_SUBMITTED,
+    ORDER_CANCELLED,
+    ORDER_MODIFIED,
+    ORDER_FILLED,
+    ORDER_REJECTED
+};
+
+/**
+ * @brief Fixed-size binary journal record, written to disk as-is
+ *
+ * Field use by type:
+ * - TRADE: id = trade ID, buyOrderId/sellOrderId, price, quantity
+ * - ORDER_*: id = order ID, price (new price for ORDER_MODIFIED),
+ *   auxPrice = trigger price, quantity (filled quantity for ORDER_FILLED)
+ * Prices are ticks of the symbol's PriceScale.
+ */
+struct JournalRecord {
+    long long timestamp;            // Microseconds since epoch
+    std::uint64_t id;
+    std::uint64_t buyOrderId;
+    std::uint64_t sellOrderId;
+    Price price;
+    Price auxPrice;
+    std::int32_t quantity;
+    std::uint16_t symbolIndex;
+    JournalRecordType type;
+    OrderSide side;
+    OrderType orderType;
+    std::uint8_t reserved[3];
+    std::uint32_t producer;         // Index of the writer thread's ring
+
+    static JournalRecord fromTrade(const Trade& trade);
+    static JournalRecord fromOrder(JournalRecordType type, const Order& order);
+};
+
+static_assert(sizeof(JournalRecord) == 64, "JournalRecord must stay one cache line");
+
+/**
+ * @brief File header in front of the records
+ */
+struct JournalFileHeader {
+    char magic[8];                  // "OMEJRNL1"
+    std::uint32_t version;
+    std::uint32_t recordSize;
+};
+
+/**
+ * @brief Binary event journal fed through per-thread lock-free rings
+ *
+ * Each writer thread gets its own SPSC ring on first use, so recording an
+ * event is a 64-byte copy with no lock and no formatting. A background
+ * thread drains every ring in batches and appends them to the file with one
+ * write() per batch. Records from different threads are not interleaved in
+ * time order; readers sort by timestamp or sequence if they need to.
+ */
+class TradeJournal {
+public:
+    struct JournalConfig {
+        std::string path;
+        size_t ringCapacity;            // Records buffered per writer thread
+        size_t batchRecords;            // Records per write() call
+        int idleSleepMicros;            // Drain thread back-off when every ring is empty
+        bool dropWhenFull;              // Drop instead of waiting when a ring is full
+
+        JournalConfig() : path("./logs/trades.journal"), ringCapacity(16384),
+                         batchRecords(1024), idleSleepMicros(100), dropWhenFull(false) {}
+    };
+
+    static constexpr size_t MAX_PRODUCERS = 64;
+
+private:
+    using RecordRing = SpscRing<JournalRecord>;
+
+    JournalConfig config;
+    std::uint64_t instanceId;
+    int fileDescriptor;
+
+    std::array<std::atomic<RecordRing*>, MAX_PRODUCERS> rings;
+    std::vector<std::unique_ptr<RecordRing>> ownedRings;
+    std::atomic<std::uint32_t> producerCount;
+    std::mutex registrationMutex;
+
+    std::atomic<bool> running;
+    std::thread drainThread;
+    std::vector<JournalRecord> writeBuffer;
+
+    std::atomic<long long> recordsWritten;
+    std::atomic<long long> recordsDropped;
+    std::atomic<long long> writeCalls;
+
+    RecordRing& localRing(std::uint32_t& producer);
+    void drainLoop();
+    size_t drainOnce();
+    void writeRecords(const JournalRecord* records, size_t count);
+
+public:
+    explicit TradeJournal(const JournalConfig& config = JournalConfig());
+    ~TradeJournal();
+
+    TradeJournal(const TradeJournal&) = delete;
+    TradeJournal& operator=(const TradeJournal&) = delete;
+
+    /**
+     * @brief Open the file and start the drain thread
+     * @return False if the file could not be opened
+     */
+    bool start();
+
+    /**
+     * @brief Drain every ring, sync the file and stop the drain thread
+     */
+    void stop();
+
+    /**
+     * @brief Append a record from the calling thread
+     * @return False if the record was dropped because the ring was full
+     */
+    bool record(const JournalRecord& record);
+
+    void recordTrade(const Trade& trade) { record(JournalRecord::fromTrade(trade)); }
+    void recordTrades(const std::vector<Trade>& trades);
+    void recordOrder(JournalRecordType type, const Order& order) {
+        record(JournalRecord::fromOrder(type, order));
+    }
+
+    bool isRunning() const { return running.load(); }
+    long long getRecordsWritten() const { return recordsWritten.load(); }
+    long long getRecordsDropped() const { return recordsDropped.load(); }
+    long long getWriteCalls() const { return writeCalls.load(); }
+};
+
+/**
+ * @brief Sequential reader for journal files, used by the offline tools
+ */
+class JournalReader {
+private:
+    int fileDescriptor;
+    std::vector<JournalRecord> buffer;
+    size_t position;
+    size_t available;
+
+public:
+    JournalReader();
+    ~JournalReader();
+
+    JournalReader(const JournalReader&) = delete;
+    JournalReader& operator=(const JournalReader&) = delete;
+
+    /**
+     * @brief Open a journal and validate its header
+     * @throws std::runtime_error if the file is missing or not a journal
+     */
+    void open(const std::string& path);
+
+    /**
+     * @brief Read the next record
+     * @return False at end of file
+     */
+    bool next(JournalRecord& record);
+};
+
+} // namespace OrderMatchingEngine
+
+#endif // TRADE_JOURNAL_HPP
\ No newline at end of file
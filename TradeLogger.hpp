@@ -1,7 +1,11 @@
 #ifndef TRADE_LOGGER_HPP
 #define TRADE_LOGGER_HPP
 
+#include "BarAggregator.hpp"
 #include "OrderBook.hpp"
+#include "TradeJournal.hpp"
+#include "TradeStore.hpp"
+#include "TaskScheduler.hpp"
 #include <vector>
 #include <fstream>
 #include <mutex>
@@ -67,18 +71,27 @@ public:
         int maxLogFiles;    // for rotation
         bool autoFlush;
         int flushIntervalSeconds;
+        bool enableBinaryJournal;   // Trade/order events go to a TradeJournal instead of LogEntry
+        std::string journalFile;    // Binary journal, rendered offline with journal_dump
+        std::string tradeStoreDirectory;        // Memory-mapped columnar trade history
+        long long tradeStoreSegmentMinutes;     // Time partition per segment file
 
         LoggerConfig() : logDirectory("./logs"), tradeLogFile("trades.csv"),
                         systemLogFile("system.log"), minLogLevel(LogLevel::INFO),
                         enableConsoleOutput(true), enableFileOutput(true),
                         enableAsyncLogging(true), maxLogFileSize(100),
-                        maxLogFiles(10), autoFlush(true), flushIntervalSeconds(5) {}
+                        maxLogFiles(10), autoFlush(true), flushIntervalSeconds(5),
+                        enableBinaryJournal(false), journalFile("trades.journal"),
+                        tradeStoreDirectory("trades"), tradeStoreSegmentMinutes(60) {}
     } config;
 
     // File streams
     std::unique_ptr<std::ofstream> tradeLogStream;
     std::unique_ptr<std::ofstream> systemLogStream;
 
+    // Binary journal for trade and order events (when enableBinaryJournal is set)
+    std::unique_ptr<TradeJournal> journal;
+
     // Async logging
     std::atomic<bool> running;
     std::thread loggingThread;
@@ -86,15 +99,21 @@ public:
     std::mutex logMutex;
     std::condition_variable logCondition;
 
+    // Background pool for flushing, rotation and archiving (optional): keeps file
+    // maintenance off the logging thread, which then only formats and writes
+    TaskScheduler* scheduler;
+    std::uint64_t flushTask;
+
     // Statistics
     std::atomic<long long> totalTradesLogged;
     std::atomic<long long> totalEventsLogged;
     std::chrono::system_clock::time_point startTime;
 
-    // Trade history for analytics
-    std::vector<Trade> tradeHistory;
-    mutable std::mutex tradeHistoryMutex;
-    int maxTradeHistory;
+    // Trade history for analytics: appended by the logging thread, queried without blocking it
+    std::unique_ptr<TradeStore> tradeStore;
+
+    // Running per-symbol totals and 1s/1m/1d bars, updated as each trade is logged
+    BarAggregator aggregates;
 
     // Performance metrics
     std::atomic<double> averageLoggingLatencyMs;
@@ -125,6 +144,8 @@ public:
     // Core logging methods
     /**
      * @brief Log a trade execution
+     * With the binary journal enabled this only copies a fixed-size record into
+     * the calling thread's ring; no string is built and no lock is taken.
      */
     void logTrade(const Trade& trade);
 
@@ -140,12 +161,12 @@ public:
                   const std::string& message);
 
     /**
-     * @brief Log order events
+     * @brief Log order events (journaled as binary records when enabled)
      */
     void logOrderSubmitted(const OrderPtr& order);
-    void logOrderCancelled(const std::string& orderId, const std::string& reason);
-    void logOrderModified(const std::string& orderId, const std::string& changes);
-    void logOrderFilled(const std::string& orderId, int quantity, double price);
+    void logOrderCancelled(OrderId orderId, const std::string& reason);
+    void logOrderModified(OrderId orderId, const std::string& changes);
+    void logOrderFilled(OrderId orderId, int quantity, double price);
     void logOrderRejected(const OrderPtr& order, const std::string& reason);
 
     /**
@@ -159,7 +180,7 @@ public:
     void logInfo(const std::string& component, const std::string& info);
     void logDebug(const std::string& component, const std::string& debug);
 
-    // Query and analytics methods
+    // Query and analytics methods (served from the trade store, bounded by disk rather than RAM)
     /**
      * @brief Get trade history within date range
      */
@@ -168,17 +189,18 @@ public:
         const std::chrono::system_clock::time_point& end) const;
 
     /**
-     * @brief Get trades for specific symbol
+     * @brief Get trades for specific symbol (uses the store's per-symbol row index)
      */
     std::vector<Trade> getTradesForSymbol(const std::string& symbol) const;
 
     /**
-     * @brief Get trades for specific user (by order IDs)
+     * @brief Get trades for specific user (by order IDs, one scan of the buy/sell ID columns)
      */
     std::vector<Trade> getTradesForUser(const std::string& userId) const;
 
     /**
      * @brief Get trade statistics
+     * Built from the running totals in O(symbols); no trade history is scanned.
      */
     struct TradeStatistics {
         long long totalTrades;
@@ -195,12 +217,24 @@ public:
     TradeStatistics getTradeStatistics() const;
 
     /**
-     * @brief Get trade statistics for specific symbol
+     * @brief Direct access to the trade store for surveillance and analytics queries
+     */
+    const TradeStore& getTradeStore() const { return *tradeStore; }
+
+    /**
+     * @brief Live bars and totals, for dashboards that poll every second
+     */
+    const BarAggregator& getAggregates() const { return aggregates; }
+
+    /**
+     * @brief Get trade statistics for specific symbol (O(1) from the running totals)
      */
     TradeStatistics getSymbolStatistics(const std::string& symbol) const;
 
     /**
      * @brief Get daily trade summary
+     * Days still retained as 1d bars are read in O(bars); older days fall back to
+     * one TradeStore::summarizeSymbol column scan each.
      */
     struct DailyTradeSummary {
         std::string date;
@@ -277,6 +311,21 @@ public:
     bool generateTradingReport(const std::string& filename,
                               const std::string& symbol = "") const;
 
+    /**
+     * @brief Hand periodic flushes (every flushIntervalSeconds), size-based rotation and
+     *        archiving to an engine-wide pool as LOW tasks (before the logger starts writing)
+     * nullptr keeps them on the logging thread.
+     */
+    void setBackgroundScheduler(TaskScheduler* scheduler);
+
+    /**
+     * @brief Generate a trading report on the background pool
+     * @param done Called on a pool thread with generateTradingReport's result
+     * @return False if no scheduler is set or it is not running
+     */
+    bool generateTradingReportAsync(const std::string& filename, const std::string& symbol,
+                                    std::function<void(bool)> done);
+
     /**
      * @brief Archive old log files
      */
@@ -0,0 +1,513 @@
+#include "TradeStore.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace OrderMatchingEngine {
+
+namespace {
+
+const char SEGMENT_MAGIC[8] = {'O', 'M', 'E', 'T', 'R', 'D', 'S', '1'};
+const char* SYMBOL_FILE = "symbols.txt";
+
+// Bytes per row across all columns
+const size_t ROW_BYTES = sizeof(long long) + sizeof(TradeId) + 2 * sizeof(OrderId) +
+                         sizeof(Price) + sizeof(std::int32_t) + sizeof(std::uint16_t);
+
+static_assert(sizeof(TradeSegment::Header) == 64, "Segment header must stay 64 bytes");
+
+long long floorTo(long long value, long long step) {
+    long long quotient = value / step;
+    if (value % step != 0 && value < 0) {
+        quotient--;
+    }
+    return quotient * step;
+}
+
+} // namespace
+
+// TradeSummary implementation
+TradeSummary::TradeSummary()
+    : tradeCount(0), volume(0), notional(0.0), openPrice(0), highPrice(0), lowPrice(0),
+      closePrice(0), firstTimestamp(0), lastTimestamp(0) {
+}
+
+namespace {
+
+/**
+ * @brief Fold the summary of a contiguous run of sorted rows into the total
+ */
+void mergeSummary(TradeSummary& total, const TradeSummary& part) {
+    if (part.tradeCount == 0) {
+        return;
+    }
+    if (total.tradeCount == 0) {
+        total = part;
+        return;
+    }
+    if (part.firstTimestamp < total.firstTimestamp) {
+        total.openPrice = part.openPrice;
+        total.firstTimestamp = part.firstTimestamp;
+    }
+    if (part.lastTimestamp >= total.lastTimestamp) {
+        total.closePrice = part.closePrice;
+        total.lastTimestamp = part.lastTimestamp;
+    }
+    total.highPrice = std::max(total.highPrice, part.highPrice);
+    total.lowPrice = std::min(total.lowPrice, part.lowPrice);
+    total.tradeCount += part.tradeCount;
+    total.volume += part.volume;
+    total.notional += part.notional;
+}
+
+/**
+ * @brief Summary of rows [first, last) of a segment whose timestamps are sorted
+ * Straight loops over the price and quantity columns, which the compiler vectorizes.
+ */
+TradeSummary summarizeRun(const TradeSegment& segment, size_t first, size_t last) {
+    TradeSummary summary;
+    if (first >= last) {
+        return summary;
+    }
+    const Price* prices = segment.getPrices();
+    const std::int32_t* quantities = segment.getQuantities();
+
+    long long volume = 0;
+    double notional = 0.0;
+    Price high = prices[first];
+    Price low = prices[first];
+    for (size_t row = first; row < last; ++row) {
+        volume += quantities[row];
+        notional += static_cast<double>(prices[row]) * quantities[row];
+        high = std::max(high, prices[row]);
+        low = std::min(low, prices[row]);
+    }
+
+    summary.tradeCount = static_cast<long long>(last - first);
+    summary.volume = volume;
+    summary.notional = notional;
+    summary.highPrice = high;
+    summary.lowPrice = low;
+    summary.openPrice = prices[first];
+    summary.closePrice = prices[last - 1];
+    summary.firstTimestamp = segment.getTimestamps()[first];
+    summary.lastTimestamp = segment.getTimestamps()[last - 1];
+    return summary;
+}
+
+/**
+ * @brief Summary of a single row
+ */
+TradeSummary summarizeRow(const TradeSegment& segment, size_t row) {
+    return summarizeRun(segment, row, row + 1);
+}
+
+} // namespace
+
+// TradeSegment implementation
+TradeSegment::TradeSegment()
+    : fileDescriptor(-1), mapping(nullptr), mappingSize(0), header(nullptr), timestamps(nullptr),
+      tradeIds(nullptr), buyOrderIds(nullptr), sellOrderIds(nullptr), prices(nullptr),
+      quantities(nullptr), symbols(nullptr), publishedRows(0),
+      minTimestamp(std::numeric_limits<long long>::max()),
+      maxTimestamp(std::numeric_limits<long long>::min()), unsorted(false) {
+}
+
+TradeSegment::~TradeSegment() {
+    if (mapping) {
+        header->rowCount = publishedRows.load();
+        ::msync(mapping, mappingSize, MS_SYNC);
+        ::munmap(mapping, mappingSize);
+    }
+    if (fileDescriptor >= 0) {
+        ::close(fileDescriptor);
+    }
+}
+
+bool TradeSegment::map(const std::string& segmentPath, std::uint64_t rowCapacity, bool create) {
+    path = segmentPath;
+    fileDescriptor = ::open(path.c_str(), create ? (O_RDWR | O_CREAT | O_EXCL) : O_RDWR, 0644);
+    if (fileDescriptor < 0) {
+        return false;
+    }
+
+    if (!create) {
+        Header existing;
+        if (::pread(fileDescriptor, &existing, sizeof(existing), 0) != static_cast<ssize_t>(sizeof(existing)) ||
+            std::memcmp(existing.magic, SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC)) != 0) {
+            return false;
+        }
+        rowCapacity = existing.capacity;
+    }
+
+    // Sparse file: pages are only allocated as rows reach them
+    mappingSize = sizeof(Header) + static_cast<size_t>(rowCapacity) * ROW_BYTES;
+    if (create && ::ftruncate(fileDescriptor, static_cast<off_t>(mappingSize)) != 0) {
+        return false;
+    }
+    void* address = ::mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+    if (address == MAP_FAILED) {
+        return false;
+    }
+    mapping = static_cast<char*>(address);
+    header = reinterpret_cast<Header*>(mapping);
+
+    // 8-byte columns first, then 4- and 2-byte ones, so every column stays aligned
+    char* column = mapping + sizeof(Header);
+    timestamps = reinterpret_cast<long long*>(column);
+    column += rowCapacity * sizeof(long long);
+    tradeIds = reinterpret_cast<TradeId*>(column);
+    column += rowCapacity * sizeof(TradeId);
+    buyOrderIds = reinterpret_cast<OrderId*>(column);
+    column += rowCapacity * sizeof(OrderId);
+    sellOrderIds = reinterpret_cast<OrderId*>(column);
+    column += rowCapacity * sizeof(OrderId);
+    prices = reinterpret_cast<Price*>(column);
+    column += rowCapacity * sizeof(Price);
+    quantities = reinterpret_cast<std::int32_t*>(column);
+    column += rowCapacity * sizeof(std::int32_t);
+    symbols = reinterpret_cast<std::uint16_t*>(column);
+    return true;
+}
+
+std::unique_ptr<TradeSegment> TradeSegment::create(const std::string& path, std::uint64_t capacity,
+                                                   long long partitionStart, long long partitionEnd) {
+    std::unique_ptr<TradeSegment> segment(new TradeSegment());
+    if (!segment->map(path, capacity, true)) {
+        throw std::runtime_error("Cannot create trade segment " + path + ": " + std::strerror(errno));
+    }
+    Header* header = segment->header;
+    std::memcpy(header->magic, SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC));
+    header->capacity = capacity;
+    header->rowCount = 0;
+    header->partitionStart = partitionStart;
+    header->partitionEnd = partitionEnd;
+    header->minTimestamp = segment->minTimestamp.load();
+    header->maxTimestamp = segment->maxTimestamp.load();
+    header->unsorted = 0;
+    return segment;
+}
+
+std::unique_ptr<TradeSegment> TradeSegment::open(const std::string& path) {
+    std::unique_ptr<TradeSegment> segment(new TradeSegment());
+    if (!segment->map(path, 0, false)) {
+        throw std::runtime_error("Cannot open trade segment " + path);
+    }
+    Header* header = segment->header;
+    std::uint64_t rows = std::min(header->rowCount, header->capacity);
+    segment->minTimestamp.store(header->minTimestamp);
+    segment->maxTimestamp.store(header->maxTimestamp);
+    segment->unsorted.store(header->unsorted != 0);
+    for (std::uint64_t row = 0; row < rows; ++row) {
+        segment->indexRow(static_cast<std::uint32_t>(row));
+    }
+    segment->publishedRows.store(rows);
+    return segment;
+}
+
+void TradeSegment::indexRow(std::uint32_t row) {
+    std::uint16_t symbolIndex = symbols[row];
+    std::lock_guard<std::mutex> lock(symbolRowsMutex);
+    if (symbolIndex >= symbolRows.size()) {
+        symbolRows.resize(static_cast<size_t>(symbolIndex) + 1);
+    }
+    symbolRows[symbolIndex].push_back(row);
+}
+
+bool TradeSegment::append(const Trade& trade) {
+    std::uint64_t row = publishedRows.load(std::memory_order_relaxed);
+    if (row == header->capacity) {
+        return false;
+    }
+
+    timestamps[row] = trade.timestamp;
+    tradeIds[row] = trade.tradeId;
+    buyOrderIds[row] = trade.buyOrderId;
+    sellOrderIds[row] = trade.sellOrderId;
+    prices[row] = trade.price;
+    quantities[row] = trade.quantity;
+    symbols[row] = getSymbolIndex(trade.buyOrderId);
+    indexRow(static_cast<std::uint32_t>(row));
+
+    if (row > 0 && trade.timestamp < timestamps[row - 1]) {
+        unsorted.store(true, std::memory_order_release);
+        header->unsorted = 1;
+    }
+    if (trade.timestamp < minTimestamp.load(std::memory_order_relaxed)) {
+        minTimestamp.store(trade.timestamp, std::memory_order_relaxed);
+        header->minTimestamp = trade.timestamp;
+    }
+    if (trade.timestamp > maxTimestamp.load(std::memory_order_relaxed)) {
+        maxTimestamp.store(trade.timestamp, std::memory_order_relaxed);
+        header->maxTimestamp = trade.timestamp;
+    }
+
+    publishedRows.store(row + 1, std::memory_order_release);
+    header->rowCount = row + 1;
+    return true;
+}
+
+size_t TradeSegment::lowerBound(long long timestamp, size_t rowCount) const {
+    if (!isSorted()) {
+        return 0; // Callers filter every row
+    }
+    return static_cast<size_t>(std::lower_bound(timestamps, timestamps + rowCount, timestamp) - timestamps);
+}
+
+std::vector<std::uint32_t> TradeSegment::symbolRowsInRange(std::uint16_t symbolIndex,
+                                                           long long start, long long end) const {
+    std::vector<std::uint32_t> rows;
+    std::lock_guard<std::mutex> lock(symbolRowsMutex);
+    if (symbolIndex >= symbolRows.size()) {
+        return rows;
+    }
+    const std::vector<std::uint32_t>& all = symbolRows[symbolIndex];
+    if (isSorted()) {
+        auto byTimestamp = [this](std::uint32_t row, long long timestamp) { return timestamps[row] < timestamp; };
+        auto first = std::lower_bound(all.begin(), all.end(), start, byTimestamp);
+        auto last = std::lower_bound(first, all.end(), end, byTimestamp);
+        rows.assign(first, last);
+    } else {
+        for (std::uint32_t row : all) {
+            if (timestamps[row] >= start && timestamps[row] < end) {
+                rows.push_back(row);
+            }
+        }
+    }
+    return rows;
+}
+
+void TradeSegment::flush() {
+    if (mapping) {
+        ::msync(mapping, mappingSize, MS_SYNC);
+    }
+}
+
+// TradeStore implementation
+TradeStore::TradeStore(const StoreConfig& config) : config(config), nextSegmentNumber(1) {
+    if (config.segmentCapacity == 0 || config.segmentCapacity > std::numeric_limits<std::uint32_t>::max()) {
+        throw std::invalid_argument("Trade store segment capacity must be between 1 and 2^32-1 rows");
+    }
+    if (config.segmentDurationMicros <= 0) {
+        throw std::invalid_argument("Trade store segment duration must be positive");
+    }
+}
+
+void TradeStore::open() {
+    namespace fs = std::filesystem;
+    fs::create_directories(config.directory);
+
+    std::vector<fs::path> segmentFiles;
+    for (const auto& entry : fs::directory_iterator(config.directory)) {
+        std::string name = entry.path().filename().string();
+        if (name.rfind("segment-", 0) == 0 && entry.path().extension() == ".dat") {
+            segmentFiles.push_back(entry.path());
+        }
+    }
+    std::sort(segmentFiles.begin(), segmentFiles.end());   // Zero-padded numbers sort in creation order
+
+    std::unique_lock<std::shared_mutex> lock(segmentsMutex);
+    segments.clear();
+    for (const auto& file : segmentFiles) {
+        segments.push_back(TradeSegment::open(file.string()));
+        int number = std::atoi(file.stem().string().substr(8).c_str());
+        nextSegmentNumber = std::max(nextSegmentNumber, number + 1);
+    }
+    lock.unlock();
+
+    loadSymbolNames();
+}
+
+void TradeStore::loadSymbolNames() {
+    std::ifstream input(config.directory + "/" + SYMBOL_FILE);
+    std::lock_guard<std::mutex> lock(symbolNamesMutex);
+    unsigned symbolIndex;
+    std::string symbol;
+    while (input >> symbolIndex >> symbol) {
+        if (symbolIndex >= symbolNames.size()) {
+            symbolNames.resize(symbolIndex + 1);
+        }
+        symbolNames[symbolIndex] = symbol;
+    }
+}
+
+void TradeStore::registerSymbol(std::uint16_t symbolIndex, const std::string& symbol) {
+    std::lock_guard<std::mutex> lock(symbolNamesMutex);
+    if (symbolIndex < symbolNames.size() && symbolNames[symbolIndex] == symbol) {
+        return;
+    }
+    if (symbolIndex >= symbolNames.size()) {
+        symbolNames.resize(static_cast<size_t>(symbolIndex) + 1);
+    }
+    symbolNames[symbolIndex] = symbol;
+
+    std::ofstream output(config.directory + "/" + SYMBOL_FILE, std::ios::app);
+    output << symbolIndex << ' ' << symbol << '\n';
+}
+
+bool TradeStore::findSymbolIndex(const std::string& symbol, std::uint16_t& symbolIndex) const {
+    std::lock_guard<std::mutex> lock(symbolNamesMutex);
+    auto it = std::find(symbolNames.begin(), symbolNames.end(), symbol);
+    if (symbol.empty() || it == symbolNames.end()) {
+        return false;
+    }
+    symbolIndex = static_cast<std::uint16_t>(it - symbolNames.begin());
+    return true;
+}
+
+std::string TradeStore::symbolName(std::uint16_t symbolIndex) const {
+    std::lock_guard<std::mutex> lock(symbolNamesMutex);
+    return symbolIndex < symbolNames.size() ? symbolNames[symbolIndex] : std::string();
+}
+
+TradeSegment& TradeStore::segmentFor(long long timestamp) {
+    // Only the appending thread changes the segment list, so it reads it without the lock
+    if (!segments.empty()) {
+        TradeSegment& current = *segments.back();
+        // Late trades stay in the open segment; it is then marked unsorted
+        if (!current.isFull() && timestamp < current.getPartitionEnd()) {
+            return current;
+        }
+    }
+
+    long long partitionStart = floorTo(timestamp, config.segmentDurationMicros);
+    if (!segments.empty() && segments.back()->isFull() && timestamp < segments.back()->getPartitionEnd()) {
+        partitionStart = segments.back()->getPartitionStart(); // Overflow of a busy partition
+    }
+
+    char name[32];
+    std::snprintf(name, sizeof(name), "segment-%06d.dat", nextSegmentNumber++);
+    auto segment = TradeSegment::create(config.directory + "/" + name, config.segmentCapacity,
+                                        partitionStart, partitionStart + config.segmentDurationMicros);
+
+    std::unique_lock<std::shared_mutex> lock(segmentsMutex);
+    segments.push_back(std::move(segment));
+    return *segments.back();
+}
+
+void TradeStore::append(const Trade& trade) {
+    registerSymbol(getSymbolIndex(trade.buyOrderId), trade.symbol);
+    segmentFor(trade.timestamp).append(trade);
+}
+
+void TradeStore::append(const std::vector<Trade>& trades) {
+    for (const auto& trade : trades) {
+        append(trade);
+    }
+}
+
+void TradeStore::flush() {
+    std::shared_lock<std::shared_mutex> lock(segmentsMutex);
+    for (const auto& segment : segments) {
+        segment->flush();
+    }
+}
+
+Trade TradeStore::rowToTrade(const TradeSegment& segment, size_t row) const {
+    Trade trade(segment.getTradeIds()[row], segment.getBuyOrderIds()[row], segment.getSellOrderIds()[row],
+                symbolName(segment.getSymbols()[row]), segment.getPrices()[row], segment.getQuantities()[row],
+                segment.getTimestamps()[row]);
+    return trade;
+}
+
+std::vector<Trade> TradeStore::getTrades(long long start, long long end) const {
+    std::vector<Trade> trades;
+    forEachSegment(start, end, [&](const TradeSegment& segment) {
+        size_t rows = segment.size();
+        const long long* timestamps = segment.getTimestamps();
+        size_t last = segment.isSorted() ? segment.lowerBound(end, rows) : rows;
+        for (size_t row = segment.lowerBound(start, rows); row < last; ++row) {
+            if (timestamps[row] >= start && timestamps[row] < end) {
+                trades.push_back(rowToTrade(segment, row));
+            }
+        }
+    });
+    return trades;
+}
+
+std::vector<Trade> TradeStore::getTradesForSymbol(std::uint16_t symbolIndex, long long start, long long end) const {
+    std::vector<Trade> trades;
+    forEachSegment(start, end, [&](const TradeSegment& segment) {
+        for (std::uint32_t row : segment.symbolRowsInRange(symbolIndex, start, end)) {
+            trades.push_back(rowToTrade(segment, row));
+        }
+    });
+    return trades;
+}
+
+std::vector<Trade> TradeStore::getTradesForOrders(const std::unordered_set<OrderId>& orderIds,
+                                                  long long start, long long end) const {
+    std::vector<Trade> trades;
+    if (orderIds.empty()) {
+        return trades;
+    }
+    forEachSegment(start, end, [&](const TradeSegment& segment) {
+        size_t rows = segment.size();
+        const long long* timestamps = segment.getTimestamps();
+        const OrderId* buyOrderIds = segment.getBuyOrderIds();
+        const OrderId* sellOrderIds = segment.getSellOrderIds();
+        size_t last = segment.isSorted() ? segment.lowerBound(end, rows) : rows;
+        for (size_t row = segment.lowerBound(start, rows); row < last; ++row) {
+            if (timestamps[row] >= start && timestamps[row] < end &&
+                (orderIds.count(buyOrderIds[row]) || orderIds.count(sellOrderIds[row]))) {
+                trades.push_back(rowToTrade(segment, row));
+            }
+        }
+    });
+    return trades;
+}
+
+TradeSummary TradeStore::summarize(long long start, long long end) const {
+    TradeSummary total;
+    forEachSegment(start, end, [&](const TradeSegment& segment) {
+        size_t rows = segment.size();
+        if (segment.isSorted()) {
+            mergeSummary(total, summarizeRun(segment, segment.lowerBound(start, rows),
+                                             segment.lowerBound(end, rows)));
+            return;
+        }
+        const long long* timestamps = segment.getTimestamps();
+        for (size_t row = 0; row < rows; ++row) {
+            if (timestamps[row] >= start && timestamps[row] < end) {
+                mergeSummary(total, summarizeRow(segment, row));
+            }
+        }
+    });
+    return total;
+}
+
+TradeSummary TradeStore::summarizeSymbol(std::uint16_t symbolIndex, long long start, long long end) const {
+    TradeSummary total;
+    forEachSegment(start, end, [&](const TradeSegment& segment) {
+        for (std::uint32_t row : segment.symbolRowsInRange(symbolIndex, start, end)) {
+            mergeSummary(total, summarizeRow(segment, row));
+        }
+    });
+    return total;
+}
+
+size_t TradeStore::getSegmentCount() const {
+    std::shared_lock<std::shared_mutex> lock(segmentsMutex);
+    return segments.size();
+}
+
+long long TradeStore::getTradeCount() const {
+    std::shared_lock<std::shared_mutex> lock(segmentsMutex);
+    long long count = 0;
+    for (const auto& segment : segments) {
+        count += static_cast<long long>(segment->size());
+    }
+    return count;
+}
+
+} // namespace OrderMatchingEngine
\ No newline at end of file
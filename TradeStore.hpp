@@ -0,0 +1,225 @@
+#ifndef TRADE_STORE_HPP
+#define TRADE_STORE_HPP
+
+#include "OrderBook.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace OrderMatchingEngine {
+
+/**
+ * @brief OHLC, volume and VWAP of the trades matched by a query
+ */
+struct TradeSummary {
+    long long tradeCount;
+    long long volume;
+    double notional;        // Sum of price * quantity, in ticks
+    Price openPrice;
+    Price highPrice;
+    Price lowPrice;
+    Price closePrice;
+    long long firstTimestamp;
+    long long lastTimestamp;
+
+    TradeSummary();
+
+    double vwap() const { return volume > 0 ? notional / volume : 0.0; }   // In ticks
+};
+
+/**
+ * @brief One time partition of the trade store: a memory-mapped file of fixed-capacity columns
+ *
+ * Layout: header, then one contiguous array per column (timestamp, trade ID,
+ * buy/sell order IDs, price, quantity, symbol index). A writer appends rows
+ * and publishes them by bumping the row count, so readers can scan the
+ * columns without any lock. Rows are also listed per symbol in memory.
+ */
+class TradeSegment {
+public:
+    struct Header {
+        char magic[8];
+        std::uint64_t capacity;
+        std::uint64_t rowCount;
+        long long partitionStart;   // Microseconds since epoch, inclusive
+        long long partitionEnd;     // Exclusive
+        long long minTimestamp;     // Of the rows actually stored
+        long long maxTimestamp;
+        std::uint8_t unsorted;      // Set once a row arrived out of timestamp order
+        std::uint8_t reserved[7];
+    };
+
+private:
+    std::string path;
+    int fileDescriptor;
+    char* mapping;
+    size_t mappingSize;
+    Header* header;
+
+    long long* timestamps;
+    TradeId* tradeIds;
+    OrderId* buyOrderIds;
+    OrderId* sellOrderIds;
+    Price* prices;
+    std::int32_t* quantities;
+    std::uint16_t* symbols;
+
+    std::atomic<std::uint64_t> publishedRows;
+    std::atomic<long long> minTimestamp;
+    std::atomic<long long> maxTimestamp;
+    std::atomic<bool> unsorted;
+
+    mutable std::mutex symbolRowsMutex;
+    std::vector<std::vector<std::uint32_t>> symbolRows;     // Indexed by symbol index
+
+    TradeSegment();
+    bool map(const std::string& path, std::uint64_t capacity, bool create);
+    void indexRow(std::uint32_t row);
+
+public:
+    ~TradeSegment();
+
+    TradeSegment(const TradeSegment&) = delete;
+    TradeSegment& operator=(const TradeSegment&) = delete;
+
+    static std::unique_ptr<TradeSegment> create(const std::string& path, std::uint64_t capacity,
+                                                long long partitionStart, long long partitionEnd);
+    static std::unique_ptr<TradeSegment> open(const std::string& path);
+
+    /**
+     * @brief Append a trade (single writer)
+     * @return False if the segment is full
+     */
+    bool append(const Trade& trade);
+
+    /**
+     * @brief First row with a timestamp >= the given one (binary search when sorted)
+     */
+    size_t lowerBound(long long timestamp, size_t rowCount) const;
+
+    /**
+     * @brief Rows of one symbol with start <= timestamp < end
+     */
+    std::vector<std::uint32_t> symbolRowsInRange(std::uint16_t symbolIndex,
+                                                 long long start, long long end) const;
+
+    size_t size() const { return publishedRows.load(std::memory_order_acquire); }
+    size_t capacity() const { return header->capacity; }
+    bool isFull() const { return size() == header->capacity; }
+    bool isSorted() const { return !unsorted.load(std::memory_order_acquire); }
+    long long getPartitionStart() const { return header->partitionStart; }
+    long long getPartitionEnd() const { return header->partitionEnd; }
+    bool overlaps(long long start, long long end) const {
+        return size() > 0 && maxTimestamp.load(std::memory_order_relaxed) >= start &&
+               minTimestamp.load(std::memory_order_relaxed) < end;
+    }
+    void flush();
+
+    // Column access for scans
+    const long long* getTimestamps() const { return timestamps; }
+    const TradeId* getTradeIds() const { return tradeIds; }
+    const OrderId* getBuyOrderIds() const { return buyOrderIds; }
+    const OrderId* getSellOrderIds() const { return sellOrderIds; }
+    const Price* getPrices() const { return prices; }
+    const std::int32_t* getQuantities() const { return quantities; }
+    const std::uint16_t* getSymbols() const { return symbols; }
+};
+
+/**
+ * @brief Append-only trade history on disk, partitioned into time segments
+ *
+ * History is bounded by disk rather than RAM. Range queries binary-search
+ * the timestamp column of each overlapping segment, and summaries are tight
+ * loops over the price and quantity columns. Appends come from one thread
+ * (the logger); any number of threads can query at the same time.
+ */
+class TradeStore {
+public:
+    struct StoreConfig {
+        std::string directory;
+        std::uint64_t segmentCapacity;      // Rows per segment file
+        long long segmentDurationMicros;    // Length of a time partition
+
+        StoreConfig() : directory("./logs/trades"), segmentCapacity(1 << 20),
+                       segmentDurationMicros(3600LL * 1000000LL) {}
+    };
+
+private:
+    StoreConfig config;
+    std::vector<std::unique_ptr<TradeSegment>> segments;   // In creation (time) order
+    mutable std::shared_mutex segmentsMutex;               // Exclusive only while adding a segment
+    std::vector<std::string> symbolNames;                  // Indexed by symbol index
+    mutable std::mutex symbolNamesMutex;
+    int nextSegmentNumber;
+
+    TradeSegment& segmentFor(long long timestamp);
+    void loadSymbolNames();
+    std::string symbolName(std::uint16_t symbolIndex) const;
+    Trade rowToTrade(const TradeSegment& segment, size_t row) const;
+
+    /**
+     * @brief Visit every segment overlapping [start, end) under a shared lock
+     */
+    template<typename Visitor>
+    void forEachSegment(long long start, long long end, Visitor&& visit) const {
+        std::shared_lock<std::shared_mutex> lock(segmentsMutex);
+        for (const auto& segment : segments) {
+            if (segment->overlaps(start, end)) {
+                visit(*segment);
+            }
+        }
+    }
+
+public:
+    explicit TradeStore(const StoreConfig& config = StoreConfig());
+
+    /**
+     * @brief Map the existing segments in the store directory, creating it if needed
+     * @throws std::runtime_error if a segment file cannot be mapped
+     */
+    void open();
+
+    /**
+     * @brief Record the name behind a symbol index, for turning rows back into Trades
+     */
+    void registerSymbol(std::uint16_t symbolIndex, const std::string& symbol);
+
+    /**
+     * @brief Look up the index of a symbol seen by the store
+     * @return False if no trade of the symbol has been stored
+     */
+    bool findSymbolIndex(const std::string& symbol, std::uint16_t& symbolIndex) const;
+
+    void append(const Trade& trade);
+    void append(const std::vector<Trade>& trades);
+
+    /**
+     * @brief Sync every mapped segment to disk
+     */
+    void flush();
+
+    // Queries over [start, end), in microseconds since epoch
+    std::vector<Trade> getTrades(long long start, long long end) const;
+    std::vector<Trade> getTradesForSymbol(std::uint16_t symbolIndex, long long start, long long end) const;
+
+    /**
+     * @brief Trades in which any of the given orders took part
+     */
+    std::vector<Trade> getTradesForOrders(const std::unordered_set<OrderId>& orderIds,
+                                          long long start, long long end) const;
+
+    TradeSummary summarize(long long start, long long end) const;
+    TradeSummary summarizeSymbol(std::uint16_t symbolIndex, long long start, long long end) const;
+
+    size_t getSegmentCount() const;
+    long long getTradeCount() const;
+};
+
+} // namespace OrderMatchingEngine
+
+#endif // TRADE_STORE_HPP
\ No newline at end of file
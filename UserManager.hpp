@@ -2,35 +2,37 @@
 #define USER_MANAGER_HPP
 
 #include "Order.hpp"
+#include "AccountRisk.hpp"
+#include "TimerWheel.hpp"
+#include "TaskScheduler.hpp"
 #include <unordered_map>
 #include <vector>
 #include <memory>
 #include <mutex>
+#include <shared_mutex>
+#include <atomic>
 #include <set>
 
 namespace OrderMatchingEngine {
 
 /**
  * @brief User account information and portfolio management
+ *
+ * Cash, reservations, per-symbol positions, the day's loss and order counters
+ * live in the account's AccountRiskState, which pre-trade checks and fills
+ * update lock-free. The remaining fields are cold and guarded by accountMutex.
  */
 class UserAccount {
 private:
     std::string userId;
     std::string userName;
-    double cashBalance;
-    std::unordered_map<std::string, int> positions; // symbol -> quantity
-    std::set<std::string> activeOrderIds;
+    AccountRiskState risk;
+    std::unordered_map<std::string, int> positions; // symbol -> quantity, for reporting by name
+    std::set<OrderId> activeOrderIds;
     double totalPnL; // Profit and Loss
-    bool isActive;
     std::chrono::system_clock::time_point creationTime;
     std::chrono::system_clock::time_point lastActivityTime;
-
-    // Risk management
-    double maxPositionValue;
-    double dailyLossLimit;
-    double currentDayLoss;
-    int maxOrdersPerDay;
-    int todayOrderCount;
+    mutable std::mutex accountMutex;
 
 public:
     UserAccount(const std::string& userId, const std::string& userName, 
@@ -39,11 +41,18 @@ public:
     // Account management
     const std::string& getUserId() const { return userId; }
     const std::string& getUserName() const { return userName; }
-    double getCashBalance() const { return cashBalance; }
+    double getCashBalance() const { return fromCashAmount(risk.getAvailableCash()); }
+    double getReservedCash() const { return fromCashAmount(risk.getReservedCash()); }
     double getTotalPnL() const { return totalPnL; }
-    bool getIsActive() const { return isActive; }
+    bool getIsActive() const { return risk.isActive(); }
 
-    void setActive(bool active) { isActive = active; }
+    void setActive(bool active) { risk.setActive(active); }
+
+    /**
+     * @brief Lock-free pre-trade state, for checks on the order path
+     */
+    AccountRiskState& getRiskState() { return risk; }
+    const AccountRiskState& getRiskState() const { return risk; }
     void updateLastActivity();
 
     // Portfolio management
@@ -61,16 +70,17 @@ public:
     void creditCash(double amount);
 
     // Order tracking
-    void addOrder(const std::string& orderId);
-    void removeOrder(const std::string& orderId);
-    bool hasOrder(const std::string& orderId) const;
+    void addOrder(OrderId orderId);
+    void removeOrder(OrderId orderId);
+    bool hasOrder(OrderId orderId) const;
     int getActiveOrderCount() const { return activeOrderIds.size(); }
-    std::set<std::string> getActiveOrders() const { return activeOrderIds; }
+    std::set<OrderId> getActiveOrders() const { return activeOrderIds; }
 
     // Risk management
     bool canPlaceOrder(double orderValue) const;
     void updateDayLoss(double loss);
     void resetDayCounters();
+    void setLimits(const AccountLimits& limits) { risk.setLimits(limits); }
 
     // Account statistics
     struct AccountStats {
@@ -89,38 +99,70 @@ public:
 
 /**
  * @brief Manages all user accounts and their interactions with the trading system
+ *
+ * Accounts are partitioned into shards by user ID hash, each with its own
+ * shared mutex that is taken exclusively only to add or remove an account.
+ * Order-path operations (canUserAfford, reserveFundsForOrder, checkRiskLimits,
+ * updateUserPosition) take one shard's lock shared to find the account and
+ * then work on its AccountRiskState without further locking; callers on the
+ * hot path can skip even that by caching getRiskState(). The audit trail is
+ * appended through a lock-free ring.
  */
 class UserManager {
 private:
-    std::unordered_map<std::string, std::unique_ptr<UserAccount>> users;
-    mutable std::mutex userManagerMutex;
+    /**
+     * @brief One partition of the accounts; a user ID always maps to the same shard
+     */
+    struct alignas(CACHE_LINE_SIZE) AccountShard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<std::string, std::unique_ptr<UserAccount>> users;
+    };
+
+    std::vector<std::unique_ptr<AccountShard>> shards;     // Power-of-two count, fixed at construction
+    std::atomic<int> userCount;
+
+    // Deleted accounts are deactivated and retired, never destroyed while the
+    // manager lives, so cached risk state pointers stay valid
+    std::vector<std::unique_ptr<UserAccount>> retiredUsers;
+    std::mutex retiredUsersMutex;
 
     // System-wide limits
-    int maxUsersLimit;
+    std::atomic<int> maxUsersLimit;
     double systemCashLimit;
-    bool enableAccountCreation;
+    std::atomic<bool> enableAccountCreation;
 
-    // Session management
-    std::unordered_map<std::string, std::string> activeSessions; // sessionId -> userId
-    std::unordered_map<std::string, std::chrono::system_clock::time_point> sessionExpiry;
-
-    // Audit trail
-    struct UserAction {
+    // Session management (login path only, off the order path). Each session has
+    // an expiry timer whose payload is its handle in sessionsByHandle, so
+    // cleanupExpiredSessions touches only the sessions that expired.
+    struct SessionInfo {
         std::string userId;
-        std::string action;
-        std::string details;
-        std::chrono::system_clock::time_point timestamp;
+        std::chrono::system_clock::time_point expiry;
+        std::uint64_t handle;
+        TimerId expiryTimer;
     };
-    std::vector<UserAction> auditTrail;
+    std::unordered_map<std::string, SessionInfo> activeSessions; // sessionId -> session
+    std::unordered_map<std::uint64_t, std::string> sessionsByHandle;
+    std::uint64_t nextSessionHandle;
+    TimerWheel sessionTimers;
+    mutable std::mutex sessionMutex;
+
+    // Audit trail
+    AuditTrail auditTrail;
+
+    // Background pool for session cleanup and whole-system reports (optional)
+    TaskScheduler* scheduler;
+    std::uint64_t sessionCleanupTask;
 
+    AccountShard& shardFor(const std::string& userId) const;
     void logUserAction(const std::string& userId, const std::string& action, 
                       const std::string& details = "");
 
 public:
     /**
      * @brief Constructor
+     * @param shardCount Account partitions, rounded up to a power of two
      */
-    UserManager();
+    explicit UserManager(size_t shardCount = 64);
 
     /**
      * @brief Destructor
@@ -140,8 +182,23 @@ public:
     UserAccount* getUser(const std::string& userId);
     const UserAccount* getUser(const std::string& userId) const;
 
+    /**
+     * @brief Pre-trade state of an account, stable for the manager's lifetime
+     * Look it up once per session and check orders against it without any lock.
+     * @return nullptr if the user does not exist
+     */
+    AccountRiskState* getRiskState(const std::string& userId);
+
+    /**
+     * @brief Index of the shard that holds a user's account
+     * Gateways can use it to give each thread the accounts of one shard.
+     */
+    size_t getShardIndex(const std::string& userId) const;
+    size_t getShardCount() const { return shards.size(); }
+
     /**
      * @brief Delete user account
+     * The account is deactivated and retired; its risk state stays valid.
      */
     bool deleteUser(const std::string& userId);
 
@@ -203,15 +260,30 @@ public:
 
     /**
      * @brief Clean up expired sessions
+     * Advances the session timer wheel: O(1) per expired session, no sweep.
      */
     void cleanupExpiredSessions();
 
+    /**
+     * @brief Run session cleanup as a periodic LOW task on an engine-wide pool
+     * Reports over every account (getSystemStats, getAllPortfolios) then also
+     * scan the account shards in parallel on the pool; nullptr goes back to
+     * calling cleanupExpiredSessions and scanning on the caller's thread.
+     */
+    void setBackgroundScheduler(TaskScheduler* scheduler,
+                                std::chrono::milliseconds cleanupInterval = std::chrono::seconds(1));
+
     // Risk management
     /**
      * @brief Check if user meets risk requirements for order
      */
     bool checkRiskLimits(const std::string& userId, const OrderPtr& order) const;
 
+    /**
+     * @brief Every pre-trade check plus the cash reservation of a buy, in one lock-free step
+     */
+    RiskCheckResult checkAndReserve(const std::string& userId, const PreTradeOrder& order);
+
     /**
      * @brief Update daily loss for user
      */
@@ -252,6 +324,7 @@ public:
 
     /**
      * @brief Get all user portfolios
+     * With a background scheduler the account shards are read in parallel, one task per shard.
      */
     std::vector<PortfolioSummary> getAllPortfolios(
         const std::unordered_map<std::string, double>& currentPrices) const;
@@ -260,17 +333,17 @@ public:
     /**
      * @brief Add order to user's active orders
      */
-    bool addOrderToUser(const std::string& userId, const std::string& orderId);
+    bool addOrderToUser(const std::string& userId, OrderId orderId);
 
     /**
      * @brief Remove order from user's active orders
      */
-    bool removeOrderFromUser(const std::string& userId, const std::string& orderId);
+    bool removeOrderFromUser(const std::string& userId, OrderId orderId);
 
     /**
      * @brief Check if user owns order
      */
-    bool userOwnsOrder(const std::string& userId, const std::string& orderId) const;
+    bool userOwnsOrder(const std::string& userId, OrderId orderId) const;
 
     // System administration
     /**
@@ -286,7 +359,7 @@ public:
     /**
      * @brief Get audit trail for user
      */
-    std::vector<UserAction> getUserAuditTrail(const std::string& userId) const;
+    std::vector<AuditRecord> getUserAuditTrail(const std::string& userId) const;
 
     /**
      * @brief Export user data to file
@@ -21,6 +21,7 @@ private:
     std::vector<std::string> symbols = {"AAPL", "GOOGL", "MSFT", "TSLA", "AMZN"};
     std::vector<std::string> userIds;
     std::mt19937 rng;
+    PriceScale priceScale; // All demo symbols use the default scale
 
     void initializeUsers() {
         std::cout << "\n=== Initializing Users ===\n";
@@ -59,7 +60,8 @@ private:
         }
 
         return std::make_shared<Order>(orderId, userId, symbol, type, side, 
-                                     price, quantity, triggerPrice);
+                                     priceScale.toTicks(price), quantity,
+                                     priceScale.toTicks(triggerPrice));
     }
 
     void simulateTrading(int numOrders, int delayMs = 100) {
@@ -71,9 +73,9 @@ private:
             std::string userId = userIds[userDist(rng)];
             auto order = createRandomOrder(userId);
 
-            std::string submittedOrderId = engine->submitOrder(order);
+            OrderId submittedOrderId = engine->submitOrder(order);
 
-            if (!submittedOrderId.empty()) {
+            if (submittedOrderId != 0) {
                 std::cout << "Order " << submittedOrderId << " submitted: "
                          << order->toString() << "\n";
             } else {
@@ -104,15 +106,15 @@ private:
         // Create a buy limit order
         auto buyOrder = std::make_shared<Order>("DEMO_BUY_001", userId, "AAPL", 
                                                OrderType::LIMIT, OrderSide::BUY, 
-                                               150.0, 100);
-        std::string buyOrderId = engine->submitOrder(buyOrder);
+                                               priceScale.toTicks(150.0), 100);
+        OrderId buyOrderId = engine->submitOrder(buyOrder);
         std::cout << "Submitted buy order: " << buyOrderId << "\n";
 
         // Create a sell limit order that won't match immediately
         auto sellOrder = std::make_shared<Order>("DEMO_SELL_001", userId, "AAPL",
                                                 OrderType::LIMIT, OrderSide::SELL,
-                                                160.0, 50);
-        std::string sellOrderId = engine->submitOrder(sellOrder);
+                                                priceScale.toTicks(160.0), 50);
+        OrderId sellOrderId = engine->submitOrder(sellOrder);
         std::cout << "Submitted sell order: " << sellOrderId << "\n";
 
         // Show order book state
@@ -124,7 +126,7 @@ private:
 
         // Demonstrate order modification
         std::cout << "\nModifying buy order price to 155.0...\n";
-        bool modified = engine->modifyOrder(buyOrderId, userId, 155.0, 0);
+        bool modified = engine->modifyOrder(buyOrderId, userId, priceScale.toTicks(155.0), 0);
         std::cout << "Order modification " << (modified ? "successful" : "failed") << "\n";
 
         // Wait a moment then cancel the sell order
@@ -209,61 +211,6 @@ public:
     }
 };
 
-/**
- * @brief Performance testing function
- */
-void performanceTest() {
-    std::cout << "\n" << std::string(60, '=') << "\n";
-    std::cout << "    PERFORMANCE TEST\n";
-    std::cout << std::string(60, '=') << "\n";
-
-    auto engine = MatchingEngineFactory::createHighPerformanceEngine();
-    engine->addSymbol("PERF_TEST");
-    engine->start();
-
-    const int NUM_ORDERS = 10000;
-    const std::string USER_ID = "PERF_USER";
-
-    std::cout << "\nGenerating " << NUM_ORDERS << " orders for performance test...\n";
-
-    auto startTime = std::chrono::high_resolution_clock::now();
-
-    // Submit orders as fast as possible
-    for (int i = 0; i < NUM_ORDERS; ++i) {
-        std::string orderId = "PERF_ORDER_" + std::to_string(i);
-        OrderSide side = (i % 2 == 0) ? OrderSide::BUY : OrderSide::SELL;
-        double price = 100.0 + (i % 20) - 10.0; // Price range 90-110
-        int quantity = 10 + (i % 90); // Quantity range 10-100
-
-        auto order = std::make_shared<Order>(orderId, USER_ID, "PERF_TEST",
-                                           OrderType::LIMIT, side, price, quantity);
-
-        engine->submitOrder(order);
-
-        if ((i + 1) % 1000 == 0) {
-            std::cout << "Progress: " << (i + 1) << "/" << NUM_ORDERS << " orders\n";
-        }
-    }
-
-    auto endTime = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
-
-    double ordersPerSecond = static_cast<double>(NUM_ORDERS) * 1000000.0 / duration.count();
-    double avgLatencyMicros = static_cast<double>(duration.count()) / NUM_ORDERS;
-
-    std::cout << "\nPerformance Test Results:\n";
-    std::cout << "Total Orders: " << NUM_ORDERS << "\n";
-    std::cout << "Total Time: " << duration.count() << " microseconds\n";
-    std::cout << "Orders/Second: " << std::fixed << std::setprecision(2) << ordersPerSecond << "\n";
-    std::cout << "Avg Latency: " << std::setprecision(3) << avgLatencyMicros << " microseconds\n";
-
-    auto finalStats = engine->getStatistics();
-    std::cout << "\nFinal Engine Stats:\n";
-    std::cout << finalStats.toString() << "\n";
-
-    engine->stop();
-}
-
 /**
  * @brief Interactive mode for manual testing
  */
@@ -319,9 +266,8 @@ int main() {
     while (true) {
         std::cout << "Select an option:\n";
         std::cout << "1. Run Full Demo\n";
-        std::cout << "2. Performance Test\n";
-        std::cout << "3. Interactive Mode\n";
-        std::cout << "4. Exit\n";
+        std::cout << "2. Interactive Mode\n";
+        std::cout << "3. Exit\n";
         std::cout << "Choice: ";
 
         int choice;
@@ -335,14 +281,10 @@ int main() {
                 break;
             }
             case 2: {
-                performanceTest();
-                break;
-            }
-            case 3: {
                 interactiveMode();
                 break;
             }
-            case 4: {
+            case 3: {
                 std::cout << "Goodbye!\n";
                 return 0;
             }